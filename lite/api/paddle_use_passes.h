@@ -40,9 +40,14 @@ USE_MIR_PASS(lite_squeeze2_matmul_fuse_pass);
 USE_MIR_PASS(lite_reshape2_matmul_fuse_pass);
 USE_MIR_PASS(lite_matmul_fuse_pass);
 USE_MIR_PASS(lite_fc_fuse_pass);
+USE_MIR_PASS(lite_gemm_epilogue_fuse_pass);
+USE_MIR_PASS(lite_elementwise_chain_fuse_pass);
 USE_MIR_PASS(lite_matmul_element_add_fuse_pass);
 USE_MIR_PASS(lite_shuffle_channel_fuse_pass);
 USE_MIR_PASS(lite_transpose_softmax_transpose_fuse_pass);
+USE_MIR_PASS(lite_scaled_dot_product_attention_fuse_pass);
+USE_MIR_PASS(lite_elementwise_add_layer_norm_fuse_pass);
+USE_MIR_PASS(lite_lookup_table_sequence_pool_fuse_pass);
 USE_MIR_PASS(lite_interpolate_fuse_pass);
 USE_MIR_PASS(identity_scale_eliminate_pass);
 USE_MIR_PASS(identity_dropout_eliminate_pass);
@@ -72,6 +77,9 @@ USE_MIR_PASS(control_flow_op_shared_inputs_and_outputs_place_sync_pass);
 USE_MIR_PASS(lite_scale_activation_fuse_pass);
 USE_MIR_PASS(lite_instance_norm_activation_fuse_pass);
 USE_MIR_PASS(ssd_boxes_calc_offline_pass);
+USE_MIR_PASS(constant_folding_pass);
+USE_MIR_PASS(redundant_op_elimination_pass);
+USE_MIR_PASS(transpose_eliminate_pass);
 USE_MIR_PASS(fix_mismatched_precision_pass);
 USE_MIR_PASS(lite_flatten_fc_fuse_pass);
 USE_MIR_PASS(lite_fc_prelu_fuse_pass);
@@ -102,6 +110,8 @@ USE_MIR_PASS(__xpu__multi_softmax_fuse_pass);
 USE_MIR_PASS(__xpu__max_pooling_pad_zero_detect_fuse_pass);
 USE_MIR_PASS(__xpu__static_kernel_pick_pass);
 USE_MIR_PASS(x86_int8_attribute_pass);
+USE_MIR_PASS(x86_bf16_attribute_pass);
+USE_MIR_PASS(x86_dynamic_quant_attribute_pass);
 USE_MIR_PASS(fill_range_fuse_pass);
 USE_MIR_PASS(range_calc_offline_pass);
 USE_MIR_PASS(p_norm_fill_constant_max_div_fuse_pass);
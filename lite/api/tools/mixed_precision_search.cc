@@ -0,0 +1,188 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/mixed_precision_search.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "lite/core/optimizer/mir/fp16_attribute_pass.h"
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+
+Samples RunSamples(Predictor* predictor,
+                   const std::vector<std::vector<int64_t>>& shapes,
+                   const Samples& inputs) {
+  Samples outputs;
+  for (auto& sample : inputs) {
+    for (size_t i = 0; i < sample.size(); i++) {
+      auto* input = predictor->GetInput(i);
+      input->Resize(shapes[i]);
+      std::copy(
+          sample[i].begin(), sample[i].end(), input->mutable_data<float>());
+    }
+    predictor->Run();
+    std::vector<std::vector<float>> sample_outputs;
+    for (size_t i = 0; i < predictor->GetOutputNames().size(); i++) {
+      auto* output = predictor->GetOutput(i);
+      const float* data = output->data<float>();
+      sample_outputs.emplace_back(data, data + output->numel());
+    }
+    outputs.push_back(sample_outputs);
+  }
+  return outputs;
+}
+
+double OutputError(const Samples& ref, const Samples& out) {
+  double max_error = 0;
+  for (size_t i = 0; i < ref.size(); i++) {
+    for (size_t j = 0; j < ref[i].size(); j++) {
+      CHECK_EQ(ref[i][j].size(), out[i][j].size());
+      double diff = 0;
+      double norm = 0;
+      for (size_t k = 0; k < ref[i][j].size(); k++) {
+        double d = out[i][j][k] - ref[i][j][k];
+        diff += d * d;
+        norm += static_cast<double>(ref[i][j][k]) * ref[i][j][k];
+      }
+      double error = std::sqrt(diff) / std::max(std::sqrt(norm), 1e-12);
+      max_error = std::max(max_error, error);
+    }
+  }
+  return max_error;
+}
+
+std::vector<std::string> WeightPrecisions(
+    const std::string& op_type, const std::vector<std::string>& precisions) {
+  const auto& quant_ops = mir::PostQuantDynamicPass::quant_ops;
+  auto* fp16_pass = mir::PassManager::Global().LookUp<mir::FP16AttributePass>(
+      "fp16_attribute_pass");
+  CHECK(fp16_pass);
+  const auto& fp16_ops = fp16_pass->fp16_ops();
+  std::vector<std::string> op_precisions;
+  for (auto& precision : precisions) {
+    const auto& ops = precision == "fp16" ? fp16_ops : quant_ops;
+    if (std::find(ops.begin(), ops.end(), op_type) != ops.end()) {
+      op_precisions.push_back(precision);
+    }
+  }
+  return op_precisions;
+}
+
+std::map<std::string, std::string> GetCandidateWeights(
+    Predictor* predictor, const std::vector<std::string>& precisions) {
+  std::map<std::string, std::string> weights;
+  for (auto& inst : predictor->runtime_program().instructions()) {
+    auto* op_info = inst.op()->op_info();
+    const auto& op_type = op_info->Type();
+    if (WeightPrecisions(op_type, precisions).empty()) continue;
+    for (auto& name : op_info->input_names()) {
+      auto* var = predictor->scope()->FindLocalVar(name);
+      if (!var || !var->IsType<lite::Tensor>()) continue;
+      auto& tensor = var->Get<lite::Tensor>();
+      auto rank = tensor.dims().size();
+      if (!tensor.persistable() || tensor.precision() != PRECISION(kFloat) ||
+          (rank != 1 && rank != 2 && rank != 4)) {
+        continue;
+      }
+      weights.emplace(name, op_type);
+    }
+  }
+  return weights;
+}
+
+void LowerPrecision(const std::string& precision,
+                    const std::string& op_type,
+                    lite::Tensor* weight) {
+  if (precision == "int8") {
+    mir::FakeQuantizeWeight(op_type, 8, weight);
+  } else if (precision == "int16") {
+    mir::FakeQuantizeWeight(op_type, 16, weight);
+  } else if (precision == "fp16") {
+    float* data = weight->mutable_data<float>();
+    for (int64_t i = 0; i < weight->numel(); i++) {
+      data[i] = static_cast<float>(float16(data[i]));
+    }
+  } else {
+    LOG(FATAL) << "Unsupported precision " << precision;
+  }
+}
+
+MixedPrecisionSearch::MixedPrecisionSearch(
+    Predictor* predictor,
+    const std::map<std::string, std::string>& weights,
+    const std::vector<std::vector<int64_t>>& shapes,
+    const Samples& inputs)
+    : predictor_(predictor),
+      weights_(weights),
+      shapes_(shapes),
+      inputs_(inputs) {
+  ref_outputs_ = RunSamples(predictor_, shapes_, inputs_);
+}
+
+double MixedPrecisionSearch::Evaluate(
+    const std::map<std::string, std::string>& plan) {
+  std::vector<std::string> names;
+  for (auto& item : plan) names.push_back(item.first);
+  auto clone = predictor_->Clone(names);
+  clone->PrepareFeedFetch();
+  for (auto& item : plan) {
+    LowerPrecision(item.second,
+                   weights_.at(item.first),
+                   clone->GetMutableTensor(item.first));
+  }
+  return OutputError(ref_outputs_, RunSamples(clone.get(), shapes_, inputs_));
+}
+
+std::map<std::string, std::string> MixedPrecisionSearch::Run(
+    const std::vector<std::string>& precisions, double tolerance) {
+  // the least sensitive weights first, by the error of the model with only
+  // the weight at the preferred precision of its op
+  std::vector<std::pair<double, std::string>> order;
+  for (auto& weight : weights_) {
+    auto op_precisions = WeightPrecisions(weight.second, precisions);
+    if (op_precisions.empty()) continue;
+    double error = Evaluate({{weight.first, op_precisions.front()}});
+    VLOG(3) << weight.first << " (" << weight.second << ") "
+            << op_precisions.front() << ": " << error;
+    order.emplace_back(error, weight.first);
+  }
+  std::stable_sort(order.begin(), order.end());
+
+  std::map<std::string, std::string> plan;
+  for (auto& item : order) {
+    const auto& name = item.second;
+    const auto& op_type = weights_.at(name);
+    for (auto& precision : WeightPrecisions(op_type, precisions)) {
+      plan[name] = precision;
+      double error = Evaluate(plan);
+      if (error <= tolerance) {
+        LOG(INFO) << name << " (" << op_type << ") -> " << precision
+                  << ", error " << error;
+        break;
+      }
+      plan.erase(name);
+    }
+    if (!plan.count(name)) {
+      LOG(INFO) << name << " (" << op_type << ") stays fp32";
+    }
+  }
+  return plan;
+}
+
+}  // namespace lite
+}  // namespace paddle
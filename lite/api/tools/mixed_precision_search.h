@@ -0,0 +1,78 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+
+namespace paddle {
+namespace lite {
+
+// sample -> input/output -> data
+using Samples = std::vector<std::vector<std::vector<float>>>;
+
+// Runs the samples on the predictor, returns their outputs.
+Samples RunSamples(Predictor* predictor,
+                   const std::vector<std::vector<int64_t>>& shapes,
+                   const Samples& inputs);
+
+// The max relative l2 error of the outputs of all the samples.
+double OutputError(const Samples& ref, const Samples& out);
+
+// The precisions in the list which the weights of the op can be lowered to:
+// int8 and int16 by post_quant_dynamic_pass, fp16 by fp16_attribute_pass.
+std::vector<std::string> WeightPrecisions(
+    const std::string& op_type, const std::vector<std::string>& precisions);
+
+// The fp32 weights of the ops which can be lowered to one of the precisions,
+// with the types of the ops.
+std::map<std::string, std::string> GetCandidateWeights(
+    Predictor* predictor, const std::vector<std::string>& precisions);
+
+// Rounds the fp32 weight to the precision, as the kernels see it.
+void LowerPrecision(const std::string& precision,
+                    const std::string& op_type,
+                    lite::Tensor* weight);
+
+// Greedy search of the lowest precision of each weight keeping the error of
+// the outputs to the ones of the predictor within a tolerance. The predictor
+// runs in fp32, the precisions are emulated on the weights of its clones.
+class MixedPrecisionSearch {
+ public:
+  MixedPrecisionSearch(Predictor* predictor,
+                       const std::map<std::string, std::string>& weights,
+                       const std::vector<std::vector<int64_t>>& shapes,
+                       const Samples& inputs);
+
+  // The error of the model with the weights in the plan lowered, the shared
+  // weights of the predictor are kept, the clone has its own copies.
+  double Evaluate(const std::map<std::string, std::string>& plan);
+
+  // weight -> precision, the weights which stay fp32 are left out.
+  std::map<std::string, std::string> Run(
+      const std::vector<std::string>& precisions, double tolerance);
+
+ private:
+  Predictor* predictor_;
+  std::map<std::string, std::string> weights_;
+  std::vector<std::vector<int64_t>> shapes_;
+  Samples inputs_;
+  Samples ref_outputs_;
+};
+
+}  // namespace lite
+}  // namespace paddle
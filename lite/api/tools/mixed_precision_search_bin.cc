@@ -0,0 +1,224 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Searches the precision of the weights of each op of a model, the lowest one
+// which keeps the outputs on a calibration set within an accuracy tolerance
+// of the fp32 model, and saves the model with the precisions picked:
+//   ./mixed_precision_search_bin --model_dir=./mobilenet_v1 \
+//       --input_shape=1,3,224,224 --calib_data_path=./calib.bin \
+//       --accuracy_tolerance=0.01 --optimized_model_path=./mobilenet_v1_mixed
+// The calibration file holds the fp32 inputs of the samples one after the
+// other, random inputs are used without it.
+// The ops are moved to the precisions from the least sensitive to the most,
+// the sensitivity of an op is the error of the model with only its weights
+// quantized. Unlike the opt tool, the kernels run here, so it is built with
+// the full api. The search runs the fp32 kernels with the weights rounded to
+// the precisions, the fp16 activations of the arm fp16 kernels are not part
+// of the error.
+
+#include <gflags/gflags.h>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/api/tools/mixed_precision_search.h"
+#include "lite/core/optimizer/mir/fp16_attribute_pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/post_quant_dynamic_pass.h"
+#include "lite/utils/string.h"
+
+DEFINE_string(model_dir, "", "the dir of the model");
+DEFINE_string(model_file, "", "the model file of a combined model");
+DEFINE_string(param_file, "", "the param file of a combined model");
+DEFINE_string(backend, "x86", "the backend to run on: x86 | arm");
+DEFINE_bool(enable_fp16,
+            false,
+            "run the arm fp16 kernels, and search the fp16 weights");
+DEFINE_string(input_shape,
+              "1,3,224,224",
+              "the shapes of the inputs, separated by colon and comma");
+DEFINE_string(calib_data_path,
+              "",
+              "the raw fp32 inputs of the calibration samples");
+DEFINE_int32(calib_samples,
+             8,
+             "the number of random samples without calib_data_path");
+DEFINE_double(accuracy_tolerance,
+              0.01,
+              "the max relative l2 error of the outputs to the fp32 model");
+DEFINE_string(precisions,
+              "int8,fp16,int16",
+              "the precisions of the weights to try, the preferred first");
+DEFINE_string(optimized_model_path,
+              "",
+              "the path of the naive buffer model to save");
+DEFINE_string(plan_path,
+              "",
+              "the file to write the precision of each weight to");
+
+namespace paddle {
+namespace lite {
+
+// The places of the model, with the arm fp16 kernels if fp16.
+static std::vector<Place> GetValidPlaces(bool fp16) {
+  std::vector<Place> places;
+  if (FLAGS_backend == "arm") {
+    if (fp16) places.emplace_back(TARGET(kARM), PRECISION(kFP16));
+    places.emplace_back(TARGET(kARM), PRECISION(kFloat));
+    places.emplace_back(TARGET(kARM), PRECISION(kInt32));
+    places.emplace_back(TARGET(kARM), PRECISION(kInt64));
+  } else if (FLAGS_backend == "x86") {
+    places.emplace_back(TARGET(kX86), PRECISION(kFloat));
+    places.emplace_back(TARGET(kX86), PRECISION(kInt64));
+  } else {
+    LOG(FATAL) << "Unsupported backend " << FLAGS_backend;
+  }
+  places.emplace_back(TARGET(kHost), PRECISION(kFloat));
+  return places;
+}
+
+static std::vector<std::vector<int64_t>> GetInputShapes() {
+  std::vector<std::vector<int64_t>> shapes;
+  for (auto& shape : Split(FLAGS_input_shape, ":")) {
+    std::vector<int64_t> dims;
+    for (auto& dim : Split(shape, ",")) dims.push_back(std::stoll(dim));
+    shapes.push_back(dims);
+  }
+  return shapes;
+}
+
+static Samples LoadCalibData(const std::vector<std::vector<int64_t>>& shapes) {
+  std::vector<int64_t> numels;
+  int64_t sample_numel = 0;
+  for (auto& shape : shapes) {
+    int64_t numel = 1;
+    for (auto dim : shape) numel *= dim;
+    numels.push_back(numel);
+    sample_numel += numel;
+  }
+  std::vector<float> data;
+  if (!FLAGS_calib_data_path.empty()) {
+    std::ifstream file(FLAGS_calib_data_path, std::ios::binary);
+    CHECK(file.is_open()) << "Failed to open " << FLAGS_calib_data_path;
+    file.seekg(0, std::ios::end);
+    data.resize(file.tellg() / sizeof(float));
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(data.data()),
+              data.size() * sizeof(float));
+    CHECK(!data.empty() && data.size() % sample_numel == 0)
+        << "The size of " << FLAGS_calib_data_path
+        << " is not a multiple of the inputs of a sample";
+  } else {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    data.resize(FLAGS_calib_samples * sample_numel);
+    for (auto& x : data) x = dist(rng);
+  }
+  Samples samples(data.size() / sample_numel);
+  const float* ptr = data.data();
+  for (auto& sample : samples) {
+    for (auto numel : numels) {
+      sample.emplace_back(ptr, ptr + numel);
+      ptr += numel;
+    }
+  }
+  return samples;
+}
+
+void SearchMixedPrecision() {
+  CHECK(!FLAGS_optimized_model_path.empty())
+      << "Missing the optimized_model_path";
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_model_file(FLAGS_model_file);
+  config.set_param_file(FLAGS_param_file);
+
+  std::vector<std::string> precisions;
+  for (auto& precision : Split(FLAGS_precisions, ",")) {
+    if (precision == "fp16" && (!FLAGS_enable_fp16 || FLAGS_backend != "arm")) {
+      LOG(WARNING) << "Skip the fp16 weights without the arm fp16 kernels";
+      continue;
+    }
+    precisions.push_back(precision);
+  }
+  CHECK(!precisions.empty()) << "No precision to search";
+
+  // the reference runs in fp32, without the fp16 place fp16_attribute_pass
+  // converts no weight
+  auto fp32_places = GetValidPlaces(false);
+  config.set_valid_places(fp32_places);
+  Predictor predictor;
+  predictor.Build(config, fp32_places);
+  auto shapes = GetInputShapes();
+  auto inputs = LoadCalibData(shapes);
+  auto weights = GetCandidateWeights(&predictor, precisions);
+  LOG(INFO) << "Search the precisions of " << weights.size()
+            << " weights on " << inputs.size() << " samples";
+  MixedPrecisionSearch search(&predictor, weights, shapes, inputs);
+  auto plan = search.Run(precisions, FLAGS_accuracy_tolerance);
+
+  std::map<std::string, lite_api::QuantType> quant_types;
+  std::set<std::string> fp16_weights;
+  for (auto& item : plan) {
+    if (item.second == "int8") {
+      quant_types[item.first] = lite_api::QuantType::QUANT_INT8;
+    } else if (item.second == "int16") {
+      quant_types[item.first] = lite_api::QuantType::QUANT_INT16;
+    } else {
+      fp16_weights.insert(item.first);
+    }
+  }
+  if (!FLAGS_plan_path.empty()) {
+    std::ofstream file(FLAGS_plan_path);
+    for (auto& item : plan) file << item.first << " " << item.second << "\n";
+  }
+
+  // build the model again with the precision passes applied to the weights
+  // picked
+  std::vector<std::string> passes;
+  if (!quant_types.empty()) {
+    auto* pass = mir::PassManager::Global().LookUp<mir::PostQuantDynamicPass>(
+        "post_quant_dynamic_pass");
+    CHECK(pass);
+    pass->SetWeightQuantTypes(quant_types);
+    passes.push_back("post_quant_dynamic_pass");
+  }
+  auto* fp16_pass = mir::PassManager::Global().LookUp<mir::FP16AttributePass>(
+      "fp16_attribute_pass");
+  CHECK(fp16_pass);
+  fp16_pass->SetFP16Weights(fp16_weights);
+  auto places = GetValidPlaces(FLAGS_enable_fp16);
+  config.set_valid_places(places);
+  Predictor mixed_predictor;
+  mixed_predictor.Build(config, places, passes);
+  mixed_predictor.SaveModel(FLAGS_optimized_model_path,
+                            lite_api::LiteModelType::kNaiveBuffer);
+  LOG(INFO) << "Saved the model with " << quant_types.size()
+            << " quantized and " << fp16_weights.size()
+            << " fp16 weights of " << weights.size() << " to "
+            << FLAGS_optimized_model_path;
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  paddle::lite::SearchMixedPrecision();
+  return 0;
+}
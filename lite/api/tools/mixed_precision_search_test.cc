@@ -0,0 +1,119 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/tools/mixed_precision_search.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+
+namespace paddle {
+namespace lite {
+
+static void AddVar(cpp::BlockDesc* block_desc,
+                   const std::string& name,
+                   const std::vector<int64_t>& dims,
+                   bool persistable) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var_desc->SetDataType(VarDescAPI::Type::FP32);
+  var_desc->SetShape(dims);
+  var_desc->SetPersistable(persistable);
+}
+
+// feed -> mul(x of [4, 32], w of [32, 16]) -> fetch
+static std::unique_ptr<Predictor> BuildMulPredictor() {
+  auto scope = std::make_shared<Scope>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({32, 16});
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  auto* w_data = w->mutable_data<float>();
+  for (int64_t i = 0; i < w->numel(); i++) w_data[i] = dist(rng);
+  w->set_persistable(true);
+
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  AddVar(block_desc, "x", {4, 32}, false);
+  AddVar(block_desc, "w", {32, 16}, true);
+  AddVar(block_desc, "out", {4, 16}, false);
+  auto* feed = block_desc->AddOp<cpp::OpDesc>();
+  feed->SetType("feed");
+  feed->SetInput("X", {"feed"});
+  feed->SetOutput("Out", {"x"});
+  feed->SetAttr<int>("col", 0);
+  auto* mul = block_desc->AddOp<cpp::OpDesc>();
+  mul->SetType("mul");
+  mul->SetInput("X", {"x"});
+  mul->SetInput("Y", {"w"});
+  mul->SetOutput("Out", {"out"});
+  mul->SetAttr<int>("x_num_col_dims", 1);
+  mul->SetAttr<int>("y_num_col_dims", 1);
+  auto* fetch = block_desc->AddOp<cpp::OpDesc>();
+  fetch->SetType("fetch");
+  fetch->SetInput("X", {"out"});
+  fetch->SetOutput("Out", {"fetch"});
+  fetch->SetAttr<int>("col", 0);
+
+  std::unique_ptr<Predictor> predictor(new Predictor(scope));
+  predictor->Build(program_desc,
+                   {Place{TARGET(kX86), PRECISION(kFloat)},
+                    Place{TARGET(kHost), PRECISION(kFloat)}});
+  return predictor;
+}
+
+TEST(MixedPrecisionSearch, weight_precisions) {
+  const std::vector<std::string> precisions{"int8", "fp16", "int16"};
+  EXPECT_EQ(WeightPrecisions("mul", precisions), precisions);
+  // only fp16_attribute_pass converts the weights of prelu
+  EXPECT_EQ(WeightPrecisions("prelu", precisions),
+            std::vector<std::string>({"fp16"}));
+  EXPECT_TRUE(WeightPrecisions("lookup_table", {"fp16"}).empty());
+  EXPECT_TRUE(WeightPrecisions("softmax", precisions).empty());
+}
+
+TEST(MixedPrecisionSearch, search) {
+  auto predictor = BuildMulPredictor();
+  auto weights = GetCandidateWeights(predictor.get(), {"int8", "int16"});
+  ASSERT_EQ(weights, (std::map<std::string, std::string>{{"w", "mul"}}));
+
+  std::vector<std::vector<int64_t>> shapes{{4, 32}};
+  Samples inputs(2, std::vector<std::vector<float>>(1));
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& sample : inputs) {
+    for (int i = 0; i < 4 * 32; i++) sample[0].push_back(dist(rng));
+  }
+  MixedPrecisionSearch search(predictor.get(), weights, shapes, inputs);
+  EXPECT_EQ(search.Evaluate({}), 0.);
+  double int8_error = search.Evaluate({{"w", "int8"}});
+  double int16_error = search.Evaluate({{"w", "int16"}});
+  EXPECT_GT(int8_error, int16_error);
+
+  // the preferred precision within the tolerance, else the next one
+  EXPECT_EQ(search.Run({"int8", "int16"}, int8_error * 2),
+            (std::map<std::string, std::string>{{"w", "int8"}}));
+  EXPECT_EQ(search.Run({"int8", "int16"}, int16_error * 2),
+            (std::map<std::string, std::string>{{"w", "int16"}}));
+  EXPECT_TRUE(search.Run({"int8", "int16"}, 0.).empty());
+}
+
+}  // namespace lite
+}  // namespace paddle
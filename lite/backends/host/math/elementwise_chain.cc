@@ -0,0 +1,203 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/elementwise_chain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The elements of a tile, 8 avx registers.
+static const int64_t kTileSize = 64;
+
+static const std::map<std::string, ElementwiseChainOp::Type> kChainOpTypes = {
+    {"scale", ElementwiseChainOp::kScale},
+    {"relu", ElementwiseChainOp::kRelu},
+    {"relu6", ElementwiseChainOp::kRelu6},
+    {"leaky_relu", ElementwiseChainOp::kLeakyRelu},
+    {"sigmoid", ElementwiseChainOp::kSigmoid},
+    {"tanh", ElementwiseChainOp::kTanh},
+    {"swish", ElementwiseChainOp::kSwish},
+    {"clip", ElementwiseChainOp::kClip},
+    {"hard_sigmoid", ElementwiseChainOp::kHardSigmoid},
+    {"add", ElementwiseChainOp::kAdd},
+    {"sub", ElementwiseChainOp::kSub},
+    {"rsub", ElementwiseChainOp::kRSub},
+    {"mul", ElementwiseChainOp::kMul},
+    {"div", ElementwiseChainOp::kDiv},
+    {"rdiv", ElementwiseChainOp::kRDiv},
+    {"max", ElementwiseChainOp::kMax},
+    {"min", ElementwiseChainOp::kMin},
+};
+
+std::vector<ElementwiseChainOp> elementwise_chain_ops(
+    const operators::FusedElementwiseChainParam& param) {
+  std::vector<ElementwiseChainOp> ops(param.ops.size());
+  size_t input_idx = 0;
+  for (size_t i = 0; i < param.ops.size(); i++) {
+    auto& op = ops[i];
+    op.alpha = param.alphas[i];
+    op.beta = param.betas[i];
+    if (param.ops[i] == "gelu") {
+      op.type = op.alpha != 0.f ? ElementwiseChainOp::kGeluTanh
+                                : ElementwiseChainOp::kGelu;
+      continue;
+    }
+    auto it = kChainOpTypes.find(param.ops[i]);
+    CHECK(it != kChainOpTypes.end()) << "Unsupported op of the chain: "
+                                     << param.ops[i];
+    op.type = it->second;
+    if (op.type >= ElementwiseChainOp::kAdd) {
+      CHECK_LT(input_idx, param.inputs.size());
+      auto* input = param.inputs[input_idx++];
+      op.y = input->data<float>();
+      op.y_numel = input->numel();
+    }
+  }
+  return ops;
+}
+
+static void apply_unary(const ElementwiseChainOp& op, float* x, int64_t n) {
+  const float alpha = op.alpha;
+  const float beta = op.beta;
+  switch (op.type) {
+    case ElementwiseChainOp::kScale:
+      for (int64_t i = 0; i < n; i++) x[i] = x[i] * alpha + beta;
+      break;
+    case ElementwiseChainOp::kRelu:
+      for (int64_t i = 0; i < n; i++) x[i] = std::max(x[i], 0.f);
+      break;
+    case ElementwiseChainOp::kRelu6:
+      for (int64_t i = 0; i < n; i++) {
+        x[i] = std::min(std::max(x[i], 0.f), alpha);
+      }
+      break;
+    case ElementwiseChainOp::kLeakyRelu:
+      for (int64_t i = 0; i < n; i++) x[i] = x[i] > 0.f ? x[i] : x[i] * alpha;
+      break;
+    case ElementwiseChainOp::kSigmoid:
+      for (int64_t i = 0; i < n; i++) x[i] = 1.f / (1.f + std::exp(-x[i]));
+      break;
+    case ElementwiseChainOp::kTanh:
+      for (int64_t i = 0; i < n; i++) x[i] = std::tanh(x[i]);
+      break;
+    case ElementwiseChainOp::kSwish:
+      for (int64_t i = 0; i < n; i++) {
+        x[i] = x[i] / (1.f + std::exp(-alpha * x[i]));
+      }
+      break;
+    case ElementwiseChainOp::kGelu:
+      // 0.5 * x * (1 + erf(x / sqrt(2)))
+      for (int64_t i = 0; i < n; i++) {
+        x[i] = 0.5f * x[i] * (1.f + std::erf(x[i] * 0.70710678f));
+      }
+      break;
+    case ElementwiseChainOp::kGeluTanh:
+      // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+      for (int64_t i = 0; i < n; i++) {
+        const float v = x[i];
+        const float inner = 0.79788456f * (v + 0.044715f * v * v * v);
+        x[i] = 0.5f * v * (1.f + std::tanh(inner));
+      }
+      break;
+    case ElementwiseChainOp::kClip:
+      for (int64_t i = 0; i < n; i++) {
+        x[i] = std::min(std::max(x[i], alpha), beta);
+      }
+      break;
+    case ElementwiseChainOp::kHardSigmoid:
+      for (int64_t i = 0; i < n; i++) {
+        x[i] = std::min(std::max(x[i] * alpha + beta, 0.f), 1.f);
+      }
+      break;
+    default:
+      LOG(FATAL) << "Not an unary op of the chain: " << op.type;
+  }
+}
+
+static void apply_binary(const ElementwiseChainOp& op,
+                         float* x,
+                         const float* y,
+                         int64_t n) {
+  switch (op.type) {
+    case ElementwiseChainOp::kAdd:
+      for (int64_t i = 0; i < n; i++) x[i] += y[i];
+      break;
+    case ElementwiseChainOp::kSub:
+      for (int64_t i = 0; i < n; i++) x[i] -= y[i];
+      break;
+    case ElementwiseChainOp::kRSub:
+      for (int64_t i = 0; i < n; i++) x[i] = y[i] - x[i];
+      break;
+    case ElementwiseChainOp::kMul:
+      for (int64_t i = 0; i < n; i++) x[i] *= y[i];
+      break;
+    case ElementwiseChainOp::kDiv:
+      for (int64_t i = 0; i < n; i++) x[i] /= y[i];
+      break;
+    case ElementwiseChainOp::kRDiv:
+      for (int64_t i = 0; i < n; i++) x[i] = y[i] / x[i];
+      break;
+    case ElementwiseChainOp::kMax:
+      for (int64_t i = 0; i < n; i++) x[i] = std::max(x[i], y[i]);
+      break;
+    case ElementwiseChainOp::kMin:
+      for (int64_t i = 0; i < n; i++) x[i] = std::min(x[i], y[i]);
+      break;
+    default:
+      LOG(FATAL) << "Not a binary op of the chain: " << op.type;
+  }
+}
+
+void elementwise_chain(const float* x,
+                       float* out,
+                       int64_t numel,
+                       const std::vector<ElementwiseChainOp>& ops) {
+  float tile[kTileSize];
+  float y_tile[kTileSize];
+  for (int64_t begin = 0; begin < numel; begin += kTileSize) {
+    const int64_t n = std::min(kTileSize, numel - begin);
+    std::memcpy(tile, x + begin, n * sizeof(float));
+    for (auto& op : ops) {
+      if (op.type < ElementwiseChainOp::kAdd) {
+        apply_unary(op, tile, n);
+        continue;
+      }
+      const float* y = op.y + begin;
+      if (op.y_numel != numel) {
+        // broadcast on the last dims, the tile may wrap around y
+        int64_t k = begin % op.y_numel;
+        for (int64_t i = 0; i < n; i++) {
+          y_tile[i] = op.y[k];
+          if (++k == op.y_numel) k = 0;
+        }
+        y = y_tile;
+      }
+      apply_binary(op, tile, y, n);
+    }
+    std::memcpy(out + begin, tile, n * sizeof(float));
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
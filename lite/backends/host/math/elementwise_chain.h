@@ -0,0 +1,72 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// An op of the chain of a fused_elementwise_chain op.
+struct ElementwiseChainOp {
+  enum Type {
+    kScale,
+    kRelu,
+    kRelu6,
+    kLeakyRelu,
+    kSigmoid,
+    kTanh,
+    kSwish,
+    kGelu,
+    kGeluTanh,
+    kClip,
+    kHardSigmoid,
+    kAdd,
+    kSub,
+    kRSub,
+    kMul,
+    kDiv,
+    kRDiv,
+    kMax,
+    kMin,
+  };
+  Type type{kScale};
+  float alpha{0.f};
+  float beta{0.f};
+  // the input of the binary ops, repeated every y_numel elements
+  const float* y{nullptr};
+  int64_t y_numel{0};
+};
+
+// The ops of the param with the current data of its inputs.
+std::vector<ElementwiseChainOp> elementwise_chain_ops(
+    const operators::FusedElementwiseChainParam& param);
+
+// Runs the chain on x tile by tile, a tile goes through all the ops in the
+// registers and the L1 cache, so the chain reads and writes the memory once
+// whatever its length. out may be x.
+void elementwise_chain(const float* x,
+                       float* out,
+                       int64_t numel,
+                       const std::vector<ElementwiseChainOp>& ops);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
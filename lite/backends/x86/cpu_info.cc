@@ -25,6 +25,10 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #include <algorithm>
 #include "lite/utils/log/cp_logging.h"
 
@@ -103,6 +107,35 @@ size_t CpuMaxChunkSize() {
 
 #ifdef PADDLE_WITH_XBYAK
 static Xbyak::util::Cpu cpu;
+
+// CPUID.(EAX=07H, ECX=01H):EAX, Xbyak 5.99 does not expose it.
+static bool CpuidLeaf7Sub1Has(int eax_bit) {
+  unsigned int data[4] = {0};
+  Xbyak::util::Cpu::getCpuidEx(7, 0, data);
+  if (data[0] < 1) return false;
+  Xbyak::util::Cpu::getCpuidEx(7, 1, data);
+  return (data[0] >> eax_bit) & 1;
+}
+
+// CPUID.(EAX=07H, ECX=0H):EDX
+static bool CpuidLeaf7EdxHas(int edx_bit) {
+  unsigned int data[4] = {0};
+  Xbyak::util::Cpu::getCpuidEx(7, 0, data);
+  return (data[3] >> edx_bit) & 1;
+}
+
+// Linux (>= 5.16) keeps the AMX tile data state disabled until the process
+// asks for it, executing any tile instruction before that raises SIGILL.
+static bool RequestAmxTileData() {
+#if defined(__linux__) && defined(SYS_arch_prctl)
+  const int ARCH_REQ_XCOMP_PERM = 0x1023;
+  const int XFEATURE_XTILEDATA = 18;
+  return syscall(SYS_arch_prctl, ARCH_REQ_XCOMP_PERM, XFEATURE_XTILEDATA) == 0;
+#else
+  return false;
+#endif
+}
+
 bool MayIUse(const cpu_isa_t cpu_isa) {
   using namespace Xbyak::util;  // NOLINT
   switch (cpu_isa) {
@@ -127,6 +160,16 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
     case avx512_mic_4ops:
       return true && MayIUse(avx512_mic) && cpu.has(Cpu::tAVX512_4FMAPS) &&
              cpu.has(Cpu::tAVX512_4VNNIW);
+    case avx512_core_bf16:
+      return true && MayIUse(avx512_core) && CpuidLeaf7Sub1Has(5);
+    case avx512_core_amx: {
+      // AMX-TILE (bit 24) and AMX-INT8 (bit 25), plus the OS permission.
+      static const bool amx_usable = MayIUse(avx512_core_vnni) &&
+                                     CpuidLeaf7EdxHas(24) &&
+                                     CpuidLeaf7EdxHas(25) &&
+                                     RequestAmxTileData();
+      return amx_usable;
+    }
     case isa_any:
       return true;
   }
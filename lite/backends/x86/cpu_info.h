@@ -61,6 +61,8 @@ typedef enum {
   avx512_core_vnni,
   avx512_mic,
   avx512_mic_4ops,
+  avx512_core_bf16,
+  avx512_core_amx,
 } cpu_isa_t;  // Instruction set architecture
 
 // May I use some instruction
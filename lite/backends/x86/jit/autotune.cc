@@ -0,0 +1,120 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lite/backends/x86/jit/autotune.h"
+#include <fstream>
+#include <sstream>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/utils/env.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+
+bool AutoTuneEnabled() {
+  static const bool enabled = GetBoolFromEnv(LITE_JIT_AUTOTUNE);
+  return enabled;
+}
+
+AutoTuneTable& AutoTuneTable::Instance() {
+  static AutoTuneTable g_autotune_table;
+  return g_autotune_table;
+}
+
+AutoTuneTable::AutoTuneTable() {
+  auto path = GetStringFromEnv(LITE_JIT_AUTOTUNE_FILE);
+  if (!path.empty()) {
+    std::ifstream file(path);
+    // the file is created at the exit of the first tuning run
+    if (file.good() && !Load(path)) {
+      LOG(WARNING) << "Failed to load the jit autotune table " << path;
+    }
+  }
+}
+
+AutoTuneTable::~AutoTuneTable() {
+  auto path = GetStringFromEnv(LITE_JIT_AUTOTUNE_FILE);
+  if (dirty_ && !path.empty()) {
+    Save(path);
+  }
+}
+
+bool AutoTuneTable::Find(KernelType kt,
+                         int64_t key,
+                         std::string* impl) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = table_.find(std::make_pair(static_cast<int>(kt), key));
+  if (iter == table_.end()) {
+    return false;
+  }
+  *impl = iter->second;
+  return true;
+}
+
+std::string AutoTuneTable::Insert(KernelType kt,
+                                  int64_t key,
+                                  const std::string& impl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto res = table_.emplace(std::make_pair(static_cast<int>(kt), key), impl);
+  dirty_ = dirty_ || res.second;
+  return res.first->second;
+}
+
+bool AutoTuneTable::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::map<std::string, int> kernel_types;
+  for (int kt = kNone + 1; kt <= kVTanh; kt++) {
+    kernel_types[to_string(static_cast<KernelType>(kt))] = kt;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string kt, impl;
+    int64_t key;
+    if (!(ss >> kt >> key >> impl)) {
+      continue;
+    }
+    auto iter = kernel_types.find(kt);
+    if (iter == kernel_types.end()) {
+      LOG(WARNING) << "Unknown jit kernel " << kt << " in " << path;
+      continue;
+    }
+    // the entries loaded take the place of the ones tuned in this process
+    table_[std::make_pair(iter->second, key)] = impl;
+  }
+  return true;
+}
+
+bool AutoTuneTable::Save(const std::string& path) const {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    LOG(WARNING) << "Failed to save the jit autotune table to " << path;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : table_) {
+    file << to_string(static_cast<KernelType>(item.first.first)) << " "
+         << item.first.second << " " << item.second << "\n";
+  }
+  return file.good();
+}
+
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
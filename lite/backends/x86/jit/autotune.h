@@ -0,0 +1,224 @@
+/* Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/backends/x86/jit/kernel_base.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+
+// Whether LITE_JIT_AUTOTUNE is set, read once per process.
+bool AutoTuneEnabled();
+
+// The implementation picked for every (KernelType, JitCodeKey(attr)), saved
+// as the ImplType() of the kernel, e.g. "JitCode", "Intrinsic", "MKL",
+// "Mixed" or "Refer". One line per entry in the text format:
+//   kSeqPool 5147735862214399342 JitCode
+// The table in the file of LITE_JIT_AUTOTUNE_FILE is loaded on the first
+// use, and written back when the process exits if the autotuning is enabled.
+class AutoTuneTable {
+ public:
+  static AutoTuneTable& Instance();
+  ~AutoTuneTable();
+
+  bool Find(KernelType kt, int64_t key, std::string* impl) const;
+  // Returns the implementation kept in the table, which is the one inserted
+  // first when several threads tune the same attr at the same time.
+  std::string Insert(KernelType kt, int64_t key, const std::string& impl);
+
+  bool Load(const std::string& path);
+  bool Save(const std::string& path) const;
+
+ private:
+  AutoTuneTable();
+
+  mutable std::mutex mutex_;
+  std::map<std::pair<int, int64_t>, std::string> table_;
+  bool dirty_{false};
+};
+
+// Export and import the tuning table, so the choices made at the warm-up of
+// one run can be shipped with the model and reused without timing again.
+inline bool SaveAutoTuneTable(const std::string& path) {
+  return AutoTuneTable::Instance().Save(path);
+}
+inline bool LoadAutoTuneTable(const std::string& path) {
+  return AutoTuneTable::Instance().Load(path);
+}
+
+// Builds the inputs of one kernel from its attr and calls a candidate on
+// them. Only the tuples below are tuned, the others always use the default.
+template <typename T, typename Func>
+class AutoTuneRunner {
+ public:
+  static constexpr bool kSupported = false;
+  template <typename Attr>
+  explicit AutoTuneRunner(const Attr& attr) {}
+  void operator()(Func func) {}
+};
+
+template <typename T>
+inline void AutoTuneFill(std::vector<T>* data, size_t size) {
+  data->resize(size);
+  // small values keep exp, sigmoid and tanh away from inf and denormals
+  for (size_t i = 0; i < size; i++) {
+    (*data)[i] = static_cast<T>(static_cast<int>(i % 17) - 8) / 16;
+  }
+}
+
+// XYZN: x, y, z, n, and AXYN with a = x[0]
+template <typename T>
+class AutoTuneRunner<T, void (*)(const T*, const T*, T*, int)> {
+ public:
+  static constexpr bool kSupported = true;
+  explicit AutoTuneRunner(int n) : n_(n) {
+    AutoTuneFill(&x_, n);
+    AutoTuneFill(&y_, n);
+    z_.resize(n);
+  }
+  void operator()(void (*func)(const T*, const T*, T*, int)) {
+    func(x_.data(), y_.data(), z_.data(), n_);
+  }
+
+ private:
+  int n_;
+  std::vector<T> x_, y_, z_;
+};
+
+// XYN: x, y, n, and XRN with the result in y[0]
+template <typename T>
+class AutoTuneRunner<T, void (*)(const T*, T*, int)> {
+ public:
+  static constexpr bool kSupported = true;
+  explicit AutoTuneRunner(int n) : n_(n) {
+    AutoTuneFill(&x_, n);
+    y_.resize(n);
+  }
+  void operator()(void (*func)(const T*, T*, int)) {
+    func(x_.data(), y_.data(), n_);
+  }
+
+ private:
+  int n_;
+  std::vector<T> x_, y_;
+};
+
+// The rnn kernels work in place on the gates, they are tuned on scratch
+// buffers which stay bounded after the activations of every call.
+template <typename T>
+class AutoTuneRunner<T, void (*)(gru_t*, const gru_attr_t*)> {
+ public:
+  static constexpr bool kSupported = true;
+  explicit AutoTuneRunner(const gru_attr_t& attr) : attr_(attr) {
+    AutoTuneFill(&gates_, 3 * attr.d);
+    AutoTuneFill(&ht_1_, attr.d);
+    ht_.resize(attr.d);
+  }
+  void operator()(void (*func)(gru_t*, const gru_attr_t*)) {
+    gru_t step;
+    step.gates = gates_.data();
+    step.ht_1 = ht_1_.data();
+    step.ht = ht_.data();
+    func(&step, &attr_);
+  }
+
+ private:
+  gru_attr_t attr_;
+  std::vector<T> gates_, ht_1_, ht_;
+};
+
+template <typename T>
+class AutoTuneRunner<T, void (*)(lstm_t*, const lstm_attr_t*)> {
+ public:
+  static constexpr bool kSupported = true;
+  explicit AutoTuneRunner(const lstm_attr_t& attr) : attr_(attr) {
+    AutoTuneFill(&gates_, 4 * attr.d);
+    AutoTuneFill(&ct_1_, attr.d);
+    AutoTuneFill(&wp_, 3 * attr.d);
+    ct_.resize(attr.d);
+    ht_.resize(attr.d);
+    checked_.resize(2 * attr.d);
+  }
+  void operator()(void (*func)(lstm_t*, const lstm_attr_t*)) {
+    lstm_t step;
+    step.gates = gates_.data();
+    step.ct_1 = ct_1_.data();
+    step.ct = ct_.data();
+    step.ht = ht_.data();
+    step.wp = wp_.data();
+    step.checked = checked_.data();
+    func(&step, &attr_);
+  }
+
+ private:
+  lstm_attr_t attr_;
+  std::vector<T> gates_, ct_1_, wp_, ct_, ht_, checked_;
+};
+
+template <typename T>
+class AutoTuneRunner<T, void (*)(const T*, T*, const seq_pool_attr_t*)> {
+ public:
+  static constexpr bool kSupported = true;
+  explicit AutoTuneRunner(const seq_pool_attr_t& attr) : attr_(attr) {
+    AutoTuneFill(&x_, static_cast<size_t>(attr.h) * attr.w);
+    y_.resize(attr.w);
+  }
+  void operator()(void (*func)(const T*, T*, const seq_pool_attr_t*)) {
+    func(x_.data(), y_.data(), &attr_);
+  }
+
+ private:
+  seq_pool_attr_t attr_;
+  std::vector<T> x_, y_;
+};
+
+// Returns the index of the fastest function, timed as the best of a few
+// rounds after one warm-up call.
+template <typename Runner, typename Func>
+size_t AutoTuneBestIndex(Runner* runner, const std::vector<Func>& funcs) {
+  const int kRounds = 5;
+  const int kRepeats = 20;
+  size_t best = 0;
+  double best_time = 0;
+  for (size_t i = 0; i < funcs.size(); i++) {
+    (*runner)(funcs[i]);
+    double min_time = 0;
+    for (int r = 0; r < kRounds; r++) {
+      auto start = std::chrono::steady_clock::now();
+      for (int k = 0; k < kRepeats; k++) {
+        (*runner)(funcs[i]);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (r == 0 || elapsed.count() < min_time) min_time = elapsed.count();
+    }
+    if (i == 0 || min_time < best_time) {
+      best = i;
+      best_time = min_time;
+    }
+  }
+  return best;
+}
+
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
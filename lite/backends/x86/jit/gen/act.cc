@@ -42,7 +42,6 @@ const float ALIGN32_BEG exp_float_consts[] ALIGN32_END = {
     REPEAT_8TIMES(SIGMOID_THRESHOLD_MIN)};
 
 const int ALIGN32_BEG exp_int_0x7f[] ALIGN32_END = {REPEAT_8TIMES(0x7f)};
-int ALIGN32_BEG g_tmp_mem[16] ALIGN32_END = {0};
 
 void VActJitCode::genCode() {
   int offset = 0;
@@ -25,7 +25,6 @@ namespace gen {
 
 extern const float exp_float_consts[];
 extern const int exp_int_0x7f[];
-extern int g_tmp_mem[];
 
 #define EXP_HIG 88.3762626647949f
 #define EXP_LOW -88.3762626647949f
@@ -149,7 +148,10 @@ class VActFunc : public JitCode {
       xmm_t xtmp1 = xmm_t(ymm_int.getIdx());
       xmm_t xtmp2 = xmm_t(jmm_tmp.getIdx());
       reg64_t reg_ptr_tmp = reg_ptr_global;
-      mov(reg_ptr_tmp, reinterpret_cast<size_t>(g_tmp_mem));
+      // 32 bytes aligned scratch in the red zone below rsp, a global buffer
+      // would be shared by all threads running this code.
+      lea(reg_ptr_tmp, ptr[rsp - 96]);
+      and_(reg_ptr_tmp, -32);
       vmovdqa(ptr[reg_ptr_tmp], ymm_int);
       vmovdqa(ptr[reg_ptr_tmp + YMM_FLOAT_BLOCK * sizeof(float)], jmm_tmp);
       vpaddd(xtmp1, xtmp1, xtmp2);
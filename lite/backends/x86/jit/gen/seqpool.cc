@@ -32,15 +32,16 @@ void SeqPoolJitCode::genCode() {
   if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
     mov(reg_tmp, reinterpret_cast<size_t>(exp_float_consts));
     vmovups(xmm_t(1), ptr[reg_tmp + OFFSET_EXP_ONE]);
-    mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
+    // 1 / h is kept in the red zone below rsp rather than in this object,
+    // so that the same code can run on several threads at the same time.
     fild(dword[param_attr]);
-    fstp(dword[reg_tmp]);
-    vmovss(xmm_t(0), ptr[reg_tmp]);
+    fstp(dword[rsp - 8]);
+    vmovss(xmm_t(0), ptr[rsp - 8]);
     if (type_ == SeqPoolType::kSqrt) {
       vsqrtps(xmm_t(0), xmm_t(0));
     }
     vdivps(xmm_t(1), xmm_t(1), xmm_t(0));
-    vmovss(ptr[reg_tmp], xmm_t(1));
+    vmovss(ptr[rsp - 8], xmm_t(1));
   }
   const int group_len = max_num_regs * block * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
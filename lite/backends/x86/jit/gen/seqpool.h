@@ -34,7 +34,6 @@ class SeqPoolJitCode : public JitCode {
           type_ == SeqPoolType::kSqrt)) {
       LOG(FATAL) << "Only supported pool type: sum, avg and sqrt.";
     }
-    fp_h_[0] = 1.f;
     this->genCode();
   }
 
@@ -83,8 +82,7 @@ class SeqPoolJitCode : public JitCode {
     L(l_h_done);
     // save right now
     if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
-      mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
-      vbroadcastss(JMM(max_num_regs), ptr[reg_tmp]);
+      vbroadcastss(JMM(max_num_regs), ptr[rsp - 8]);
     }
     offset = w_offset;
     for (int i = 0; i < max_num_regs; ++i) {
@@ -138,8 +136,7 @@ class SeqPoolJitCode : public JitCode {
     L(l_h_done);
     // save right now
     if (type_ == SeqPoolType::kAvg || type_ == SeqPoolType::kSqrt) {
-      mov(reg_tmp, reinterpret_cast<size_t>(fp_h_));
-      vbroadcastss(xmm_t(max_num_regs), ptr[reg_tmp]);
+      vbroadcastss(xmm_t(max_num_regs), ptr[rsp - 8]);
       for (int i = 0; i < rest_used_num_regs; ++i) {
         vmulps(xmm_t(i), xmm_t(i), xmm_t(max_num_regs));
       }
@@ -195,7 +192,6 @@ class SeqPoolJitCode : public JitCode {
   }
 
  private:
-  float ALIGN32_BEG fp_h_[1] ALIGN32_END;
   int w_;
   SeqPoolType type_;
   reg64_t param_src{abi_param1};
@@ -19,6 +19,7 @@
 #include <string>
 #include <utility>  // for std::move
 #include <vector>
+#include "lite/backends/x86/jit/autotune.h"
 #include "lite/backends/x86/jit/gen_base.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernel_key.h"
@@ -38,8 +39,9 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
   using Attr = typename KernelTuple::attr_type;
   int64_t key = JitCodeKey<Attr>(attr);
   auto& codes = JitCodePool<KernelTuple::kernel_type>::Instance();
-  if (codes.Has(key)) {
-    return codes.AllKernels().at(key).get();
+  const Kernel* code = codes.Find(key);
+  if (code) {
+    return code;
   }
 
   // creator is not related with attr, so can use KernelKey as key
@@ -54,9 +56,7 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
       if (i && i->CanBeUsed(attr)) {
         auto p = i->CreateJitCode(attr);
         if (p) {
-          auto res = p.get();
-          codes.Insert(key, std::move(p));
-          return res;
+          return codes.Insert(key, std::move(p));
         }
       }
     }
@@ -174,6 +174,45 @@ typename KernelTuple::func_type GetDefaultBestFunc(
   return funcs[0];
 }
 
+// With LITE_JIT_AUTOTUNE set, time all the candidates on this attr and
+// return the fastest one, the choice is kept in the AutoTuneTable. A choice
+// imported from a table is used even if the autotuning is disabled.
+template <typename KernelTuple, typename PlaceType = lite::fluid::CPUPlace>
+typename KernelTuple::func_type GetAutoTunedBestFunc(
+    const typename KernelTuple::attr_type& attr) {
+  using T = typename KernelTuple::data_type;
+  using Func = typename KernelTuple::func_type;
+  auto funcs = GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
+  CHECK_GE(funcs.size(), 1UL);
+  if (funcs.size() == 1UL) {
+    return funcs[0].second;
+  }
+  auto& table = AutoTuneTable::Instance();
+  int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
+  std::string impl;
+  if (!table.Find(KernelTuple::kernel_type, key, &impl)) {
+    if (!AutoTuneEnabled() || !AutoTuneRunner<T, Func>::kSupported) {
+      return funcs[0].second;
+    }
+    std::vector<Func> candidates;
+    for (auto& f : funcs) {
+      candidates.emplace_back(f.second);
+    }
+    AutoTuneRunner<T, Func> runner(attr);
+    size_t best = AutoTuneBestIndex(&runner, candidates);
+    impl = table.Insert(KernelTuple::kernel_type, key, funcs[best].first);
+    VLOG(3) << "jit autotune " << to_string(KernelTuple::kernel_type) << " "
+            << attr << ": " << impl;
+  }
+  for (auto& f : funcs) {
+    if (f.first == impl) {
+      return f.second;
+    }
+  }
+  // the implementation in the table is not built in this library
+  return funcs[0].second;
+}
+
 template <typename KernelTuple, typename PlaceType>
 class KernelFuncs {
  public:
@@ -191,8 +230,8 @@ class KernelFuncs {
     if (Has(key)) {
       return funcs_.at(key);
     }
-    // If do not have this attr in cache then get the default best
-    auto func = GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
+    // If do not have this attr in cache then get the tuned or default best
+    auto func = GetAutoTunedBestFunc<KernelTuple, PlaceType>(attr);
     Insert(key, func);
     return func;
   }
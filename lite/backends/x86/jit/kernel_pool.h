@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>  // for unique_ptr
+#include <mutex>   // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>  // for move
@@ -28,6 +29,10 @@ namespace paddle {
 namespace lite {
 namespace jit {
 
+// The generated code only depends on the attr, so one pool is shared by all
+// threads and every code is generated once per process. The lookups on the
+// hot path are served by the thread local KernelFuncs::Cache() in front of
+// this pool, so the lock is only taken the first time a thread sees an attr.
 template <KernelType KT>
 class JitCodePool {
   typedef std::unique_ptr<GenBase> GenBasePtr;
@@ -36,19 +41,27 @@ class JitCodePool {
  public:
   JitCodePool() = default;
   static JitCodePool& Instance() {
-    static LITE_THREAD_LOCAL JitCodePool<KT> g_jit_codes;
+    static JitCodePool<KT> g_jit_codes;
     return g_jit_codes;
   }
 
-  const JitCodeMap& AllKernels() { return codes_; }
+  bool Has(int64_t key) const { return Find(key) != nullptr; }
 
-  bool Has(int64_t key) const { return codes_.find(key) != codes_.end(); }
+  const GenBase* Find(int64_t key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = codes_.find(key);
+    return iter == codes_.end() ? nullptr : iter->second.get();
+  }
 
-  void Insert(int64_t key, GenBasePtr value) {
-    codes_.emplace(key, std::move(value));
+  // Returns the code kept in the pool, which is the one inserted first when
+  // several threads generate the code of the same key at the same time.
+  const GenBase* Insert(int64_t key, GenBasePtr value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return codes_.emplace(key, std::move(value)).first->second.get();
   }
 
  private:
+  mutable std::mutex mutex_;
   JitCodeMap codes_;
 };
 
@@ -0,0 +1,276 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/attention.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// x[i] = exp(x[i] - max), returns the sum of x
+static inline float exp_sub_max_sum(float* x, int n, float max) {
+  int i = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  __m256 vec_max = _mm256_set1_ps(max);
+  __m256 vec_sum = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m256 vec_x = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vec_max));
+    _mm256_storeu_ps(x + i, vec_x);
+    vec_sum = _mm256_add_ps(vec_sum, vec_x);
+  }
+  float tmp[8];
+  _mm256_storeu_ps(tmp, vec_sum);
+  for (int j = 0; j < 8; j++) sum += tmp[j];
+#endif
+  for (; i < n; i++) {
+    x[i] = std::exp(x[i] - max);
+    sum += x[i];
+  }
+  return sum;
+}
+
+// s[i][j] = alpha * sum_dd q[i][dd] * kt[dd][j], for i < rows, j < bk
+static void tile_scores(const float* q,
+                        const float* kt,
+                        int rows,
+                        int bk,
+                        int d,
+                        float alpha,
+                        float* s) {
+  int i = 0;
+  int j_vec = 0;
+#ifdef __AVX2__
+  // 4 rows x 16 columns in 8 accumulators
+  j_vec = bk / 16 * 16;
+  for (; i + 4 <= rows; i += 4) {
+    const float* q0 = q + static_cast<int64_t>(i) * d;
+    for (int j = 0; j < j_vec; j += 16) {
+      __m256 vec_s[4][2];
+      for (int r = 0; r < 4; r++) {
+        vec_s[r][0] = _mm256_setzero_ps();
+        vec_s[r][1] = _mm256_setzero_ps();
+      }
+      for (int dd = 0; dd < d; dd++) {
+        __m256 vec_k0 = _mm256_loadu_ps(kt + dd * ATTN_BLOCK_K + j);
+        __m256 vec_k1 = _mm256_loadu_ps(kt + dd * ATTN_BLOCK_K + j + 8);
+        for (int r = 0; r < 4; r++) {
+          __m256 vec_q = _mm256_set1_ps(q0[r * d + dd]);
+          vec_s[r][0] = _mm256_fmadd_ps(vec_q, vec_k0, vec_s[r][0]);
+          vec_s[r][1] = _mm256_fmadd_ps(vec_q, vec_k1, vec_s[r][1]);
+        }
+      }
+      __m256 vec_alpha = _mm256_set1_ps(alpha);
+      for (int r = 0; r < 4; r++) {
+        float* s_row = s + (i + r) * ATTN_BLOCK_K + j;
+        _mm256_storeu_ps(s_row, _mm256_mul_ps(vec_s[r][0], vec_alpha));
+        _mm256_storeu_ps(s_row + 8, _mm256_mul_ps(vec_s[r][1], vec_alpha));
+      }
+    }
+  }
+#endif
+  for (int r = 0; r < rows; r++) {
+    // rows below i only miss the columns the vector loop skipped
+    const int j0 = r < i ? j_vec : 0;
+    if (j0 == bk) continue;
+    float* s_row = s + r * ATTN_BLOCK_K;
+    const float* q_row = q + static_cast<int64_t>(r) * d;
+    std::fill(s_row + j0, s_row + bk, 0.f);
+    for (int dd = 0; dd < d; dd++) {
+      const float qv = q_row[dd] * alpha;
+      const float* kt_row = kt + dd * ATTN_BLOCK_K;
+      for (int j = j0; j < bk; j++) {
+        s_row[j] += qv * kt_row[j];
+      }
+    }
+  }
+}
+
+// acc[i][c] += sum_j p[i][j] * v[j][c], for i < rows, c < dv
+static void tile_pv(const float* p,
+                    const float* v,
+                    int rows,
+                    int bk,
+                    int dv,
+                    float* acc) {
+  int i = 0;
+  int c_vec = 0;
+#ifdef __AVX2__
+  // 4 rows x 16 columns in 8 accumulators
+  c_vec = dv / 16 * 16;
+  for (; i + 4 <= rows; i += 4) {
+    for (int c = 0; c < c_vec; c += 16) {
+      __m256 vec_acc[4][2];
+      for (int r = 0; r < 4; r++) {
+        vec_acc[r][0] = _mm256_loadu_ps(acc + (i + r) * dv + c);
+        vec_acc[r][1] = _mm256_loadu_ps(acc + (i + r) * dv + c + 8);
+      }
+      for (int j = 0; j < bk; j++) {
+        const float* v_row = v + static_cast<int64_t>(j) * dv + c;
+        __m256 vec_v0 = _mm256_loadu_ps(v_row);
+        __m256 vec_v1 = _mm256_loadu_ps(v_row + 8);
+        for (int r = 0; r < 4; r++) {
+          __m256 vec_p = _mm256_set1_ps(p[(i + r) * ATTN_BLOCK_K + j]);
+          vec_acc[r][0] = _mm256_fmadd_ps(vec_p, vec_v0, vec_acc[r][0]);
+          vec_acc[r][1] = _mm256_fmadd_ps(vec_p, vec_v1, vec_acc[r][1]);
+        }
+      }
+      for (int r = 0; r < 4; r++) {
+        _mm256_storeu_ps(acc + (i + r) * dv + c, vec_acc[r][0]);
+        _mm256_storeu_ps(acc + (i + r) * dv + c + 8, vec_acc[r][1]);
+      }
+    }
+  }
+#endif
+  for (int r = 0; r < rows; r++) {
+    const int c0 = r < i ? c_vec : 0;
+    if (c0 == dv) continue;
+    float* acc_row = acc + r * dv;
+    for (int j = 0; j < bk; j++) {
+      const float pv = p[r * ATTN_BLOCK_K + j];
+      const float* v_row = v + static_cast<int64_t>(j) * dv;
+      for (int c = c0; c < dv; c++) {
+        acc_row[c] += pv * v_row[c];
+      }
+    }
+  }
+}
+
+// One tile of at most ATTN_BLOCK_Q query rows against all keys.
+// buf holds kt: [d][ATTN_BLOCK_K], s: [ATTN_BLOCK_Q][ATTN_BLOCK_K],
+// acc: [ATTN_BLOCK_Q][dv], row_max and row_sum: [ATTN_BLOCK_Q].
+static void attention_tile(const float* q,
+                           const float* k,
+                           const float* v,
+                           const float* mask,
+                           int64_t mask_row_stride,
+                           int rows,
+                           int sk,
+                           int d,
+                           int dv,
+                           float alpha,
+                           float* out,
+                           float* buf) {
+  const float neg_inf = -std::numeric_limits<float>::infinity();
+  float* kt = buf;
+  float* s = kt + d * ATTN_BLOCK_K;
+  float* acc = s + ATTN_BLOCK_Q * ATTN_BLOCK_K;
+  float* row_max = acc + ATTN_BLOCK_Q * dv;
+  float* row_sum = row_max + ATTN_BLOCK_Q;
+  std::fill(acc, acc + rows * dv, 0.f);
+  std::fill(row_max, row_max + rows, neg_inf);
+  std::fill(row_sum, row_sum + rows, 0.f);
+
+  for (int k0 = 0; k0 < sk; k0 += ATTN_BLOCK_K) {
+    const int bk = std::min(ATTN_BLOCK_K, sk - k0);
+    // keys of this tile as [d][bk], so the scores below are contiguous
+    for (int j = 0; j < bk; j++) {
+      const float* k_row = k + static_cast<int64_t>(k0 + j) * d;
+      for (int dd = 0; dd < d; dd++) {
+        kt[dd * ATTN_BLOCK_K + j] = k_row[dd];
+      }
+    }
+    tile_scores(q, kt, rows, bk, d, alpha, s);
+    for (int i = 0; i < rows; i++) {
+      float* s_row = s + i * ATTN_BLOCK_K;
+      if (mask) {
+        const float* mask_row = mask + i * mask_row_stride + k0;
+        for (int j = 0; j < bk; j++) {
+          s_row[j] += mask_row[j];
+        }
+      }
+
+      // online softmax: rescale what was accumulated with the old max
+      float new_max = row_max[i];
+      for (int j = 0; j < bk; j++) {
+        new_max = std::max(new_max, s_row[j]);
+      }
+      // every key seen so far is masked out by -inf, p is all zero
+      if (new_max == neg_inf) {
+        std::fill(s_row, s_row + bk, 0.f);
+        continue;
+      }
+      const float correction = std::exp(row_max[i] - new_max);
+      row_sum[i] =
+          row_sum[i] * correction + exp_sub_max_sum(s_row, bk, new_max);
+      row_max[i] = new_max;
+      float* acc_row = acc + i * dv;
+      for (int c = 0; c < dv; c++) {
+        acc_row[c] *= correction;
+      }
+    }
+    tile_pv(s, v + static_cast<int64_t>(k0) * dv, rows, bk, dv, acc);
+  }
+
+  for (int i = 0; i < rows; i++) {
+    const float scale = row_sum[i] > 0.f ? 1.f / row_sum[i] : 0.f;
+    const float* acc_row = acc + i * dv;
+    float* out_row = out + static_cast<int64_t>(i) * dv;
+    for (int c = 0; c < dv; c++) {
+      out_row[c] = acc_row[c] * scale;
+    }
+  }
+}
+
+void scaled_dot_product_attention(const float* q,
+                                  const float* k,
+                                  const float* v,
+                                  const float* mask,
+                                  const int64_t* mask_offset,
+                                  int64_t mask_row_stride,
+                                  int batch,
+                                  int sq,
+                                  int sk,
+                                  int d,
+                                  int dv,
+                                  float alpha,
+                                  float* out) {
+  const int q_tiles = (sq + ATTN_BLOCK_Q - 1) / ATTN_BLOCK_Q;
+  const int buf_size = d * ATTN_BLOCK_K + ATTN_BLOCK_Q * ATTN_BLOCK_K +
+                       ATTN_BLOCK_Q * dv + 2 * ATTN_BLOCK_Q;
+#pragma omp parallel for
+  for (int t = 0; t < batch * q_tiles; t++) {
+    const int b = t / q_tiles;
+    const int i0 = (t % q_tiles) * ATTN_BLOCK_Q;
+    const int rows = std::min(ATTN_BLOCK_Q, sq - i0);
+    std::vector<float> buf(buf_size);
+    attention_tile(q + (static_cast<int64_t>(b) * sq + i0) * d,
+                   k + static_cast<int64_t>(b) * sk * d,
+                   v + static_cast<int64_t>(b) * sk * dv,
+                   mask ? mask + mask_offset[b] + i0 * mask_row_stride
+                        : nullptr,
+                   mask_row_stride,
+                   rows,
+                   sk,
+                   d,
+                   dv,
+                   alpha,
+                   out + (static_cast<int64_t>(b) * sq + i0) * dv,
+                   buf.data());
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
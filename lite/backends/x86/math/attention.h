@@ -0,0 +1,53 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Tile sizes of the query rows and key columns, the scores are only kept
+// for one ATTN_BLOCK_Q x ATTN_BLOCK_K tile at a time.
+#define ATTN_BLOCK_Q 32
+#define ATTN_BLOCK_K 64
+
+// out[b] = softmax(alpha * q[b] * k[b]^T + mask[b]) * v[b] for every
+// b in [0, batch), with q: [sq, d], k: [sk, d], v: [sk, dv], out: [sq, dv].
+// The softmax is computed online over the key tiles, so the [sq, sk]
+// scores are never materialized. mask is optional, row i of batch b
+// starts at mask + mask_offset[b] + i * mask_row_stride and holds sk
+// values, mask_row_stride is 0 when one mask row is shared by all queries.
+// Runs in parallel over batch x query tiles.
+void scaled_dot_product_attention(const float* q,
+                                  const float* k,
+                                  const float* v,
+                                  const float* mask,
+                                  const int64_t* mask_offset,
+                                  int64_t mask_row_stride,
+                                  int batch,
+                                  int sq,
+                                  int sk,
+                                  int d,
+                                  int dv,
+                                  float alpha,
+                                  float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/im2col.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/context.h"
 #include "lite/core/tensor.h"
 
@@ -103,48 +104,49 @@ class ContextProjectFunctor {
     std::vector<int> padding({up_pad, 0, down_pad, 0});
     std::vector<int> stride({context_stride, 1});
 
-    int input_row_begin, input_row_end;
     int sequence_height, sequence_width;
     sequence_width = in.dims()[1];
 
-    for (int i = 0; i < static_cast<int>(lod_level_0.size()) - 1; ++i) {
-      if (lod_level_0[i] == lod_level_0[i + 1]) continue;
-
-      input_row_begin = (context_start > 0)
-                            ? static_cast<int>(lod_level_0[i]) + context_start
-                            : static_cast<int>(lod_level_0[i]);
-      input_row_end = static_cast<int>(lod_level_0[i + 1]);
-
-      // lite::Tensor out_t =
-      // col->Slice<float>(static_cast<int>(lod_level_0[i]),
-      //                          static_cast<int>(lod_level_0[i + 1]));
-      lite::Tensor out_t =
-          col->Slice<float>(static_cast<int64_t>(lod_level_0[i]),
-                            static_cast<int>(lod_level_0[i + 1]));
-
-      sequence_height = static_cast<int>(out_t.dims()[0]);
-
-      if (input_row_begin < input_row_end) {
-        lite::Tensor in_t = in.Slice<float>(input_row_begin, input_row_end);
-
-        std::vector<int64_t> output_shape(
-            {sequence_height,
-             1,
-             1,
-             context_length,
-             sequence_width});  // output_height, output_width,
-        // input_channels, filter_height, filter_width
-        out_t.Resize(output_shape);
-
-        std::vector<int64_t> input_shape(
-            {1,
-             input_row_end - input_row_begin,
-             sequence_width});  // input_channels, input_height, input_width
-        in_t.Resize(input_shape);
-        im2col_ocf(context, in_t, dilation, stride, padding, &out_t);
-        out_t.Resize({sequence_height, context_length * sequence_width});
+    // the sequences write disjoint rows of col, so they are unrolled in
+    // parallel, split by their lengths
+    RunParallelForLoD(lod_level_0, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        if (lod_level_0[i] == lod_level_0[i + 1]) continue;
+
+        int input_row_begin =
+            (context_start > 0)
+                ? static_cast<int>(lod_level_0[i]) + context_start
+                : static_cast<int>(lod_level_0[i]);
+        int input_row_end = static_cast<int>(lod_level_0[i + 1]);
+
+        lite::Tensor out_t =
+            col->Slice<float>(static_cast<int64_t>(lod_level_0[i]),
+                              static_cast<int>(lod_level_0[i + 1]));
+
+        int height = static_cast<int>(out_t.dims()[0]);
+
+        if (input_row_begin < input_row_end) {
+          lite::Tensor in_t = in.Slice<float>(input_row_begin, input_row_end);
+
+          std::vector<int64_t> output_shape(
+              {height,
+               1,
+               1,
+               context_length,
+               sequence_width});  // output_height, output_width,
+          // input_channels, filter_height, filter_width
+          out_t.Resize(output_shape);
+
+          std::vector<int64_t> input_shape(
+              {1,
+               input_row_end - input_row_begin,
+               sequence_width});  // input_channels, input_height, input_width
+          in_t.Resize(input_shape);
+          im2col_ocf(context, in_t, dilation, stride, padding, &out_t);
+          out_t.Resize({height, context_length * sequence_width});
+        }
       }
-    }
+    });
     if (padding_trainable) {
       CHECK(padding_data != nullptr);
       for (int i = 0; i < static_cast<int>(lod_level_0.size()) - 1; ++i) {
@@ -13,141 +13,172 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include "lite/backends/x86/math/elementwise_common_broadcast_config.h"
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
 
-#define ElementWiseFunc(op)                                                    \
-  template <typename T>                                                        \
-  void Elementwise_##op(const T* dinx,                                         \
-                        const T* diny,                                         \
-                        T* dout,                                               \
-                        int num,                                               \
-                        bool has_active,                                       \
-                        std::string act_type) {                                \
-    if (act_type == "tanh") {                                                  \
-      lite::x86::math::elementwise_range_to_range<                             \
-          MergeConfig<op##Config<T>, ActiveConfig<ActiveType::TANH, T>>>(      \
-          dinx, diny, dout, num);                                              \
-    } else if (act_type == "relu") {                                           \
-      lite::x86::math::elementwise_range_to_range<                             \
-          MergeConfig<op##Config<T>, ActiveConfig<ActiveType::RELU, T>>>(      \
-          dinx, diny, dout, num);                                              \
-    } else if (act_type == "sigmoid") {                                        \
-      lite::x86::math::elementwise_range_to_range<                             \
-          MergeConfig<op##Config<T>, ActiveConfig<ActiveType::SIGMOID, T>>>(   \
-          dinx, diny, dout, num);                                              \
-    } else {                                                                   \
-      lite::x86::math::elementwise_range_to_range<                             \
-          MergeConfig<op##Config<T>, ActiveConfig<ActiveType::NO_ACTIVE, T>>>( \
-          dinx, diny, dout, num);                                              \
-    }                                                                          \
+// Elementwise ops are memory bound, below this many outputs waking the
+// threads up costs more than it saves.
+#define ELEMENTWISE_PARALLEL_MIN_SIZE 32768
+// the contiguous cases are split into blocks of this many elements
+#define ELEMENTWISE_BLOCK_SIZE 4096
+
+// Runs f(begin, end) over [0, rows) rows of row_size elements, in parallel
+// only when there is enough work.
+template <typename Func>
+void elementwise_parallel_for(int64_t rows, int64_t row_size, const Func& f) {
+  if (rows > 1 && rows * row_size >= ELEMENTWISE_PARALLEL_MIN_SIZE) {
+    RunParallelFor(0, rows, f);
+  } else {
+    f(0, rows);
+  }
+}
+
+// Runs f(offset, len) over the blocks of [0, num).
+template <typename Func>
+void elementwise_for_blocks(int64_t num, const Func& f) {
+  const int64_t blocks = (num + ELEMENTWISE_BLOCK_SIZE - 1) /
+                         ELEMENTWISE_BLOCK_SIZE;
+  elementwise_parallel_for(
+      blocks, ELEMENTWISE_BLOCK_SIZE, [&](int64_t begin, int64_t end) {
+        const int64_t offset = begin * ELEMENTWISE_BLOCK_SIZE;
+        const int64_t len =
+            (std::min)(end * ELEMENTWISE_BLOCK_SIZE, num) - offset;
+        if (len > 0) {
+          f(offset, static_cast<int>(len));
+        }
+      });
+}
+
+// z = x op y, x and y of the same shape.
+template <class Config>
+void elementwise_same_dim(const typename Config::T* dinx,
+                          const typename Config::T* diny,
+                          typename Config::T* dout,
+                          int num) {
+  elementwise_for_blocks(num, [&](int64_t offset, int len) {
+    elementwise_range_to_range<Config>(
+        dinx + offset, diny + offset, dout + offset, len);
+  });
+}
+
+// z[i][j][k] = x[i][j][k] op y[j] for i < batch, j < channels, k < num, or
+// x[j] op y[i][j][k] when inv. With num == 1 the small operand is a whole
+// row, with channels == 1 too it is a scalar; both are run over contiguous
+// ranges rather than one element at a time.
+template <class Config>
+void elementwise_broadcast(const typename Config::T* dinx,
+                           const typename Config::T* diny,
+                           typename Config::T* dout,
+                           int batch,
+                           int channels,
+                           int num,
+                           bool inv) {
+  if (channels == 1 && num == 1) {
+    elementwise_for_blocks(batch, [&](int64_t offset, int len) {
+      if (inv) {
+        elementwise_one_to_range<Config>(
+            dinx, diny + offset, dout + offset, len);
+      } else {
+        elementwise_range_to_one<Config>(
+            dinx + offset, diny, dout + offset, len);
+      }
+    });
+  } else if (num == 1) {
+    elementwise_parallel_for(batch, channels, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const int64_t offset = i * channels;
+        if (inv) {
+          elementwise_range_to_range<Config>(
+              dinx, diny + offset, dout + offset, channels);
+        } else {
+          elementwise_range_to_range<Config>(
+              dinx + offset, diny, dout + offset, channels);
+        }
+      }
+    });
+  } else {
+    elementwise_parallel_for(
+        static_cast<int64_t>(batch) * channels,
+        num,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const int64_t j = i % channels;
+            const int64_t offset = i * num;
+            if (inv) {
+              elementwise_one_to_range<Config>(
+                  dinx + j, diny + offset, dout + offset, num);
+            } else {
+              elementwise_range_to_one<Config>(
+                  dinx + offset, diny + j, dout + offset, num);
+            }
+          }
+        });
+  }
+}
+
+#define ElementWiseActConfig(op, act) \
+  MergeConfig<op##Config<T>, ActiveConfig<ActiveType::act, T>>
+
+#define ElementWiseFunc(op)                                                  \
+  template <typename T>                                                      \
+  void Elementwise_##op(const T* dinx,                                       \
+                        const T* diny,                                       \
+                        T* dout,                                             \
+                        int num,                                             \
+                        bool has_active,                                     \
+                        std::string act_type) {                              \
+    if (act_type == "tanh") {                                                \
+      elementwise_same_dim<ElementWiseActConfig(op, TANH)>(                  \
+          dinx, diny, dout, num);                                            \
+    } else if (act_type == "relu") {                                         \
+      elementwise_same_dim<ElementWiseActConfig(op, RELU)>(                  \
+          dinx, diny, dout, num);                                            \
+    } else if (act_type == "sigmoid") {                                      \
+      elementwise_same_dim<ElementWiseActConfig(op, SIGMOID)>(               \
+          dinx, diny, dout, num);                                            \
+    } else if (act_type == "abs") {                                          \
+      elementwise_same_dim<ElementWiseActConfig(op, ABS)>(                   \
+          dinx, diny, dout, num);                                            \
+    } else {                                                                 \
+      elementwise_same_dim<ElementWiseActConfig(op, NO_ACTIVE)>(             \
+          dinx, diny, dout, num);                                            \
+    }                                                                        \
   }
 
-#define ElementWiseFuncBCast(op)                                      \
-  template <typename T>                                               \
-  void Elementwise_Broadcast_##op(const T* dinx,                      \
-                                  const T* diny,                      \
-                                  T* dout,                            \
-                                  int batch,                          \
-                                  int channels,                       \
-                                  int num,                            \
-                                  bool has_active,                    \
-                                  std::string act_type,               \
-                                  bool inv) {                         \
-    if (act_type == "tanh") {                                         \
-      for (int i = 0; i < batch; ++i) {                               \
-        for (int j = 0; j < channels; ++j) {                          \
-          int offset = (i * channels + j) * num;                      \
-          auto* dout_ptr = dout + offset;                             \
-          if (inv) {                                                  \
-            const auto* dinx_ptr = dinx + j;                          \
-            const auto* diny_ptr = diny + offset;                     \
-            lite::x86::math::elementwise_one_to_range<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::TANH, T>>>(      \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          } else {                                                    \
-            const auto* dinx_ptr = dinx + offset;                     \
-            const auto* diny_ptr = diny + j;                          \
-            lite::x86::math::elementwise_range_to_one<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::TANH, T>>>(      \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          }                                                           \
-        }                                                             \
-      }                                                               \
-    } else if (act_type == "relu") {                                  \
-      for (int i = 0; i < batch; ++i) {                               \
-        for (int j = 0; j < channels; ++j) {                          \
-          int offset = (i * channels + j) * num;                      \
-          auto* dout_ptr = dout + offset;                             \
-          if (inv) {                                                  \
-            const auto* dinx_ptr = dinx + j;                          \
-            const auto* diny_ptr = diny + offset;                     \
-            lite::x86::math::elementwise_one_to_range<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::RELU, T>>>(      \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          } else {                                                    \
-            const auto* dinx_ptr = dinx + offset;                     \
-            const auto* diny_ptr = diny + j;                          \
-            lite::x86::math::elementwise_range_to_one<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::RELU, T>>>(      \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          }                                                           \
-        }                                                             \
-      }                                                               \
-    } else if (act_type == "sigmoid") {                               \
-      for (int i = 0; i < batch; ++i) {                               \
-        for (int j = 0; j < channels; ++j) {                          \
-          int offset = (i * channels + j) * num;                      \
-          auto* dout_ptr = dout + offset;                             \
-          if (inv) {                                                  \
-            const auto* dinx_ptr = dinx + j;                          \
-            const auto* diny_ptr = diny + offset;                     \
-            lite::x86::math::elementwise_one_to_range<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::SIGMOID, T>>>(   \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          } else {                                                    \
-            const auto* dinx_ptr = dinx + offset;                     \
-            const auto* diny_ptr = diny + j;                          \
-            lite::x86::math::elementwise_range_to_one<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::SIGMOID, T>>>(   \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          }                                                           \
-        }                                                             \
-      }                                                               \
-    } else {                                                          \
-      for (int i = 0; i < batch; ++i) {                               \
-        for (int j = 0; j < channels; ++j) {                          \
-          int offset = (i * channels + j) * num;                      \
-          auto* dout_ptr = dout + offset;                             \
-          if (inv) {                                                  \
-            const auto* dinx_ptr = dinx + j;                          \
-            const auto* diny_ptr = diny + offset;                     \
-            lite::x86::math::elementwise_one_to_range<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::NO_ACTIVE, T>>>( \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          } else {                                                    \
-            const auto* dinx_ptr = dinx + offset;                     \
-            const auto* diny_ptr = diny + j;                          \
-            lite::x86::math::elementwise_range_to_one<                \
-                MergeConfig<op##Config<T>,                            \
-                            ActiveConfig<ActiveType::NO_ACTIVE, T>>>( \
-                dinx_ptr, diny_ptr, dout_ptr, num);                   \
-          }                                                           \
-        }                                                             \
-      }                                                               \
-    }                                                                 \
+#define ElementWiseFuncBCast(op)                                             \
+  template <typename T>                                                      \
+  void Elementwise_Broadcast_##op(const T* dinx,                             \
+                                  const T* diny,                             \
+                                  T* dout,                                   \
+                                  int batch,                                 \
+                                  int channels,                              \
+                                  int num,                                   \
+                                  bool has_active,                           \
+                                  std::string act_type,                      \
+                                  bool inv) {                                \
+    if (act_type == "tanh") {                                                \
+      elementwise_broadcast<ElementWiseActConfig(op, TANH)>(                 \
+          dinx, diny, dout, batch, channels, num, inv);                      \
+    } else if (act_type == "relu") {                                         \
+      elementwise_broadcast<ElementWiseActConfig(op, RELU)>(                 \
+          dinx, diny, dout, batch, channels, num, inv);                      \
+    } else if (act_type == "sigmoid") {                                      \
+      elementwise_broadcast<ElementWiseActConfig(op, SIGMOID)>(              \
+          dinx, diny, dout, batch, channels, num, inv);                      \
+    } else if (act_type == "abs") {                                          \
+      elementwise_broadcast<ElementWiseActConfig(op, ABS)>(                  \
+          dinx, diny, dout, batch, channels, num, inv);                      \
+    } else {                                                                 \
+      elementwise_broadcast<ElementWiseActConfig(op, NO_ACTIVE)>(            \
+          dinx, diny, dout, batch, channels, num, inv);                      \
+    }                                                                        \
   }
 
 // clang-format off
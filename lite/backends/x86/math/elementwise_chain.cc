@@ -0,0 +1,252 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/elementwise_chain.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+using lite::host::math::ElementwiseChainOp;
+
+#ifdef __AVX__
+
+// The elements of a tile, 8 avx registers.
+static const int64_t kTileSize = 64;
+
+// a * b + c, without requiring fma
+static inline __m256 madd_ps(__m256 a, __m256 b, __m256 c) {
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+
+static inline __m256 sigmoid_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+  return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+// 2 / (1 + exp(-2x)) - 1
+static inline __m256 tanh_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_mul_ps(_mm256_set1_ps(-2.f), x));
+  return _mm256_sub_ps(
+      _mm256_div_ps(_mm256_set1_ps(2.f), _mm256_add_ps(one, e)), one);
+}
+
+// erf by the formula 7.1.26 of Abramowitz and Stegun, the absolute error is
+// below 1.5e-7.
+static inline __m256 erf_ps(__m256 x) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 sign = _mm256_and_ps(x, sign_mask);
+  __m256 ax = _mm256_andnot_ps(sign_mask, x);
+  __m256 t = _mm256_div_ps(
+      one, madd_ps(_mm256_set1_ps(0.3275911f), ax, one));
+  __m256 p = _mm256_set1_ps(1.061405429f);
+  p = madd_ps(p, t, _mm256_set1_ps(-1.453152027f));
+  p = madd_ps(p, t, _mm256_set1_ps(1.421413741f));
+  p = madd_ps(p, t, _mm256_set1_ps(-0.284496736f));
+  p = madd_ps(p, t, _mm256_set1_ps(0.254829592f));
+  p = _mm256_mul_ps(p, t);
+  __m256 e = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(),
+                                     _mm256_mul_ps(ax, ax)));
+  __m256 y = _mm256_sub_ps(one, _mm256_mul_ps(p, e));
+  return _mm256_or_ps(y, sign);
+}
+
+static void apply_unary(const ElementwiseChainOp& op, float* x) {
+  const __m256 alpha = _mm256_set1_ps(op.alpha);
+  const __m256 beta = _mm256_set1_ps(op.beta);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  for (int64_t i = 0; i < kTileSize; i += 8) {
+    __m256 v = _mm256_loadu_ps(x + i);
+    switch (op.type) {
+      case ElementwiseChainOp::kScale:
+        v = madd_ps(v, alpha, beta);
+        break;
+      case ElementwiseChainOp::kRelu:
+        v = _mm256_max_ps(v, zero);
+        break;
+      case ElementwiseChainOp::kRelu6:
+        v = _mm256_min_ps(_mm256_max_ps(v, zero), alpha);
+        break;
+      case ElementwiseChainOp::kLeakyRelu:
+        v = _mm256_blendv_ps(_mm256_mul_ps(v, alpha),
+                             v,
+                             _mm256_cmp_ps(v, zero, _CMP_GT_OQ));
+        break;
+      case ElementwiseChainOp::kSigmoid:
+        v = sigmoid_ps(v);
+        break;
+      case ElementwiseChainOp::kTanh:
+        v = tanh_ps(v);
+        break;
+      case ElementwiseChainOp::kSwish:
+        v = _mm256_mul_ps(v, sigmoid_ps(_mm256_mul_ps(alpha, v)));
+        break;
+      case ElementwiseChainOp::kGelu: {
+        // 0.5 * x * (1 + erf(x / sqrt(2)))
+        __m256 e = erf_ps(_mm256_mul_ps(v, _mm256_set1_ps(0.70710678f)));
+        v = _mm256_mul_ps(_mm256_mul_ps(half, v), _mm256_add_ps(one, e));
+        break;
+      }
+      case ElementwiseChainOp::kGeluTanh: {
+        // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+        __m256 v3 = _mm256_mul_ps(_mm256_mul_ps(v, v), v);
+        __m256 inner = _mm256_mul_ps(
+            _mm256_set1_ps(0.79788456f),
+            madd_ps(_mm256_set1_ps(0.044715f), v3, v));
+        v = _mm256_mul_ps(_mm256_mul_ps(half, v),
+                          _mm256_add_ps(one, tanh_ps(inner)));
+        break;
+      }
+      case ElementwiseChainOp::kClip:
+        v = _mm256_min_ps(_mm256_max_ps(v, alpha), beta);
+        break;
+      case ElementwiseChainOp::kHardSigmoid:
+        v = _mm256_min_ps(_mm256_max_ps(madd_ps(v, alpha, beta), zero),
+                          one);
+        break;
+      default:
+        LOG(FATAL) << "Not an unary op of the chain: " << op.type;
+    }
+    _mm256_storeu_ps(x + i, v);
+  }
+}
+
+static void apply_binary(const ElementwiseChainOp& op,
+                         float* x,
+                         const float* y) {
+  for (int64_t i = 0; i < kTileSize; i += 8) {
+    __m256 a = _mm256_loadu_ps(x + i);
+    __m256 b = _mm256_loadu_ps(y + i);
+    switch (op.type) {
+      case ElementwiseChainOp::kAdd:
+        a = _mm256_add_ps(a, b);
+        break;
+      case ElementwiseChainOp::kSub:
+        a = _mm256_sub_ps(a, b);
+        break;
+      case ElementwiseChainOp::kRSub:
+        a = _mm256_sub_ps(b, a);
+        break;
+      case ElementwiseChainOp::kMul:
+        a = _mm256_mul_ps(a, b);
+        break;
+      case ElementwiseChainOp::kDiv:
+        a = _mm256_div_ps(a, b);
+        break;
+      case ElementwiseChainOp::kRDiv:
+        a = _mm256_div_ps(b, a);
+        break;
+      case ElementwiseChainOp::kMax:
+        a = _mm256_max_ps(a, b);
+        break;
+      case ElementwiseChainOp::kMin:
+        a = _mm256_min_ps(a, b);
+        break;
+      default:
+        LOG(FATAL) << "Not a binary op of the chain: " << op.type;
+    }
+    _mm256_storeu_ps(x + i, a);
+  }
+}
+
+// Runs the chain on the elements [begin, end) of x.
+static void elementwise_chain_range(
+    const float* x,
+    float* out,
+    int64_t numel,
+    int64_t begin,
+    int64_t end,
+    const std::vector<ElementwiseChainOp>& ops) {
+  // a tile is always full, the lanes after the last element are zeros
+  float tile[kTileSize];
+  float y_tile[kTileSize];
+  for (int64_t tile_begin = begin; tile_begin < end; tile_begin += kTileSize) {
+    const int64_t n = std::min(kTileSize, end - tile_begin);
+    std::memcpy(tile, x + tile_begin, n * sizeof(float));
+    if (n < kTileSize) {
+      std::fill(tile + n, tile + kTileSize, 0.f);
+    }
+    for (auto& op : ops) {
+      if (op.type < ElementwiseChainOp::kAdd) {
+        apply_unary(op, tile);
+        continue;
+      }
+      const float* y = op.y + tile_begin;
+      if (op.y_numel != numel || n < kTileSize) {
+        // broadcast on the last dims, the tile may wrap around y
+        int64_t k = tile_begin % op.y_numel;
+        for (int64_t i = 0; i < n; i++) {
+          y_tile[i] = op.y[k];
+          if (++k == op.y_numel) k = 0;
+        }
+        std::fill(y_tile + n, y_tile + kTileSize, 1.f);
+        y = y_tile;
+      }
+      apply_binary(op, tile, y);
+    }
+    std::memcpy(out + tile_begin, tile, n * sizeof(float));
+  }
+}
+
+// Below it the threads cost more than they save.
+static const int64_t kParallelMinSize = 16 * 1024;
+
+void elementwise_chain(const float* x,
+                       float* out,
+                       int64_t numel,
+                       const std::vector<ElementwiseChainOp>& ops) {
+  if (numel < kParallelMinSize) {
+    elementwise_chain_range(x, out, numel, 0, numel, ops);
+    return;
+  }
+  const int64_t num_tiles = (numel + kTileSize - 1) / kTileSize;
+  RunParallelFor(0, num_tiles, [&](int64_t tile_begin, int64_t tile_end) {
+    elementwise_chain_range(x,
+                            out,
+                            numel,
+                            tile_begin * kTileSize,
+                            std::min(tile_end * kTileSize, numel),
+                            ops);
+  });
+}
+
+#else
+
+void elementwise_chain(const float* x,
+                       float* out,
+                       int64_t numel,
+                       const std::vector<ElementwiseChainOp>& ops) {
+  lite::host::math::elementwise_chain(x, out, numel, ops);
+}
+
+#endif
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,37 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "lite/backends/host/math/elementwise_chain.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// host::math::elementwise_chain on x86, the ops run on the tiles with avx and
+// the tiles of a large x are split over the threads. out may be x.
+void elementwise_chain(
+    const float* x,
+    float* out,
+    int64_t numel,
+    const std::vector<lite::host::math::ElementwiseChainOp>& ops);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
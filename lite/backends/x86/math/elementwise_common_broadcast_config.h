@@ -291,6 +291,11 @@ inline T NaiveSigmoid(T a) {
   return static_cast<T>(1.0) / (static_cast<T>(1.0) + std::exp(-tmp));
 }
 
+template <class T>
+inline T NaiveAbs(T a) {
+  return std::fabs(a);
+}
+
 template <typename T>
 inline T NaiveAdd(T l, T r) {
   return l + r;
@@ -344,7 +349,11 @@ struct NullCpuInstruction {};
 template <class ComputeConfig, class ActConfig>
 struct MergeConfig : public ComputeConfig, public ActConfig {};
 
-enum class ActiveType { NO_ACTIVE, RELU, TANH, SIGMOID };
+// The activations fused into one pass of the float ops. These cover what
+// lite_elementwise_activation_fuse_pass emits for x86 (relu, abs and tanh).
+// The ones with attributes such as relu6, leaky_relu or gelu are left to
+// lite_elementwise_chain_fuse_pass, which runs after it.
+enum class ActiveType { NO_ACTIVE, RELU, TANH, SIGMOID, ABS };
 
 template <class DataType>
 struct BasicConfig {};
@@ -660,6 +669,18 @@ struct ActiveConfig<ActiveType::SIGMOID, float> {
   constexpr static __m256 (*isa_active)(const __m256) = forward_avx::Sigmoid;
   constexpr static bool has_active = true;
 };
+
+// clear the sign bit
+inline __m256 _mm256_abs_ps(const __m256 a) {
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a);
+}
+
+template <>
+struct ActiveConfig<ActiveType::ABS, float> {
+  constexpr static float (*naive_active)(float) = NaiveAbs<float>;
+  constexpr static __m256 (*isa_active)(const __m256) = _mm256_abs_ps;
+  constexpr static bool has_active = true;
+};
 #elif defined(__SSE4_2__)
 __m128 _mm_relu_ps(const __m128& a);
 
@@ -684,6 +705,17 @@ struct ActiveConfig<ActiveType::SIGMOID, float> {
   constexpr static __m128 (*isa_active)(const __m128) = nullptr;
   constexpr static bool has_active = true;
 };
+
+inline __m128 _mm_abs_ps(const __m128 a) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.f), a);
+}
+
+template <>
+struct ActiveConfig<ActiveType::ABS, float> {
+  constexpr static float (*naive_active)(float) = NaiveAbs<float>;
+  constexpr static __m128 (*isa_active)(const __m128) = _mm_abs_ps;
+  constexpr static bool has_active = true;
+};
 #endif
 
 // fuse-activation doesn't support int32 and int64 type
@@ -711,6 +743,14 @@ struct ActiveConfig<ActiveType::SIGMOID, int32_t> {
   constexpr static bool has_active = false;
 };
 
+template <>
+struct ActiveConfig<ActiveType::ABS, int32_t> {
+  constexpr static int32_t (*naive_active)(int32_t) = nullptr;
+  constexpr static typename BasicConfig<int32_t>::ISA_T (*isa_active)(
+      const typename BasicConfig<int32_t>::ISA_T) = nullptr;
+  constexpr static bool has_active = false;
+};
+
 template <>
 struct ActiveConfig<ActiveType::RELU, int64_t> {
   constexpr static int64_t (*naive_active)(int64_t) = nullptr;
@@ -735,6 +775,14 @@ struct ActiveConfig<ActiveType::SIGMOID, int64_t> {
   constexpr static bool has_active = false;
 };
 
+template <>
+struct ActiveConfig<ActiveType::ABS, int64_t> {
+  constexpr static int64_t (*naive_active)(int64_t) = nullptr;
+  constexpr static typename BasicConfig<int64_t>::ISA_T (*isa_active)(
+      const typename BasicConfig<int64_t>::ISA_T) = nullptr;
+  constexpr static bool has_active = false;
+};
+
 // avoid compling error: xxx_address will never be null
 static bool condition_one(void* isa_op, void* naive_op) {
   return ((isa_op != nullptr) && (naive_op != nullptr));
@@ -746,8 +794,9 @@ static bool condition_two(void* isa_op, void* naive_op) {
 
 static bool condition_three(void* isa_act) { return (isa_act != nullptr); }
 
-// Fuse-Activation only supports relu, sigmoid and tanh for AVX instruction,
-// relu for SSE instruction, the others run naive functions instead.
+// Fuse-Activation only supports relu, sigmoid, tanh and abs for AVX
+// instruction, relu and abs for SSE instruction, the others run naive
+// functions instead.
 template <class Config, bool IS_X_SINGLE, bool IS_Y_SINGLE>
 void do_isa_elementwise(const typename Config::T* dinx,
                         const typename Config::T* diny,
@@ -0,0 +1,287 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/embedding.h"
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+static inline void prefetch_row(const float* row, int64_t width) {
+  const char* p = reinterpret_cast<const char*>(row);
+  const int64_t bytes = width * static_cast<int64_t>(sizeof(float));
+  for (int64_t b = 0; b < bytes; b += 64) {
+    _mm_prefetch(p + b, _MM_HINT_T0);
+  }
+}
+
+template <typename T_IDS>
+static inline void check_id(T_IDS id, int64_t table_height, int64_t i) {
+  CHECK_LT(static_cast<int64_t>(id), table_height) << "i = " << i;
+  CHECK_GE(static_cast<int64_t>(id), 0) << "i = " << i;
+}
+
+template <typename T_IDS>
+void lookup_table(const float* table,
+                  int64_t table_height,
+                  int64_t width,
+                  const T_IDS* ids,
+                  int64_t ids_numel,
+                  int64_t padding_idx,
+                  float* out) {
+#pragma omp parallel for
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    const int64_t next = i + EMB_PREFETCH_DISTANCE;
+    if (next < ids_numel && ids[next] >= 0 && ids[next] < table_height) {
+      prefetch_row(table + static_cast<int64_t>(ids[next]) * width, width);
+    }
+    float* out_row = out + i * width;
+    if (padding_idx != -1 && ids[i] == padding_idx) {
+      std::memset(out_row, 0, width * sizeof(float));
+    } else {
+      check_id(ids[i], table_height, i);
+      std::memcpy(out_row,
+                  table + static_cast<int64_t>(ids[i]) * width,
+                  width * sizeof(float));
+    }
+  }
+}
+
+static inline void dequant_row(
+    const uint8_t* q, float min, float scale, int64_t n, float* out) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vec_min = _mm256_set1_ps(min);
+  __m256 vec_scale = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    __m128i vec_q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i));
+    __m256 vec_x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(vec_q));
+    _mm256_storeu_ps(out + i, _mm256_fmadd_ps(vec_x, vec_scale, vec_min));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = scale * static_cast<int>(q[i]) + min;
+  }
+}
+
+template <typename T_IDS>
+void lookup_table_dequant(const float* table,
+                          int64_t table_height,
+                          int64_t quant_width,
+                          const T_IDS* ids,
+                          int64_t ids_numel,
+                          int64_t padding_idx,
+                          float* out) {
+  const int64_t width = (quant_width - 2) * 4;
+#pragma omp parallel for
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    const int64_t next = i + EMB_PREFETCH_DISTANCE;
+    if (next < ids_numel && ids[next] >= 0 && ids[next] < table_height) {
+      prefetch_row(table + static_cast<int64_t>(ids[next]) * quant_width,
+                   quant_width);
+    }
+    float* out_row = out + i * width;
+    if (padding_idx != -1 && ids[i] == padding_idx) {
+      std::memset(out_row, 0, width * sizeof(float));
+    } else {
+      check_id(ids[i], table_height, i);
+      const float* row = table + static_cast<int64_t>(ids[i]) * quant_width;
+      const float min = row[0];
+      const float max = row[1];
+      dequant_row(reinterpret_cast<const uint8_t*>(row + 2),
+                  min,
+                  (max - min) / 256,
+                  width,
+                  out_row);
+    }
+  }
+}
+
+// out[w] = sum_h table[ids[h * ids_width + w]], the rows of padding_idx are
+// zeros but still counted in the length of the sequence.
+template <typename T_IDS>
+static void sum_rows(const float* table,
+                     int64_t width,
+                     const T_IDS* ids,
+                     int64_t ids_height,
+                     int64_t ids_width,
+                     int64_t padding_idx,
+                     float* out) {
+  std::fill(out, out + ids_width * width, 0.f);
+  for (int64_t h = 0; h < ids_height; ++h) {
+    if (h + 1 < ids_height) {
+      const T_IDS* next_ids = ids + (h + 1) * ids_width;
+      for (int64_t w = 0; w < ids_width; ++w) {
+        if (padding_idx == -1 || next_ids[w] != padding_idx) {
+          prefetch_row(table + static_cast<int64_t>(next_ids[w]) * width,
+                       width);
+        }
+      }
+    }
+    for (int64_t w = 0; w < ids_width; ++w) {
+      const T_IDS id = ids[h * ids_width + w];
+      if (padding_idx != -1 && id == padding_idx) continue;
+      const float* row = table + static_cast<int64_t>(id) * width;
+      float* out_row = out + w * width;
+      for (int64_t c = 0; c < width; ++c) {
+        out_row[c] += row[c];
+      }
+    }
+  }
+}
+
+template <typename T_IDS>
+static void sum_rows_jit(const float* table,
+                         int64_t table_height,
+                         int64_t width,
+                         const T_IDS* ids,
+                         int64_t ids_height,
+                         int64_t ids_width,
+                         int64_t padding_idx,
+                         float* out) {
+  sum_rows(table, width, ids, ids_height, ids_width, padding_idx, out);
+}
+
+// The jit EmbSeqPool kernel only takes int64 ids and has no padding_idx.
+static void sum_rows_jit(const float* table,
+                         int64_t table_height,
+                         int64_t width,
+                         const int64_t* ids,
+                         int64_t ids_height,
+                         int64_t ids_width,
+                         int64_t padding_idx,
+                         float* out) {
+  if (padding_idx != -1) {
+    sum_rows(table, width, ids, ids_height, ids_width, padding_idx, out);
+    return;
+  }
+  jit::emb_seq_pool_attr_t attr(table_height,
+                                width,
+                                ids_height,
+                                ids_width,
+                                ids_width * width,
+                                jit::SeqPoolType::kSum);
+  auto emb_seq_pool =
+      jit::KernelFuncs<jit::EmbSeqPoolTuple<float>, lite::fluid::CPUPlace>::
+          Cache()
+              .At(attr);
+  emb_seq_pool(table, ids, out, &attr);
+}
+
+template <typename T_IDS>
+void embedding_seq_pool(const float* table,
+                        int64_t table_height,
+                        int64_t width,
+                        const T_IDS* ids,
+                        int64_t ids_width,
+                        const uint64_t* lod,
+                        int64_t num_seqs,
+                        const std::string& pool_type,
+                        int64_t padding_idx,
+                        float pad_value,
+                        float* out) {
+  CHECK(pool_type == "SUM" || pool_type == "AVERAGE" || pool_type == "SQRT")
+      << "Unsupported pool type " << pool_type;
+  const int64_t out_width = ids_width * width;
+  const int64_t ids_numel = static_cast<int64_t>(lod[num_seqs]) * ids_width;
+  for (int64_t i = 0; i < ids_numel; ++i) {
+    if (padding_idx == -1 || ids[i] != padding_idx) {
+      check_id(ids[i], table_height, i);
+    }
+  }
+#pragma omp parallel for
+  for (int64_t s = 0; s < num_seqs; ++s) {
+    const int64_t begin = static_cast<int64_t>(lod[s]);
+    const int64_t height = static_cast<int64_t>(lod[s + 1]) - begin;
+    float* out_row = out + s * out_width;
+    if (height == 0) {
+      std::fill(out_row, out_row + out_width, pad_value);
+      continue;
+    }
+    // the first rows of the next sequence, the jit kernel does not prefetch
+    if (s + 1 < num_seqs) {
+      const int64_t next = static_cast<int64_t>(lod[s + 1]) * ids_width;
+      const int64_t end = std::min(static_cast<int64_t>(lod[s + 2]) * ids_width,
+                                   next + EMB_PREFETCH_DISTANCE);
+      for (int64_t i = next; i < end; ++i) {
+        if (padding_idx == -1 || ids[i] != padding_idx) {
+          prefetch_row(table + static_cast<int64_t>(ids[i]) * width, width);
+        }
+      }
+    }
+    sum_rows_jit(table,
+                 table_height,
+                 width,
+                 ids + begin * ids_width,
+                 height,
+                 ids_width,
+                 padding_idx,
+                 out_row);
+    if (pool_type != "SUM") {
+      const float scale = pool_type == "AVERAGE"
+                              ? 1.f / height
+                              : 1.f / std::sqrt(static_cast<float>(height));
+      for (int64_t c = 0; c < out_width; ++c) {
+        out_row[c] *= scale;
+      }
+    }
+  }
+}
+
+#define INSTANTIATE_EMBEDDING(T_IDS)                            \
+  template void lookup_table<T_IDS>(const float*,               \
+                                    int64_t,                    \
+                                    int64_t,                    \
+                                    const T_IDS*,               \
+                                    int64_t,                    \
+                                    int64_t,                    \
+                                    float*);                    \
+  template void lookup_table_dequant<T_IDS>(const float*,       \
+                                            int64_t,            \
+                                            int64_t,            \
+                                            const T_IDS*,       \
+                                            int64_t,            \
+                                            int64_t,            \
+                                            float*);            \
+  template void embedding_seq_pool<T_IDS>(const float*,         \
+                                          int64_t,              \
+                                          int64_t,              \
+                                          const T_IDS*,         \
+                                          int64_t,              \
+                                          const uint64_t*,      \
+                                          int64_t,              \
+                                          const std::string&,   \
+                                          int64_t,              \
+                                          float,                \
+                                          float*);
+
+INSTANTIATE_EMBEDDING(int32_t);
+INSTANTIATE_EMBEDDING(int64_t);
+
+#undef INSTANTIATE_EMBEDDING
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
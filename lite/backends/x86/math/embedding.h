@@ -0,0 +1,73 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The rows of the ids this far ahead are prefetched while the current one is
+// copied, the ids of embedding lookups are random so the hardware prefetcher
+// can not follow them.
+#define EMB_PREFETCH_DISTANCE 8
+
+// out[i] = table[ids[i]] for i in [0, ids_numel), the rows of padding_idx
+// are zeros. table: [table_height, width].
+template <typename T_IDS>
+void lookup_table(const float* table,
+                  int64_t table_height,
+                  int64_t width,
+                  const T_IDS* ids,
+                  int64_t ids_numel,
+                  int64_t padding_idx,
+                  float* out);
+
+// Same as lookup_table on a table compressed to 8 bits, each row holds
+// quant_width floats: min, max and then (quant_width - 2) * 4 bytes q,
+// which are dequantized on the fly as min + q * (max - min) / 256.
+template <typename T_IDS>
+void lookup_table_dequant(const float* table,
+                          int64_t table_height,
+                          int64_t quant_width,
+                          const T_IDS* ids,
+                          int64_t ids_numel,
+                          int64_t padding_idx,
+                          float* out);
+
+// lookup_table followed by sequence_pool without the expanded embedding.
+// Sequence s holds the ids rows [lod[s], lod[s + 1]), every row has
+// ids_width ids, out[s] is [ids_width, width]. pool_type is one of "SUM",
+// "AVERAGE" and "SQRT", the empty sequences are filled with pad_value.
+template <typename T_IDS>
+void embedding_seq_pool(const float* table,
+                        int64_t table_height,
+                        int64_t width,
+                        const T_IDS* ids,
+                        int64_t ids_width,
+                        const uint64_t* lod,
+                        int64_t num_seqs,
+                        const std::string& pool_type,
+                        int64_t padding_idx,
+                        float pad_value,
+                        float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
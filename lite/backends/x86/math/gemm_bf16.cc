@@ -0,0 +1,316 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include <string.h>
+#include <algorithm>
+#include "lite/core/memory.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+static inline uint16_t fp32_to_bf16_one(float x) {
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  if ((u & 0x7fffffff) > 0x7f800000) {
+    return static_cast<uint16_t>((u >> 16) | 0x40);
+  }
+  u += 0x7fff + ((u >> 16) & 1);
+  return static_cast<uint16_t>(u >> 16);
+}
+
+static inline float bf16_to_fp32_one(uint16_t x) {
+  uint32_t u = static_cast<uint32_t>(x) << 16;
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+void fp32_to_bf16(const float* din, uint16_t* dout, int64_t size) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  const __m256i vec_abs = _mm256_set1_epi32(0x7fffffff);
+  const __m256i vec_inf = _mm256_set1_epi32(0x7f800000);
+  const __m256i vec_round = _mm256_set1_epi32(0x7fff);
+  const __m256i vec_one = _mm256_set1_epi32(1);
+  const __m256i vec_quiet = _mm256_set1_epi32(0x40);
+  for (; i + 16 <= size; i += 16) {
+    __m256i vec_out[2];
+    for (int j = 0; j < 2; j++) {
+      __m256i u = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(din + i + j * 8));
+      __m256i odd = _mm256_and_si256(_mm256_srli_epi32(u, 16), vec_one);
+      __m256i rnd = _mm256_srli_epi32(
+          _mm256_add_epi32(u, _mm256_add_epi32(vec_round, odd)), 16);
+      __m256i nan = _mm256_or_si256(_mm256_srli_epi32(u, 16), vec_quiet);
+      __m256i is_nan =
+          _mm256_cmpgt_epi32(_mm256_and_si256(u, vec_abs), vec_inf);
+      vec_out[j] = _mm256_blendv_epi8(rnd, nan, is_nan);
+    }
+    __m256i vec_pack = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(vec_out[0], vec_out[1]), 0xd8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dout + i), vec_pack);
+  }
+#endif
+  for (; i < size; i++) {
+    dout[i] = fp32_to_bf16_one(din[i]);
+  }
+}
+
+void bf16_to_fp32(const uint16_t* din, float* dout, int64_t size) {
+  for (int64_t i = 0; i < size; i++) {
+    dout[i] = bf16_to_fp32_one(din[i]);
+  }
+}
+
+int64_t gemm_bf16_packed_b_size(int N, int K) {
+  int64_t panels = (N + GEMM_BF16_NR - 1) / GEMM_BF16_NR;
+  int64_t k2 = (K + 1) / 2;
+  return panels * k2 * GEMM_BF16_NR * 2;
+}
+
+void gemm_bf16_pack_b(int N, int K, const float* B, int ldb, uint16_t* dout) {
+  gemm_bf16_pack_b(N, K, B, ldb, false, 1.f, dout);
+}
+
+void gemm_bf16_pack_b(int N,
+                      int K,
+                      const float* B,
+                      int ldb,
+                      bool trans_b,
+                      float alpha,
+                      uint16_t* dout) {
+  const int panels = (N + GEMM_BF16_NR - 1) / GEMM_BF16_NR;
+  const int k2 = (K + 1) / 2;
+  // B[k][n] scaled, or B[n][k] when trans_b
+  const int64_t k_stride = trans_b ? 1 : ldb;
+  const int64_t n_stride = trans_b ? ldb : 1;
+#pragma omp parallel for
+  for (int p = 0; p < panels; p++) {
+    uint16_t* dst = dout + static_cast<int64_t>(p) * k2 * GEMM_BF16_NR * 2;
+    const int n0 = p * GEMM_BF16_NR;
+    const int n = std::min(GEMM_BF16_NR, N - n0);
+    for (int kk = 0; kk < k2; kk++) {
+      const float* b0 = B + 2 * kk * k_stride + n0 * n_stride;
+      const float* b1 = b0 + k_stride;
+      const bool has_b1 = (2 * kk + 1) < K;
+      for (int j = 0; j < GEMM_BF16_NR; j++) {
+        dst[2 * j] = j < n ? fp32_to_bf16_one(alpha * b0[j * n_stride]) : 0;
+        dst[2 * j + 1] = (j < n && has_b1)
+                             ? fp32_to_bf16_one(alpha * b1[j * n_stride])
+                             : 0;
+      }
+      dst += GEMM_BF16_NR * 2;
+    }
+  }
+}
+
+void gemm_bf16_panel_ref(int M,
+                         int n,
+                         int K2,
+                         const uint32_t* A,
+                         int lda2,
+                         const uint32_t* B,
+                         float* C,
+                         int ldc,
+                         const float* bias,
+                         bool relu) {
+  for (int i = 0; i < M; i++) {
+    const uint32_t* a = A + static_cast<int64_t>(i) * lda2;
+    for (int j = 0; j < n; j++) {
+      float sum = 0.f;
+      for (int kk = 0; kk < K2; kk++) {
+        uint32_t b = B[kk * GEMM_BF16_NR + j];
+        sum += bf16_to_fp32_one(a[kk] & 0xffff) * bf16_to_fp32_one(b & 0xffff);
+        sum += bf16_to_fp32_one(a[kk] >> 16) * bf16_to_fp32_one(b >> 16);
+      }
+      if (bias) sum += bias[j];
+      if (relu) sum = std::max(sum, 0.f);
+      C[static_cast<int64_t>(i) * ldc + j] = sum;
+    }
+  }
+}
+
+#ifdef __AVX2__
+// MR rows x 16 columns, the low half of each 32-bit lane is widened by
+// a shift and the high half by a mask, this is what vdpbf16ps does.
+template <int MR>
+static inline void gemm_bf16_avx2_mr(int n,
+                                     int K2,
+                                     const uint32_t* A,
+                                     int lda2,
+                                     const uint32_t* B,
+                                     float* C,
+                                     int ldc,
+                                     const float* bias,
+                                     bool relu) {
+  const __m256i vec_mask = _mm256_set1_epi32(0xffff0000);
+  __m256 vec_c[MR][2];
+  for (int i = 0; i < MR; i++) {
+    vec_c[i][0] = _mm256_setzero_ps();
+    vec_c[i][1] = _mm256_setzero_ps();
+  }
+  for (int kk = 0; kk < K2; kk++) {
+    __m256i vec_b0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + kk * 16));
+    __m256i vec_b1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + kk * 16 + 8));
+    __m256 vec_b0_lo = _mm256_castsi256_ps(_mm256_slli_epi32(vec_b0, 16));
+    __m256 vec_b0_hi = _mm256_castsi256_ps(_mm256_and_si256(vec_b0, vec_mask));
+    __m256 vec_b1_lo = _mm256_castsi256_ps(_mm256_slli_epi32(vec_b1, 16));
+    __m256 vec_b1_hi = _mm256_castsi256_ps(_mm256_and_si256(vec_b1, vec_mask));
+    for (int i = 0; i < MR; i++) {
+      __m256i vec_a = _mm256_set1_epi32(A[i * lda2 + kk]);
+      __m256 vec_a_lo = _mm256_castsi256_ps(_mm256_slli_epi32(vec_a, 16));
+      __m256 vec_a_hi = _mm256_castsi256_ps(_mm256_and_si256(vec_a, vec_mask));
+      vec_c[i][0] = _mm256_fmadd_ps(vec_a_lo, vec_b0_lo, vec_c[i][0]);
+      vec_c[i][1] = _mm256_fmadd_ps(vec_a_lo, vec_b1_lo, vec_c[i][1]);
+      vec_c[i][0] = _mm256_fmadd_ps(vec_a_hi, vec_b0_hi, vec_c[i][0]);
+      vec_c[i][1] = _mm256_fmadd_ps(vec_a_hi, vec_b1_hi, vec_c[i][1]);
+    }
+  }
+  __m256 vec_bias0 = _mm256_setzero_ps();
+  __m256 vec_bias1 = _mm256_setzero_ps();
+  float tmp[GEMM_BF16_NR];
+  if (bias) {
+    memset(tmp, 0, sizeof(tmp));
+    memcpy(tmp, bias, n * sizeof(float));
+    vec_bias0 = _mm256_loadu_ps(tmp);
+    vec_bias1 = _mm256_loadu_ps(tmp + 8);
+  }
+  const __m256 vec_zero = _mm256_setzero_ps();
+  for (int i = 0; i < MR; i++) {
+    __m256 vec_out0 = _mm256_add_ps(vec_c[i][0], vec_bias0);
+    __m256 vec_out1 = _mm256_add_ps(vec_c[i][1], vec_bias1);
+    if (relu) {
+      vec_out0 = _mm256_max_ps(vec_out0, vec_zero);
+      vec_out1 = _mm256_max_ps(vec_out1, vec_zero);
+    }
+    float* c = C + static_cast<int64_t>(i) * ldc;
+    if (n == GEMM_BF16_NR) {
+      _mm256_storeu_ps(c, vec_out0);
+      _mm256_storeu_ps(c + 8, vec_out1);
+    } else {
+      _mm256_storeu_ps(tmp, vec_out0);
+      _mm256_storeu_ps(tmp + 8, vec_out1);
+      memcpy(c, tmp, n * sizeof(float));
+    }
+  }
+}
+
+void gemm_bf16_panel_avx2(int M,
+                          int n,
+                          int K2,
+                          const uint32_t* A,
+                          int lda2,
+                          const uint32_t* B,
+                          float* C,
+                          int ldc,
+                          const float* bias,
+                          bool relu) {
+  int i = 0;
+  for (; i + 4 <= M; i += 4) {
+    gemm_bf16_avx2_mr<4>(n,
+                         K2,
+                         A + static_cast<int64_t>(i) * lda2,
+                         lda2,
+                         B,
+                         C + static_cast<int64_t>(i) * ldc,
+                         ldc,
+                         bias,
+                         relu);
+  }
+  for (; i < M; i++) {
+    gemm_bf16_avx2_mr<1>(n,
+                         K2,
+                         A + static_cast<int64_t>(i) * lda2,
+                         lda2,
+                         B,
+                         C + static_cast<int64_t>(i) * ldc,
+                         ldc,
+                         bias,
+                         relu);
+  }
+}
+#endif  // __AVX2__
+
+// LITE_WITH_GEMM_BF16_AVX512 is set on this file by
+// lite/backends/x86/CMakeLists when gemm_bf16_avx512.cc can be built.
+gemm_bf16_kernel_t GetGemmBF16Kernel() {
+#ifdef LITE_WITH_GEMM_BF16_AVX512
+  if (MayIUse(avx512_core_bf16)) return gemm_bf16_panel_avx512;
+#endif
+#ifdef __AVX2__
+  return gemm_bf16_panel_avx2;
+#else
+  return gemm_bf16_panel_ref;
+#endif
+}
+
+void gemm_bf16(int M,
+               int N,
+               int K,
+               const float* A,
+               int lda,
+               const uint16_t* packed_b,
+               float* C,
+               int ldc,
+               const float* bias,
+               bool relu) {
+  static gemm_bf16_kernel_t kernel = GetGemmBF16Kernel();
+  const int k2 = (K + 1) / 2;
+  const int panels = (N + GEMM_BF16_NR - 1) / GEMM_BF16_NR;
+  const int mb = 64;
+  const int mblocks = (M + mb - 1) / mb;
+
+  // A rows as bf16 pairs, the odd tail of K is padded with zero
+  uint32_t* a_bf16 = static_cast<uint32_t*>(TargetMalloc(
+      TARGET(kX86), static_cast<size_t>(M) * k2 * sizeof(uint32_t)));
+#pragma omp parallel for
+  for (int i = 0; i < M; i++) {
+    uint16_t* dst =
+        reinterpret_cast<uint16_t*>(a_bf16 + static_cast<int64_t>(i) * k2);
+    fp32_to_bf16(A + static_cast<int64_t>(i) * lda, dst, K);
+    if (K & 1) dst[K] = 0;
+  }
+
+#pragma omp parallel for
+  for (int t = 0; t < mblocks * panels; t++) {
+    const int m0 = (t / panels) * mb;
+    const int n0 = (t % panels) * GEMM_BF16_NR;
+    const uint32_t* b = reinterpret_cast<const uint32_t*>(packed_b) +
+                        static_cast<int64_t>(t % panels) * k2 * GEMM_BF16_NR;
+    kernel(std::min(mb, M - m0),
+           std::min(GEMM_BF16_NR, N - n0),
+           k2,
+           a_bf16 + static_cast<int64_t>(m0) * k2,
+           k2,
+           b,
+           C + static_cast<int64_t>(m0) * ldc + n0,
+           ldc,
+           bias ? bias + n0 : nullptr,
+           relu);
+  }
+  TargetFree(TARGET(kX86), a_bf16);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
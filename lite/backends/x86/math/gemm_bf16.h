@@ -0,0 +1,118 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/backends/x86/cpu_info.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// B is packed into panels of GEMM_BF16_NR columns, each panel stored as
+// [K / 2][GEMM_BF16_NR][2] so that one 32-bit lane holds B[k][n] and
+// B[k + 1][n], which is the operand layout of vdpbf16ps.
+#define GEMM_BF16_NR 16
+
+// fp32 -> bf16 with round-to-nearest-even, NaN stays NaN.
+void fp32_to_bf16(const float* din, uint16_t* dout, int64_t size);
+void bf16_to_fp32(const uint16_t* din, float* dout, int64_t size);
+
+// Number of uint16_t needed to hold the packed B of a K x N matrix,
+// K is padded to 2 and N to GEMM_BF16_NR with zeros.
+int64_t gemm_bf16_packed_b_size(int N, int K);
+// B is K x N row-major fp32 (the layout of fc/mul weights).
+void gemm_bf16_pack_b(int N, int K, const float* B, int ldb, uint16_t* dout);
+// The same with B scaled by alpha, and N x K when trans_b (the layouts of
+// the matmul weights).
+void gemm_bf16_pack_b(int N,
+                      int K,
+                      const float* B,
+                      int ldb,
+                      bool trans_b,
+                      float alpha,
+                      uint16_t* dout);
+
+// C = A * B (+ bias) (relu), A is fp32 and rounded to bf16 on the fly,
+// B comes from gemm_bf16_pack_b, products are accumulated in fp32.
+void gemm_bf16(int M,
+               int N,
+               int K,
+               const float* A,
+               int lda,
+               const uint16_t* packed_b,
+               float* C,
+               int ldc,
+               const float* bias,
+               bool relu);
+
+// Computes one panel: C[M][n] for n <= GEMM_BF16_NR columns. A holds bf16
+// pairs (K2 = ceil(K / 2) per row, row stride lda2), B is one packed panel,
+// bias is already offset to the panel or nullptr.
+typedef void (*gemm_bf16_kernel_t)(int M,
+                                   int n,
+                                   int K2,
+                                   const uint32_t* A,
+                                   int lda2,
+                                   const uint32_t* B,
+                                   float* C,
+                                   int ldc,
+                                   const float* bias,
+                                   bool relu);
+
+// plain c++
+void gemm_bf16_panel_ref(int M,
+                         int n,
+                         int K2,
+                         const uint32_t* A,
+                         int lda2,
+                         const uint32_t* B,
+                         float* C,
+                         int ldc,
+                         const float* bias,
+                         bool relu);
+
+// avx2, bf16 widened to fp32 by shift/mask then fma
+void gemm_bf16_panel_avx2(int M,
+                          int n,
+                          int K2,
+                          const uint32_t* A,
+                          int lda2,
+                          const uint32_t* B,
+                          float* C,
+                          int ldc,
+                          const float* bias,
+                          bool relu);
+
+// avx512_bf16, vdpbf16ps
+void gemm_bf16_panel_avx512(int M,
+                            int n,
+                            int K2,
+                            const uint32_t* A,
+                            int lda2,
+                            const uint32_t* B,
+                            float* C,
+                            int ldc,
+                            const float* bias,
+                            bool relu);
+
+// Returns the panel kernel of the best isa available, never nullptr.
+gemm_bf16_kernel_t GetGemmBF16Kernel();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,151 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Built with -mavx512bf16, see lite/backends/x86/CMakeLists.txt.
+#if defined(__AVX512BF16__) && defined(__AVX512BW__)
+
+#include <immintrin.h>
+#include "lite/backends/x86/math/gemm_bf16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// bias, relu and the masked store of the last panel
+template <int MR>
+static inline void gemm_bf16_avx512_store(const __m512* vec_c,
+                                          int n,
+                                          float* C,
+                                          int ldc,
+                                          const float* bias,
+                                          bool relu) {
+  const __mmask16 mask = static_cast<__mmask16>((1u << n) - 1);
+  __m512 vec_bias =
+      bias ? _mm512_maskz_loadu_ps(mask, bias) : _mm512_setzero_ps();
+  const __m512 vec_zero = _mm512_setzero_ps();
+  for (int i = 0; i < MR; i++) {
+    __m512 vec_out = _mm512_add_ps(vec_c[i], vec_bias);
+    if (relu) vec_out = _mm512_max_ps(vec_out, vec_zero);
+    _mm512_mask_storeu_ps(C + static_cast<int64_t>(i) * ldc, mask, vec_out);
+  }
+}
+
+// MR rows x 16 columns, one zmm accumulator per row.
+template <int MR>
+static inline void gemm_bf16_avx512_mr(int n,
+                                       int K2,
+                                       const uint32_t* A,
+                                       int lda2,
+                                       const uint32_t* B,
+                                       float* C,
+                                       int ldc,
+                                       const float* bias,
+                                       bool relu) {
+  __m512 vec_c[MR];
+  for (int i = 0; i < MR; i++) {
+    vec_c[i] = _mm512_setzero_ps();
+  }
+  for (int kk = 0; kk < K2; kk++) {
+    __m512bh vec_b = (__m512bh)_mm512_loadu_si512(B + kk * GEMM_BF16_NR);
+    for (int i = 0; i < MR; i++) {
+      __m512bh vec_a = (__m512bh)_mm512_set1_epi32(A[i * lda2 + kk]);
+      vec_c[i] = _mm512_dpbf16_ps(vec_c[i], vec_a, vec_b);
+    }
+  }
+  gemm_bf16_avx512_store<MR>(vec_c, n, C, ldc, bias, relu);
+}
+
+// A single row has only one dependency chain on the accumulator,
+// so split K over four accumulators to hide the latency of vdpbf16ps.
+static inline void gemm_bf16_avx512_row(int n,
+                                        int K2,
+                                        const uint32_t* A,
+                                        const uint32_t* B,
+                                        float* C,
+                                        const float* bias,
+                                        bool relu) {
+  __m512 vec_c[4];
+  for (int i = 0; i < 4; i++) {
+    vec_c[i] = _mm512_setzero_ps();
+  }
+  int kk = 0;
+  for (; kk + 4 <= K2; kk += 4) {
+    for (int i = 0; i < 4; i++) {
+      __m512bh vec_b =
+          (__m512bh)_mm512_loadu_si512(B + (kk + i) * GEMM_BF16_NR);
+      __m512bh vec_a = (__m512bh)_mm512_set1_epi32(A[kk + i]);
+      vec_c[i] = _mm512_dpbf16_ps(vec_c[i], vec_a, vec_b);
+    }
+  }
+  for (; kk < K2; kk++) {
+    __m512bh vec_b = (__m512bh)_mm512_loadu_si512(B + kk * GEMM_BF16_NR);
+    __m512bh vec_a = (__m512bh)_mm512_set1_epi32(A[kk]);
+    vec_c[0] = _mm512_dpbf16_ps(vec_c[0], vec_a, vec_b);
+  }
+  vec_c[0] = _mm512_add_ps(_mm512_add_ps(vec_c[0], vec_c[1]),
+                           _mm512_add_ps(vec_c[2], vec_c[3]));
+  gemm_bf16_avx512_store<1>(vec_c, n, C, 0, bias, relu);
+}
+
+void gemm_bf16_panel_avx512(int M,
+                            int n,
+                            int K2,
+                            const uint32_t* A,
+                            int lda2,
+                            const uint32_t* B,
+                            float* C,
+                            int ldc,
+                            const float* bias,
+                            bool relu) {
+  int i = 0;
+  for (; i + 8 <= M; i += 8) {
+    gemm_bf16_avx512_mr<8>(n,
+                           K2,
+                           A + static_cast<int64_t>(i) * lda2,
+                           lda2,
+                           B,
+                           C + static_cast<int64_t>(i) * ldc,
+                           ldc,
+                           bias,
+                           relu);
+  }
+  for (; i + 4 <= M; i += 4) {
+    gemm_bf16_avx512_mr<4>(n,
+                           K2,
+                           A + static_cast<int64_t>(i) * lda2,
+                           lda2,
+                           B,
+                           C + static_cast<int64_t>(i) * ldc,
+                           ldc,
+                           bias,
+                           relu);
+  }
+  for (; i < M; i++) {
+    gemm_bf16_avx512_row(n,
+                         K2,
+                         A + static_cast<int64_t>(i) * lda2,
+                         B,
+                         C + static_cast<int64_t>(i) * ldc,
+                         bias,
+                         relu);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#endif  // __AVX512BF16__ && __AVX512BW__
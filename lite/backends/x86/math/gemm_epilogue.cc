@@ -0,0 +1,277 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_epilogue.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class EpilogueOp {
+  kScale,
+  kRelu,
+  kRelu6,
+  kLeakyRelu,
+  kSigmoid,
+  kTanh,
+  kSwish,
+  // the ways the tensor of an "add" is broadcast to the output
+  kAddFull,
+  kAddCol,
+  kAddRow,
+  kAddBroadcast,
+};
+
+// Whether dims broadcast to out_dims from the right.
+static bool IsBroadcast(const DDim& dims, const DDim& out_dims) {
+  if (dims.size() > out_dims.size()) return false;
+  const size_t offset = out_dims.size() - dims.size();
+  for (size_t i = 0; i < dims.size(); i++) {
+    if (dims[i] != 1 && dims[i] != out_dims[offset + i]) return false;
+  }
+  return true;
+}
+
+static EpilogueOp GetOp(const std::string& op,
+                        const lite::Tensor* tensor,
+                        const DDim& out_dims,
+                        int64_t m,
+                        int64_t n) {
+  if (op == "scale") return EpilogueOp::kScale;
+  if (op == "relu") return EpilogueOp::kRelu;
+  if (op == "relu6") return EpilogueOp::kRelu6;
+  if (op == "leaky_relu") return EpilogueOp::kLeakyRelu;
+  if (op == "sigmoid") return EpilogueOp::kSigmoid;
+  if (op == "tanh") return EpilogueOp::kTanh;
+  if (op == "swish") return EpilogueOp::kSwish;
+  CHECK_EQ(op, "add") << "Unsupported op of the epilogue";
+  CHECK(tensor) << "The add of the epilogue has no tensor";
+  const auto& dims = tensor->dims();
+  const int64_t numel = dims.production();
+  const int64_t last_dim = dims.size() ? dims[dims.size() - 1] : 1;
+  if (numel == m * n && last_dim == n) return EpilogueOp::kAddFull;
+  if (numel == n && last_dim == n) return EpilogueOp::kAddCol;
+  if (numel == m && last_dim == 1) return EpilogueOp::kAddRow;
+  // e.g. a mask of [batch, 1, 1, seq] added to the [batch, head, seq, seq]
+  // scores, which the shape check of the fuse pass lets through
+  CHECK(IsBroadcast(dims, out_dims))
+      << "The tensor " << dims << " of the epilogue can not be broadcast to "
+      << "the output " << out_dims;
+  return EpilogueOp::kAddBroadcast;
+}
+
+// The offset of the row of the tensor broadcast to each of the rows
+// [row_begin, row_end) of the output.
+static std::vector<int64_t> BroadcastRowOffsets(const DDim& dims,
+                                                const DDim& out_dims,
+                                                int64_t row_begin,
+                                                int64_t row_end) {
+  // the strides of the tensor on the dims of the output but the last, 0 on
+  // the dims it is broadcast on
+  const size_t rank = out_dims.size();
+  const size_t offset = rank - dims.size();
+  std::vector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (size_t i = rank; i-- > offset;) {
+    const int64_t dim = dims[i - offset];
+    if (i + 1 < rank && dim != 1) strides[i] = stride;
+    stride *= dim;
+  }
+  std::vector<int64_t> offsets(row_end - row_begin);
+  for (int64_t row = row_begin; row < row_end; row++) {
+    int64_t index = row;
+    int64_t y_offset = 0;
+    for (size_t i = rank - 1; i-- > 0;) {
+      y_offset += (index % out_dims[i]) * strides[i];
+      index /= out_dims[i];
+    }
+    offsets[row - row_begin] = y_offset;
+  }
+  return offsets;
+}
+
+// Below this many elements the rows are not worth splitting over threads.
+static const int64_t kParallelMinElements = 16 * 1024;
+
+static inline float sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+#ifdef __AVX__
+static inline __m256 sigmoid_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), x));
+  return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+// 2 / (1 + exp(-2x)) - 1
+static inline __m256 tanh_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp256_ps(_mm256_mul_ps(_mm256_set1_ps(-2.f), x));
+  return _mm256_sub_ps(
+      _mm256_div_ps(_mm256_set1_ps(2.f), _mm256_add_ps(one, e)), one);
+}
+#endif
+
+// Runs op on the n elements of the row x, y is the tensor of an add, which
+// steps by y_stride along the row, 0 for a single element.
+static void ApplyOp(EpilogueOp op,
+                    float alpha,
+                    float beta,
+                    const float* y,
+                    int64_t y_stride,
+                    float* x,
+                    int64_t n) {
+  int64_t j = 0;
+#ifdef __AVX__
+  const __m256 valpha = _mm256_set1_ps(alpha);
+  const __m256 vbeta = _mm256_set1_ps(beta);
+  const __m256 zero = _mm256_setzero_ps();
+  for (; j + 8 <= n; j += 8) {
+    __m256 v = _mm256_loadu_ps(x + j);
+    switch (op) {
+      case EpilogueOp::kScale:
+        v = _mm256_add_ps(_mm256_mul_ps(v, valpha), vbeta);
+        break;
+      case EpilogueOp::kRelu:
+        v = _mm256_max_ps(v, zero);
+        break;
+      case EpilogueOp::kRelu6:
+        v = _mm256_min_ps(_mm256_max_ps(v, zero), valpha);
+        break;
+      case EpilogueOp::kLeakyRelu:
+        v = _mm256_blendv_ps(_mm256_mul_ps(v, valpha),
+                             v,
+                             _mm256_cmp_ps(v, zero, _CMP_GT_OQ));
+        break;
+      case EpilogueOp::kSigmoid:
+        v = sigmoid_ps(v);
+        break;
+      case EpilogueOp::kTanh:
+        v = tanh_ps(v);
+        break;
+      case EpilogueOp::kSwish:
+        v = _mm256_mul_ps(v, sigmoid_ps(_mm256_mul_ps(valpha, v)));
+        break;
+      default:
+        v = _mm256_add_ps(
+            v, y_stride ? _mm256_loadu_ps(y + j) : _mm256_set1_ps(y[0]));
+        break;
+    }
+    _mm256_storeu_ps(x + j, v);
+  }
+#endif
+  for (; j < n; j++) {
+    switch (op) {
+      case EpilogueOp::kScale:
+        x[j] = x[j] * alpha + beta;
+        break;
+      case EpilogueOp::kRelu:
+        x[j] = std::max(x[j], 0.f);
+        break;
+      case EpilogueOp::kRelu6:
+        x[j] = std::min(std::max(x[j], 0.f), alpha);
+        break;
+      case EpilogueOp::kLeakyRelu:
+        x[j] = x[j] > 0.f ? x[j] : x[j] * alpha;
+        break;
+      case EpilogueOp::kSigmoid:
+        x[j] = sigmoid(x[j]);
+        break;
+      case EpilogueOp::kTanh:
+        x[j] = std::tanh(x[j]);
+        break;
+      case EpilogueOp::kSwish:
+        x[j] = x[j] * sigmoid(alpha * x[j]);
+        break;
+      default:
+        x[j] += y[j * y_stride];
+        break;
+    }
+  }
+}
+
+void gemm_epilogue(const operators::GemmEpilogueParam& epilogue,
+                   float* out,
+                   const DDim& out_dims,
+                   int64_t row_begin,
+                   int64_t row_end) {
+  const int64_t n = out_dims.size() ? out_dims[out_dims.size() - 1] : 1;
+  const int64_t m = n ? out_dims.production() / n : 0;
+  const size_t num_ops = epilogue.ops.size();
+  std::vector<EpilogueOp> ops(num_ops);
+  std::vector<const float*> add_data(num_ops, nullptr);
+  std::vector<std::vector<int64_t>> row_offsets(num_ops);
+  // 1 if the tensor of a broadcast add has the last dim of the output
+  std::vector<int64_t> col_strides(num_ops, 0);
+  for (size_t k = 0; k < num_ops; k++) {
+    const auto* tensor = epilogue.tensors[k];
+    ops[k] = GetOp(epilogue.ops[k], tensor, out_dims, m, n);
+    if (tensor) add_data[k] = tensor->data<float>();
+    if (ops[k] == EpilogueOp::kAddBroadcast) {
+      const auto& dims = tensor->dims();
+      row_offsets[k] =
+          BroadcastRowOffsets(dims, out_dims, row_begin, row_end);
+      col_strides[k] = dims.size() && dims[dims.size() - 1] != 1 ? 1 : 0;
+    }
+  }
+  auto apply_rows = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      float* x = out + i * n;
+      for (size_t k = 0; k < num_ops; k++) {
+        const float* y = nullptr;
+        int64_t y_stride = 1;
+        switch (ops[k]) {
+          case EpilogueOp::kAddFull:
+            y = add_data[k] + i * n;
+            break;
+          case EpilogueOp::kAddCol:
+            y = add_data[k];
+            break;
+          case EpilogueOp::kAddRow:
+            y = add_data[k] + i;
+            y_stride = 0;
+            break;
+          case EpilogueOp::kAddBroadcast:
+            y = add_data[k] + row_offsets[k][i - row_begin];
+            y_stride = col_strides[k];
+            break;
+          default:
+            break;
+        }
+        ApplyOp(
+            ops[k], epilogue.alphas[k], epilogue.betas[k], y, y_stride, x, n);
+      }
+    }
+  };
+  if ((row_end - row_begin) * n < kParallelMinElements) {
+    apply_rows(row_begin, row_end);
+  } else {
+    RunParallelFor(row_begin, row_end, apply_rows);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
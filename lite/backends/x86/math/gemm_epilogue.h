@@ -0,0 +1,38 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Applies the epilogue to the rows [row_begin, row_end) of the row major
+// output of out_dims, whose rows are of its last dim, every row goes through
+// all the ops of the chain while it is in the cache. The rows are split over
+// the threads once there are enough of them.
+void gemm_epilogue(const operators::GemmEpilogueParam& epilogue,
+                   float* out,
+                   const DDim& out_dims,
+                   int64_t row_begin,
+                   int64_t row_end);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -90,17 +90,17 @@ class generate_gemm_s8u8_x86_kern {
         cur_c = _C + loop_m * _ldc + loop_n;
 
         // kernel
-        gemm_kernel_loop_int8(min_m,
-                              min_n,
-                              _K,
-                              cur_a,
-                              _pack_B,
-                              cur_c,
-                              _ldc,
-                              _scale + loop_m,
-                              _re_bias + loop_m,
-                              _relu_type,
-                              _relu_alpha);
+        _kern(min_m,
+              min_n,
+              _K,
+              cur_a,
+              _pack_B,
+              cur_c,
+              _ldc,
+              _scale + loop_m,
+              _re_bias + loop_m,
+              _relu_type,
+              _relu_alpha);
       }
     }
   }
@@ -119,6 +119,8 @@ class generate_gemm_s8u8_x86_kern {
   const int _unroll_n = 32;
   const int _unroll_m = 2;
   const int _l2_size = 262144;  // 256K
+  // micro-kernel picked from cpu_info at init
+  gemm_s8u8_kernel_t<TYPE_C> _kern{nullptr};
   // work buffer
   TYPE_C *_C{nullptr};
   float *_Sa{nullptr};
@@ -188,6 +190,7 @@ class generate_gemm_s8u8_x86_kern {
     }
     calc_scale(M, _Sa, _Sb, _Sc, _scale);
     prepackA_i8(M, K, _A, _pack_A, _is_trans_A);
+    _kern = GetGemmS8U8Kernel<TYPE_C>(GemmS8U8BestIsa());
   }
 
   void gemm_int8_deinit() {
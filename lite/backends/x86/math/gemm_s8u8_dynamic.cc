@@ -0,0 +1,240 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_pack.h"
+#include "lite/backends/x86/parallel.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The columns of qb the micro-kernels go through while the rows of A stay
+// packed, about half of the L2 cache of the packed B.
+static const int kBlockBytes = 128 * 1024;
+static const int kUnrollN = 32;
+// Below this many multiply-adds the rows are not split over the threads.
+static const int64_t kParallelMinMacs = 1 << 18;
+
+int gemm_s8u8_dynamic_a_range() {
+#ifdef __AVX2__
+  cpu_isa_t isa = GemmS8U8BestIsa();
+  return isa == avx512_core_vnni || isa == avx512_core_amx ? 127 : 63;
+#else
+  return 127;
+#endif
+}
+
+static int AlignK(int K) {
+#ifdef __AVX2__
+  return (K + 3) / 4 * 4;
+#else
+  return K;
+#endif
+}
+
+int64_t gemm_s8u8_dynamic_packed_b_size(int N, int K) {
+  return static_cast<int64_t>(N) * AlignK(K);
+}
+
+void gemm_s8u8_dynamic_quant_b(int N,
+                               int K,
+                               const float* B,
+                               int ldb,
+                               bool trans_b,
+                               float alpha,
+                               uint8_t* qb,
+                               float* b_scales) {
+  auto b_at = [&](int k, int n) {
+    return trans_b ? B[n * ldb + k] : B[k * ldb + n];
+  };
+  // K x N row-major s8
+  std::vector<int8_t> q(static_cast<size_t>(K) * N);
+  for (int n = 0; n < N; n++) {
+    float abs_max = 0.f;
+    for (int k = 0; k < K; k++) {
+      abs_max = std::max(abs_max, std::fabs(b_at(k, n)));
+    }
+    float scale = abs_max / 127.f;
+    float inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+    for (int k = 0; k < K; k++) {
+      q[k * N + n] = static_cast<int8_t>(std::round(b_at(k, n) * inv_scale));
+    }
+    b_scales[n] = scale * alpha;
+  }
+#ifdef __AVX2__
+  gemm_s8u8s8_runpackB(N, K, N, q.data(), qb, false);
+#else
+  for (size_t i = 0; i < q.size(); i++) {
+    qb[i] = static_cast<uint8_t>(q[i] + TRANS_INT8_UINT8_OFFT);
+  }
+#endif
+}
+
+// Quantizes the n floats of a by their abs max to q, returns the scale and
+// the sum of q.
+static float QuantRow(const float* a, int n, float range, int8_t* q, int* sum) {
+  int k = 0;
+  float abs_max = 0.f;
+#ifdef __AVX2__
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 vmax = _mm256_setzero_ps();
+  for (; k + 8 <= n; k += 8) {
+    vmax = _mm256_max_ps(vmax,
+                         _mm256_andnot_ps(sign_mask, _mm256_loadu_ps(a + k)));
+  }
+  __m128 m4 = _mm_max_ps(_mm256_castps256_ps128(vmax),
+                         _mm256_extractf128_ps(vmax, 1));
+  m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+  m4 = _mm_max_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+  abs_max = _mm_cvtss_f32(m4);
+#endif
+  for (; k < n; k++) abs_max = std::max(abs_max, std::fabs(a[k]));
+  const float scale = abs_max / range;
+  const float inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+  // rounded to nearest even, as cvtps does
+  k = 0;
+  int total = 0;
+#ifdef __AVX2__
+  const __m256 vinv = _mm256_set1_ps(inv_scale);
+  __m256i vsum = _mm256_setzero_si256();
+  for (; k + 8 <= n; k += 8) {
+    __m256i v = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(a + k), vinv));
+    vsum = _mm256_add_epi32(vsum, v);
+    __m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                  _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(q + k),
+                     _mm_packs_epi16(v16, v16));
+  }
+  __m128i s4 = _mm_add_epi32(_mm256_castsi256_si128(vsum),
+                             _mm256_extracti128_si256(vsum, 1));
+  s4 = _mm_hadd_epi32(s4, s4);
+  s4 = _mm_hadd_epi32(s4, s4);
+  total = _mm_cvtsi128_si32(s4);
+#endif
+  for (; k < n; k++) {
+    q[k] = static_cast<int8_t>(std::nearbyint(a[k] * inv_scale));
+    total += q[k];
+  }
+  *sum = total;
+  return scale;
+}
+
+// c = c * b_scales + bias, then relu, on the n floats of a row.
+static void DequantRow(
+    float* c, int n, const float* b_scales, const float* bias, bool relu) {
+  int j = 0;
+#ifdef __AVX2__
+  const __m256 zero = _mm256_setzero_ps();
+  for (; j + 8 <= n; j += 8) {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(c + j),
+                             _mm256_loadu_ps(b_scales + j));
+    if (bias) v = _mm256_add_ps(v, _mm256_loadu_ps(bias + j));
+    if (relu) v = _mm256_max_ps(v, zero);
+    _mm256_storeu_ps(c + j, v);
+  }
+#endif
+  for (; j < n; j++) {
+    float x = c[j] * b_scales[j] + (bias ? bias[j] : 0.f);
+    c[j] = relu ? std::max(x, 0.f) : x;
+  }
+}
+
+void gemm_s8u8_dynamic(int M,
+                       int N,
+                       int K,
+                       const float* A,
+                       int lda,
+                       const uint8_t* qb,
+                       const float* b_scales,
+                       float* C,
+                       int ldc,
+                       const float* bias,
+                       bool relu) {
+  if (M <= 0 || N <= 0) return;
+  const float range = gemm_s8u8_dynamic_a_range();
+  const int k_align = AlignK(K);
+#ifdef __AVX2__
+  auto kern = GetGemmS8U8Kernel<float>(GemmS8U8BestIsa());
+  const int block_n = std::max(
+      kUnrollN, kBlockBytes / std::max(k_align, 1) / kUnrollN * kUnrollN);
+#endif
+
+  // the rows [begin, end), quantized, multiplied and scaled back while they
+  // are in the cache
+  auto compute_rows = [&](int64_t begin, int64_t end) {
+    const int rows = static_cast<int>(end - begin);
+    std::vector<int8_t> qa(static_cast<size_t>(rows) * K);
+    std::vector<float> a_scales(rows);
+    // minus the 128 added to qb times the sum of the row, in C
+    std::vector<float> offsets(rows);
+    for (int i = 0; i < rows; i++) {
+      int sum = 0;
+      a_scales[i] =
+          QuantRow(A + (begin + i) * lda, K, range, qa.data() + i * K, &sum);
+      offsets[i] = -a_scales[i] * TRANS_INT8_UINT8_OFFT * sum;
+    }
+    float* c_rows = C + begin * ldc;
+#ifdef __AVX2__
+    // C = a_scales * sum(qa * (qb + 128)) + offsets, the scales of the
+    // columns go below
+    std::vector<int8_t> pack_a(static_cast<size_t>(rows) * k_align, 0);
+    gemm_s8u8s8_prepackA(rows, K, qa.data(), pack_a.data(), false);
+    for (int n = 0; n < N; n += block_n) {
+      kern(rows,
+           std::min(block_n, N - n),
+           K,
+           pack_a.data(),
+           const_cast<uint8_t*>(qb) + static_cast<int64_t>(n) * k_align,
+           c_rows + n,
+           ldc,
+           a_scales.data(),
+           offsets.data(),
+           0,
+           0.f);
+    }
+#else
+    for (int i = 0; i < rows; i++) {
+      const int8_t* q = qa.data() + i * K;
+      for (int n = 0; n < N; n++) {
+        int32_t sum = 0;
+        for (int k = 0; k < K; k++) sum += q[k] * qb[k * N + n];
+        c_rows[i * ldc + n] = a_scales[i] * sum + offsets[i];
+      }
+    }
+#endif
+    for (int i = 0; i < rows; i++) {
+      DequantRow(c_rows + i * ldc, N, b_scales, bias, relu);
+    }
+  };
+  if (static_cast<int64_t>(M) * N * K < kParallelMinMacs) {
+    compute_rows(0, M);
+  } else {
+    RunParallelFor(0, M, compute_rows);
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
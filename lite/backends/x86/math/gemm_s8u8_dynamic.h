@@ -0,0 +1,69 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The int8 gemm of the fp32 fc/mul/matmul with dynamic quantization, which
+// needs no calibration: B, the weight, is quantized per column once, the
+// rows of A are quantized at every run by their abs max, gemm_s8u8
+// multiplies them and the int32 sums are scaled back to fp32 by the scales
+// of the row and of the column.
+
+// The largest |A| quantized, 127 with vpdpbusd. vpmaddubsw adds two s8 * u8
+// products in int16, which saturates above 2 * 63 * 255, so the kernels
+// without vnni get 7 bits of A.
+int gemm_s8u8_dynamic_a_range();
+
+// Number of bytes of the B quantized by gemm_s8u8_dynamic_quant_b, K is
+// padded to 4 for the kernels of gemm_s8u8_pack.h.
+int64_t gemm_s8u8_dynamic_packed_b_size(int N, int K);
+
+// Quantizes B per column and packs it once to qb, as u8 (s8 + 128) in the
+// layout gemm_s8u8_dynamic reads, and the N scales of its columns to
+// b_scales. B is K x N, or N x K when trans_b, fp32. alpha is folded into
+// the scales.
+void gemm_s8u8_dynamic_quant_b(int N,
+                               int K,
+                               const float* B,
+                               int ldb,
+                               bool trans_b,
+                               float alpha,
+                               uint8_t* qb,
+                               float* b_scales);
+
+// C = A * B (+ bias) (relu), A is M x K fp32, B comes from
+// gemm_s8u8_dynamic_quant_b. The rows of A are split over the threads.
+void gemm_s8u8_dynamic(int M,
+                       int N,
+                       int K,
+                       const float* A,
+                       int lda,
+                       const uint8_t* qb,
+                       const float* b_scales,
+                       float* C,
+                       int ldc,
+                       const float* bias,
+                       bool relu);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -15,12 +15,29 @@ limitations under the License. */
 #pragma once
 
 #include <stdint.h>
+#include "lite/backends/x86/cpu_info.h"
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
 
+// All micro-kernels below share one signature and the packed layout
+// of gemm_s8u8_pack.h, A is s8 and B is u8 (s8 + TRANS_INT8_UINT8_OFFT).
+template <typename TYPE_C>
+using gemm_s8u8_kernel_t = void (*)(int M,
+                                    int N,
+                                    int K,
+                                    int8_t* A,
+                                    uint8_t* B,
+                                    TYPE_C* C,
+                                    int ldc,
+                                    const float* scale,
+                                    const float* bias,
+                                    int relu_type,
+                                    float relu_alpha);
+
+// avx2, vpmaddubsw + vpmaddwd
 void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
@@ -45,6 +62,115 @@ void gemm_kernel_loop_int8(int M,
                            int relu_type,
                            float relu_alpha);
 
+// avx512bw, 32-column tiles on zmm
+void gemm_kernel_loop_int8_avx512(int M,
+                                  int N,
+                                  int K,
+                                  int8_t* A,
+                                  uint8_t* B,
+                                  int8_t* C,
+                                  int ldc,
+                                  const float* scale,
+                                  const float* bias,
+                                  int relu_type,
+                                  float relu_alpha);
+
+void gemm_kernel_loop_int8_avx512(int M,
+                                  int N,
+                                  int K,
+                                  int8_t* A,
+                                  uint8_t* B,
+                                  float* C,
+                                  int ldc,
+                                  const float* scale,
+                                  const float* bias,
+                                  int relu_type,
+                                  float relu_alpha);
+
+// avx512-vnni, vpdpbusd
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                int8_t* A,
+                                uint8_t* B,
+                                int8_t* C,
+                                int ldc,
+                                const float* scale,
+                                const float* bias,
+                                int relu_type,
+                                float relu_alpha);
+
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                int8_t* A,
+                                uint8_t* B,
+                                float* C,
+                                int ldc,
+                                const float* scale,
+                                const float* bias,
+                                int relu_type,
+                                float relu_alpha);
+
+// amx-int8 tiles for 16x32 blocks, vnni for the remainder
+void gemm_kernel_loop_int8_amx(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               int8_t* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha);
+
+void gemm_kernel_loop_int8_amx(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               float* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha);
+
+// scalar reference, used to check the other kernels
+void gemm_kernel_loop_int8_ref(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               int8_t* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha);
+
+void gemm_kernel_loop_int8_ref(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               float* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha);
+
+// The fastest isa among avx512_core_amx, avx512_core_vnni, avx512_core and
+// avx2 that is both compiled in and supported by the running cpu.
+cpu_isa_t GemmS8U8BestIsa();
+
+// Micro-kernel of the given isa, isa_any gives the scalar reference.
+// Returns nullptr if that isa is not compiled in or not supported.
+template <typename TYPE_C>
+gemm_s8u8_kernel_t<TYPE_C> GetGemmS8U8Kernel(cpu_isa_t isa);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -0,0 +1,251 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Built with -mavx512bw -mavx512vl -mavx512vnni -mamx-tile -mamx-int8,
+// see lite/backends/x86/CMakeLists.txt.
+#if defined(__AVX512VNNI__) && defined(__AMX_TILE__) && defined(__AMX_INT8__)
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include "lite/core/memory.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// AMX blocking: a 16 x 32 block of C is two 16 x 16 int32 tiles, fed by
+// one A tile (16 rows x 64 int8) and two B tiles (16 K4 rows x 16 columns).
+// The 32-column tiles of the packed B are already in the K4 x N layout AMX
+// expects, only A is re-laid from row pairs to plain rows here.
+#define AMX_TILE_M 16
+#define AMX_TILE_N 32
+#define AMX_TILE_K 64
+
+#define TMM_C0 0
+#define TMM_C1 1
+#define TMM_A 2
+#define TMM_B0 3
+#define TMM_B1 4
+
+struct amx_tile_config_t {
+  uint8_t palette_id;
+  uint8_t start_row;
+  uint8_t reserved[14];
+  uint16_t colsb[16];
+  uint8_t rows[16];
+};
+
+static void amx_tile_config() {
+  alignas(64) amx_tile_config_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.palette_id = 1;
+  const int tiles[] = {TMM_C0, TMM_C1, TMM_A, TMM_B0, TMM_B1};
+  for (int t : tiles) {
+    cfg.rows[t] = 16;
+    cfg.colsb[t] = 64;
+  }
+  _tile_loadconfig(&cfg);
+}
+
+// rows [m, m + 16) of the row-pair packed A into 16 plain rows of k_pad bytes
+static void amx_repack_a(
+    const int8_t* A, int m, int k_loop, int k_pad, int8_t* out) {
+  memset(out, 0, AMX_TILE_M * k_pad);
+  const int pack_k = k_loop * 4;
+  for (int r = 0; r < AMX_TILE_M; r += 2) {
+    const int8_t* pair = A + (m + r) * pack_k;
+    int8_t* row0 = out + r * k_pad;
+    int8_t* row1 = row0 + k_pad;
+    for (int k = 0; k < k_loop; k++) {
+      memcpy(row0 + k * 4, pair + k * 8, 4);
+      memcpy(row1 + k * 4, pair + k * 8 + 4, 4);
+    }
+  }
+}
+
+static inline __m512 amx_act(__m512 v, int relu_type, __m512 alpha) {
+  const __m512 zero = _mm512_setzero_ps();
+  switch (relu_type) {
+    case 1:
+      return _mm512_max_ps(v, zero);
+    case 2:
+      return _mm512_min_ps(_mm512_max_ps(v, zero), alpha);
+    case 3: {
+      __mmask16 neg = _mm512_cmp_ps_mask(v, zero, _CMP_LE_OS);
+      return _mm512_mask_mul_ps(v, neg, v, alpha);
+    }
+    default:
+      return v;
+  }
+}
+
+static inline void amx_store(__m512 v, int8_t* dst) {
+  __m512i iv = _mm512_cvtps_epi32(v);
+  iv = _mm512_min_epi32(_mm512_max_epi32(iv, _mm512_set1_epi32(-127)),
+                        _mm512_set1_epi32(127));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm512_cvtepi32_epi8(iv));
+}
+
+static inline void amx_store(__m512 v, float* dst) { _mm512_storeu_ps(dst, v); }
+
+template <typename TYPE_C>
+static void gemm_kernel_loop_int8_amx_impl(int M,
+                                           int N,
+                                           int K,
+                                           int8_t* A,
+                                           uint8_t* B,
+                                           TYPE_C* C,
+                                           int ldc,
+                                           const float* scale,
+                                           const float* bias,
+                                           int relu_type,
+                                           float relu_alpha) {
+  const int k_loop = (K + 3) >> 2;
+  const int pack_k = k_loop << 2;
+  const int k_pad = (pack_k + AMX_TILE_K - 1) / AMX_TILE_K * AMX_TILE_K;
+  const int k4_blk = AMX_TILE_K / 4;
+  const int m_amx = M / AMX_TILE_M * AMX_TILE_M;
+  const int n_amx = N / AMX_TILE_N * AMX_TILE_N;
+  if (m_amx == 0 || n_amx == 0) {
+    gemm_kernel_loop_int8_vnni(
+        M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+    return;
+  }
+
+  int8_t* a_buf = reinterpret_cast<int8_t*>(
+      TargetMalloc(TARGET(kX86), AMX_TILE_M * k_pad));
+  alignas(64) uint8_t b_tail[k4_blk * AMX_TILE_N * 4];
+  alignas(64) int32_t c_buf[AMX_TILE_M * AMX_TILE_N];
+  const __m512 vec_alpha = _mm512_set1_ps(relu_alpha);
+
+  amx_tile_config();
+  for (int m = 0; m < m_amx; m += AMX_TILE_M) {
+    amx_repack_a(A, m, k_loop, k_pad, a_buf);
+    const uint8_t* b_tile = B;
+    for (int n = 0; n < n_amx; n += AMX_TILE_N) {
+      _tile_zero(TMM_C0);
+      _tile_zero(TMM_C1);
+      for (int k = 0; k < k_loop; k += k4_blk) {
+        const uint8_t* b_ptr = b_tile + k * AMX_TILE_N * 4;
+        if (k + k4_blk > k_loop) {
+          // the A tail is zero padded, only keep B reads inside the buffer
+          memset(b_tail, 0, sizeof(b_tail));
+          memcpy(b_tail, b_ptr, (k_loop - k) * AMX_TILE_N * 4);
+          b_ptr = b_tail;
+        }
+        _tile_loadd(TMM_A, a_buf + k * 4, k_pad);
+        _tile_loadd(TMM_B0, b_ptr, AMX_TILE_N * 4);
+        _tile_loadd(TMM_B1, b_ptr + 64, AMX_TILE_N * 4);
+        _tile_dpbsud(TMM_C0, TMM_A, TMM_B0);
+        _tile_dpbsud(TMM_C1, TMM_A, TMM_B1);
+      }
+      _tile_stored(TMM_C0, c_buf, AMX_TILE_N * 4);
+      _tile_stored(TMM_C1, c_buf + 16, AMX_TILE_N * 4);
+
+      for (int r = 0; r < AMX_TILE_M; r++) {
+        const __m512 vec_scale = _mm512_set1_ps(scale[m + r]);
+        const __m512 vec_bias = _mm512_set1_ps(bias[m + r]);
+        TYPE_C* c_ptr = C + (m + r) * ldc + n;
+        for (int j = 0; j < AMX_TILE_N; j += 16) {
+          __m512 v = _mm512_cvtepi32_ps(
+              _mm512_load_si512(c_buf + r * AMX_TILE_N + j));
+          v = _mm512_fmadd_ps(v, vec_scale, vec_bias);
+          amx_store(amx_act(v, relu_type, vec_alpha), c_ptr + j);
+        }
+      }
+      b_tile += AMX_TILE_N * pack_k;
+    }
+  }
+  _tile_release();
+  TargetFree(TARGET(kX86), a_buf);
+
+  // columns left after the 32-wide tiles, then rows left after the 16-row
+  // blocks, both on the avx512-vnni kernel
+  if (n_amx < N) {
+    gemm_kernel_loop_int8_vnni(m_amx,
+                               N - n_amx,
+                               K,
+                               A,
+                               B + n_amx * pack_k,
+                               C + n_amx,
+                               ldc,
+                               scale,
+                               bias,
+                               relu_type,
+                               relu_alpha);
+  }
+  if (m_amx < M) {
+    gemm_kernel_loop_int8_vnni(M - m_amx,
+                               N,
+                               K,
+                               A + m_amx * pack_k,
+                               B,
+                               C + m_amx * ldc,
+                               ldc,
+                               scale + m_amx,
+                               bias + m_amx,
+                               relu_type,
+                               relu_alpha);
+  }
+}
+
+void gemm_kernel_loop_int8_amx(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               int8_t* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha) {
+  gemm_kernel_loop_int8_amx_impl<int8_t>(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+void gemm_kernel_loop_int8_amx(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               float* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha) {
+  gemm_kernel_loop_int8_amx_impl<float>(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+#undef AMX_TILE_M
+#undef AMX_TILE_N
+#undef AMX_TILE_K
+#undef TMM_C0
+#undef TMM_C1
+#undef TMM_A
+#undef TMM_B0
+#undef TMM_B1
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#endif  // __AVX512VNNI__ && __AMX_TILE__ && __AMX_INT8__
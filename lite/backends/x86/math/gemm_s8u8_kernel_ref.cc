@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <stdint.h>
+#include <algorithm>
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Plain C++ version of the micro-kernel working on the same packed layout:
+// A is packed by row pairs (K4 of row 0, K4 of row 1, ...), a trailing odd
+// row by itself; B is packed in column tiles of 32/24/16/8/4/2/1, each tile
+// stored as K4 x tile_n.
+template <typename TYPE_C>
+static void gemm_kernel_loop_int8_ref_impl(int M,
+                                           int N,
+                                           int K,
+                                           const int8_t* A,
+                                           const uint8_t* B,
+                                           TYPE_C* C,
+                                           int ldc,
+                                           const float* scale,
+                                           const float* bias,
+                                           int relu_type,
+                                           float relu_alpha) {
+  const int tile_n[] = {32, 24, 16, 8, 4, 2, 1};
+  int k_loop = (K + 3) >> 2;
+  int pack_k = k_loop << 2;
+  for (int m = 0; m < M; m += 2) {
+    int rows = std::min(2, M - m);
+    const int8_t* a_blk = A + m * pack_k;
+    const uint8_t* b_tile = B;
+    int n = 0;
+    for (int t : tile_n) {
+      for (; n + t <= N; n += t) {
+        for (int r = 0; r < rows; r++) {
+          for (int j = 0; j < t; j++) {
+            int acc = 0;
+            for (int k = 0; k < k_loop; k++) {
+              const int8_t* a_k = a_blk + k * rows * 4 + r * 4;
+              const uint8_t* b_k = b_tile + k * t * 4 + j * 4;
+              for (int i = 0; i < 4; i++) {
+                acc += static_cast<int>(a_k[i]) * static_cast<int>(b_k[i]);
+              }
+            }
+            float val = acc * scale[m + r] + bias[m + r];
+            switch (relu_type) {
+              case 1:
+                val = std::max(val, 0.f);
+                break;
+              case 2:
+                val = std::min(std::max(val, 0.f), relu_alpha);
+                break;
+              case 3:
+                val = val > 0.f ? val : relu_alpha * val;
+                break;
+              default:
+                break;
+            }
+            TYPE_C* c_ptr = C + (m + r) * ldc + n + j;
+            if (sizeof(TYPE_C) == 1) {
+              int ival = val > 0 ? static_cast<int>(val + 0.5f)
+                                 : static_cast<int>(val - 0.5f);
+              *c_ptr = static_cast<TYPE_C>(std::min(std::max(ival, -127), 127));
+            } else {
+              *c_ptr = static_cast<TYPE_C>(val);
+            }
+          }
+        }
+        b_tile += t * pack_k;
+      }
+    }
+  }
+}
+
+void gemm_kernel_loop_int8_ref(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               int8_t* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha) {
+  gemm_kernel_loop_int8_ref_impl<int8_t>(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+void gemm_kernel_loop_int8_ref(int M,
+                               int N,
+                               int K,
+                               int8_t* A,
+                               uint8_t* B,
+                               float* C,
+                               int ldc,
+                               const float* scale,
+                               const float* bias,
+                               int relu_type,
+                               float relu_alpha) {
+  gemm_kernel_loop_int8_ref_impl<float>(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
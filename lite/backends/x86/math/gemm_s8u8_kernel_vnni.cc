@@ -0,0 +1,27 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Built with -mavx512bw -mavx512vl -mavx512vnni,
+// see lite/backends/x86/CMakeLists.txt.
+#if defined(__AVX512BW__) && defined(__AVX512VL__) && defined(__AVX512VNNI__)
+
+#define GEMM_S8U8_KERNEL_NAME gemm_kernel_loop_int8_vnni
+#define GEMM_S8U8_WITH_AVX512
+#define GEMM_S8U8_WITH_VNNI
+#include "lite/backends/x86/math/gemm_s8u8_kernel_impl.h"
+#undef GEMM_S8U8_WITH_VNNI
+#undef GEMM_S8U8_WITH_AVX512
+#undef GEMM_S8U8_KERNEL_NAME
+
+#endif  // __AVX512BW__ && __AVX512VL__ && __AVX512VNNI__
@@ -0,0 +1,192 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/layer_norm.h"
+#include <cmath>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// s = x + residual stored to dst when residual is given, returns the source
+// of the second pass. mean and m2 are the Welford mean and sum of squared
+// deviations for the layer norm, or mean of s * s for the rms norm.
+template <bool kRms>
+static inline const float* norm_row_stats(const float* x,
+                                          const float* residual,
+                                          float* dst,
+                                          int n,
+                                          float* mean,
+                                          float* m2) {
+  const float* src = residual ? dst : x;
+  int i = 0;
+  float row_mean = 0.f;
+  float row_m2 = 0.f;
+#ifdef __AVX__
+  if (n >= 8) {
+    __m256 vec_mean = _mm256_setzero_ps();
+    __m256 vec_m2 = _mm256_setzero_ps();
+    int count = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 vec_s = _mm256_loadu_ps(x + i);
+      if (residual) {
+        vec_s = _mm256_add_ps(vec_s, _mm256_loadu_ps(residual + i));
+        _mm256_storeu_ps(dst + i, vec_s);
+      }
+      if (kRms) {
+        vec_m2 = _mm256_add_ps(vec_m2, _mm256_mul_ps(vec_s, vec_s));
+      } else {
+        count++;
+        __m256 vec_delta = _mm256_sub_ps(vec_s, vec_mean);
+        vec_mean = _mm256_add_ps(
+            vec_mean,
+            _mm256_mul_ps(vec_delta, _mm256_set1_ps(1.f / count)));
+        vec_m2 = _mm256_add_ps(
+            vec_m2,
+            _mm256_mul_ps(vec_delta, _mm256_sub_ps(vec_s, vec_mean)));
+      }
+    }
+    float lane_mean[8];
+    float lane_m2[8];
+    _mm256_storeu_ps(lane_mean, vec_mean);
+    _mm256_storeu_ps(lane_m2, vec_m2);
+    // every lane has seen the same number of elements
+    for (int l = 0; l < 8; l++) {
+      row_mean += lane_mean[l];
+      row_m2 += lane_m2[l];
+    }
+    if (!kRms) {
+      row_mean *= 0.125f;
+      for (int l = 0; l < 8; l++) {
+        const float d = lane_mean[l] - row_mean;
+        row_m2 += d * d * count;
+      }
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    const float s = residual ? x[i] + residual[i] : x[i];
+    if (residual) {
+      dst[i] = s;
+    }
+    if (kRms) {
+      row_m2 += s * s;
+    } else {
+      const float delta = s - row_mean;
+      row_mean += delta / (i + 1);
+      row_m2 += delta * (s - row_mean);
+    }
+  }
+  *mean = row_mean;
+  *m2 = row_m2;
+  return src;
+}
+
+// y = (s - mean) * rstd * scale + bias
+static inline void norm_row_apply(const float* s,
+                                  const float* scale,
+                                  const float* bias,
+                                  float mean,
+                                  float rstd,
+                                  float* y,
+                                  int n) {
+  int i = 0;
+#ifdef __AVX__
+  __m256 vec_mean = _mm256_set1_ps(mean);
+  __m256 vec_rstd = _mm256_set1_ps(rstd);
+  for (; i + 8 <= n; i += 8) {
+    __m256 vec_y = _mm256_mul_ps(
+        _mm256_sub_ps(_mm256_loadu_ps(s + i), vec_mean), vec_rstd);
+    if (scale) {
+      vec_y = _mm256_mul_ps(vec_y, _mm256_loadu_ps(scale + i));
+    }
+    if (bias) {
+      vec_y = _mm256_add_ps(vec_y, _mm256_loadu_ps(bias + i));
+    }
+    _mm256_storeu_ps(y + i, vec_y);
+  }
+#endif
+  for (; i < n; i++) {
+    float out = (s[i] - mean) * rstd;
+    if (scale) out *= scale[i];
+    if (bias) out += bias[i];
+    y[i] = out;
+  }
+}
+
+template <bool kRms>
+static void add_norm(const float* x,
+                     const float* residual,
+                     int64_t residual_stride,
+                     const float* scale,
+                     const float* bias,
+                     float* y,
+                     float* sum,
+                     int rows,
+                     int n,
+                     float epsilon) {
+#pragma omp parallel for
+  for (int r = 0; r < rows; r++) {
+    const int64_t offset = static_cast<int64_t>(r) * n;
+    float* y_row = y + offset;
+    float mean = 0.f;
+    float m2 = 0.f;
+    const float* s = norm_row_stats<kRms>(
+        x + offset,
+        residual ? residual + r * residual_stride : nullptr,
+        sum ? sum + offset : y_row,
+        n,
+        &mean,
+        &m2);
+    const float rstd = 1.f / std::sqrt(m2 / n + epsilon);
+    norm_row_apply(s, scale, bias, kRms ? 0.f : mean, rstd, y_row, n);
+  }
+}
+
+void add_layer_norm(const float* x,
+                    const float* residual,
+                    int64_t residual_stride,
+                    const float* scale,
+                    const float* bias,
+                    float* y,
+                    float* sum,
+                    int rows,
+                    int n,
+                    float epsilon) {
+  add_norm<false>(
+      x, residual, residual_stride, scale, bias, y, sum, rows, n, epsilon);
+}
+
+void add_rms_norm(const float* x,
+                  const float* residual,
+                  int64_t residual_stride,
+                  const float* scale,
+                  const float* bias,
+                  float* y,
+                  float* sum,
+                  int rows,
+                  int n,
+                  float epsilon) {
+  add_norm<true>(
+      x, residual, residual_stride, scale, bias, y, sum, rows, n, epsilon);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
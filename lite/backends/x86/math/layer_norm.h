@@ -0,0 +1,57 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// y = (s - mean(s)) / sqrt(var(s) + epsilon) * scale + bias for each row of
+// s = x + residual: [rows, n]. The mean and variance of a row are gathered in
+// one pass with Welford's algorithm. residual is optional, residual_stride is
+// n for a residual of [rows, n] and 0 for one row shared by all rows. sum is
+// optional and receives s when it is used elsewhere. scale and bias are
+// optional as well. Runs in parallel over the rows.
+void add_layer_norm(const float* x,
+                    const float* residual,
+                    int64_t residual_stride,
+                    const float* scale,
+                    const float* bias,
+                    float* y,
+                    float* sum,
+                    int rows,
+                    int n,
+                    float epsilon);
+
+// Same as add_layer_norm with y = s / sqrt(mean(s * s) + epsilon) * scale +
+// bias, i.e. RMSNorm.
+void add_rms_norm(const float* x,
+                  const float* residual,
+                  int64_t residual_stride,
+                  const float* scale,
+                  const float* bias,
+                  float* y,
+                  float* sum,
+                  int rows,
+                  int n,
+                  float epsilon);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,378 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/reduce.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Reductions are memory bound, below this many elements waking the threads
+// up costs more than it saves.
+#define REDUCE_PARALLEL_MIN_SIZE 32768
+// the rows are reduced pairwise down to blocks of this many elements
+#define REDUCE_PAIRWISE_BLOCK 256
+// the inner dim is reduced in tiles of this many columns
+#define REDUCE_TILE 64
+
+template <typename T>
+struct SumOp {
+  static T init() { return static_cast<T>(0); }
+  static T apply(T a, T b) { return a + b; }
+#ifdef __AVX__
+  static __m256 apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+#endif
+};
+
+template <typename T>
+struct ProdOp {
+  static T init() { return static_cast<T>(1); }
+  static T apply(T a, T b) { return a * b; }
+#ifdef __AVX__
+  static __m256 apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+};
+
+template <typename T>
+struct MaxOp {
+  static T init() { return std::numeric_limits<T>::lowest(); }
+  static T apply(T a, T b) { return a > b ? a : b; }
+#ifdef __AVX__
+  static __m256 apply(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+#endif
+};
+
+template <typename T>
+struct MinOp {
+  static T init() { return (std::numeric_limits<T>::max)(); }
+  static T apply(T a, T b) { return a < b ? a : b; }
+#ifdef __AVX__
+  static __m256 apply(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+#endif
+};
+
+template <class Op, typename T>
+struct Reducer {
+  // op over x[0, n)
+  static T Row(const T* x, int64_t n) {
+    T acc[4] = {Op::init(), Op::init(), Op::init(), Op::init()};
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      for (int j = 0; j < 4; ++j) {
+        acc[j] = Op::apply(acc[j], x[i + j]);
+      }
+    }
+    for (; i < n; ++i) {
+      acc[0] = Op::apply(acc[0], x[i]);
+    }
+    return Op::apply(Op::apply(acc[0], acc[1]), Op::apply(acc[2], acc[3]));
+  }
+
+  // dst[j] = op(dst[j], x[0][j], ..., x[rows - 1][j]) for j < n, the rows
+  // are ld apart
+  static void Cols(const T* x, int64_t ld, int64_t rows, int64_t n, T* dst) {
+    for (int64_t k = 0; k < rows; ++k) {
+      for (int64_t j = 0; j < n; ++j) {
+        dst[j] = Op::apply(dst[j], x[k * ld + j]);
+      }
+    }
+  }
+};
+
+#ifdef __AVX__
+template <class Op>
+struct Reducer<Op, float> {
+  static float Row(const float* x, int64_t n) {
+    const __m256 init = _mm256_set1_ps(Op::init());
+    __m256 acc0 = init;
+    __m256 acc1 = init;
+    __m256 acc2 = init;
+    __m256 acc3 = init;
+    int64_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+      acc0 = Op::apply(acc0, _mm256_loadu_ps(x + i));
+      acc1 = Op::apply(acc1, _mm256_loadu_ps(x + i + 8));
+      acc2 = Op::apply(acc2, _mm256_loadu_ps(x + i + 16));
+      acc3 = Op::apply(acc3, _mm256_loadu_ps(x + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) {
+      acc0 = Op::apply(acc0, _mm256_loadu_ps(x + i));
+    }
+    acc0 = Op::apply(Op::apply(acc0, acc1), Op::apply(acc2, acc3));
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc0);
+    float res = Op::apply(Op::apply(Op::apply(lanes[0], lanes[1]),
+                                    Op::apply(lanes[2], lanes[3])),
+                          Op::apply(Op::apply(lanes[4], lanes[5]),
+                                    Op::apply(lanes[6], lanes[7])));
+    for (; i < n; ++i) {
+      res = Op::apply(res, x[i]);
+    }
+    return res;
+  }
+
+  static void Cols(
+      const float* x, int64_t ld, int64_t rows, int64_t n, float* dst) {
+    int64_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+      __m256 acc0 = _mm256_loadu_ps(dst + j);
+      __m256 acc1 = _mm256_set1_ps(Op::init());
+      int64_t k = 0;
+      for (; k + 2 <= rows; k += 2) {
+        acc0 = Op::apply(acc0, _mm256_loadu_ps(x + k * ld + j));
+        acc1 = Op::apply(acc1, _mm256_loadu_ps(x + (k + 1) * ld + j));
+      }
+      if (k < rows) {
+        acc0 = Op::apply(acc0, _mm256_loadu_ps(x + k * ld + j));
+      }
+      _mm256_storeu_ps(dst + j, Op::apply(acc0, acc1));
+    }
+    for (; j < n; ++j) {
+      for (int64_t k = 0; k < rows; ++k) {
+        dst[j] = Op::apply(dst[j], x[k * ld + j]);
+      }
+    }
+  }
+};
+#endif
+
+// op over x[0, n), the halves are reduced apart down to the blocks so that
+// the rounding error of a sum grows with log(n) rather than n
+template <class Op, typename T>
+static T ReduceRow(const T* x, int64_t n) {
+  if (n <= REDUCE_PAIRWISE_BLOCK) {
+    return Reducer<Op, T>::Row(x, n);
+  }
+  const int64_t half = (n / 2 + 7) / 8 * 8;
+  return Op::apply(ReduceRow<Op>(x, half), ReduceRow<Op>(x + half, n - half));
+}
+
+// dst[j] = op over k < rows of x[k * ld + j] for j < n <= REDUCE_TILE, the
+// blocks of rows are reduced apart and then added to dst
+template <class Op, typename T>
+static void ReduceCols(
+    const T* x, int64_t ld, int64_t rows, int64_t n, T* dst) {
+  T block[REDUCE_TILE];
+  std::fill(dst, dst + n, Op::init());
+  for (int64_t k = 0; k < rows; k += REDUCE_PAIRWISE_BLOCK) {
+    std::fill(block, block + n, Op::init());
+    Reducer<Op, T>::Cols(x + k * ld,
+                         ld,
+                         (std::min<int64_t>)(REDUCE_PAIRWISE_BLOCK, rows - k),
+                         n,
+                         block);
+    for (int64_t j = 0; j < n; ++j) {
+      dst[j] = Op::apply(dst[j], block[j]);
+    }
+  }
+}
+
+// out[o][j] = op over k < r of in[o][k][j]
+template <class Op, typename T>
+static void ReduceOuterInner(
+    const T* in, T* out, int64_t outer, int64_t r, int64_t inner) {
+  const int64_t tiles = (inner + REDUCE_TILE - 1) / REDUCE_TILE;
+  const int64_t items = outer * tiles;
+  // the rows [k_begin, k_end) of one tile of one outer index into dst
+  auto reduce_item = [&](int64_t item, int64_t k_begin, int64_t k_end, T* dst) {
+    const int64_t o = item / tiles;
+    const int64_t j = (item % tiles) * REDUCE_TILE;
+    const T* src = in + (o * r + k_begin) * inner + j;
+    T* dst_item = dst + o * inner + j;
+    if (inner == 1) {
+      *dst_item = ReduceRow<Op>(src, k_end - k_begin);
+    } else {
+      ReduceCols<Op>(src,
+                     inner,
+                     k_end - k_begin,
+                     (std::min<int64_t>)(REDUCE_TILE, inner - j),
+                     dst_item);
+    }
+  };
+
+  const int64_t threads = GetMaxThreads();
+  const bool parallel = outer * r * inner >= REDUCE_PARALLEL_MIN_SIZE;
+  if (!parallel || items >= threads || r < 2 * threads) {
+    auto run = [&](int64_t begin, int64_t end) {
+      for (int64_t item = begin; item < end; ++item) {
+        reduce_item(item, 0, r, out);
+      }
+    };
+    if (parallel) {
+      RunParallelFor(0, items, run);
+    } else {
+      run(0, items);
+    }
+    return;
+  }
+
+  // Too few items to keep the threads busy, e.g. the global pooling of one
+  // image: every thread reduces a chunk of r for all the items, then the
+  // partial results are combined as a tree.
+  const int64_t chunks = threads;
+  const int64_t chunk_size = (r + chunks - 1) / chunks;
+  const int64_t out_size = outer * inner;
+  std::vector<T> partial(chunks * out_size, Op::init());
+  RunParallelFor(0, chunks, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const int64_t k_begin = c * chunk_size;
+      const int64_t k_end = (std::min)(r, k_begin + chunk_size);
+      if (k_begin >= k_end) continue;
+      for (int64_t item = 0; item < items; ++item) {
+        reduce_item(item, k_begin, k_end, partial.data() + c * out_size);
+      }
+    }
+  });
+  for (int64_t step = 1; step < chunks; step *= 2) {
+    for (int64_t c = 0; c + step < chunks; c += 2 * step) {
+      T* dst = partial.data() + c * out_size;
+      const T* src = partial.data() + (c + step) * out_size;
+      for (int64_t i = 0; i < out_size; ++i) {
+        dst[i] = Op::apply(dst[i], src[i]);
+      }
+    }
+  }
+  std::memcpy(out, partial.data(), out_size * sizeof(T));
+}
+
+// dims alternate between kept and reduced, the reduced runs are done one
+// at a time from the innermost one, each pass leaves a dim of size 1
+template <class Op, typename T>
+static void ReduceCollapsed(const T* in,
+                            T* out,
+                            std::vector<int64_t> dims,
+                            const std::vector<bool>& reduced) {
+  std::vector<int> runs;
+  int64_t total = 1;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (reduced[i]) runs.push_back(i);
+    total *= dims[i];
+  }
+  if (runs.empty()) {
+    std::memcpy(out, in, total * sizeof(T));
+    return;
+  }
+  std::vector<T> buf[2];
+  const T* src = in;
+  for (int n = runs.size() - 1; n >= 0; --n) {
+    const int g = runs[n];
+    int64_t outer = 1;
+    int64_t inner = 1;
+    for (int i = 0; i < g; ++i) outer *= dims[i];
+    for (size_t i = g + 1; i < dims.size(); ++i) inner *= dims[i];
+    T* dst = out;
+    if (n > 0) {
+      buf[n % 2].resize(outer * inner);
+      dst = buf[n % 2].data();
+    }
+    ReduceOuterInner<Op>(src, dst, outer, dims[g], inner);
+    dims[g] = 1;
+    src = dst;
+  }
+}
+
+template <typename T>
+void reduce(const T* in,
+            T* out,
+            const std::vector<int64_t>& in_dims,
+            const std::vector<int>& reduce_dims,
+            ReduceType type) {
+  const int rank = in_dims.size();
+  std::vector<bool> reduced_dim(rank, false);
+  for (auto d : reduce_dims) {
+    CHECK(d >= 0 && d < rank) << "reduce dim " << d << " out of rank "
+                              << rank;
+    reduced_dim[d] = true;
+  }
+
+  // drop the dims of size 1 and merge the neighbouring dims which are both
+  // kept or both reduced
+  std::vector<int64_t> dims;
+  std::vector<bool> reduced;
+  int64_t total = 1;
+  int64_t count = 1;
+  for (int i = 0; i < rank; ++i) {
+    total *= in_dims[i];
+    if (reduced_dim[i]) count *= in_dims[i];
+    if (in_dims[i] == 1) continue;
+    if (!dims.empty() && reduced.back() == reduced_dim[i]) {
+      dims.back() *= in_dims[i];
+    } else {
+      dims.push_back(in_dims[i]);
+      reduced.push_back(reduced_dim[i]);
+    }
+  }
+  if (total == 0) {
+    int64_t out_size = 1;
+    for (int i = 0; i < rank; ++i) {
+      if (!reduced_dim[i]) out_size *= in_dims[i];
+    }
+    std::fill(out, out + out_size, static_cast<T>(0));
+    return;
+  }
+
+  switch (type) {
+    case ReduceType::kSum:
+    case ReduceType::kMean:
+      ReduceCollapsed<SumOp<T>>(in, out, dims, reduced);
+      break;
+    case ReduceType::kProd:
+      ReduceCollapsed<ProdOp<T>>(in, out, dims, reduced);
+      break;
+    case ReduceType::kMax:
+      ReduceCollapsed<MaxOp<T>>(in, out, dims, reduced);
+      break;
+    case ReduceType::kMin:
+      ReduceCollapsed<MinOp<T>>(in, out, dims, reduced);
+      break;
+    default:
+      LOG(FATAL) << "unsupported reduce type";
+  }
+  if (type == ReduceType::kMean) {
+    const int64_t out_size = total / count;
+    for (int64_t i = 0; i < out_size; ++i) {
+      out[i] /= static_cast<T>(count);
+    }
+  }
+}
+
+template void reduce<float>(const float*,
+                            float*,
+                            const std::vector<int64_t>&,
+                            const std::vector<int>&,
+                            ReduceType);
+template void reduce<int>(const int*,
+                          int*,
+                          const std::vector<int64_t>&,
+                          const std::vector<int>&,
+                          ReduceType);
+template void reduce<int64_t>(const int64_t*,
+                              int64_t*,
+                              const std::vector<int64_t>&,
+                              const std::vector<int>&,
+                              ReduceType);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
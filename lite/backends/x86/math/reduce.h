@@ -0,0 +1,47 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class ReduceType { kSum, kMean, kProd, kMax, kMin };
+
+// out = the reduction of in over the dims of reduce_dims, any rank, out
+// holds the kept dims in order. The dims of size 1 are dropped and the
+// neighbouring dims that are both kept or both reduced are merged, every
+// reduced run is then an [outer, r, inner] reduction:
+//  - inner == 1, e.g. the global pooling of NCHW, sums the contiguous rows
+//    pairwise with vector accumulators;
+//  - inner > 1, e.g. NHWC, accumulates vectors of the inner dim, in blocks
+//    of rows which are added to the result.
+// Runs in parallel over outer x inner tiles, or over chunks of r combined
+// as a tree when there are too few of those.
+template <typename T>
+void reduce(const T* in,
+            T* out,
+            const std::vector<int64_t>& in_dims,
+            const std::vector<int>& reduce_dims,
+            ReduceType type);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,250 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/rnn_cell.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/math/activation_functions.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace forward = detail::forward;
+
+void RnnPackedWeight::Pack(const float* weight_hh,
+                           int gate_num,
+                           int hidden_size) {
+  CHECK_GT(gate_num, 0);
+  CHECK_GT(hidden_size, 0);
+  gate_num_ = gate_num;
+  hidden_size_ = hidden_size;
+  num_tiles_ = (hidden_size + RNN_CELL_TILE - 1) / RNN_CELL_TILE;
+  data_.assign(
+      static_cast<size_t>(num_tiles_) * hidden_size * gate_num * RNN_CELL_TILE,
+      0.f);
+  float* dst = data_.data();
+  for (int t = 0; t < num_tiles_; ++t) {
+    for (int k = 0; k < hidden_size; ++k) {
+      for (int g = 0; g < gate_num; ++g) {
+        for (int j = 0; j < RNN_CELL_TILE; ++j, ++dst) {
+          const int unit = t * RNN_CELL_TILE + j;
+          if (unit < hidden_size) {
+            *dst = weight_hh[(static_cast<size_t>(g) * hidden_size + unit) *
+                                 hidden_size +
+                             k];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Runs f(tile, row) over every tile of every row. The items are ordered by
+// tile, so each thread gets a few tiles and reads only their weights.
+template <typename Func>
+static void ForEachTile(int num_tiles, int batch_size, const Func& f) {
+  RunParallelFor(0,
+                 static_cast<int64_t>(num_tiles) * batch_size,
+                 [&](int64_t begin, int64_t end) {
+                   for (int64_t i = begin; i < end; ++i) {
+                     f(static_cast<int>(i / batch_size),
+                       static_cast<int>(i % batch_size));
+                   }
+                 });
+}
+
+#ifdef __AVX__
+static inline __m256 fmadd(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// the last tile may hold less than RNN_CELL_TILE units
+static inline __m256 load_tile(const float* p, int n) {
+  if (n == RNN_CELL_TILE) {
+    return _mm256_loadu_ps(p);
+  }
+  float buf[RNN_CELL_TILE] = {0.f};
+  std::memcpy(buf, p, n * sizeof(float));
+  return _mm256_loadu_ps(buf);
+}
+
+static inline void store_tile(float* p, __m256 v, int n) {
+  if (n == RNN_CELL_TILE) {
+    _mm256_storeu_ps(p, v);
+    return;
+  }
+  float buf[RNN_CELL_TILE];
+  _mm256_storeu_ps(buf, v);
+  std::memcpy(p, buf, n * sizeof(float));
+}
+
+// acc[g] = h_prev * W_g^T for the units of one tile. The even and odd k are
+// accumulated apart to have twice the independent fma chains.
+template <int kGates>
+static inline void tile_gemv(const float* w,
+                             const float* h_prev,
+                             int hidden_size,
+                             __m256* acc) {
+  __m256 acc_odd[kGates];
+  for (int g = 0; g < kGates; ++g) {
+    acc[g] = _mm256_setzero_ps();
+    acc_odd[g] = _mm256_setzero_ps();
+  }
+  const int step = kGates * RNN_CELL_TILE;
+  int k = 0;
+  for (; k + 1 < hidden_size; k += 2) {
+    __m256 h0 = _mm256_set1_ps(h_prev[k]);
+    __m256 h1 = _mm256_set1_ps(h_prev[k + 1]);
+    const float* w0 = w + k * step;
+    const float* w1 = w0 + step;
+    for (int g = 0; g < kGates; ++g) {
+      acc[g] = fmadd(h0, _mm256_loadu_ps(w0 + g * RNN_CELL_TILE), acc[g]);
+      acc_odd[g] =
+          fmadd(h1, _mm256_loadu_ps(w1 + g * RNN_CELL_TILE), acc_odd[g]);
+    }
+  }
+  if (k < hidden_size) {
+    __m256 h0 = _mm256_set1_ps(h_prev[k]);
+    const float* w0 = w + k * step;
+    for (int g = 0; g < kGates; ++g) {
+      acc[g] = fmadd(h0, _mm256_loadu_ps(w0 + g * RNN_CELL_TILE), acc[g]);
+    }
+  }
+  for (int g = 0; g < kGates; ++g) {
+    acc[g] = _mm256_add_ps(acc[g], acc_odd[g]);
+  }
+}
+#else
+template <int kGates>
+static inline void tile_gemv(const float* w,
+                             const float* h_prev,
+                             int hidden_size,
+                             float acc[][RNN_CELL_TILE]) {
+  for (int g = 0; g < kGates; ++g) {
+    std::fill(acc[g], acc[g] + RNN_CELL_TILE, 0.f);
+  }
+  for (int k = 0; k < hidden_size; ++k) {
+    const float* wk = w + k * kGates * RNN_CELL_TILE;
+    for (int g = 0; g < kGates; ++g) {
+      for (int j = 0; j < RNN_CELL_TILE; ++j) {
+        acc[g][j] += h_prev[k] * wk[g * RNN_CELL_TILE + j];
+      }
+    }
+  }
+}
+#endif
+
+void rnn_lstm_cell_packed(const RnnPackedWeight& weight,
+                          const float* x_gates,
+                          const float* h_prev,
+                          const float* c_prev,
+                          float* h,
+                          float* c,
+                          int batch_size) {
+  CHECK_EQ(weight.gate_num(), 4);
+  const int hidden = weight.hidden_size();
+  ForEachTile(weight.num_tiles(), batch_size, [&](int t, int b) {
+    const int unit = t * RNN_CELL_TILE;
+    const int n = (std::min)(RNN_CELL_TILE, hidden - unit);
+    const float* x_row = x_gates + static_cast<size_t>(b) * 4 * hidden + unit;
+    const float* c_prev_row = c_prev + static_cast<size_t>(b) * hidden + unit;
+    float* h_row = h + static_cast<size_t>(b) * hidden + unit;
+    float* c_row = c + static_cast<size_t>(b) * hidden + unit;
+#ifdef __AVX__
+    __m256 acc[4];
+    tile_gemv<4>(
+        weight.tile(t), h_prev + static_cast<size_t>(b) * hidden, hidden, acc);
+    __m256 ig =
+        forward::avx::Sigmoid(_mm256_add_ps(acc[0], load_tile(x_row, n)));
+    __m256 fg = forward::avx::Sigmoid(
+        _mm256_add_ps(acc[1], load_tile(x_row + hidden, n)));
+    __m256 cg = forward::avx::Tanh(
+        _mm256_add_ps(acc[2], load_tile(x_row + 2 * hidden, n)));
+    __m256 og = forward::avx::Sigmoid(
+        _mm256_add_ps(acc[3], load_tile(x_row + 3 * hidden, n)));
+    __m256 ct = fmadd(fg, load_tile(c_prev_row, n), _mm256_mul_ps(ig, cg));
+    store_tile(c_row, ct, n);
+    store_tile(h_row, _mm256_mul_ps(og, forward::avx::Tanh(ct)), n);
+#else
+    float acc[4][RNN_CELL_TILE];
+    tile_gemv<4>(
+        weight.tile(t), h_prev + static_cast<size_t>(b) * hidden, hidden, acc);
+    for (int j = 0; j < n; ++j) {
+      float ig = forward::Sigmoid<float>(acc[0][j] + x_row[j]);
+      float fg = forward::Sigmoid<float>(acc[1][j] + x_row[hidden + j]);
+      float cg = forward::Tanh<float>(acc[2][j] + x_row[2 * hidden + j]);
+      float og = forward::Sigmoid<float>(acc[3][j] + x_row[3 * hidden + j]);
+      c_row[j] = fg * c_prev_row[j] + ig * cg;
+      h_row[j] = og * forward::Tanh<float>(c_row[j]);
+    }
+#endif
+  });
+}
+
+void rnn_gru_cell_packed(const RnnPackedWeight& weight,
+                         const float* x_gates,
+                         const float* reset_bias,
+                         const float* h_prev,
+                         float* h,
+                         int batch_size) {
+  CHECK_EQ(weight.gate_num(), 3);
+  const int hidden = weight.hidden_size();
+  ForEachTile(weight.num_tiles(), batch_size, [&](int t, int b) {
+    const int unit = t * RNN_CELL_TILE;
+    const int n = (std::min)(RNN_CELL_TILE, hidden - unit);
+    const float* x_row = x_gates + static_cast<size_t>(b) * 3 * hidden + unit;
+    const float* h_prev_b = h_prev + static_cast<size_t>(b) * hidden;
+    float* h_row = h + static_cast<size_t>(b) * hidden + unit;
+#ifdef __AVX__
+    __m256 acc[3];
+    tile_gemv<3>(weight.tile(t), h_prev_b, hidden, acc);
+    __m256 rg =
+        forward::avx::Sigmoid(_mm256_add_ps(acc[0], load_tile(x_row, n)));
+    __m256 zg = forward::avx::Sigmoid(
+        _mm256_add_ps(acc[1], load_tile(x_row + hidden, n)));
+    __m256 reset = _mm256_mul_ps(
+        rg, _mm256_add_ps(acc[2], load_tile(reset_bias + unit, n)));
+    __m256 ng = forward::avx::Tanh(
+        _mm256_add_ps(load_tile(x_row + 2 * hidden, n), reset));
+    __m256 hp = load_tile(h_prev_b + unit, n);
+    store_tile(h_row, fmadd(zg, _mm256_sub_ps(hp, ng), ng), n);
+#else
+    float acc[3][RNN_CELL_TILE];
+    tile_gemv<3>(weight.tile(t), h_prev_b, hidden, acc);
+    for (int j = 0; j < n; ++j) {
+      float rg = forward::Sigmoid<float>(acc[0][j] + x_row[j]);
+      float zg = forward::Sigmoid<float>(acc[1][j] + x_row[hidden + j]);
+      float ng = forward::Tanh<float>(x_row[2 * hidden + j] +
+                                      rg * (acc[2][j] + reset_bias[unit + j]));
+      h_row[j] = ng + zg * (h_prev_b[unit + j] - ng);
+    }
+#endif
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
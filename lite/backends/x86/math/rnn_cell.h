@@ -0,0 +1,85 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The hidden units are computed in tiles of this many, one ymm register.
+#define RNN_CELL_TILE 8
+
+// The recurrent weight W_hh [gate_num * hidden_size, hidden_size] of the rnn
+// op, packed once so that the weights of one tile of hidden units are
+// contiguous for all the gates:
+//   [hidden_size / RNN_CELL_TILE][hidden_size (k)][gate_num][RNN_CELL_TILE]
+// the units of the last tile past hidden_size are zeros. Every thread of the
+// cell owns a range of tiles, which stays in its cache over the time steps.
+class RnnPackedWeight {
+ public:
+  void Pack(const float* weight_hh, int gate_num, int hidden_size);
+
+  const float* tile(int t) const {
+    return data_.data() +
+           static_cast<size_t>(t) * hidden_size_ * gate_num_ * RNN_CELL_TILE;
+  }
+  int gate_num() const { return gate_num_; }
+  int hidden_size() const { return hidden_size_; }
+  int num_tiles() const { return num_tiles_; }
+  bool empty() const { return data_.empty(); }
+
+ private:
+  int gate_num_{0};
+  int hidden_size_{0};
+  int num_tiles_{0};
+  std::vector<float> data_;
+};
+
+// One LSTM step of batch_size rows, gate order i, f, g, o as in the rnn op.
+// x_gates [batch_size, 4 * hidden_size] holds x * W_ih^T and both biases:
+//   gates = x_gates + h_prev * W_hh^T
+//   c = sigmoid(f) * c_prev + sigmoid(i) * tanh(g)
+//   h = sigmoid(o) * tanh(c)
+// The gate gemv, the activations and the cell update are done in registers
+// for one tile at a time. h and c must not alias h_prev and c_prev.
+void rnn_lstm_cell_packed(const RnnPackedWeight& weight,
+                          const float* x_gates,
+                          const float* h_prev,
+                          const float* c_prev,
+                          float* h,
+                          float* c,
+                          int batch_size);
+
+// One GRU step, gate order r, z, n as in the rnn op. x_gates holds
+// x * W_ih^T + b_ih, plus b_hh for r and z, reset_bias is b_hh of n:
+//   r = sigmoid(x_r + h_prev * W_hr^T), z = sigmoid(x_z + h_prev * W_hz^T)
+//   n = tanh(x_n + r * (h_prev * W_hn^T + reset_bias))
+//   h = (1 - z) * n + z * h_prev
+// h must not alias h_prev.
+void rnn_gru_cell_packed(const RnnPackedWeight& weight,
+                         const float* x_gates,
+                         const float* reset_bias,
+                         const float* h_prev,
+                         float* h,
+                         int batch_size);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -12,6 +12,10 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include <cstring>
 #include <string>
 
 #include "lite/backends/x86/fluid/eigen.h"
@@ -20,6 +24,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/math_function.h"
 #include "lite/backends/x86/math/sequence_pooling.h"
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -35,6 +40,98 @@ template <typename T,
           typename IndexType = Eigen::DenseIndex>
 using EigenMatrix = lite::fluid::EigenMatrix<T, MajorType, IndexType>;
 
+// out[k] = max_j in[j * dim + k] over the height rows of one sequence, and
+// index[k] is the row of the max, counted from first_row.
+template <typename T>
+static void MaxPoolRows(const T* in,
+                        int64_t height,
+                        int64_t dim,
+                        int first_row,
+                        T* out,
+                        int* index) {
+  std::memcpy(out, in, dim * sizeof(T));
+  for (int64_t k = 0; k < dim; ++k) {
+    index[k] = first_row;
+  }
+  for (int64_t j = 1; j < height; ++j) {
+    const T* row = in + j * dim;
+    for (int64_t k = 0; k < dim; ++k) {
+      if (row[k] > out[k]) {
+        out[k] = row[k];
+        index[k] = first_row + static_cast<int>(j);
+      }
+    }
+  }
+}
+
+#ifdef __AVX__
+static void MaxPoolRows(const float* in,
+                        int64_t height,
+                        int64_t dim,
+                        int first_row,
+                        float* out,
+                        int* index) {
+  int64_t k = 0;
+  for (; k + 8 <= dim; k += 8) {
+    __m256 vec_max = _mm256_loadu_ps(in + k);
+    __m256 vec_idx = _mm256_castsi256_ps(_mm256_set1_epi32(first_row));
+    for (int64_t j = 1; j < height; ++j) {
+      __m256 vec_x = _mm256_loadu_ps(in + j * dim + k);
+      __m256 mask = _mm256_cmp_ps(vec_x, vec_max, _CMP_GT_OQ);
+      __m256 vec_j = _mm256_castsi256_ps(
+          _mm256_set1_epi32(first_row + static_cast<int>(j)));
+      vec_max = _mm256_blendv_ps(vec_max, vec_x, mask);
+      vec_idx = _mm256_blendv_ps(vec_idx, vec_j, mask);
+    }
+    _mm256_storeu_ps(out + k, vec_max);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(index + k),
+                        _mm256_castps_si256(vec_idx));
+  }
+  for (; k < dim; ++k) {
+    out[k] = in[k];
+    index[k] = first_row;
+    for (int64_t j = 1; j < height; ++j) {
+      if (in[j * dim + k] > out[k]) {
+        out[k] = in[j * dim + k];
+        index[k] = first_row + static_cast<int>(j);
+      }
+    }
+  }
+}
+#endif
+
+// The sequences are pooled in parallel, split by RunParallelForLoD.
+template <typename T>
+static void MaxSeqPool(const lite::Tensor& input,
+                       T pad_value,
+                       lite::Tensor* output,
+                       lite::Tensor* index) {
+  auto& starts = input.lod()[input.lod().size() - 1];
+  const T* in_data = input.data<T>();
+  T* out_data = output->template mutable_data<T>();
+  int* max_index = index->template mutable_data<int>();
+
+  int64_t num_seq = output->dims()[0];
+  int64_t dim = output->numel() / num_seq;
+  RunParallelForLoD(starts, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (starts[i] == starts[i + 1]) {
+        for (int64_t k = 0; k < dim; ++k) {
+          out_data[i * dim + k] = pad_value;
+          max_index[i * dim + k] = -1;
+        }
+        continue;
+      }
+      MaxPoolRows(in_data + starts[i] * dim,
+                  static_cast<int64_t>(starts[i + 1] - starts[i]),
+                  dim,
+                  static_cast<int>(starts[i]),
+                  out_data + i * dim,
+                  max_index + i * dim);
+    }
+  });
+}
+
 template <typename T, bool is_test>
 class MaxSeqPoolFunctor {
  public:
@@ -52,35 +149,7 @@ class MaxSeqPoolFunctor {
       CHECK_EQ(in_dims[i], out_dims[i]);
     }
     CHECK_EQ(idx_dims, out_dims);
-
-    auto starts = input.lod()[input.lod().size() - 1];
-    const T* in_data = input.data<T>();
-    T* out_data = output->template mutable_data<T>();
-    int* max_index = index->mutable_data<int>();
-
-    int64_t num_seq = out_dims[0];
-    int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-          max_index[i * dim + k] = -1;
-        }
-        continue;
-      }
-      for (int64_t k = 0; k < dim; ++k) {
-        out_data[i * dim + k] = in_data[starts[i] * dim + k];
-        max_index[i * dim + k] = starts[i];
-      }
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
-            max_index[i * dim + k] = j;
-          }
-        }
-      }
-    }
+    MaxSeqPool(input, pad_value, output, index);
   }
 };
 // Instantisation of Max Sequence Pooling for test phase eg. no need to fill
@@ -104,35 +173,7 @@ class MaxSeqPoolFunctor<T, true> {
     for (size_t i = 0; i < idx_dims.size(); ++i) {
       CHECK_EQ(idx_dims[i], out_dims[i]);
     }
-    auto starts = input.lod()[input.lod().size() - 1];
-    const T* in_data = input.data<T>();
-    T* out_data = output->template mutable_data<T>();
-    int* max_index = index->template mutable_data<int>();
-
-    int64_t num_seq = out_dims[0];
-    int64_t dim = output->numel() / num_seq;
-    for (int64_t i = 0; i < num_seq; ++i) {
-      if (starts[i] == starts[i + 1]) {
-        for (int64_t k = 0; k < dim; ++k) {
-          out_data[i * dim + k] = pad_value;
-          max_index[i * dim + k] = -1;
-        }
-        continue;
-      }
-      std::memcpy(
-          &out_data[i * dim], &in_data[starts[i] * dim], dim * sizeof(T));
-      for (int64_t k = 0; k < dim; ++k) {
-        max_index[i * dim + k] = starts[i];
-      }
-      for (size_t j = starts[i] + 1; j < starts[i + 1]; ++j) {
-        for (int64_t k = 0; k < dim; ++k) {
-          if (in_data[j * dim + k] > out_data[i * dim + k]) {
-            out_data[i * dim + k] = in_data[j * dim + k];
-            max_index[i * dim + k] = j;
-          }
-        }
-      }
-    }
+    MaxSeqPool(input, pad_value, output, index);
   }
 };
 template <typename T>
@@ -170,6 +211,33 @@ class MaxSeqPoolGradFunctor {
   }
 };
 
+// Copies one row of every sequence, the first one if first else the last.
+template <typename T>
+static void PickSeqPool(const lite::Tensor& input,
+                        T pad_value,
+                        bool first,
+                        lite::Tensor* output) {
+  const T* in_data = input.data<T>();
+  T* out_data = output->template mutable_data<T>();
+
+  // Calculate the size of each item in sequence
+  int64_t item_size = input.numel() / input.dims()[0];
+  auto& lod = input.lod()[input.lod().size() - 1];
+  RunParallelForLoD(lod, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      T* out_row = out_data + i * item_size;
+      if (lod[i] == lod[i + 1]) {
+        for (int64_t j = 0; j < item_size; ++j) {
+          out_row[j] = pad_value;
+        }
+        continue;
+      }
+      uint64_t row = first ? lod[i] : lod[i + 1] - 1;
+      std::memcpy(out_row, in_data + row * item_size, item_size * sizeof(T));
+    }
+  });
+}
+
 template <typename T>
 class LastSeqPoolFunctor {
  public:
@@ -177,29 +245,7 @@ class LastSeqPoolFunctor {
                   const lite::Tensor& input,
                   T pad_value,
                   lite::Tensor* output) {
-    // Create pointers to input and output data
-    auto* in_data = input.data<T>();
-    auto* out_data = output->template mutable_data<T>();
-
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[input.lod().size() - 1];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
-        }
-      } else {
-        // Point to the begin of next sequence
-        in_data += seq_len * item_size;
-        // Copy the last item of sequence to output
-        std::memcpy(out_data, (in_data - item_size), item_size * sizeof(T));
-      }
-      out_data += item_size;
-    }
+    PickSeqPool(input, pad_value, false, output);
   }
 };
 
@@ -210,29 +256,7 @@ class FirstSeqPoolFunctor {
                   const lite::Tensor& input,
                   T pad_value,
                   lite::Tensor* output) {
-    // Create pointers to input and output data
-    auto* in_data = input.data<T>();
-    auto* out_data = output->template mutable_data<T>();
-
-    // Calculate the size of each item in sequence
-    int64_t item_size = input.numel() / input.dims()[0];
-    auto lod = input.lod()[input.lod().size() - 1];
-    int seq_num = static_cast<int>(lod.size()) - 1;
-    for (int i = 0; i < seq_num; ++i) {
-      // Calculate the length of each sequence
-      int64_t seq_len = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      if (seq_len == 0) {
-        for (int j = 0; j < item_size; ++j) {
-          out_data[j] = pad_value;
-        }
-      } else {
-        // Copy the first item of sequence to output
-        std::memcpy(out_data, in_data, item_size * sizeof(T));
-        // Point to the next sequence
-        in_data += seq_len * item_size;
-      }
-      out_data += item_size;
-    }
+    PickSeqPool(input, pad_value, true, output);
   }
 };
 
@@ -294,54 +318,36 @@ class SequencePoolFunctor<TARGET(kX86), T> {
       return;
     }
 
-    auto lod = input.lod()[input.lod().size() - 1];
-    if (pooltype == "SUM") {
-      const T* src = input.data<T>();
-      T* dst = output->template mutable_data<T>(TARGET(kX86));
-      jit::seq_pool_attr_t attr(
-          static_cast<int>(input.numel() / input.dims()[0]),
-          jit::SeqPoolType::kSum);
+    jit::SeqPoolType type = jit::SeqPoolType::kSum;
+    if (pooltype == "AVERAGE") {
+      type = jit::SeqPoolType::kAvg;
+    } else if (pooltype == "SQRT") {
+      type = jit::SeqPoolType::kSqrt;
+    } else if (pooltype != "SUM") {
+      LOG(FATAL) << "unsupported pooling pooltype";
+    }
+    auto& lod = input.lod()[input.lod().size() - 1];
+    const T* src = input.data<T>();
+    T* dst = output->template mutable_data<T>(TARGET(kX86));
+    const int w = static_cast<int>(input.numel() / input.dims()[0]);
+    RunParallelForLoD(lod, [&](int64_t begin, int64_t end) {
+      // the attr is per thread as h changes with every sequence, and the
+      // kernel comes from the cache of this thread.
+      jit::seq_pool_attr_t attr(w, type);
       auto seqpool =
           jit::KernelFuncs<jit::SeqPoolTuple<T>, lite::fluid::CPUPlace>::Cache()
               .At(attr);
-      for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
+      for (int64_t i = begin; i < end; ++i) {
         attr.h = static_cast<int>(lod[i + 1] - lod[i]);
         if (attr.h == 0) {
-          for (int j = 0; j < attr.w; ++j) {
-            dst[j] = pad_value;
+          for (int j = 0; j < w; ++j) {
+            dst[i * w + j] = pad_value;
           }
         } else {
-          seqpool(src, dst, &attr);
-        }
-        dst += attr.w;
-        src += attr.h * attr.w;
-      }
-      return;
-    }
-    auto eigen_device = lite::fluid::EigenDeviceType<TARGET(kX86)>();
-    for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      Tensor out_t = output->Slice<float>(i, i + 1);
-      int64_t w = input.numel() / input.dims()[0];
-      if (lod[i] == lod[i + 1]) {
-        for (int j = 0; j < w; ++j) {
-          out_t.mutable_data<T>()[j] = pad_value;
+          seqpool(src + lod[i] * w, dst + i * w, &attr);
         }
-        continue;
       }
-      Tensor in_t = input.Slice<float>(static_cast<int>(lod[i]),
-                                       static_cast<int>(lod[i + 1]));
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      auto in_e = EigenMatrix<T>::From(in_t, lite::DDim({h, w}));
-      auto out_e = EigenVector<T>::Flatten(out_t);
-      if (pooltype == "AVERAGE") {
-        out_e.device(eigen_device) = in_e.mean(Eigen::array<int, 1>({{0}}));
-      } else if (pooltype == "SQRT") {
-        out_e.device(eigen_device) = in_e.sum(Eigen::array<int, 1>({{0}})) /
-                                     std::sqrt(static_cast<T>(h));
-      } else {
-        LOG(FATAL) << "unsupported pooling pooltype";
-      }
-    }
+    });
   }
 };
 
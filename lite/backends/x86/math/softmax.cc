@@ -13,7 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/x86/math/softmax.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "lite/backends/x86/math/softmax_impl.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
 
 namespace paddle {
 namespace lite {
@@ -28,6 +35,239 @@ template class SoftmaxFunctor<lite::TargetType::kX86, float, true>;
 // template class SoftmaxGradFunctor<lite::TargetType::kX86, float>;
 // template class SoftmaxGradFunctor<lite::TargetType::kX86, double>;
 
+#define SOFTMAX_BLOCK 8
+
+#ifdef __AVX__
+static inline float reduce_max_ps(__m256 vec) {
+  __m128 vec_max =
+      _mm_max_ps(_mm256_castps256_ps128(vec), _mm256_extractf128_ps(vec, 1));
+  vec_max = _mm_max_ps(vec_max, _mm_movehl_ps(vec_max, vec_max));
+  vec_max = _mm_max_ss(vec_max, _mm_shuffle_ps(vec_max, vec_max, 1));
+  return _mm_cvtss_f32(vec_max);
+}
+
+static inline float reduce_add_ps(__m256 vec) {
+  __m128 vec_sum =
+      _mm_add_ps(_mm256_castps256_ps128(vec), _mm256_extractf128_ps(vec, 1));
+  vec_sum = _mm_add_ps(vec_sum, _mm_movehl_ps(vec_sum, vec_sum));
+  vec_sum = _mm_add_ss(vec_sum, _mm_shuffle_ps(vec_sum, vec_sum, 1));
+  return _mm_cvtss_f32(vec_sum);
+}
+#endif
+
+static inline float row_max(const float* x, int n) {
+  float max_val = -std::numeric_limits<float>::infinity();
+  int i = 0;
+#ifdef __AVX__
+  if (n >= 8) {
+    __m256 vec_max0 = _mm256_set1_ps(max_val);
+    __m256 vec_max1 = vec_max0;
+    for (; i + 16 <= n; i += 16) {
+      vec_max0 = _mm256_max_ps(vec_max0, _mm256_loadu_ps(x + i));
+      vec_max1 = _mm256_max_ps(vec_max1, _mm256_loadu_ps(x + i + 8));
+    }
+    for (; i + 8 <= n; i += 8) {
+      vec_max0 = _mm256_max_ps(vec_max0, _mm256_loadu_ps(x + i));
+    }
+    max_val = reduce_max_ps(_mm256_max_ps(vec_max0, vec_max1));
+  }
+#endif
+  for (; i < n; i++) {
+    max_val = (std::max)(max_val, x[i]);
+  }
+  return max_val;
+}
+
+// returns sum(exp(x - max_val)), and stores exp(x - max_val) to y if kStore
+template <bool kStore>
+static inline float row_exp_sum(const float* x,
+                                float max_val,
+                                float* y,
+                                int n) {
+  float sum = 0.f;
+  int i = 0;
+#ifdef __AVX__
+  __m256 vec_max = _mm256_set1_ps(max_val);
+  __m256 vec_sum0 = _mm256_setzero_ps();
+  __m256 vec_sum1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    __m256 vec_e0 = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vec_max));
+    __m256 vec_e1 =
+        exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i + 8), vec_max));
+    if (kStore) {
+      _mm256_storeu_ps(y + i, vec_e0);
+      _mm256_storeu_ps(y + i + 8, vec_e1);
+    }
+    vec_sum0 = _mm256_add_ps(vec_sum0, vec_e0);
+    vec_sum1 = _mm256_add_ps(vec_sum1, vec_e1);
+  }
+  for (; i + 8 <= n; i += 8) {
+    __m256 vec_e = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vec_max));
+    if (kStore) {
+      _mm256_storeu_ps(y + i, vec_e);
+    }
+    vec_sum0 = _mm256_add_ps(vec_sum0, vec_e);
+  }
+  sum = reduce_add_ps(_mm256_add_ps(vec_sum0, vec_sum1));
+#endif
+  for (; i < n; i++) {
+    const float e = std::exp(x[i] - max_val);
+    if (kStore) {
+      y[i] = e;
+    }
+    sum += e;
+  }
+  return sum;
+}
+
+// y = x * scale + bias
+static inline void row_scale_bias(
+    const float* x, float scale, float bias, float* y, int n) {
+  int i = 0;
+#ifdef __AVX__
+  __m256 vec_scale = _mm256_set1_ps(scale);
+  __m256 vec_bias = _mm256_set1_ps(bias);
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        y + i,
+        _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), vec_scale),
+                      vec_bias));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] = x[i] * scale + bias;
+  }
+}
+
+// Softmax of a contiguous row: one pass for the max, one pass for exp and
+// its sum, one pass to normalize. The row is reused from cache, which is
+// cheaper than an online max that needs exp of every element twice.
+// A row of -inf only, e.g. masked out entirely, gives zero probabilities.
+template <bool kLog>
+static inline void softmax_row(const float* x, float* y, int n) {
+  const float max_val = row_max(x, n);
+  if (max_val == -std::numeric_limits<float>::infinity()) {
+    std::fill(y, y + n, kLog ? max_val : 0.f);
+    return;
+  }
+  if (kLog) {
+    const float sum = row_exp_sum<false>(x, max_val, nullptr, n);
+    row_scale_bias(x, 1.f, -max_val - std::log(sum), y, n);
+  } else {
+    const float sum = row_exp_sum<true>(x, max_val, y, n);
+    row_scale_bias(y, 1.f / sum, 0.f, y, n);
+  }
+}
+
+// Softmax of w <= SOFTMAX_BLOCK adjacent columns of a strided axis, the
+// columns are independent so the vector lanes run along inner_num.
+template <bool kLog>
+static inline void softmax_cols(
+    const float* x, float* y, int axis_size, int inner_num, int w) {
+#ifdef __AVX__
+  if (w == 8) {
+    __m256 vec_max = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    for (int a = 0; a < axis_size; a++) {
+      vec_max = _mm256_max_ps(
+          vec_max, _mm256_loadu_ps(x + static_cast<int64_t>(a) * inner_num));
+    }
+    __m256 vec_sum = _mm256_setzero_ps();
+    for (int a = 0; a < axis_size; a++) {
+      const int64_t offset = static_cast<int64_t>(a) * inner_num;
+      __m256 vec_e =
+          exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + offset), vec_max));
+      if (!kLog) {
+        _mm256_storeu_ps(y + offset, vec_e);
+      }
+      vec_sum = _mm256_add_ps(vec_sum, vec_e);
+    }
+    if (kLog) {
+      __m256 vec_bias = _mm256_add_ps(vec_max, log256_ps(vec_sum));
+      for (int a = 0; a < axis_size; a++) {
+        const int64_t offset = static_cast<int64_t>(a) * inner_num;
+        _mm256_storeu_ps(y + offset,
+                         _mm256_sub_ps(_mm256_loadu_ps(x + offset), vec_bias));
+      }
+    } else {
+      __m256 vec_scale = _mm256_div_ps(_mm256_set1_ps(1.f), vec_sum);
+      for (int a = 0; a < axis_size; a++) {
+        const int64_t offset = static_cast<int64_t>(a) * inner_num;
+        _mm256_storeu_ps(y + offset,
+                         _mm256_mul_ps(_mm256_loadu_ps(y + offset), vec_scale));
+      }
+    }
+    return;
+  }
+#endif
+  for (int c = 0; c < w; c++) {
+    float max_val = -std::numeric_limits<float>::infinity();
+    for (int a = 0; a < axis_size; a++) {
+      max_val = (std::max)(max_val, x[static_cast<int64_t>(a) * inner_num + c]);
+    }
+    float sum = 0.f;
+    for (int a = 0; a < axis_size; a++) {
+      const int64_t offset = static_cast<int64_t>(a) * inner_num + c;
+      const float e = std::exp(x[offset] - max_val);
+      if (!kLog) {
+        y[offset] = e;
+      }
+      sum += e;
+    }
+    const float bias = max_val + std::log(sum);
+    const float scale = 1.f / sum;
+    for (int a = 0; a < axis_size; a++) {
+      const int64_t offset = static_cast<int64_t>(a) * inner_num + c;
+      if (kLog) {
+        y[offset] = x[offset] - bias;
+      } else {
+        y[offset] *= scale;
+      }
+    }
+  }
+}
+
+template <bool kLog>
+static void softmax_impl(
+    const float* x, float* y, int outer_num, int axis_size, int inner_num) {
+  if (inner_num == 1) {
+#pragma omp parallel for
+    for (int o = 0; o < outer_num; o++) {
+      const int64_t offset = static_cast<int64_t>(o) * axis_size;
+      softmax_row<kLog>(x + offset, y + offset, axis_size);
+    }
+  } else {
+    const int blocks = (inner_num + SOFTMAX_BLOCK - 1) / SOFTMAX_BLOCK;
+#pragma omp parallel for
+    for (int t = 0; t < outer_num * blocks; t++) {
+      const int o = t / blocks;
+      const int c = (t % blocks) * SOFTMAX_BLOCK;
+      const int64_t offset =
+          static_cast<int64_t>(o) * axis_size * inner_num + c;
+      softmax_cols<kLog>(x + offset,
+                         y + offset,
+                         axis_size,
+                         inner_num,
+                         (std::min)(SOFTMAX_BLOCK, inner_num - c));
+    }
+  }
+}
+
+void softmax(const float* x,
+             float* y,
+             int outer_num,
+             int axis_size,
+             int inner_num) {
+  softmax_impl<false>(x, y, outer_num, axis_size, inner_num);
+}
+
+void log_softmax(const float* x,
+                 float* y,
+                 int outer_num,
+                 int axis_size,
+                 int inner_num) {
+  softmax_impl<true>(x, y, outer_num, axis_size, inner_num);
+}
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -43,6 +43,21 @@ class SoftmaxGradFunctor {
                   lite::TensorLite* x_grad);
 };
 
+// Softmax of x viewed as [outer_num, axis_size, inner_num] along the
+// axis_size dim, vectorized with avx and parallel over the outer rows.
+void softmax(const float* x,
+             float* y,
+             int outer_num,
+             int axis_size,
+             int inner_num);
+
+// y = x - max - log(sum(exp(x - max))), same layout as softmax.
+void log_softmax(const float* x,
+                 float* y,
+                 int outer_num,
+                 int axis_size,
+                 int inner_num);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -0,0 +1,280 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/transpose.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/log/cp_logging.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Transposes are memory bound, below this many elements waking the threads
+// up costs more than it saves.
+#define TRANS_PARALLEL_MIN_SIZE 32768
+
+// Runs f(begin, end) over [0, items) items of item_size elements, in
+// parallel only when there is enough work.
+template <typename Func>
+static void ForEachItem(int64_t items, int64_t item_size, const Func& f) {
+  if (items > 1 && items * item_size >= TRANS_PARALLEL_MIN_SIZE) {
+    RunParallelFor(0, items, f);
+  } else {
+    f(0, items);
+  }
+}
+
+// Drops the dims of size 1 and merges the input dims that stay next to each
+// other in the output, e.g. [N, C, H, W] with axis [0, 2, 3, 1] becomes
+// [N, C, H * W] with [0, 2, 1].
+static void CollapseDims(const std::vector<int64_t>& in_dims,
+                         const std::vector<int>& axis,
+                         std::vector<int64_t>* dims,
+                         std::vector<int>* perm) {
+  const int rank = in_dims.size();
+  std::vector<int> kept_id(rank, -1);
+  int kept = 0;
+  for (int i = 0; i < rank; ++i) {
+    if (in_dims[i] != 1) kept_id[i] = kept++;
+  }
+  std::vector<int> kept_axis;
+  std::vector<int64_t> kept_dims;
+  for (int i = 0; i < rank; ++i) {
+    if (kept_id[i] >= 0) kept_dims.push_back(in_dims[i]);
+    if (kept_id[axis[i]] >= 0) kept_axis.push_back(kept_id[axis[i]]);
+  }
+
+  // the runs of the output whose input dims are consecutive, by the first
+  // input dim of every run
+  std::vector<int> run_of_dim(kept, -1);
+  std::vector<int> run_first;
+  for (int k = 0; k < kept; ++k) {
+    if (k == 0 || kept_axis[k] != kept_axis[k - 1] + 1) {
+      run_of_dim[kept_axis[k]] = run_first.size();
+      run_first.push_back(kept_axis[k]);
+    }
+  }
+  std::vector<int> run_id(run_first.size());
+  std::vector<int64_t> run_dims(run_first.size(), 1);
+  int merged = 0;
+  for (int i = 0; i < kept; ++i) {
+    if (run_of_dim[i] >= 0) run_id[run_of_dim[i]] = merged++;
+    run_dims[merged - 1] *= kept_dims[i];
+  }
+  dims->assign(run_dims.begin(), run_dims.end());
+  perm->assign(run_id.begin(), run_id.end());
+}
+
+#ifdef __AVX__
+// dst[j * ldd + i] = src[i * lds + j] for an 8x8 tile
+static inline void transpose_8x8(const float* src,
+                                 int64_t lds,
+                                 float* dst,
+                                 int64_t ldd) {
+  __m256 r0 = _mm256_loadu_ps(src);
+  __m256 r1 = _mm256_loadu_ps(src + lds);
+  __m256 r2 = _mm256_loadu_ps(src + 2 * lds);
+  __m256 r3 = _mm256_loadu_ps(src + 3 * lds);
+  __m256 r4 = _mm256_loadu_ps(src + 4 * lds);
+  __m256 r5 = _mm256_loadu_ps(src + 5 * lds);
+  __m256 r6 = _mm256_loadu_ps(src + 6 * lds);
+  __m256 r7 = _mm256_loadu_ps(src + 7 * lds);
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  r0 = _mm256_shuffle_ps(t0, t2, 0x44);
+  r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+  r2 = _mm256_shuffle_ps(t1, t3, 0x44);
+  r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+  r4 = _mm256_shuffle_ps(t4, t6, 0x44);
+  r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+  r6 = _mm256_shuffle_ps(t5, t7, 0x44);
+  r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(dst + ldd, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ldd, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ldd, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ldd, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ldd, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ldd, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ldd, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+#endif
+
+// dst[j * ldd + i] = src[i * lds + j] for i < rows, j < cols, one block
+template <typename T>
+static void transpose_block(const T* src,
+                            int64_t lds,
+                            T* dst,
+                            int64_t ldd,
+                            int64_t rows,
+                            int64_t cols) {
+  int64_t i = 0;
+#ifdef __AVX__
+  // the shuffles only move the bits, so the 4-byte integers go through
+  // the float registers as well
+  if (sizeof(T) == sizeof(float)) {
+    for (; i + 8 <= rows; i += 8) {
+      int64_t j = 0;
+      for (; j + 8 <= cols; j += 8) {
+        transpose_8x8(reinterpret_cast<const float*>(src + i * lds + j),
+                      lds,
+                      reinterpret_cast<float*>(dst + j * ldd + i),
+                      ldd);
+      }
+      for (; j < cols; ++j) {
+        for (int64_t ii = i; ii < i + 8; ++ii) {
+          dst[j * ldd + ii] = src[ii * lds + j];
+        }
+      }
+    }
+  }
+#endif
+  for (; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      dst[j * ldd + i] = src[i * lds + j];
+    }
+  }
+}
+
+template <typename T>
+void transpose(const T* in,
+               T* out,
+               const std::vector<int64_t>& in_dims,
+               const std::vector<int>& axis) {
+  CHECK_EQ(in_dims.size(), axis.size());
+  int64_t total = 1;
+  for (auto d : in_dims) total *= d;
+  if (total == 0) return;
+
+  std::vector<int64_t> dims;
+  std::vector<int> perm;
+  CollapseDims(in_dims, axis, &dims, &perm);
+  const int rank = dims.size();
+  if (rank <= 1) {
+    std::memcpy(out, in, total * sizeof(T));
+    return;
+  }
+
+  std::vector<int64_t> in_stride(rank, 1);
+  std::vector<int64_t> out_stride(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_stride[i] = in_stride[i + 1] * dims[i + 1];
+    out_stride[i] = out_stride[i + 1] * dims[perm[i + 1]];
+  }
+  // the output stride of every input dim
+  std::vector<int64_t> in_out_stride(rank);
+  for (int k = 0; k < rank; ++k) {
+    in_out_stride[perm[k]] = out_stride[k];
+  }
+
+  if (perm[rank - 1] == rank - 1) {
+    // copy the rows in the output order, row r of the output starts at the
+    // input offset of its index over the outer output dims
+    const int64_t row = dims[rank - 1];
+    ForEachItem(total / row, row, [&](int64_t begin, int64_t end) {
+      std::vector<int64_t> index(rank - 1);
+      int64_t offset = 0;
+      int64_t r = begin;
+      for (int k = rank - 2; k >= 0; --k) {
+        index[k] = r % dims[perm[k]];
+        r /= dims[perm[k]];
+        offset += index[k] * in_stride[perm[k]];
+      }
+      for (r = begin; r < end; ++r) {
+        std::memcpy(out + r * row, in + offset, row * sizeof(T));
+        for (int k = rank - 2; k >= 0; --k) {
+          offset += in_stride[perm[k]];
+          if (++index[k] < dims[perm[k]]) break;
+          offset -= index[k] * in_stride[perm[k]];
+          index[k] = 0;
+        }
+      }
+    });
+    return;
+  }
+
+  // the innermost input dim and the input dim which becomes the innermost
+  // output dim make a 2D transpose, over the index of the other dims
+  const int inner = perm[rank - 1];
+  const int64_t rows = dims[inner];
+  const int64_t cols = dims[rank - 1];
+  const int64_t lds = in_stride[inner];
+  const int64_t ldd = in_out_stride[rank - 1];
+  std::vector<int64_t> outer_dims;
+  std::vector<int64_t> outer_in_stride;
+  std::vector<int64_t> outer_out_stride;
+  for (int i = 0; i < rank - 1; ++i) {
+    if (i == inner) continue;
+    outer_dims.push_back(dims[i]);
+    outer_in_stride.push_back(in_stride[i]);
+    outer_out_stride.push_back(in_out_stride[i]);
+  }
+  const int64_t row_blocks = (rows + TRANS_BLOCK - 1) / TRANS_BLOCK;
+  const int64_t col_blocks = (cols + TRANS_BLOCK - 1) / TRANS_BLOCK;
+  const int64_t blocks = row_blocks * col_blocks;
+  const int64_t outer = total / (rows * cols);
+  ForEachItem(outer * blocks,
+              TRANS_BLOCK * TRANS_BLOCK,
+              [&](int64_t begin, int64_t end) {
+                for (int64_t item = begin; item < end; ++item) {
+                  int64_t o = item / blocks;
+                  const int64_t i0 = (item % blocks / col_blocks) * TRANS_BLOCK;
+                  const int64_t j0 = (item % col_blocks) * TRANS_BLOCK;
+                  int64_t in_offset = i0 * lds + j0;
+                  int64_t out_offset = j0 * ldd + i0;
+                  for (int k = outer_dims.size() - 1; k >= 0; --k) {
+                    const int64_t idx = o % outer_dims[k];
+                    o /= outer_dims[k];
+                    in_offset += idx * outer_in_stride[k];
+                    out_offset += idx * outer_out_stride[k];
+                  }
+                  transpose_block(in + in_offset,
+                                  lds,
+                                  out + out_offset,
+                                  ldd,
+                                  (std::min<int64_t>)(TRANS_BLOCK, rows - i0),
+                                  (std::min<int64_t>)(TRANS_BLOCK, cols - j0));
+                }
+              });
+}
+
+template void transpose<float>(const float*,
+                               float*,
+                               const std::vector<int64_t>&,
+                               const std::vector<int>&);
+template void transpose<int32_t>(const int32_t*,
+                                 int32_t*,
+                                 const std::vector<int64_t>&,
+                                 const std::vector<int>&);
+template void transpose<int64_t>(const int64_t*,
+                                 int64_t*,
+                                 const std::vector<int64_t>&,
+                                 const std::vector<int>&);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
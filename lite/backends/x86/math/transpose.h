@@ -0,0 +1,47 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The 2D transposes are done in TRANS_BLOCK x TRANS_BLOCK blocks, small
+// enough for the source and the destination block to stay in L1.
+#define TRANS_BLOCK 32
+
+// out = in with its dims permuted, dim i of out is dim axis[i] of in, of any
+// rank. The dims of size 1 are dropped and the input dims which stay next
+// to each other in out are merged first, then:
+//  - when the innermost dim stays innermost, e.g. [B, S, H, D] to
+//    [B, H, S, D], whole rows are copied;
+//  - otherwise it is a batch of 2D transposes, e.g. NCHW to NHWC is
+//    [N, C, H * W] to [N, H * W, C], done in blocks with 8x8 AVX register
+//    tiles for the 4-byte types.
+// Runs in parallel over the rows or the blocks.
+template <typename T>
+void transpose(const T* in,
+               T* out,
+               const std::vector<int64_t>& in_dims,
+               const std::vector<int>& axis);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -15,6 +15,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 #include "lite/backends/x86/mklml.h"
@@ -72,6 +75,56 @@ static inline void RunParallelFor(const int64_t begin,
   f(begin, end);
 }
 
+// Runs f(seq_begin, seq_end) over the sequences of lod, the sequences are
+// split into contiguous chunks of about the same number of rows rather than
+// the same number of sequences, so that one long sequence does not leave the
+// other threads waiting. Every sequence also costs one row, the empty ones
+// included.
+static inline void RunParallelForLoD(const std::vector<uint64_t>& lod,
+                                     const ThreadHandler& f) {
+  const int64_t num_seqs = static_cast<int64_t>(lod.size()) - 1;
+  if (num_seqs <= 0) {
+    return;
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  int64_t num_threads = (std::min)(GetMaxThreads(), num_seqs);
+  if (num_threads > 1) {
+    auto cost = [&](int64_t i) {
+      return static_cast<int64_t>(lod[i] - lod[0]) + i;
+    };
+    // the first sequence of the chunk tid, cost is strictly increasing so
+    // the chunk num_threads starts at num_seqs
+    auto chunk_begin = [&](int64_t tid) {
+      const int64_t target = cost(num_seqs) * tid / num_threads;
+      int64_t lo = 0;
+      int64_t hi = num_seqs;
+      while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (cost(mid) < target) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return lo;
+    };
+#pragma omp parallel num_threads(num_threads)
+    {
+      int64_t tid = omp_get_thread_num();
+      int64_t begin_tid = chunk_begin(tid);
+      int64_t end_tid = chunk_begin(tid + 1);
+      if (begin_tid < end_tid) {
+        f(begin_tid, end_tid);
+      }
+    }
+    return;
+  }
+#endif
+
+  f(0, num_seqs);
+}
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,148 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_autotune.h"
+#include <chrono>  // NOLINT
+#include <fstream>
+#include "lite/utils/env.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+bool KernelAutoTuneEnabled() { return GetBoolFromEnv(LITE_KERNEL_AUTOTUNE); }
+
+KernelAutoTuneTable& KernelAutoTuneTable::Global() {
+  static KernelAutoTuneTable x;
+  return x;
+}
+
+KernelAutoTuneTable::KernelAutoTuneTable() {
+  auto path = GetStringFromEnv(LITE_KERNEL_AUTOTUNE_FILE);
+  if (!path.empty()) {
+    std::ifstream file(path);
+    // the file is created at the exit of the first tuning run
+    if (file.good() && !Load(path)) {
+      LOG(WARNING) << "Failed to load the kernel autotune table " << path;
+    }
+  }
+}
+
+KernelAutoTuneTable::~KernelAutoTuneTable() {
+  auto path = GetStringFromEnv(LITE_KERNEL_AUTOTUNE_FILE);
+  if (dirty_ && !path.empty()) {
+    Save(path);
+  }
+}
+
+bool KernelAutoTuneTable::Find(const std::string& key,
+                               std::string* impl) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = table_.find(key);
+  if (iter == table_.end()) {
+    return false;
+  }
+  *impl = iter->second;
+  return true;
+}
+
+std::string KernelAutoTuneTable::Insert(const std::string& key,
+                                        const std::string& impl,
+                                        const std::string& stale) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto res = table_.emplace(key, impl);
+  if (!res.second && !stale.empty() && res.first->second == stale) {
+    res.first->second = impl;
+    dirty_ = true;
+  }
+  dirty_ = dirty_ || res.second;
+  return res.first->second;
+}
+
+bool KernelAutoTuneTable::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  while (std::getline(file, line)) {
+    auto pos = line.find(' ');
+    if (pos == std::string::npos || pos + 1 >= line.size()) {
+      continue;
+    }
+    // the entries loaded take the place of the ones tuned in this process
+    table_[line.substr(pos + 1)] = line.substr(0, pos);
+  }
+  return true;
+}
+
+bool KernelAutoTuneTable::Save(const std::string& path) const {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    LOG(WARNING) << "Failed to save the kernel autotune table to " << path;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : table_) {
+    file << item.second << " " << item.first << "\n";
+  }
+  return file.good();
+}
+
+std::string KernelAutoTunePick(
+    const std::string& key,
+    const std::vector<std::pair<std::string, std::function<void()>>>&
+        candidates,
+    const std::string& default_impl) {
+  auto& table = KernelAutoTuneTable::Global();
+  std::string impl;
+  if (table.Find(key, &impl)) {
+    for (auto& candidate : candidates) {
+      if (candidate.first == impl) return impl;
+    }
+    LOG(WARNING) << "Ignore the autotuned " << impl << " of " << key
+                 << ", it can not run here";
+  }
+  if (!KernelAutoTuneEnabled() || candidates.size() < 2) {
+    return default_impl;
+  }
+
+  // the whole kernels take long enough to time one run at a time
+  const int kRounds = 3;
+  size_t best = 0;
+  double best_time = 0;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    candidates[i].second();
+    double min_time = 0;
+    for (int r = 0; r < kRounds; r++) {
+      auto start = std::chrono::steady_clock::now();
+      candidates[i].second();
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (r == 0 || elapsed.count() < min_time) min_time = elapsed.count();
+    }
+    VLOG(3) << "autotune " << key << ": " << candidates[i].first << " "
+            << min_time * 1e3 << " ms";
+    if (i == 0 || min_time < best_time) {
+      best = i;
+      best_time = min_time;
+    }
+  }
+  // impl is the stale entry of the table if there is one
+  return table.Insert(key, candidates[best].first, impl);
+}
+
+}  // namespace lite
+}  // namespace paddle
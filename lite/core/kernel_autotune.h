@@ -0,0 +1,85 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+// Whether LITE_KERNEL_AUTOTUNE is set.
+bool KernelAutoTuneEnabled();
+
+// The implementation picked by the kernels which have several of them, by
+// a key of the kernel and the shapes it runs on, e.g. the "direct",
+// "depthwise" or "gemm" of the x86 conv. One line per entry in the text
+// format, the implementation first:
+//   direct conv2d/x86/float x={1,32,56,56} w={64,32,3,3} s=1,1 ...
+// The table in the file of LITE_KERNEL_AUTOTUNE_FILE is loaded on the first
+// use, and written back when the process exits if it changed.
+class KernelAutoTuneTable {
+ public:
+  static KernelAutoTuneTable& Global();
+  ~KernelAutoTuneTable();
+
+  bool Find(const std::string& key, std::string* impl) const;
+  // Returns the implementation kept in the table, which is the one inserted
+  // first when several kernels tune the same key at the same time. An entry
+  // still holding stale, which the kernel can not run, is replaced.
+  std::string Insert(const std::string& key,
+                     const std::string& impl,
+                     const std::string& stale = "");
+
+  bool Load(const std::string& path);
+  bool Save(const std::string& path) const;
+
+ private:
+  KernelAutoTuneTable();
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::string> table_;
+  bool dirty_{false};
+};
+
+// Export and import the tuning table, so the choices made at the first run
+// on the device can be shipped with the model and reused without timing.
+inline bool SaveKernelAutoTuneTable(const std::string& path) {
+  return KernelAutoTuneTable::Global().Save(path);
+}
+inline bool LoadKernelAutoTuneTable(const std::string& path) {
+  return KernelAutoTuneTable::Global().Load(path);
+}
+
+// Picks the implementation of a kernel for the key, in order:
+//  - the one in the table, if it is one of the candidates;
+//  - with the autotuning enabled, the fastest of the candidates, every one
+//    is run on the actual inputs of the kernel and timed as the best of a
+//    few rounds after a warm-up run, the winner is added to the table;
+//  - default_impl.
+// The candidates must be able to run one after the other on the same
+// inputs and outputs.
+std::string KernelAutoTunePick(
+    const std::string& key,
+    const std::vector<std::pair<std::string, std::function<void()>>>&
+        candidates,
+    const std::string& default_impl);
+
+}  // namespace lite
+}  // namespace paddle
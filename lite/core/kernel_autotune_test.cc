@@ -0,0 +1,159 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_autotune.h"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/utils/env.h"
+
+namespace paddle {
+namespace lite {
+
+using Candidates = std::vector<std::pair<std::string, std::function<void()>>>;
+
+// Candidates counting their runs, the "slow" one sleeps for a while.
+static Candidates CountedCandidates(const std::vector<std::string>& names,
+                                    std::vector<int>* runs) {
+  runs->assign(names.size(), 0);
+  Candidates candidates;
+  for (size_t i = 0; i < names.size(); i++) {
+    candidates.emplace_back(names[i], [=]() {
+      (*runs)[i]++;
+      if (names[i] == "slow") {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    });
+  }
+  return candidates;
+}
+
+static int TotalRuns(const std::vector<int>& runs) {
+  int total = 0;
+  for (auto run : runs) total += run;
+  return total;
+}
+
+TEST(KernelAutoTuneTable, save_load) {
+  auto& table = KernelAutoTuneTable::Global();
+  const std::string path = "kernel_autotune_test_table.txt";
+  {
+    std::ofstream file(path);
+    file << "direct conv2d/x86/float x={1,8,4,4} w={8,8,3,3} s=1,1\n";
+    file << "gemm conv2d/x86/float x={1,8,4,4} w={8,8,1,1} s=1,1\n";
+    // no key
+    file << "depthwise\n";
+  }
+  ASSERT_TRUE(table.Load(path));
+  std::string impl;
+  ASSERT_TRUE(
+      table.Find("conv2d/x86/float x={1,8,4,4} w={8,8,3,3} s=1,1", &impl));
+  EXPECT_EQ(impl, "direct");
+  ASSERT_TRUE(
+      table.Find("conv2d/x86/float x={1,8,4,4} w={8,8,1,1} s=1,1", &impl));
+  EXPECT_EQ(impl, "gemm");
+  EXPECT_FALSE(table.Find("", &impl));
+  EXPECT_FALSE(table.Load("kernel_autotune_test_missing.txt"));
+
+  // the entries read back are the ones saved, one line each
+  const std::string saved = "kernel_autotune_test_saved.txt";
+  ASSERT_TRUE(table.Save(saved));
+  std::ifstream file(saved);
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(file, line)) lines.push_back(line);
+  EXPECT_NE(std::find(lines.begin(),
+                      lines.end(),
+                      "direct conv2d/x86/float x={1,8,4,4} w={8,8,3,3} s=1,1"),
+            lines.end());
+  EXPECT_NE(std::find(lines.begin(),
+                      lines.end(),
+                      "gemm conv2d/x86/float x={1,8,4,4} w={8,8,1,1} s=1,1"),
+            lines.end());
+  EXPECT_EQ(std::find(lines.begin(), lines.end(), "depthwise"), lines.end());
+}
+
+TEST(KernelAutoTunePick, table_hit) {
+  KernelAutoTuneTable::Global().Insert("pick/hit", "slow");
+  std::vector<int> runs;
+  auto candidates = CountedCandidates({"fast", "slow"}, &runs);
+  setenv(LITE_KERNEL_AUTOTUNE, "1", 1);
+  EXPECT_EQ(KernelAutoTunePick("pick/hit", candidates, "fast"), "slow");
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  EXPECT_EQ(TotalRuns(runs), 0);
+}
+
+TEST(KernelAutoTunePick, disabled) {
+  std::vector<int> runs;
+  auto candidates = CountedCandidates({"fast", "slow"}, &runs);
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  EXPECT_EQ(KernelAutoTunePick("pick/disabled", candidates, "slow"), "slow");
+  EXPECT_EQ(TotalRuns(runs), 0);
+  std::string impl;
+  EXPECT_FALSE(KernelAutoTuneTable::Global().Find("pick/disabled", &impl));
+}
+
+TEST(KernelAutoTunePick, one_candidate) {
+  std::vector<int> runs;
+  auto candidates = CountedCandidates({"slow"}, &runs);
+  setenv(LITE_KERNEL_AUTOTUNE, "1", 1);
+  EXPECT_EQ(KernelAutoTunePick("pick/one", candidates, "slow"), "slow");
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  EXPECT_EQ(TotalRuns(runs), 0);
+  std::string impl;
+  EXPECT_FALSE(KernelAutoTuneTable::Global().Find("pick/one", &impl));
+}
+
+TEST(KernelAutoTunePick, tune) {
+  std::vector<int> runs;
+  auto candidates = CountedCandidates({"slow", "fast"}, &runs);
+  setenv(LITE_KERNEL_AUTOTUNE, "1", 1);
+  EXPECT_EQ(KernelAutoTunePick("pick/tune", candidates, "slow"), "fast");
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  // a warm-up run and the timed rounds each
+  EXPECT_EQ(runs[0], runs[1]);
+  EXPECT_GT(runs[0], 1);
+  std::string impl;
+  ASSERT_TRUE(KernelAutoTuneTable::Global().Find("pick/tune", &impl));
+  EXPECT_EQ(impl, "fast");
+}
+
+// an entry of an implementation the kernel can not run here, e.g. from the
+// table of another device
+TEST(KernelAutoTunePick, stale_entry) {
+  auto& table = KernelAutoTuneTable::Global();
+  table.Insert("pick/stale", "winograd");
+  std::vector<int> runs;
+  auto candidates = CountedCandidates({"slow", "fast"}, &runs);
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  EXPECT_EQ(KernelAutoTunePick("pick/stale", candidates, "slow"), "slow");
+  EXPECT_EQ(TotalRuns(runs), 0);
+  // tuned again and replaced
+  setenv(LITE_KERNEL_AUTOTUNE, "1", 1);
+  EXPECT_EQ(KernelAutoTunePick("pick/stale", candidates, "slow"), "fast");
+  unsetenv(LITE_KERNEL_AUTOTUNE);
+  std::string impl;
+  ASSERT_TRUE(table.Find("pick/stale", &impl));
+  EXPECT_EQ(impl, "fast");
+}
+
+}  // namespace lite
+}  // namespace paddle
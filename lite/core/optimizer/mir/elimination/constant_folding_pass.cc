@@ -0,0 +1,484 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/constant_folding_pass.h"
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/core/optimizer/mir/ssa_graph_utils.h"
+#include "lite/core/type_system.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The ops which must run at inference time even with persistable inputs.
+static const std::set<std::string> kUnfoldableOps = {
+    "feed",
+    "fetch",
+    "io_copy",
+    "io_copy_once",
+    "layout",
+    "layout_once",
+    "calib",
+    "calib_once",
+    "while",
+    "conditional_block",
+    "subgraph",
+    "uniform_random",
+    "gaussian_random",
+    "randint",
+    "randperm",
+    "sampling_id",
+    "dropout",
+    "write_to_array",
+    "read_from_array",
+    "tensor_array_to_tensor",
+    "lod_array_length",
+    "increment",
+    "assign",
+    "share_data",
+};
+
+// The ops computed by the pass itself rather than by their kernels, so they
+// fold in opt too, where the kernels are fakes. They are the ones between
+// the weights and the shapes of the models exported with dynamic shapes,
+// next to those of the *_calc_offline_pass.
+static const std::set<std::string> kFoldedWithoutKernels = {
+    "shape",
+    "cast",
+    "slice",
+    "concat",
+    "elementwise_add",
+    "elementwise_sub",
+    "elementwise_mul",
+    "elementwise_div",
+    "elementwise_max",
+    "elementwise_min",
+};
+
+static const lite::Tensor& InputTensor(const OpInfo* op_info,
+                                       Scope* scope,
+                                       const std::string& arg_name,
+                                       size_t i = 0) {
+  return scope->FindVar(op_info->Input(arg_name)[i])->Get<lite::Tensor>();
+}
+
+static lite::Tensor* OutputTensor(const OpInfo* op_info, Scope* scope) {
+  return scope->FindVar(op_info->Output("Out").front())
+      ->GetMutable<lite::Tensor>();
+}
+
+static bool HasTensorInput(const OpInfo* op_info,
+                           const std::vector<std::string>& arg_names) {
+  for (auto& arg_name : arg_names) {
+    if (op_info->HasInput(arg_name) && !op_info->Input(arg_name).empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Runs func<T>(...) with T of the precision and returns true, returns false
+// for the other precisions.
+#define FOLD_WITH_PRECISION(precision, func, ...) \
+  switch (precision) {                            \
+    case PRECISION(kFloat):                       \
+      func<float>(__VA_ARGS__);                   \
+      return true;                                \
+    case PRECISION(kInt32):                       \
+      func<int32_t>(__VA_ARGS__);                 \
+      return true;                                \
+    case PRECISION(kInt64):                       \
+      func<int64_t>(__VA_ARGS__);                 \
+      return true;                                \
+    default:                                      \
+      return false;                               \
+  }
+
+// The precision of the paddle dtype of the cast attributes.
+static PrecisionType CastPrecision(int dtype) {
+  switch (dtype) {
+    case 2:
+      return PRECISION(kInt32);
+    case 3:
+      return PRECISION(kInt64);
+    case 5:
+      return PRECISION(kFloat);
+    default:
+      return PRECISION(kUnk);
+  }
+}
+
+template <typename InT, typename OutT>
+static void CastTo(const lite::Tensor& x, lite::Tensor* out) {
+  const auto* x_data = x.data<InT>();
+  auto* out_data = out->mutable_data<OutT>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    out_data[i] = static_cast<OutT>(x_data[i]);
+  }
+}
+
+template <typename InT>
+static bool Cast(const lite::Tensor& x,
+                 PrecisionType out_precision,
+                 lite::Tensor* out) {
+  switch (out_precision) {
+    case PRECISION(kFloat):
+      CastTo<InT, float>(x, out);
+      return true;
+    case PRECISION(kInt32):
+      CastTo<InT, int32_t>(x, out);
+      return true;
+    case PRECISION(kInt64):
+      CastTo<InT, int64_t>(x, out);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// x[begin[d], begin[d] + size[d]) of every dim d into out
+template <typename T>
+static void Slice(const lite::Tensor& x,
+                  const std::vector<int64_t>& begin,
+                  const std::vector<int64_t>& size,
+                  lite::Tensor* out) {
+  const auto x_dims = x.dims().Vectorize();
+  const int rank = x_dims.size();
+  const auto* x_data = x.data<T>();
+  auto* out_data = out->mutable_data<T>();
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < out->numel(); i++) {
+    int64_t offset = 0;
+    for (int d = 0; d < rank; d++) {
+      offset = offset * x_dims[d] + begin[d] + index[d];
+    }
+    out_data[i] = x_data[offset];
+    for (int d = rank - 1; d >= 0; d--) {
+      if (++index[d] < size[d]) break;
+      index[d] = 0;
+    }
+  }
+}
+
+// The inputs one after another in each of the outer rows.
+template <typename T>
+static void Concat(const std::vector<const lite::Tensor*>& xs,
+                   int64_t outer,
+                   lite::Tensor* out) {
+  auto* out_data = out->mutable_data<T>();
+  for (int64_t o = 0; o < outer; o++) {
+    for (auto* x : xs) {
+      const int64_t inner = x->numel() / outer;
+      const auto* x_data = x->data<T>() + o * inner;
+      out_data = std::copy(x_data, x_data + inner, out_data);
+    }
+  }
+}
+
+// y of the shape of x or of a single element.
+template <typename T>
+static void Elementwise(const std::string& op_type,
+                        const lite::Tensor& x,
+                        const lite::Tensor& y,
+                        lite::Tensor* out) {
+  const auto* x_data = x.data<T>();
+  const auto* y_data = y.data<T>();
+  auto* out_data = out->mutable_data<T>();
+  const int64_t y_step = y.numel() == 1 ? 0 : 1;
+  for (int64_t i = 0; i < x.numel(); i++) {
+    const T a = x_data[i];
+    const T b = y_data[i * y_step];
+    T c;
+    if (op_type == "elementwise_add") {
+      c = a + b;
+    } else if (op_type == "elementwise_sub") {
+      c = a - b;
+    } else if (op_type == "elementwise_mul") {
+      c = a * b;
+    } else if (op_type == "elementwise_div") {
+      c = a / b;
+    } else if (op_type == "elementwise_max") {
+      c = std::max(a, b);
+    } else {
+      c = std::min(a, b);
+    }
+    out_data[i] = c;
+  }
+}
+
+// Whether any element of an integer tensor is 0, the divisors an integer
+// elementwise_div would trap on.
+template <typename T>
+static bool HasZero(const lite::Tensor& x) {
+  const auto* x_data = x.data<T>();
+  return std::find(x_data, x_data + x.numel(), T(0)) != x_data + x.numel();
+}
+
+// Runs the op of kFoldedWithoutKernels on its inputs after InferShape,
+// false for the cases not handled here.
+static bool FoldWithoutKernel(OpLite* op) {
+  auto* op_info = op->op_info();
+  auto* scope = op->scope();
+  const auto& op_type = op_info->Type();
+  auto* out = OutputTensor(op_info, scope);
+
+  if (op_type == "shape") {
+    const auto in_dims = InputTensor(op_info, scope, "Input").dims();
+    auto* out_data = out->mutable_data<int32_t>();
+    for (size_t i = 0; i < in_dims.size(); i++) {
+      out_data[i] = static_cast<int32_t>(in_dims[i]);
+    }
+    return true;
+  }
+
+  if (op_type == "cast") {
+    const auto& x = InputTensor(op_info, scope, "X");
+    auto in_precision = CastPrecision(op_info->GetAttr<int>("in_dtype"));
+    auto out_precision = CastPrecision(op_info->GetAttr<int>("out_dtype"));
+    if (x.precision() != in_precision) return false;
+    switch (in_precision) {
+      case PRECISION(kFloat):
+        return Cast<float>(x, out_precision, out);
+      case PRECISION(kInt32):
+        return Cast<int32_t>(x, out_precision, out);
+      case PRECISION(kInt64):
+        return Cast<int64_t>(x, out_precision, out);
+      default:
+        return false;
+    }
+  }
+
+  if (op_type == "slice") {
+    if (HasTensorInput(op_info,
+                       {"StartsTensor",
+                        "EndsTensor",
+                        "StartsTensorList",
+                        "EndsTensorList"})) {
+      return false;
+    }
+    const auto& x = InputTensor(op_info, scope, "Input");
+    const auto x_dims = x.dims().Vectorize();
+    const int rank = x_dims.size();
+    auto axes = op_info->GetAttr<std::vector<int>>("axes");
+    auto starts = op_info->GetAttr<std::vector<int>>("starts");
+    auto ends = op_info->GetAttr<std::vector<int>>("ends");
+    if (starts.size() != axes.size() || ends.size() != axes.size()) {
+      return false;
+    }
+    // the start and the size of every dim of x
+    std::vector<int64_t> begin(rank, 0);
+    std::vector<int64_t> size = x_dims;
+    for (size_t i = 0; i < axes.size(); i++) {
+      const int axis = axes[i] < 0 ? axes[i] + rank : axes[i];
+      if (axis < 0 || axis >= rank) return false;
+      const int64_t dim = x_dims[axis];
+      int64_t start = starts[i] < 0 ? starts[i] + dim : starts[i];
+      int64_t end = ends[i] < 0 ? ends[i] + dim : ends[i];
+      start = std::min(std::max<int64_t>(start, 0), dim);
+      end = std::min(std::max<int64_t>(end, 0), dim);
+      begin[axis] = start;
+      size[axis] = std::max<int64_t>(end - start, 0);
+    }
+    int64_t numel = 1;
+    for (auto d : size) numel *= d;
+    if (numel != out->numel()) return false;
+    FOLD_WITH_PRECISION(x.precision(), Slice, x, begin, size, out);
+  }
+
+  if (op_type == "concat") {
+    if (HasTensorInput(op_info, {"AxisTensor"})) return false;
+    std::vector<const lite::Tensor*> xs;
+    for (size_t i = 0; i < op_info->Input("X").size(); i++) {
+      xs.push_back(&InputTensor(op_info, scope, "X", i));
+      if (xs.back()->precision() != xs.front()->precision()) return false;
+    }
+    const int rank = xs.front()->dims().size();
+    int axis = op_info->GetAttr<int>("axis");
+    if (axis < 0) axis += rank;
+    if (axis < 0 || axis >= rank) return false;
+    int64_t outer = 1;
+    for (int d = 0; d < axis; d++) outer *= xs.front()->dims()[d];
+    FOLD_WITH_PRECISION(xs.front()->precision(), Concat, xs, outer, out);
+  }
+
+  // the elementwise ops
+  if (op_info->HasAttr("axis") && op_info->GetAttr<int>("axis") != -1) {
+    return false;
+  }
+  const auto& x = InputTensor(op_info, scope, "X");
+  const auto& y = InputTensor(op_info, scope, "Y");
+  if (x.precision() != y.precision() || out->dims() != x.dims() ||
+      (y.dims() != x.dims() && y.numel() != 1)) {
+    return false;
+  }
+  if (op_type == "elementwise_div" &&
+      ((y.precision() == PRECISION(kInt32) && HasZero<int32_t>(y)) ||
+       (y.precision() == PRECISION(kInt64) && HasZero<int64_t>(y)))) {
+    return false;
+  }
+  FOLD_WITH_PRECISION(x.precision(), Elementwise, op_type, x, y, out);
+}
+
+#undef FOLD_WITH_PRECISION
+
+bool ConstantFoldingPass::IsFoldable(SSAGraph* graph, Node* node) {
+  auto& stmt = node->AsStmt();
+  if (kUnfoldableOps.count(stmt.op_type())) return false;
+  auto* scope = stmt.op()->scope();
+  if (node->outlinks.empty()) return false;
+  std::set<std::string> in_names;
+  for (auto* in : node->inlinks) {
+    auto* var = scope->FindVar(in->arg()->name);
+    if (!var || !var->IsType<lite::Tensor>()) return false;
+    const auto& tensor = var->Get<lite::Tensor>();
+    if (!tensor.persistable() || !tensor.IsInitialized()) return false;
+    in_names.insert(in->arg()->name);
+  }
+  for (auto* out : node->outlinks) {
+    const auto& name = out->arg()->name;
+    auto* var = scope->FindVar(name);
+    if (!var || !var->IsType<lite::Tensor>()) return false;
+    if (var->Get<lite::Tensor>().persistable()) return false;
+    // inplace ops would overwrite their own inputs
+    if (in_names.count(name)) return false;
+    if (HasExtraProducers(graph, name, {stmt.op_type()})) return false;
+    for (auto* consumer : out->outlinks) {
+      if (consumer->IsStmt() && consumer->AsStmt().op_type() == "fetch") {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ConstantFoldingPass::FoldStmt(SSAGraph* graph, Node* node) {
+  auto& stmt = node->AsStmt();
+  auto op = stmt.op();
+  if (kFoldedWithoutKernels.count(stmt.op_type())) {
+    return InferOutputShapes(node) && FoldWithoutKernel(op.get());
+  }
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  // the kernels of opt do not run
+  return false;
+#else
+  auto* scope = op->scope();
+  std::vector<Place> places;
+#if defined(LITE_WITH_X86) && !defined(LITE_WITH_PYTHON)
+  places.emplace_back(TARGET(kX86), PRECISION(kFloat));
+  places.emplace_back(TARGET(kX86), PRECISION(kInt32));
+  places.emplace_back(TARGET(kX86), PRECISION(kInt64));
+#endif
+  places.emplace_back(TARGET(kHost), PRECISION(kFloat));
+  places.emplace_back(TARGET(kHost), PRECISION(kInt32));
+  places.emplace_back(TARGET(kHost), PRECISION(kInt64));
+  places.emplace_back(TARGET(kHost), PRECISION(kAny));
+  auto kernels = op->CreateKernels(places);
+
+  // The first kernel which takes the precisions of all the inputs, the
+  // arguments a kernel does not declare take any tensor.
+  KernelBase* picked = nullptr;
+  for (auto& kernel : kernels) {
+    if (kernel->target() != TARGET(kHost) &&
+        kernel->target() != TARGET(kX86)) {
+      continue;
+    }
+    bool matched = true;
+    for (auto& arg_name : stmt.op_info()->input_argnames()) {
+      const auto* decl = ParamTypeRegistry::Global().RetrieveInArgument(
+          kernel->place(), kernel->GenParamTypeKey(), arg_name);
+      if (!decl || decl->type->precision() == PRECISION(kAny)) continue;
+      for (auto& var_name : stmt.op_info()->Input(arg_name)) {
+        const auto& tensor = scope->FindVar(var_name)->Get<lite::Tensor>();
+        if (tensor.precision() != decl->type->precision()) {
+          matched = false;
+          break;
+        }
+      }
+      if (!matched) break;
+    }
+    if (matched) {
+      picked = kernel.get();
+      break;
+    }
+  }
+  if (!picked) {
+    VLOG(5) << "No host kernel of " << stmt.op_type() << " to fold";
+    return false;
+  }
+
+  if (!InferOutputShapes(node)) return false;
+  picked->SetContext(ContextScheduler::Global().NewContext(picked->target()));
+  picked->Launch();
+  return true;
+#endif
+}
+
+bool ConstantFoldingPass::InferOutputShapes(Node* node) {
+  auto& stmt = node->AsStmt();
+  auto op = stmt.op();
+  if (!op->CheckShape() || !op->InferShape()) return false;
+  int64_t numel = 0;
+  for (auto* out : node->outlinks) {
+    numel +=
+        op->scope()->FindVar(out->arg()->name)->Get<lite::Tensor>().numel();
+  }
+  if (numel > kMaxFoldedNumel) {
+    VLOG(5) << "Skip folding " << stmt.op_type() << ", its outputs hold "
+            << numel << " elements";
+    return false;
+  }
+  return true;
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    if (!IsFoldable(graph.get(), node)) continue;
+    const std::string op_type = node->AsStmt().op_type();
+    if (!FoldStmt(graph.get(), node)) continue;
+
+    // Offline calc the op, only retain its outputs as persistable tensors
+    auto* scope = node->AsStmt().op()->scope();
+    for (auto* out : node->outlinks) {
+      scope->FindVar(out->arg()->name)
+          ->GetMutable<lite::Tensor>()
+          ->set_persistable(true);
+      out->arg()->is_weight = true;
+      out->arg()->is_persist = true;
+    }
+    std::set<const Node*> nodes2rm;
+    nodes2rm.insert(node);
+    // the weights this op was the only consumer of are dropped as well
+    for (auto* in : node->inlinks) {
+      if (in->outlinks.size() == 1) nodes2rm.insert(in);
+    }
+    GraphSafeRemoveNodes(graph.get(), nodes2rm);
+    VLOG(4) << "Folded " << op_type << " into weights";
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass,
+                  paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kAny)});
@@ -0,0 +1,61 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/tensor.h"
+#include "lite/core/types.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Runs the ops whose inputs are all persistable once at optimize time and
+// replaces them with their outputs as weights. The statements are visited
+// in topological order, so a whole chain fed only by weights, such as
+// shape -> slice -> cast -> scale, is folded op by op.
+//
+// The shape, cast, slice, concat and elementwise ops on fp32, int32 and
+// int64 tensors are computed by the pass, in opt as well. The other ops run
+// their kernels of the host, and of x86 when it is compiled in. Those are
+// fakes in the opt tool, so the other ops only fold when the full predictor
+// optimizes the model at load time.
+// An op is kept when:
+//  - it has side effects or random outputs, or is control flow;
+//  - an output has another producer, feeds a fetch or is a tensor array;
+//  - no kernel takes the precisions of its inputs;
+//  - its outputs hold more than kMaxFoldedNumel elements, which would grow
+//    the model more than the computation is worth.
+class ConstantFoldingPass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  static constexpr int64_t kMaxFoldedNumel = 1 << 20;
+
+ private:
+  bool IsFoldable(SSAGraph* graph, Node* node);
+  bool FoldStmt(SSAGraph* graph, Node* node);
+  // InferShape of the op, false if it fails or the outputs are too large.
+  bool InferOutputShapes(Node* node);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,135 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+static std::vector<float> FoldedData(PassTestHelper* helper,
+                                     const std::string& name) {
+  auto* var = helper->exec_scope()->FindVar(name);
+  if (!var) return {};
+  const auto& tensor = var->Get<lite::Tensor>();
+  EXPECT_TRUE(tensor.persistable());
+  const auto* data = tensor.data<float>();
+  return std::vector<float>(data, data + tensor.numel());
+}
+
+// shape -> cast -> elementwise_mul of the weights, which opt folds too
+TEST(ConstantFoldingPass, shape_chain) {
+  PassTestHelper helper;
+  helper.AddWeight("w", {2, 3});
+  helper.AddWeight("k", {2}, 2.f);
+  helper.AddVar("s", {2});
+  helper.AddVar("sf", {2});
+  helper.AddVar("m", {2});
+  helper.AddVar("x", {2});
+  helper.AddVar("out", {2});
+  helper.AddOp("shape", {{"Input", {"w"}}}, {{"Out", {"s"}}});
+  auto* cast = helper.AddOp("cast", {{"X", {"s"}}}, {{"Out", {"sf"}}});
+  cast->SetAttr<int>("in_dtype", 2);
+  cast->SetAttr<int>("out_dtype", 5);
+  helper
+      .AddOp("elementwise_mul",
+             {{"X", {"sf"}}, {"Y", {"k"}}},
+             {{"Out", {"m"}}})
+      ->SetAttr<int>("axis", -1);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"m"}}, {"Y", {"x"}}},
+             {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("constant_folding_pass", graph);
+  for (auto type : {"shape", "cast", "elementwise_mul"}) {
+    EXPECT_TRUE(PassTestHelper::Stmts(graph, type).empty()) << type;
+  }
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "elementwise_add").size(), 1u);
+  EXPECT_EQ(FoldedData(&helper, "m"), std::vector<float>({4.f, 6.f}));
+}
+
+TEST(ConstantFoldingPass, slice_concat) {
+  PassTestHelper helper;
+  auto* w = helper.AddWeight("w", {2, 3});
+  for (int i = 0; i < 6; i++) w->mutable_data<float>()[i] = i;
+  helper.AddWeight("b", {2, 1}, -1.f);
+  helper.AddVar("sliced", {2, 2});
+  helper.AddVar("c", {2, 3});
+  helper.AddVar("x", {2, 3});
+  helper.AddVar("out", {2, 3});
+  auto* slice =
+      helper.AddOp("slice", {{"Input", {"w"}}}, {{"Out", {"sliced"}}});
+  slice->SetAttr<std::vector<int>>("axes", {1});
+  slice->SetAttr<std::vector<int>>("starts", {1});
+  slice->SetAttr<std::vector<int>>("ends", {3});
+  slice->SetAttr<std::vector<int>>("infer_flags", {1});
+  slice->SetAttr<std::vector<int>>("decrease_axis", {});
+  helper.AddOp("concat", {{"X", {"sliced", "b"}}}, {{"Out", {"c"}}})
+      ->SetAttr<int>("axis", 1);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"c"}}, {"Y", {"x"}}},
+             {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("constant_folding_pass", graph);
+  EXPECT_TRUE(PassTestHelper::Stmts(graph, "slice").empty());
+  EXPECT_TRUE(PassTestHelper::Stmts(graph, "concat").empty());
+  EXPECT_EQ(FoldedData(&helper, "c"),
+            std::vector<float>({1.f, 2.f, -1.f, 4.f, 5.f, -1.f}));
+}
+
+// an integer division by a 0 divisor is left to run, not folded
+TEST(ConstantFoldingPass, int_div_by_zero) {
+  PassTestHelper helper;
+  helper.AddWeight("w", {2, 3});
+  auto* zero = helper.AddWeight("zero", {2});
+  auto* zero_data = zero->mutable_data<int32_t>();
+  zero_data[0] = 1;
+  zero_data[1] = 0;
+  helper.AddVar("s", {2});
+  helper.AddVar("d", {2});
+  helper.AddVar("x", {2});
+  helper.AddVar("out", {2});
+  helper.AddOp("shape", {{"Input", {"w"}}}, {{"Out", {"s"}}});
+  helper
+      .AddOp("elementwise_div",
+             {{"X", {"s"}}, {"Y", {"zero"}}},
+             {{"Out", {"d"}}})
+      ->SetAttr<int>("axis", -1);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"d"}}, {"Y", {"x"}}},
+             {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("constant_folding_pass", graph);
+  EXPECT_TRUE(PassTestHelper::Stmts(graph, "shape").empty());
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "elementwise_div").size(), 1u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,282 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/redundant_op_elimination_pass.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The ops which may give different outputs for the same inputs, or which
+// read or write more than their links show.
+static const std::set<std::string> kUnmergeableOps = {
+    "feed",
+    "fetch",
+    "while",
+    "conditional_block",
+    "subgraph",
+    "uniform_random",
+    "gaussian_random",
+    "randint",
+    "randperm",
+    "sampling_id",
+    "write_to_array",
+    "read_from_array",
+    "lod_array_length",
+    "increment",
+    "print",
+};
+
+// The ops which are kept even if nothing reads their outputs.
+static const std::set<std::string> kSideEffectOps = {
+    "feed",
+    "fetch",
+    "while",
+    "conditional_block",
+    "subgraph",
+    "write_to_array",
+    "increment",
+    "print",
+    "save",
+    "assign",
+};
+
+// The attributes which only describe where an op came from.
+static const std::set<std::string> kIgnoredAttrs = {
+    "op_callstack", "op_namescope", "op_role", "op_role_var", "op_device"};
+
+static void AppendValue(std::ostringstream* os, const std::string& x) {
+  *os << x.size() << '#' << x;
+}
+static void AppendValue(std::ostringstream* os, bool x) { *os << x; }
+static void AppendValue(std::ostringstream* os, int32_t x) { *os << x; }
+static void AppendValue(std::ostringstream* os, int64_t x) { *os << x; }
+// The bits of the floats, so that the keys compare them exactly.
+static void AppendValue(std::ostringstream* os, float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  *os << bits;
+}
+static void AppendValue(std::ostringstream* os, double x) {
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  *os << bits;
+}
+template <typename T>
+static void AppendValue(std::ostringstream* os, const std::vector<T>& x) {
+  *os << '[';
+  for (const auto& v : x) {
+    AppendValue(os, v);
+    *os << ',';
+  }
+  *os << ']';
+}
+
+bool RedundantOpEliminationPass::GenOpKey(
+    const Node* node,
+    const std::map<const Node*, int>& arg_ids,
+    std::string* key) {
+  auto* op_info = node->stmt()->op_info();
+  if (kUnmergeableOps.count(op_info->Type())) return false;
+  std::unordered_map<std::string, const Node*> in_nodes;
+  for (auto* in : node->inlinks) {
+    in_nodes[in->arg()->name] = in;
+  }
+
+  std::ostringstream os;
+  os << op_info->Type() << ';';
+  // the inputs by node rather than by name, a var written twice is two
+  // nodes of the same name
+  for (auto& arg_name : op_info->input_argnames()) {
+    os << arg_name << '(';
+    for (auto& var_name : op_info->Input(arg_name)) {
+      auto it = in_nodes.find(var_name);
+      if (it == in_nodes.end()) return false;
+      os << arg_ids.at(it->second) << ',';
+    }
+    os << ')';
+  }
+  for (auto& arg_name : op_info->output_argnames()) {
+    os << arg_name << '(' << op_info->Output(arg_name).size() << ')';
+  }
+  for (auto& attr : op_info->attr_types()) {
+    const auto& attr_name = attr.first;
+    if (kIgnoredAttrs.count(attr_name)) continue;
+    os << attr_name << '=';
+    switch (attr.second) {
+#define APPEND_ATTR(attr_type, cpp_type)                     \
+  case cpp::OpDesc::AttrType::attr_type:                     \
+    AppendValue(&os, op_info->GetAttr<cpp_type>(attr_name)); \
+    break
+      APPEND_ATTR(INT, int32_t);
+      APPEND_ATTR(FLOAT, float);
+      APPEND_ATTR(STRING, std::string);
+      APPEND_ATTR(INTS, std::vector<int32_t>);
+      APPEND_ATTR(FLOATS, std::vector<float>);
+      APPEND_ATTR(STRINGS, std::vector<std::string>);
+      APPEND_ATTR(BOOLEAN, bool);
+      APPEND_ATTR(LONG, int64_t);
+      APPEND_ATTR(LONGS, std::vector<int64_t>);
+      APPEND_ATTR(FLOAT64, double);
+      APPEND_ATTR(FLOAT64S, std::vector<double>);
+#undef APPEND_ATTR
+      default:
+        // the ops with sub blocks or unknown attributes are kept
+        return false;
+    }
+    os << ';';
+  }
+  *key = os.str();
+  return true;
+}
+
+void RedundantOpEliminationPass::EliminateCommonSubexpressions(
+    SSAGraph* graph) {
+  std::map<const Node*, int> arg_ids;
+  // the outputs are renamed in their consumers, which is only safe when no
+  // other node has the same name
+  std::map<std::string, int> name_count;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsArg()) continue;
+    arg_ids.emplace(&node, arg_ids.size());
+    name_count[node.arg()->name]++;
+  }
+  auto is_mergeable_output = [&](const Node* out) {
+    if (name_count[out->arg()->name] != 1) return false;
+    if (out->arg()->is_weight || out->arg()->is_persist) return false;
+    for (auto* consumer : out->outlinks) {
+      auto* consumer_info = consumer->stmt()->op_info();
+      // the fetched names are looked up by the users, the sub blocks read
+      // their vars by name
+      if (consumer_info->Type() == "fetch" ||
+          consumer_info->HasAttr("sub_block")) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::unordered_map<std::string, Node*> key_to_node;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    std::string key;
+    if (!GenOpKey(node, arg_ids, &key)) continue;
+    bool mergeable = !node->outlinks.empty();
+    for (auto* out : node->outlinks) {
+      mergeable = mergeable && is_mergeable_output(out);
+    }
+    if (!mergeable) continue;
+    auto it = key_to_node.find(key);
+    if (it == key_to_node.end()) {
+      key_to_node.emplace(key, node);
+      continue;
+    }
+
+    // the same computation as an earlier op, read its outputs instead
+    Node* to_keep = it->second;
+    auto* keep_info = to_keep->stmt()->op_info();
+    auto* remove_info = node->stmt()->op_info();
+    std::set<const Node*> nodes2rm = {node};
+    for (auto& arg_name : keep_info->output_argnames()) {
+      const auto& keep_names = keep_info->Output(arg_name);
+      const auto& remove_names = remove_info->Output(arg_name);
+      CHECK_EQ(keep_names.size(), remove_names.size());
+      for (size_t i = 0; i < keep_names.size(); ++i) {
+        auto* keep_node = graph->RetrieveArgument(keep_names[i]);
+        auto* remove_node = graph->RetrieveArgument(remove_names[i]);
+        nodes2rm.insert(remove_node);
+        for (auto* consumer : remove_node->outlinks) {
+          auto new_op_info = *consumer->stmt()->op_info();
+          new_op_info.UpdateAllInputs(remove_names[i], keep_names[i]);
+          consumer->stmt()->ResetOp(new_op_info, graph->valid_places());
+          // a consumer of both outputs reads the kept one already
+          if (std::find(keep_node->outlinks.begin(),
+                        keep_node->outlinks.end(),
+                        consumer) == keep_node->outlinks.end()) {
+            DirectedLink(keep_node, consumer);
+          }
+        }
+      }
+    }
+    VLOG(4) << "Merge " << remove_info->Type() << " into the same op";
+    GraphSafeRemoveNodes(graph, nodes2rm);
+  }
+}
+
+void RedundantOpEliminationPass::EliminateDeadOps(SSAGraph* graph) {
+  // mark the ops which the fetches and the side effects depend on, from the
+  // end of the graph backward
+  std::set<const Node*> live;
+  std::vector<const Node*> worklist;
+  bool has_fetch = false;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsStmt()) continue;
+    auto* op_info = node.stmt()->op_info();
+    bool keep = kSideEffectOps.count(op_info->Type()) ||
+                op_info->HasAttr("sub_block");
+    for (auto* out : node.outlinks) {
+      keep = keep || out->arg()->is_weight || out->arg()->is_persist;
+    }
+    has_fetch = has_fetch || op_info->Type() == "fetch";
+    if (keep && live.insert(&node).second) worklist.push_back(&node);
+  }
+  // without fetches the outputs are read some other way, keep everything
+  if (!has_fetch) return;
+  while (!worklist.empty()) {
+    auto* stmt = worklist.back();
+    worklist.pop_back();
+    for (auto* in : stmt->inlinks) {
+      for (auto* producer : in->inlinks) {
+        if (live.insert(producer).second) worklist.push_back(producer);
+      }
+    }
+  }
+
+  std::set<const Node*> nodes2rm;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsStmt()) {
+      if (!live.count(&node)) {
+        VLOG(4) << "Remove dead op " << node.stmt()->op_type();
+        nodes2rm.insert(&node);
+      }
+      continue;
+    }
+    // the vars which only the dead ops produce or read
+    bool used = false;
+    for (auto* stmt : node.inlinks) used = used || live.count(stmt);
+    for (auto* stmt : node.outlinks) used = used || live.count(stmt);
+    if (!used) nodes2rm.insert(&node);
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+}
+
+void RedundantOpEliminationPass::Apply(
+    const std::unique_ptr<SSAGraph>& graph) {
+  EliminateCommonSubexpressions(graph.get());
+  EliminateDeadOps(graph.get());
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(redundant_op_elimination_pass,
+                  paddle::lite::mir::RedundantOpEliminationPass)
+    .BindTargets({TARGET(kAny)});
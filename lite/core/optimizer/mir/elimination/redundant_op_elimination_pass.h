@@ -0,0 +1,56 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * mir::RedundantOpEliminationPass is the target independent common
+ * subexpression and dead op elimination on the SSAGraph:
+ *  - the ops are keyed by their type, attributes and input nodes in
+ *    topological order, an op with the key of an earlier one is removed and
+ *    its consumers read the outputs of the earlier one instead, so the
+ *    repeated shape/slice/transpose/matmul of multi-branch graphs run once;
+ *  - the ops whose outputs never reach a fetch or an op with side effects
+ *    are removed.
+ * It runs after the fusions: the ops it merges have the consumers of all
+ * the duplicates, which keeps the fusers expecting a single consumer from
+ * matching them.
+ */
+class RedundantOpEliminationPass : public mir::StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  void EliminateCommonSubexpressions(SSAGraph* graph);
+  void EliminateDeadOps(SSAGraph* graph);
+  // Returns false for the ops which must not be merged.
+  bool GenOpKey(const Node* node,
+                const std::map<const Node*, int>& arg_ids,
+                std::string* key);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+// relu(x) twice, the two results into the consumers given
+static std::unique_ptr<SSAGraph> BuildDuplicates(PassTestHelper* helper,
+                                                 bool one_consumer) {
+  helper->AddVar("x", {2, 8});
+  helper->AddVar("a", {2, 8});
+  helper->AddVar("b", {2, 8});
+  helper->AddVar("out", {2, 8});
+  helper->AddOp("relu", {{"X", {"x"}}}, {{"Out", {"a"}}});
+  helper->AddOp("relu", {{"X", {"x"}}}, {{"Out", {"b"}}});
+  if (one_consumer) {
+    helper
+        ->AddOp("elementwise_add",
+                {{"X", {"a"}}, {"Y", {"b"}}},
+                {{"Out", {"out"}}})
+        ->SetAttr<int>("axis", -1);
+  } else {
+    helper->AddVar("out2", {2, 8});
+    helper->AddOp("softmax", {{"X", {"a"}}}, {{"Out", {"out"}}})
+        ->SetAttr<int>("axis", -1);
+    helper->AddOp("softmax", {{"X", {"b"}}}, {{"Out", {"out2"}}})
+        ->SetAttr<int>("axis", 0);
+  }
+  return helper->BuildGraph(kPlaces);
+}
+
+static Node* ArgNode(const std::unique_ptr<SSAGraph>& graph,
+                     const std::string& name) {
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg() && node.arg()->name == name) return &node;
+  }
+  return nullptr;
+}
+
+TEST(RedundantOpEliminationPass, merge_into_consumers) {
+  PassTestHelper helper;
+  auto graph = BuildDuplicates(&helper, false);
+  PassTestHelper::ApplyPass("redundant_op_elimination_pass", graph);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "relu").size(), 1u);
+  EXPECT_EQ(ArgNode(graph, "b"), nullptr);
+  auto* a = ArgNode(graph, "a");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(a->outlinks.size(), 2u);
+  for (auto* softmax : PassTestHelper::Stmts(graph, "softmax")) {
+    EXPECT_EQ(softmax->stmt()->op_info()->Input("X"),
+              std::vector<std::string>{"a"});
+  }
+}
+
+TEST(RedundantOpEliminationPass, consumer_of_both) {
+  PassTestHelper helper;
+  auto graph = BuildDuplicates(&helper, true);
+  PassTestHelper::ApplyPass("redundant_op_elimination_pass", graph);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "relu").size(), 1u);
+  auto adds = PassTestHelper::Stmts(graph, "elementwise_add");
+  ASSERT_EQ(adds.size(), 1u);
+  auto* add = adds.front();
+  EXPECT_EQ(add->stmt()->op_info()->Input("Y"),
+            std::vector<std::string>{"a"});
+  // one link from a to the add, which reads it as X and Y
+  auto* a = ArgNode(graph, "a");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(a->outlinks.size(), 1u);
+  EXPECT_EQ(std::count(add->inlinks.begin(), add->inlinks.end(), a), 1);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
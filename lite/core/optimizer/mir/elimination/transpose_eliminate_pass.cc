@@ -0,0 +1,460 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/elimination/transpose_eliminate_pass.h"
+#include <algorithm>
+#include <list>
+#include <set>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::set<std::string> kTransposeOps = {"transpose",
+                                                    "transpose2"};
+
+// The ops which compute every element from the element at the same place,
+// whatever the order of the dims.
+static const std::set<std::string> kUnaryOps = {
+    "relu",
+    "relu6",
+    "leaky_relu",
+    "sigmoid",
+    "tanh",
+    "swish",
+    "gelu",
+    "hard_swish",
+    "hard_sigmoid",
+    "elu",
+    "exp",
+    "log",
+    "abs",
+    "sqrt",
+    "rsqrt",
+    "square",
+    "sign",
+    "erf",
+    "softplus",
+    "mish",
+    "silu",
+    "scale",
+    "clip",
+    "pow",
+    "floor",
+    "round",
+    "reciprocal",
+};
+static const std::set<std::string> kBinaryOps = {"elementwise_add",
+                                                 "elementwise_sub",
+                                                 "elementwise_mul",
+                                                 "elementwise_div",
+                                                 "elementwise_max",
+                                                 "elementwise_min",
+                                                 "elementwise_pow"};
+static const std::set<std::string> kReduceOps = {"reduce_sum",
+                                                 "reduce_mean",
+                                                 "reduce_max",
+                                                 "reduce_min",
+                                                 "reduce_prod"};
+
+static Node* FindArg(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->arg()->name == name) return link;
+  }
+  return nullptr;
+}
+
+static Node* InputNode(Node* stmt, const std::string& arg_name) {
+  auto* op_info = stmt->stmt()->op_info();
+  if (!op_info->HasInput(arg_name)) return nullptr;
+  auto names = op_info->Input(arg_name);
+  return names.size() == 1 ? FindArg(stmt->inlinks, names.front()) : nullptr;
+}
+
+static Node* OutputNode(Node* stmt, const std::string& arg_name) {
+  auto* op_info = stmt->stmt()->op_info();
+  if (!op_info->HasOutput(arg_name)) return nullptr;
+  auto names = op_info->Output(arg_name);
+  return names.size() == 1 ? FindArg(stmt->outlinks, names.front()) : nullptr;
+}
+
+static std::vector<int> GetPerm(Node* transpose) {
+  return transpose->stmt()->op_info()->GetAttr<std::vector<int>>("axis");
+}
+
+static bool IsIdentity(const std::vector<int>& perm) {
+  for (size_t i = 0; i < perm.size(); i++) {
+    if (perm[i] != static_cast<int>(i)) return false;
+  }
+  return true;
+}
+
+// The dims attr of the reduce, in [0, rank), empty for reduce_all.
+static std::vector<int> GetReduceDims(const OpInfo* op_info, int rank) {
+  if (op_info->HasAttr("reduce_all") && op_info->GetAttr<bool>("reduce_all")) {
+    return {};
+  }
+  auto dims = op_info->GetAttr<std::vector<int>>("dim");
+  for (auto& d : dims) {
+    if (d < 0) d += rank;
+  }
+  return dims;
+}
+
+void TransposeEliminatePass::SetAllGraphs(
+    std::vector<std::unique_ptr<mir::SSAGraph>>* graphs) {
+  graphs_ = graphs;
+}
+
+bool TransposeEliminatePass::IsTranspose(Node* node) {
+  if (!node->IsStmt() ||
+      !kTransposeOps.count(node->stmt()->op_info()->Type())) {
+    return false;
+  }
+  if (!InputNode(node, "X") || !OutputNode(node, "Out")) return false;
+  // the XShape goes away with the transpose
+  auto* xshape = OutputNode(node, "XShape");
+  return !xshape ||
+         (xshape->outlinks.empty() && name_count_[xshape->arg()->name] == 1);
+}
+
+bool TransposeEliminatePass::IsSingleUse(const Node* var) {
+  if (var->outlinks.size() != 1 || name_count_[var->arg()->name] != 1 ||
+      var->arg()->is_weight || var->arg()->is_persist) {
+    return false;
+  }
+  auto* reader = var->outlinks.front()->stmt()->op_info();
+  return reader->Type() != "fetch" && !reader->HasAttr("sub_block");
+}
+
+bool TransposeEliminatePass::IsReplaceable(const Node* var) {
+  if (name_count_[var->arg()->name] != 1 || var->arg()->is_weight ||
+      var->arg()->is_persist) {
+    return false;
+  }
+  for (auto* reader : var->outlinks) {
+    auto* op_info = reader->stmt()->op_info();
+    // the fetched names are looked up by the users, the sub blocks read
+    // their vars by name
+    if (op_info->Type() == "fetch" || op_info->HasAttr("sub_block")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TransposeEliminatePass::RemoveTranspose(SSAGraph* graph,
+                                             Node* transpose) {
+  auto* in = InputNode(transpose, "X");
+  auto* out = OutputNode(transpose, "Out");
+  std::vector<Node*> readers(out->outlinks.begin(), out->outlinks.end());
+  for (auto* reader : readers) {
+    auto op_desc = *reader->stmt()->op_info();
+    op_desc.UpdateAllInputs(out->arg()->name, in->arg()->name);
+    reader->stmt()->ResetOp(op_desc, graph->valid_places());
+    RemoveDirectedLink(out, reader);
+    DirectedLink(in, reader);
+  }
+  std::set<const Node*> nodes2rm = {transpose};
+  for (auto* var : transpose->outlinks) nodes2rm.insert(var);
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  removed_.insert(transpose);
+}
+
+void TransposeEliminatePass::SwapWithNext(SSAGraph* graph,
+                                          Node* transpose,
+                                          Node* op,
+                                          OpInfo* op_desc,
+                                          const std::vector<int>& perm) {
+  auto* in = InputNode(transpose, "X");
+  auto* mid = OutputNode(transpose, "Out");
+  auto* out = OutputNode(op, "Out");
+  // the op writes mid, which the transpose reads
+  op_desc->UpdateAllInputs(mid->arg()->name, in->arg()->name);
+  op_desc->SetOutput("Out", {mid->arg()->name});
+  op->stmt()->ResetOp(*op_desc, graph->valid_places());
+  auto transpose_desc = *transpose->stmt()->op_info();
+  transpose_desc.SetInput("X", {mid->arg()->name});
+  transpose_desc.SetOutput("Out", {out->arg()->name});
+  transpose_desc.SetAttr("axis", perm);
+  transpose->stmt()->ResetOp(transpose_desc, graph->valid_places());
+
+  RemoveDirectedLink(in, transpose);
+  RemoveDirectedLink(transpose, mid);
+  RemoveDirectedLink(mid, op);
+  RemoveDirectedLink(op, out);
+  DirectedLink(in, op);
+  DirectedLink(op, mid);
+  DirectedLink(mid, transpose);
+  DirectedLink(transpose, out);
+
+  // mid holds the output of the op before the transpose now, for the passes
+  // which read the shapes of the vars
+  auto* scope = op->stmt()->op()->scope();
+  auto* mid_var = scope ? scope->FindVar(mid->arg()->name) : nullptr;
+  auto* out_var = scope ? scope->FindVar(out->arg()->name) : nullptr;
+  if (mid_var && out_var && mid_var->IsType<lite::Tensor>() &&
+      out_var->IsType<lite::Tensor>()) {
+    auto out_dims = out_var->Get<lite::Tensor>().dims();
+    if (out_dims.size() == perm.size()) {
+      std::vector<int64_t> mid_dims(perm.size());
+      for (size_t i = 0; i < perm.size(); i++) {
+        mid_dims[perm[i]] = out_dims[i];
+      }
+      mid_var->GetMutable<lite::Tensor>()->Resize(mid_dims);
+    }
+  }
+}
+
+bool TransposeEliminatePass::MergeTransposes(SSAGraph* graph,
+                                             Node* transpose) {
+  auto perm = GetPerm(transpose);
+  auto* out = OutputNode(transpose, "Out");
+  if (IsIdentity(perm)) {
+    if (!IsReplaceable(out)) return false;
+    RemoveTranspose(graph, transpose);
+    return true;
+  }
+  if (!IsSingleUse(out) || !IsTranspose(out->outlinks.front())) return false;
+  auto* next = out->outlinks.front();
+  auto next_perm = GetPerm(next);
+  if (next_perm.size() != perm.size()) return false;
+  // the next one reads the input of this one with the dims of both
+  std::vector<int> merged_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    merged_perm[i] = perm[next_perm[i]];
+  }
+  auto* in = InputNode(transpose, "X");
+  auto next_desc = *next->stmt()->op_info();
+  next_desc.UpdateAllInputs(out->arg()->name, in->arg()->name);
+  next_desc.SetAttr("axis", merged_perm);
+  next->stmt()->ResetOp(next_desc, graph->valid_places());
+  RemoveDirectedLink(out, next);
+  DirectedLink(in, next);
+  std::set<const Node*> nodes2rm = {transpose};
+  for (auto* var : transpose->outlinks) nodes2rm.insert(var);
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  removed_.insert(transpose);
+  VLOG(4) << "Merge two transposes";
+  return true;
+}
+
+bool TransposeEliminatePass::FoldIntoMatmul(SSAGraph* graph,
+                                            Node* transpose) {
+  // only the swap of the last two dims
+  auto perm = GetPerm(transpose);
+  const int rank = perm.size();
+  if (rank < 2 || perm[rank - 1] != rank - 2 || perm[rank - 2] != rank - 1) {
+    return false;
+  }
+  for (int i = 0; i < rank - 2; i++) {
+    if (perm[i] != i) return false;
+  }
+  auto* out = OutputNode(transpose, "Out");
+  if (!IsSingleUse(out)) return false;
+  auto* matmul = out->outlinks.front();
+  auto op_desc = *matmul->stmt()->op_info();
+  std::string attr_x;
+  std::string attr_y;
+  if (op_desc.Type() == "matmul") {
+    attr_x = "transpose_X";
+    attr_y = "transpose_Y";
+  } else if (op_desc.Type() == "matmul_v2") {
+    attr_x = "trans_x";
+    attr_y = "trans_y";
+  } else {
+    return false;
+  }
+  auto x = op_desc.Input("X");
+  auto y = op_desc.Input("Y");
+  if (x.size() != 1 || y.size() != 1 || x.front() == y.front()) return false;
+  const auto& attr = x.front() == out->arg()->name ? attr_x : attr_y;
+  bool trans = op_desc.HasAttr(attr) && op_desc.GetAttr<bool>(attr);
+  op_desc.SetAttr(attr, !trans);
+  matmul->stmt()->ResetOp(op_desc, graph->valid_places());
+  RemoveTranspose(graph, transpose);
+  VLOG(4) << "Fold a transpose into " << op_desc.Type();
+  return true;
+}
+
+bool TransposeEliminatePass::SinkThroughElementwise(SSAGraph* graph,
+                                                    Node* transpose) {
+  auto* mid = OutputNode(transpose, "Out");
+  if (!IsSingleUse(mid)) return false;
+  auto* op = mid->outlinks.front();
+  auto op_desc = *op->stmt()->op_info();
+  if (!OutputNode(op, "Out") || op->outlinks.size() != 1) return false;
+  auto perm = GetPerm(transpose);
+  if (kUnaryOps.count(op_desc.Type())) {
+    auto x = op_desc.Input("X");
+    if (x.size() != 1 || x.front() != mid->arg()->name) return false;
+    SwapWithNext(graph, transpose, op, &op_desc, perm);
+    VLOG(4) << "Sink a transpose below " << op_desc.Type();
+    return true;
+  }
+  if (!kBinaryOps.count(op_desc.Type())) return false;
+  if (op_desc.HasAttr("axis") && op_desc.GetAttr<int>("axis") != -1) {
+    return false;
+  }
+  auto x = op_desc.Input("X");
+  auto y = op_desc.Input("Y");
+  if (x.size() != 1 || y.size() != 1 || x.front() == y.front()) return false;
+  auto* other = FindArg(
+      op->inlinks, x.front() == mid->arg()->name ? y.front() : x.front());
+  if (!other) return false;
+  // a scalar weight is the same in any order of the dims
+  auto* scope = op->stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(other->arg()->name) : nullptr;
+  if (other->arg()->is_weight && var && var->IsType<lite::Tensor>() &&
+      var->Get<lite::Tensor>().numel() == 1 &&
+      var->Get<lite::Tensor>().dims().size() <= perm.size()) {
+    SwapWithNext(graph, transpose, op, &op_desc, perm);
+    VLOG(4) << "Sink a transpose below " << op_desc.Type();
+    return true;
+  }
+  // both inputs transposed the same way, the transpose of the other one goes
+  // away
+  if (other->inlinks.size() != 1 || !IsTranspose(other->inlinks.front()) ||
+      !IsSingleUse(other) || GetPerm(other->inlinks.front()) != perm) {
+    return false;
+  }
+  auto* other_transpose = other->inlinks.front();
+  auto* other_in = InputNode(other_transpose, "X");
+  op_desc.UpdateAllInputs(other->arg()->name, other_in->arg()->name);
+  RemoveDirectedLink(other, op);
+  DirectedLink(other_in, op);
+  SwapWithNext(graph, transpose, op, &op_desc, perm);
+  std::set<const Node*> nodes2rm = {other_transpose};
+  for (auto* var : other_transpose->outlinks) nodes2rm.insert(var);
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  removed_.insert(other_transpose);
+  VLOG(4) << "Sink the transposes of both inputs below " << op_desc.Type();
+  return true;
+}
+
+bool TransposeEliminatePass::SinkThroughReduce(SSAGraph* graph,
+                                               Node* transpose) {
+  auto* mid = OutputNode(transpose, "Out");
+  if (!IsSingleUse(mid)) return false;
+  auto* reduce = mid->outlinks.front();
+  auto op_desc = *reduce->stmt()->op_info();
+  if (!kReduceOps.count(op_desc.Type()) || !OutputNode(reduce, "Out") ||
+      reduce->outlinks.size() != 1) {
+    return false;
+  }
+  auto perm = GetPerm(transpose);
+  const int rank = perm.size();
+  auto dims = GetReduceDims(&op_desc, rank);
+  bool keep_dim =
+      op_desc.HasAttr("keep_dim") && op_desc.GetAttr<bool>("keep_dim");
+  // the dims of the input of the transpose to reduce
+  std::vector<int> in_dims;
+  for (auto d : dims) {
+    if (d < 0 || d >= rank) return false;
+    in_dims.push_back(perm[d]);
+  }
+  // the order of the dims left, which is the same if they are kept
+  std::vector<int> out_perm = perm;
+  if (!keep_dim) {
+    std::vector<int> left;
+    for (int i = 0; i < rank; i++) {
+      if (std::find(dims.begin(), dims.end(), i) == dims.end()) {
+        left.push_back(perm[i]);
+      }
+    }
+    auto sorted = left;
+    std::sort(sorted.begin(), sorted.end());
+    out_perm.clear();
+    for (auto d : left) {
+      out_perm.push_back(std::lower_bound(sorted.begin(), sorted.end(), d) -
+                         sorted.begin());
+    }
+  }
+  if (dims.empty() || IsIdentity(out_perm)) {
+    // the reduce of the input gives the output directly
+    if (!dims.empty()) {
+      op_desc.SetAttr("dim", in_dims);
+      reduce->stmt()->ResetOp(op_desc, graph->valid_places());
+    }
+    RemoveTranspose(graph, transpose);
+  } else {
+    op_desc.SetAttr("dim", in_dims);
+    SwapWithNext(graph, transpose, reduce, &op_desc, out_perm);
+  }
+  VLOG(4) << "Sink a transpose below " << op_desc.Type();
+  return true;
+}
+
+void TransposeEliminatePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // the names of the other blocks count too, a var which a sub block reads
+  // or writes is never more than once in the whole program
+  name_count_.clear();
+  std::vector<SSAGraph*> graphs{graph.get()};
+  if (graphs_) {
+    for (auto& other : *graphs_) {
+      if (other.get() != graph.get()) graphs.push_back(other.get());
+    }
+  }
+  for (auto* g : graphs) {
+    for (auto& node : g->mutable_nodes()) {
+      if (node.IsArg()) name_count_[node.arg()->name]++;
+    }
+  }
+
+  // a rewrite only changes the transposes next to it, so rather than
+  // starting over after each one, those are visited again from a worklist:
+  // the one moved below an op, the one merged into and the one before.
+  std::list<Node*> worklist;
+  std::set<Node*> queued;
+  removed_.clear();
+  auto push = [&](Node* node) {
+    if (node && !removed_.count(node) && IsTranspose(node) &&
+        queued.insert(node).second) {
+      worklist.push_back(node);
+    }
+  };
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    push(node);
+  }
+  while (!worklist.empty()) {
+    auto* transpose = worklist.front();
+    worklist.pop_front();
+    queued.erase(transpose);
+    if (removed_.count(transpose) || !IsTranspose(transpose)) continue;
+    auto* in = InputNode(transpose, "X");
+    auto* out = OutputNode(transpose, "Out");
+    Node* prev = in->inlinks.size() == 1 ? in->inlinks.front() : nullptr;
+    Node* next = out->outlinks.size() == 1 ? out->outlinks.front() : nullptr;
+    if (!MergeTransposes(graph.get(), transpose) &&
+        !FoldIntoMatmul(graph.get(), transpose) &&
+        !SinkThroughElementwise(graph.get(), transpose) &&
+        !SinkThroughReduce(graph.get(), transpose)) {
+      continue;
+    }
+    push(transpose);
+    push(next);
+    push(prev);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(transpose_eliminate_pass,
+                  paddle::lite::mir::TransposeEliminatePass)
+    .BindTargets({TARGET(kAny)})
+    .ExcludeTargets({TARGET(kXPU), TARGET(kNNAdapter)});
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * TransposeEliminatePass removes the transposes which the models converted
+ * from the other frameworks are full of:
+ *  - a transpose is sunk below the elementwise ops and the activations which
+ *    do not care about the layout, and the reduces with the dims remapped,
+ *    so that it meets the transposes after it, e.g.
+ *      transpose(0,2,3,1) -> relu -> transpose(0,3,1,2)
+ *    becomes a relu alone;
+ *  - two transposes in a row are merged into one, which is removed if it
+ *    keeps the order of the dims;
+ *  - a transpose of the last two dims into a matmul or matmul_v2 is folded
+ *    into its transpose_X/transpose_Y (trans_x/trans_y).
+ */
+class TransposeEliminatePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+  // The graphs of all the blocks, the vars which the other blocks read or
+  // write are left alone. nullptr for the graph given to Apply alone.
+  void SetAllGraphs(std::vector<std::unique_ptr<mir::SSAGraph>>* graphs);
+
+ private:
+  // A transpose whose XShape, if any, is not read.
+  bool IsTranspose(Node* node);
+  // Each of them rewrites the graph around the transpose and returns true,
+  // or returns false with the graph unchanged.
+  bool MergeTransposes(SSAGraph* graph, Node* transpose);
+  bool FoldIntoMatmul(SSAGraph* graph, Node* transpose);
+  bool SinkThroughElementwise(SSAGraph* graph, Node* transpose);
+  bool SinkThroughReduce(SSAGraph* graph, Node* transpose);
+
+  // Whether the var is only read by the op after it, which can take its
+  // place or give it another value.
+  bool IsSingleUse(const Node* var);
+  // Whether the readers of the var can read another var instead.
+  bool IsReplaceable(const Node* var);
+  // Makes the readers of the output of the transpose read its input, and
+  // removes the transpose.
+  void RemoveTranspose(SSAGraph* graph, Node* transpose);
+  // Moves the transpose from the input of the op to its output:
+  //   in -> transpose -> mid -> op -> out
+  // becomes
+  //   in -> op -> mid -> transpose -> out
+  // with the op desc of the op given.
+  void SwapWithNext(SSAGraph* graph,
+                    Node* transpose,
+                    Node* op,
+                    OpInfo* op_desc,
+                    const std::vector<int>& perm);
+
+  // the number of the var nodes of each name in all the graphs
+  std::map<std::string, int> name_count_;
+  // the transposes removed by the rewrites of this Apply
+  std::set<const Node*> removed_;
+  std::vector<std::unique_ptr<mir::SSAGraph>>* graphs_{nullptr};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
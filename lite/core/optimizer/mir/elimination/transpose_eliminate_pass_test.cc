@@ -0,0 +1,144 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/elimination/transpose_eliminate_pass.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+static void AddTranspose(PassTestHelper* helper,
+                         const std::string& x,
+                         const std::string& out,
+                         const std::vector<int>& axis) {
+  helper->AddOp("transpose2", {{"X", {x}}}, {{"Out", {out}}})
+      ->SetAttr<std::vector<int>>("axis", axis);
+}
+
+static std::vector<std::string> InputNames(Node* stmt,
+                                           const std::string& arg) {
+  return stmt->stmt()->op_info()->Input(arg);
+}
+
+// transpose -> relu -> transpose back -> softmax
+static void BuildSinkModel(PassTestHelper* helper, bool persistable_mid) {
+  helper->AddVar("x", {1, 4, 5, 3});
+  if (persistable_mid) {
+    helper->AddWeight("t0", {1, 3, 4, 5});
+  } else {
+    helper->AddVar("t0", {1, 3, 4, 5});
+  }
+  helper->AddVar("r", {1, 3, 4, 5});
+  helper->AddVar("t1", {1, 4, 5, 3});
+  helper->AddVar("out", {1, 4, 5, 3});
+  AddTranspose(helper, "x", "t0", {0, 3, 1, 2});
+  helper->AddOp("relu", {{"X", {"t0"}}}, {{"Out", {"r"}}});
+  AddTranspose(helper, "r", "t1", {0, 2, 3, 1});
+  helper->AddOp("softmax", {{"X", {"t1"}}}, {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+}
+
+TEST(TransposeEliminatePass, sink_and_cancel) {
+  PassTestHelper helper;
+  BuildSinkModel(&helper, false);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("transpose_eliminate_pass", graph);
+  EXPECT_TRUE(PassTestHelper::Stmts(graph, "transpose2").empty());
+  auto relu = PassTestHelper::Stmts(graph, "relu");
+  ASSERT_EQ(relu.size(), 1u);
+  EXPECT_EQ(InputNames(relu.front(), "X"), std::vector<std::string>{"x"});
+}
+
+TEST(TransposeEliminatePass, merge) {
+  PassTestHelper helper;
+  helper.AddVar("x", {2, 3, 4});
+  helper.AddVar("t0", {3, 2, 4});
+  helper.AddVar("t1", {3, 4, 2});
+  helper.AddVar("out", {3, 4, 2});
+  AddTranspose(&helper, "x", "t0", {1, 0, 2});
+  AddTranspose(&helper, "t0", "t1", {0, 2, 1});
+  helper.AddOp("softmax", {{"X", {"t1"}}}, {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("transpose_eliminate_pass", graph);
+  auto transposes = PassTestHelper::Stmts(graph, "transpose2");
+  ASSERT_EQ(transposes.size(), 1u);
+  auto* op_info = transposes.front()->stmt()->op_info();
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>{"x"});
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("axis"),
+            std::vector<int>({1, 2, 0}));
+}
+
+TEST(TransposeEliminatePass, fold_into_matmul) {
+  PassTestHelper helper;
+  helper.AddVar("x", {2, 3, 4});
+  helper.AddVar("y", {2, 5, 4});
+  helper.AddVar("yt", {2, 4, 5});
+  helper.AddVar("out", {2, 3, 5});
+  AddTranspose(&helper, "y", "yt", {0, 2, 1});
+  auto* matmul = helper.AddOp(
+      "matmul_v2", {{"X", {"x"}}, {"Y", {"yt"}}}, {{"Out", {"out"}}});
+  matmul->SetAttr<bool>("trans_x", false);
+  matmul->SetAttr<bool>("trans_y", false);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("transpose_eliminate_pass", graph);
+  EXPECT_TRUE(PassTestHelper::Stmts(graph, "transpose2").empty());
+  auto matmuls = PassTestHelper::Stmts(graph, "matmul_v2");
+  ASSERT_EQ(matmuls.size(), 1u);
+  EXPECT_EQ(InputNames(matmuls.front(), "Y"), std::vector<std::string>{"y"});
+  EXPECT_TRUE(matmuls.front()->stmt()->op_info()->GetAttr<bool>("trans_y"));
+}
+
+TEST(TransposeEliminatePass, keep_persistable) {
+  PassTestHelper helper;
+  BuildSinkModel(&helper, true);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("transpose_eliminate_pass", graph);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "transpose2").size(), 2u);
+}
+
+TEST(TransposeEliminatePass, keep_vars_of_other_blocks) {
+  PassTestHelper helper;
+  BuildSinkModel(&helper, false);
+  // another block which reads the output of the first transpose
+  PassTestHelper sub_block;
+  sub_block.AddVar("t0", {1, 3, 4, 5});
+  sub_block.AddVar("sub_out", {1, 3, 4, 5});
+  sub_block.AddOp("relu", {{"X", {"t0"}}}, {{"Out", {"sub_out"}}});
+  std::vector<std::unique_ptr<SSAGraph>> graphs;
+  graphs.push_back(helper.BuildGraph(kPlaces));
+  graphs.push_back(sub_block.BuildGraph(kPlaces));
+  auto* pass = PassManager::Global().LookUp<TransposeEliminatePass>(
+      "transpose_eliminate_pass");
+  ASSERT_TRUE(pass);
+  pass->SetAllGraphs(&graphs);
+  pass->Apply(graphs.front());
+  pass->SetAllGraphs(nullptr);
+  // the first transpose stays, so does the second one it would cancel
+  EXPECT_EQ(PassTestHelper::Stmts(graphs.front(), "transpose2").size(), 2u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
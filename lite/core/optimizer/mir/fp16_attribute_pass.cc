@@ -44,6 +44,9 @@ void FP16AttributePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       CHECK(in_node->IsArg()) << "The input node should be variable.";
       if (in_node->arg()->is_weight) {
         std::string weight_name = in_node->arg()->name;
+        if (select_fp16_weights_ && !fp16_weights_.count(weight_name)) {
+          continue;
+        }
         Tensor* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
         CHECK(weight) << "Can not find the weight in scope.";
         if (weight->precision() != PrecisionType::kFloat) {
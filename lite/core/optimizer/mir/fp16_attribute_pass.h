@@ -14,6 +14,7 @@
 
 #pragma once
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "lite/api/paddle_place.h"
@@ -34,7 +35,20 @@ class FP16AttributePass : public ProgramPass {
  public:
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
 
+  // Mark only the weights in the set as fp16, instead of all the weights of
+  // fp16_ops_, e.g. the mixed precision picked by
+  // lite/api/tools/mixed_precision_search.cc.
+  void SetFP16Weights(const std::set<std::string>& fp16_weights) {
+    fp16_weights_ = fp16_weights;
+    select_fp16_weights_ = true;
+  }
+
+  // The types of the ops whose weights can be fp16.
+  const std::vector<std::string>& fp16_ops() const { return fp16_ops_; }
+
  private:
+  std::set<std::string> fp16_weights_;
+  bool select_fp16_weights_{false};
   std::vector<std::string> fp16_ops_{"conv2d",
                                      "depthwise_conv2d",
                                      "conv2d_transpose",
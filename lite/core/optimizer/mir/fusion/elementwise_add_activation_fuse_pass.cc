@@ -39,7 +39,8 @@ void ElementwiseActivationFusePass::Apply(
   };
 
   bool has_arm = has_target(TARGET(kARM));
-  // arm not support tanh and abs act fusion
+  // arm not support tanh and abs act fusion, x86 fuses relu, abs and tanh
+  // (see ActiveType in elementwise_common_broadcast_config.h)
   if (!has_arm) {
     act_types.push_back("abs");
     act_types.push_back("tanh");
@@ -0,0 +1,41 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_add_layer_norm_fuse_pass.h"
+#include <memory>
+#include <vector>
+#include "lite/core/optimizer/mir/fusion/elementwise_add_layer_norm_fuser.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void ElementwiseAddLayerNormFusePass::Apply(
+    const std::unique_ptr<SSAGraph>& graph) {
+  // the sum is written out only when it is consumed by other ops
+  for (auto keep_add_out : {false, true}) {
+    fusion::ElementwiseAddLayerNormFuser fuser(keep_add_out);
+    fuser(graph.get());
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_add_layer_norm_fuse_pass,
+                  paddle::lite::mir::ElementwiseAddLayerNormFusePass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("add_layer_norm");
@@ -0,0 +1,79 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// elementwise_add(x of [2, 3, 8], residual) -> layer_norm, returns the
+// number of add_layer_norm ops after the pass.
+static size_t FuseAddLayerNorm(const std::vector<int64_t>& x_dims,
+                               const std::vector<int64_t>& residual_dims,
+                               int begin_norm_axis) {
+  std::vector<int64_t> norm_dims(x_dims.begin() + begin_norm_axis,
+                                 x_dims.end());
+  std::vector<int64_t> stat_dims(x_dims.begin(),
+                                 x_dims.begin() + begin_norm_axis);
+  int64_t norm_size = 1;
+  for (auto dim : norm_dims) norm_size *= dim;
+  PassTestHelper helper;
+  helper.AddVar("x", x_dims);
+  helper.AddVar("residual", residual_dims);
+  helper.AddVar("add_out", x_dims);
+  helper.AddWeight("scale", {norm_size});
+  helper.AddWeight("bias", {norm_size}, 0.f);
+  helper.AddVar("y", x_dims);
+  helper.AddVar("mean", stat_dims);
+  helper.AddVar("variance", stat_dims);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"x"}}, {"Y", {"residual"}}},
+             {{"Out", {"add_out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto* layer_norm = helper.AddOp(
+      "layer_norm",
+      {{"X", {"add_out"}}, {"Scale", {"scale"}}, {"Bias", {"bias"}}},
+      {{"Y", {"y"}}, {"Mean", {"mean"}}, {"Variance", {"variance"}}});
+  layer_norm->SetAttr<int>("begin_norm_axis", begin_norm_axis);
+  layer_norm->SetAttr<float>("epsilon", 1e-5f);
+  auto graph =
+      helper.BuildGraph({Place{TARGET(kX86), PRECISION(kFloat)},
+                         Place{TARGET(kHost), PRECISION(kAny)}});
+  helper.ApplyPass("lite_elementwise_add_layer_norm_fuse_pass", graph);
+  return PassTestHelper::Stmts(graph, "add_layer_norm").size();
+}
+
+TEST(ElementwiseAddLayerNormFusePass, residual_shape) {
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {2, 3, 8}, 2), 1u);
+  EXPECT_EQ(FuseAddLayerNorm({-1, 3, 8}, {-1, 3, 8}, 2), 1u);
+  // one row of the normalized dims
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {8}, 2), 1u);
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {1, 1, 8}, 2), 1u);
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {3, 8}, 1), 1u);
+  // broadcast on the rows of x
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {3, 8}, 2), 0u);
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {2, 1, 8}, 2), 0u);
+  EXPECT_EQ(FuseAddLayerNorm({2, 3, 8}, {-1, 3, 8}, 2), 0u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,154 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_add_layer_norm_fuser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// The shape from the var desc, -1 for the dims only known at runtime.
+static std::vector<int64_t> ArgDims(const Node* stmt, const std::string& name) {
+  auto* scope = stmt->stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(name) : nullptr;
+  if (!var || !var->IsType<lite::Tensor>()) return {};
+  return var->Get<lite::Tensor>().dims().Vectorize();
+}
+
+// add_layer_norm adds a residual of the shape of x, or one row of the
+// normalized dims to all the rows. Other broadcasts, e.g. a residual of
+// [S, H] on x of [B, S, H], are left unfused, as is an x broadcast to the
+// residual, which would change the shape of the output.
+static bool IsFusableResidual(const Node* layer_norm) {
+  auto* op_info = layer_norm->stmt()->op_info();
+  const auto& add_out_name = op_info->Input("X").front();
+  const Node* add = nullptr;
+  for (auto* in : layer_norm->inlinks) {
+    if (in->arg()->name != add_out_name || in->inlinks.size() != 1) continue;
+    add = in->inlinks.front();
+  }
+  if (!add || add->stmt()->op_type() != "elementwise_add") return false;
+  auto* add_info = add->stmt()->op_info();
+  auto x_dims = ArgDims(add, add_info->Input("X").front());
+  auto y_dims = ArgDims(add, add_info->Input("Y").front());
+  if (x_dims.empty() || y_dims.empty()) return false;
+  // the dims only known at runtime are the same when both are, e.g. the
+  // batch of x and residual, CheckShape of the fused op checks them again
+  if (x_dims == y_dims) return true;
+  const int begin_norm_axis = op_info->GetAttr<int>("begin_norm_axis");
+  if (begin_norm_axis < 0 ||
+      begin_norm_axis >= static_cast<int>(x_dims.size())) {
+    return false;
+  }
+  std::vector<int64_t> norm_dims(x_dims.begin() + begin_norm_axis,
+                                 x_dims.end());
+  size_t start = 0;
+  while (start + norm_dims.size() < y_dims.size() && y_dims[start] == 1) {
+    start++;
+  }
+  std::vector<int64_t> row_dims(y_dims.begin() + start, y_dims.end());
+  if (row_dims != norm_dims) return false;
+  for (auto dim : row_dims) {
+    if (dim < 0) return false;
+  }
+  return true;
+}
+
+void ElementwiseAddLayerNormFuser::BuildPattern() {
+  // create nodes.
+  auto* x = VarNode("x")->assert_is_op_input("elementwise_add", "X");
+  auto* residual =
+      VarNode("residual")->assert_is_op_input("elementwise_add", "Y");
+  auto* add = OpNode("add", "elementwise_add")
+                  ->assert_op_attr<int>("axis", -1)
+                  ->AsIntermediate();
+  auto* add_out = VarNode("add_out")
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_is_op_input("layer_norm", "X");
+  auto* scale = VarNode("scale")->assert_is_op_input("layer_norm", "Scale");
+  auto* bias = VarNode("bias")->assert_is_op_input("layer_norm", "Bias");
+  auto* layer_norm = OpNode("layer_norm", "layer_norm")
+                         ->assert_node_satisfied(IsFusableResidual)
+                         ->AsIntermediate();
+  auto* y = VarNode("y")->assert_is_op_output("layer_norm", "Y");
+  auto* mean = VarNode("mean")
+                   ->assert_is_op_output("layer_norm", "Mean")
+                   ->AsIntermediate();
+  auto* variance = VarNode("variance")
+                       ->assert_is_op_output("layer_norm", "Variance")
+                       ->AsIntermediate();
+  if (!keep_add_out_) {
+    add_out->AsIntermediate();
+  }
+
+  // create topology.
+  std::vector<PMNode*> add_inputs{x, residual};
+  std::vector<PMNode*> layer_norm_inputs{add_out, scale, bias};
+  add_inputs >> *add >> *add_out;
+  layer_norm_inputs >> *layer_norm >> *y;
+  *layer_norm >> *mean;
+  *layer_norm >> *variance;
+}
+
+void ElementwiseAddLayerNormFuser::InsertNewNode(SSAGraph* graph,
+                                                 const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto add_layer_norm_op = LiteOpRegistry::Global().Create("add_layer_norm");
+  auto layer_norm = matched.at("layer_norm")->stmt()->op();
+  auto* scope = layer_norm->scope();
+  auto& valid_places = layer_norm->valid_places();
+  add_layer_norm_op->Attach(op_desc, scope);
+
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(add_layer_norm_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("x"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("residual"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("scale"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("bias"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("y"));
+  if (keep_add_out_) {
+    IR_NODE_LINK_TO(new_op_node, matched.at("add_out"));
+  }
+}
+
+cpp::OpDesc ElementwiseAddLayerNormFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* layer_norm_info = matched.at("layer_norm")->stmt()->op_info();
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("add_layer_norm");
+  op_desc.SetInput("X", {matched.at("x")->arg()->name});
+  op_desc.SetInput("Residual", {matched.at("residual")->arg()->name});
+  op_desc.SetInput("Scale", {matched.at("scale")->arg()->name});
+  op_desc.SetInput("Bias", {matched.at("bias")->arg()->name});
+  op_desc.SetOutput("Y", {matched.at("y")->arg()->name});
+  if (keep_add_out_) {
+    op_desc.SetOutput("ResidualOut", {matched.at("add_out")->arg()->name});
+  }
+  op_desc.SetAttr("begin_norm_axis",
+                  layer_norm_info->GetAttr<int>("begin_norm_axis"));
+  op_desc.SetAttr("epsilon", layer_norm_info->GetAttr<float>("epsilon"));
+  op_desc.SetAttr("rms_norm", false);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
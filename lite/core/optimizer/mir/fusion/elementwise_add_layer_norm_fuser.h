@@ -0,0 +1,59 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/* Fuse the residual add in front of layer_norm, the unused Mean and
+ * Variance outputs of layer_norm are dropped.
+ *
+ *   x   residual
+ *    \  /
+ *  elementwise_add                x  residual  scale  bias
+ *      |                           \    |      |    /
+ *   add_out  scale  bias   ==>       add_layer_norm
+ *       \     |     /                 |          |
+ *        layer_norm                   y    (add_out)
+ *      /     |     \
+ *     y    mean   variance
+ *
+ * add_out stays an output of the fused op when it has other consumers,
+ * as in the pre-norm transformer blocks. The residual must have the shape
+ * of x or of the normalized dims, which the kernel supports.
+ */
+class ElementwiseAddLayerNormFuser : public FuseBase {
+ public:
+  explicit ElementwiseAddLayerNormFuser(bool keep_add_out)
+      : keep_add_out_(keep_add_out) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  bool keep_add_out_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,300 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <map>
+#include <set>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The binary ops and their names in the chain, the second when the value of
+// the chain is the Y of the op.
+static const std::map<std::string, std::pair<std::string, std::string>>
+    kBinaryOps = {
+        {"elementwise_add", {"add", "add"}},
+        {"elementwise_sub", {"sub", "rsub"}},
+        {"elementwise_mul", {"mul", "mul"}},
+        {"elementwise_div", {"div", "rdiv"}},
+        {"elementwise_max", {"max", "max"}},
+        {"elementwise_min", {"min", "min"}},
+};
+
+// The shape from the var desc, -1 for the dims only known at runtime.
+static std::vector<int64_t> ArgDims(Node* stmt, Node* arg) {
+  auto* scope = stmt->stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(arg->arg()->name) : nullptr;
+  if (!var || !var->IsType<lite::Tensor>()) return {};
+  return var->Get<lite::Tensor>().dims().Vectorize();
+}
+
+// The types of the vars are from the var descs, the weights have none and
+// are checked by their tensors.
+static bool IsFloatTensor(Node* stmt, Node* arg) {
+  auto* type = arg->arg()->type;
+  if (type) {
+    return type->IsTensor() && type->precision() == PRECISION(kFloat);
+  }
+  if (!arg->arg()->is_weight) return false;
+  auto* scope = stmt->stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(arg->arg()->name) : nullptr;
+  return var && var->IsType<lite::Tensor>() &&
+         var->Get<lite::Tensor>().precision() == PRECISION(kFloat);
+}
+
+// Whether y broadcast to x keeps the shape of x: the same shape, or a weight
+// of the last dims of x or of a single element. The unknown dims (-1) of the
+// var descs may differ at runtime, so a var of the same shape only counts
+// when its dims are all known.
+static bool IsBroadcastable(const std::vector<int64_t>& x_dims,
+                            const std::vector<int64_t>& y_dims,
+                            bool y_is_weight) {
+  if (x_dims.empty() || y_dims.empty()) return false;
+  if (!y_is_weight) {
+    for (auto d : y_dims) {
+      if (d < 0) return false;
+    }
+    return x_dims == y_dims;
+  }
+  if (x_dims == y_dims) return true;
+  int64_t numel = 1;
+  for (auto d : y_dims) numel *= d;
+  if (numel == 1) return true;
+  size_t start = 0;
+  while (start < y_dims.size() && y_dims[start] == 1) start++;
+  size_t y_rank = y_dims.size() - start;
+  if (y_rank > x_dims.size()) return false;
+  for (size_t i = 0; i < y_rank; i++) {
+    if (y_dims[start + i] != x_dims[x_dims.size() - y_rank + i]) return false;
+  }
+  return true;
+}
+
+bool ElementwiseChainFusePass::GetChainOp(Node* node,
+                                          Node* x,
+                                          ChainOp* chain_op) {
+  auto* op_info = node->stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  const auto& x_name = x->arg()->name;
+  *chain_op = ChainOp();
+  if (node->outlinks.size() != 1 || op_info->Output("Out").size() != 1 ||
+      !IsFloatTensor(node, x) ||
+      !IsFloatTensor(node, node->outlinks.front())) {
+    return false;
+  }
+
+  auto binary = kBinaryOps.find(op_type);
+  if (binary != kBinaryOps.end()) {
+    if (op_info->HasAttr("axis") && op_info->GetAttr<int>("axis") != -1) {
+      return false;
+    }
+    auto x_names = op_info->Input("X");
+    auto y_names = op_info->Input("Y");
+    if (x_names.size() != 1 || y_names.size() != 1 ||
+        x_names.front() == y_names.front()) {
+      return false;
+    }
+    bool is_x = x_names.front() == x_name;
+    const auto& y_name = is_x ? y_names.front() : x_names.front();
+    for (auto* in : node->inlinks) {
+      if (in->arg()->name == y_name) chain_op->y = in;
+    }
+    if (!chain_op->y || !IsFloatTensor(node, chain_op->y)) return false;
+    bool y_is_weight =
+        chain_op->y->arg()->is_weight || chain_op->y->arg()->is_persist;
+    if (!IsBroadcastable(
+            ArgDims(node, x), ArgDims(node, chain_op->y), y_is_weight)) {
+      return false;
+    }
+    chain_op->op = is_x ? binary->second.first : binary->second.second;
+    return true;
+  }
+
+  auto x_names = op_info->Input("X");
+  if (x_names.size() != 1 || x_names.front() != x_name) return false;
+  if (op_type == "relu" || op_type == "sigmoid" || op_type == "tanh") {
+    chain_op->op = op_type;
+  } else if (op_type == "relu6") {
+    chain_op->op = op_type;
+    chain_op->alpha = op_info->HasAttr("threshold")
+                          ? op_info->GetAttr<float>("threshold")
+                          : 6.f;
+  } else if (op_type == "leaky_relu") {
+    chain_op->op = op_type;
+    chain_op->alpha = op_info->GetAttr<float>("alpha");
+  } else if (op_type == "swish") {
+    chain_op->op = op_type;
+    chain_op->alpha = op_info->GetAttr<float>("beta");
+  } else if (op_type == "gelu") {
+    // 1 for the tanh approximation
+    chain_op->op = op_type;
+    if (op_info->HasAttr("approximate") &&
+        op_info->GetAttr<bool>("approximate")) {
+      chain_op->alpha = 1.f;
+    }
+  } else if (op_type == "hard_sigmoid") {
+    chain_op->op = op_type;
+    chain_op->alpha = op_info->GetAttr<float>("slope");
+    chain_op->beta = op_info->GetAttr<float>("offset");
+  } else if (op_type == "clip") {
+    // the bounds from the tensors are only known at runtime
+    for (auto arg : {"Min", "Max"}) {
+      if (op_info->HasInput(arg) && !op_info->Input(arg).empty()) {
+        return false;
+      }
+    }
+    chain_op->op = op_type;
+    chain_op->alpha = op_info->GetAttr<float>("min");
+    chain_op->beta = op_info->GetAttr<float>("max");
+  } else if (op_type == "scale") {
+    if (op_info->HasAttr("activation_type") ||
+        (op_info->HasInput("ScaleTensor") &&
+         !op_info->Input("ScaleTensor").empty())) {
+      return false;
+    }
+    float scale = op_info->GetAttr<float>("scale");
+    float bias = op_info->GetAttr<float>("bias");
+    chain_op->op = op_type;
+    chain_op->alpha = scale;
+    chain_op->beta =
+        op_info->GetAttr<bool>("bias_after_scale") ? bias : bias * scale;
+  } else if (op_type == "cast") {
+    // the casts from fp32 (5) to fp32 have nothing to do in the chain
+    if (op_info->GetAttr<int>("in_dtype") != 5 ||
+        op_info->GetAttr<int>("out_dtype") != 5) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void ElementwiseChainFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // the kernels of the fused op are only for x86 and host
+  for (auto& place : graph->valid_places()) {
+    if (place.target != TARGET(kX86) && place.target != TARGET(kHost) &&
+        place.target != TARGET(kAny)) {
+      return;
+    }
+  }
+  // the vars inside the chain are removed, which is only safe when no other
+  // node has the same name
+  std::map<std::string, int> name_count;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) name_count[node.arg()->name]++;
+  }
+  auto is_inner_var = [&](Node* var) {
+    return var->outlinks.size() == 1 && !var->arg()->is_weight &&
+           !var->arg()->is_persist && name_count[var->arg()->name] == 1;
+  };
+
+  // Find all the chains before rewriting any of them, the fused stmts are
+  // freed by GraphSafeRemoveNodes while the topological order still holds
+  // them.
+  std::set<Node*> fused;
+  std::vector<Chain> chains;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || fused.count(node)) continue;
+    // the chain starts from the X of its first op
+    auto x_names = node->stmt()->op_info()->Input("X");
+    if (x_names.size() != 1) continue;
+    Node* x = nullptr;
+    for (auto* in : node->inlinks) {
+      if (in->arg()->name == x_names.front()) x = in;
+    }
+    if (!x) continue;
+
+    Chain chain;
+    chain.x = x;
+    Node* value = x;
+    Node* stmt = node;
+    ChainOp chain_op;
+    while (!fused.count(stmt) && GetChainOp(stmt, value, &chain_op)) {
+      chain.stmts.push_back(stmt);
+      if (!chain_op.op.empty()) chain.ops.push_back(chain_op);
+      value = stmt->outlinks.front();
+      if (!is_inner_var(value)) break;
+      stmt = value->outlinks.front();
+    }
+    if (chain.stmts.size() < 2) continue;
+    chain.out = value;
+    fused.insert(chain.stmts.begin(), chain.stmts.end());
+    chains.push_back(chain);
+  }
+
+  for (auto& chain : chains) {
+    FuseChain(graph.get(), chain);
+  }
+}
+
+void ElementwiseChainFusePass::FuseChain(SSAGraph* graph, const Chain& chain) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_elementwise_chain");
+  op_desc.SetInput("X", {chain.x->arg()->name});
+  op_desc.SetOutput("Out", {chain.out->arg()->name});
+  std::vector<std::string> ops;
+  std::vector<float> alphas;
+  std::vector<float> betas;
+  std::vector<std::string> input_names;
+  std::vector<Node*> input_nodes;
+  for (auto& op : chain.ops) {
+    ops.push_back(op.op);
+    alphas.push_back(op.alpha);
+    betas.push_back(op.beta);
+    if (op.y) {
+      input_names.push_back(op.y->arg()->name);
+      input_nodes.push_back(op.y);
+    }
+  }
+  if (!input_names.empty()) op_desc.SetInput("Inputs", input_names);
+  op_desc.SetAttr("chain_ops", ops);
+  op_desc.SetAttr("chain_alphas", alphas);
+  op_desc.SetAttr("chain_betas", betas);
+
+  auto first_op = chain.stmts.front()->stmt()->op();
+  auto chain_op_lite =
+      LiteOpRegistry::Global().Create("fused_elementwise_chain");
+  chain_op_lite->Attach(op_desc, first_op->scope());
+  auto* new_node =
+      graph->GraphCreateInstructNode(chain_op_lite, first_op->valid_places());
+
+  std::set<const Node*> nodes2rm;
+  for (size_t i = 0; i < chain.stmts.size(); i++) {
+    nodes2rm.insert(chain.stmts[i]);
+    if (i + 1 < chain.stmts.size()) {
+      nodes2rm.insert(chain.stmts[i]->outlinks.front());
+    }
+  }
+  VLOG(4) << "Fuse a chain of " << chain.stmts.size() << " elementwise ops";
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  DirectedLink(chain.x, new_node);
+  for (auto* input_node : input_nodes) {
+    DirectedLink(input_node, new_node);
+  }
+  DirectedLink(new_node, chain.out);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_chain_fuse_pass,
+                  paddle::lite::mir::ElementwiseChainFusePass)
+    .BindTargets({TARGET(kX86), TARGET(kHost)})
+    .BindKernel("fused_elementwise_chain");
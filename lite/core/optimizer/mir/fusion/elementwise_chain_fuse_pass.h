@@ -0,0 +1,69 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ElementwiseChainFusePass merges the longest chains of fp32 elementwise
+ * ops into a fused_elementwise_chain op, e.g.
+ *
+ *   scale -> elementwise_mul(gate) -> sigmoid -> elementwise_add(bias)
+ *
+ * each op of the chain takes the output of the one before as its only
+ * reader, and the other input of a binary op has the shape of the chain, or
+ * is a weight of its last dims or a scalar. The kernel of the fused op runs
+ * all of them on a tile of the data at a time, so a chain of N ops reads and
+ * writes the memory once instead of N times.
+ */
+class ElementwiseChainFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  struct ChainOp {
+    std::string op;
+    float alpha{0.f};
+    float beta{0.f};
+    // the other input of a binary op
+    Node* y{nullptr};
+  };
+
+  struct Chain {
+    // the X of the first op and the Out of the last one
+    Node* x{nullptr};
+    Node* out{nullptr};
+    std::vector<Node*> stmts;
+    std::vector<ChainOp> ops;
+  };
+
+  // Reads the op of the node, which takes x as the value of the chain, false
+  // if it can not be fused.
+  bool GetChainOp(Node* node, Node* x, ChainOp* chain_op);
+  // Replaces the stmts of the chain and the vars between them by one
+  // fused_elementwise_chain op.
+  void FuseChain(SSAGraph* graph, const Chain& chain);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
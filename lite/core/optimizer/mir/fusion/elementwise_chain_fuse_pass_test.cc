@@ -0,0 +1,123 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// scale(x) -> elementwise_add(, y) -> relu, returns the number of
+// fused_elementwise_chain ops after the pass.
+static size_t FuseChain(const std::vector<int64_t>& x_dims,
+                        const std::vector<int64_t>& y_dims,
+                        bool y_is_weight) {
+  PassTestHelper helper;
+  helper.AddVar("x", x_dims);
+  if (y_is_weight) {
+    helper.AddWeight("y", y_dims);
+  } else {
+    helper.AddVar("y", y_dims);
+  }
+  helper.AddVar("scale_out", x_dims);
+  helper.AddVar("add_out", x_dims);
+  helper.AddVar("out", x_dims);
+  auto* scale =
+      helper.AddOp("scale", {{"X", {"x"}}}, {{"Out", {"scale_out"}}});
+  scale->SetAttr<float>("scale", 2.f);
+  scale->SetAttr<float>("bias", 1.f);
+  scale->SetAttr<bool>("bias_after_scale", true);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"scale_out"}}, {"Y", {"y"}}},
+             {{"Out", {"add_out"}}})
+      ->SetAttr<int>("axis", -1);
+  helper.AddOp("relu", {{"X", {"add_out"}}}, {{"Out", {"out"}}});
+  auto graph =
+      helper.BuildGraph({Place{TARGET(kX86), PRECISION(kFloat)},
+                         Place{TARGET(kHost), PRECISION(kAny)}});
+  helper.ApplyPass("lite_elementwise_chain_fuse_pass", graph);
+  return PassTestHelper::Stmts(graph, "fused_elementwise_chain").size();
+}
+
+TEST(ElementwiseChainFusePass, fuse_chain) {
+  EXPECT_EQ(FuseChain({2, 3, 8}, {2, 3, 8}, false), 1u);
+  // a weight of the last dims or of a single element
+  EXPECT_EQ(FuseChain({-1, 3, 8}, {3, 8}, true), 1u);
+  EXPECT_EQ(FuseChain({-1, 3, 8}, {1}, true), 1u);
+}
+
+TEST(ElementwiseChainFusePass, unknown_dims) {
+  // the -1 of x and y may be different sizes at runtime
+  EXPECT_EQ(FuseChain({-1, 3, 8}, {-1, 3, 8}, false), 0u);
+  // a var broadcast on the rows of x, the add splits the chain
+  EXPECT_EQ(FuseChain({2, 3, 8}, {3, 8}, false), 0u);
+  EXPECT_EQ(FuseChain({-1, 3, 8}, {2, 3}, true), 0u);
+}
+
+TEST(ElementwiseChainFusePass, two_long_chains) {
+  // x -> scale -> relu -> sigmoid -> tanh -> softmax -> scale -> relu -> out
+  // the later stmts of the first chain are freed while the pass still walks
+  // the topological order taken before the rewrite
+  PassTestHelper helper;
+  for (auto name : {"x", "s0", "r0", "g0", "t0", "sm", "s1", "out"}) {
+    helper.AddVar(name, {2, 3, 8});
+  }
+  auto add_scale = [&](const std::string& in, const std::string& out) {
+    auto* scale = helper.AddOp("scale", {{"X", {in}}}, {{"Out", {out}}});
+    scale->SetAttr<float>("scale", 2.f);
+    scale->SetAttr<float>("bias", 1.f);
+    scale->SetAttr<bool>("bias_after_scale", true);
+  };
+  add_scale("x", "s0");
+  helper.AddOp("relu", {{"X", {"s0"}}}, {{"Out", {"r0"}}});
+  helper.AddOp("sigmoid", {{"X", {"r0"}}}, {{"Out", {"g0"}}});
+  helper.AddOp("tanh", {{"X", {"g0"}}}, {{"Out", {"t0"}}});
+  helper.AddOp("softmax", {{"X", {"t0"}}}, {{"Out", {"sm"}}})
+      ->SetAttr<int>("axis", -1);
+  add_scale("sm", "s1");
+  helper.AddOp("relu", {{"X", {"s1"}}}, {{"Out", {"out"}}});
+  auto graph =
+      helper.BuildGraph({Place{TARGET(kX86), PRECISION(kFloat)},
+                         Place{TARGET(kHost), PRECISION(kAny)}});
+  helper.ApplyPass("lite_elementwise_chain_fuse_pass", graph);
+
+  auto chains = PassTestHelper::Stmts(graph, "fused_elementwise_chain");
+  ASSERT_EQ(chains.size(), 2u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "softmax").size(), 1u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "scale").size(), 0u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "relu").size(), 0u);
+  for (auto* chain : chains) {
+    auto* op_info = chain->stmt()->op_info();
+    auto ops = op_info->GetAttr<std::vector<std::string>>("chain_ops");
+    if (op_info->Input("X").front() == "x") {
+      EXPECT_EQ(ops.size(), 4u);
+      EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"t0"}));
+    } else {
+      EXPECT_EQ(ops.size(), 2u);
+      EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"sm"}));
+      EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"out"}));
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
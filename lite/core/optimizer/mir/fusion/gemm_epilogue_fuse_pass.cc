@@ -0,0 +1,222 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/gemm_epilogue_fuse_pass.h"
+#include <map>
+#include <set>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The ops with an epilogue in the x86 kernels.
+static const std::set<std::string> kGemmOps = {"fc", "matmul_v2"};
+
+// The shape from the var desc, -1 for the dims only known at runtime.
+static std::vector<int64_t> ArgDims(Node* stmt, const std::string& name) {
+  auto* scope = stmt->stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(name) : nullptr;
+  if (!var || !var->IsType<lite::Tensor>()) return {};
+  return var->Get<lite::Tensor>().dims().Vectorize();
+}
+
+// Whether y broadcast to the output x of the gemm keeps the shape of x,
+// which holds when every dim of y aligned to the right is 1 or the dim of x.
+// The dims only known at runtime are taken as equal when both are, e.g. the
+// batch of a residual, the kernel checks them again.
+static bool IsBroadcastToGemmOut(const std::vector<int64_t>& x_dims,
+                                 const std::vector<int64_t>& y_dims) {
+  if (x_dims.empty() || y_dims.empty() || y_dims.size() > x_dims.size()) {
+    return false;
+  }
+  const size_t offset = x_dims.size() - y_dims.size();
+  for (size_t i = 0; i < y_dims.size(); i++) {
+    const int64_t x_dim = x_dims[offset + i];
+    const int64_t y_dim = y_dims[i];
+    if (y_dim != 1 && y_dim != x_dim) return false;
+  }
+  return true;
+}
+
+// Reads the op of the node as an op of the epilogue, the tensor of an add is
+// the input of the op other than x_name.
+static bool GetEpilogueOp(Node* node,
+                          const std::string& x_name,
+                          std::string* op,
+                          float* alpha,
+                          float* beta,
+                          std::string* tensor_name) {
+  auto* op_info = node->stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  *alpha = 0.f;
+  *beta = 0.f;
+  tensor_name->clear();
+  if (op_type == "relu" || op_type == "sigmoid" || op_type == "tanh") {
+    *op = op_type;
+  } else if (op_type == "relu6") {
+    *op = op_type;
+    *alpha = op_info->HasAttr("threshold")
+                 ? op_info->GetAttr<float>("threshold")
+                 : 6.f;
+  } else if (op_type == "leaky_relu") {
+    *op = op_type;
+    *alpha = op_info->GetAttr<float>("alpha");
+  } else if (op_type == "swish") {
+    *op = op_type;
+    *alpha = op_info->GetAttr<float>("beta");
+  } else if (op_type == "scale") {
+    // the scale fused with an activation or read from a tensor is kept
+    if (op_info->HasAttr("activation_type") ||
+        (op_info->HasInput("ScaleTensor") &&
+         !op_info->Input("ScaleTensor").empty())) {
+      return false;
+    }
+    float scale = op_info->GetAttr<float>("scale");
+    float bias = op_info->GetAttr<float>("bias");
+    *op = op_type;
+    *alpha = scale;
+    *beta = op_info->GetAttr<bool>("bias_after_scale") ? bias : bias * scale;
+  } else if (op_type == "elementwise_add") {
+    // the output keeps the shape of the gemm only if the other input is
+    // broadcast to it
+    if (op_info->HasAttr("axis") && op_info->GetAttr<int>("axis") != -1) {
+      return false;
+    }
+    auto x = op_info->Input("X");
+    auto y = op_info->Input("Y");
+    auto out = op_info->Output("Out");
+    if (x.size() != 1 || y.size() != 1 || out.size() != 1 ||
+        x.front() == y.front()) {
+      return false;
+    }
+    *op = "add";
+    *tensor_name = x.front() == x_name ? y.front() : x.front();
+    auto x_dims = ArgDims(node, x_name);
+    return IsBroadcastToGemmOut(x_dims, ArgDims(node, *tensor_name)) &&
+           ArgDims(node, out.front()) == x_dims;
+  } else {
+    return false;
+  }
+  return op_info->Input("X").size() == 1 &&
+         op_info->Input("X").front() == x_name &&
+         op_info->Output("Out").size() == 1;
+}
+
+void GemmEpilogueFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // the kernels of the other targets have no epilogue
+  for (auto& place : graph->valid_places()) {
+    if (place.target != TARGET(kX86) && place.target != TARGET(kHost) &&
+        place.target != TARGET(kAny)) {
+      return;
+    }
+  }
+  // the output is renamed, which is only safe when no other node has the
+  // same name
+  std::map<std::string, int> name_count;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) name_count[node.arg()->name]++;
+  }
+  std::vector<Node*> gemm_nodes;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto* op_info = node->stmt()->op_info();
+    if (!kGemmOps.count(op_info->Type()) || op_info->HasAttr("enable_int8") ||
+        node->outlinks.size() != 1) {
+      continue;
+    }
+    gemm_nodes.push_back(node);
+  }
+
+  for (auto* gemm : gemm_nodes) {
+    cpp::OpDesc op_desc = *gemm->stmt()->op_info();
+    std::vector<std::string> ops;
+    std::vector<float> alphas;
+    std::vector<float> betas;
+    std::vector<std::string> input_names;
+    if (op_desc.HasAttr("epilogue_ops")) {
+      ops = op_desc.GetAttr<std::vector<std::string>>("epilogue_ops");
+      alphas = op_desc.GetAttr<std::vector<float>>("epilogue_alphas");
+      betas = op_desc.GetAttr<std::vector<float>>("epilogue_betas");
+    }
+    if (op_desc.HasInput("EpilogueInputs")) {
+      input_names = op_desc.Input("EpilogueInputs");
+    }
+    const size_t num_fused_ops = ops.size();
+    std::vector<Node*> input_nodes;
+    std::set<const Node*> nodes2rm;
+    Node* out = gemm->outlinks.front();
+    while (out->outlinks.size() == 1 && !out->arg()->is_weight &&
+           !out->arg()->is_persist && name_count[out->arg()->name] == 1) {
+      Node* next = out->outlinks.front();
+      std::string op;
+      float alpha;
+      float beta;
+      std::string tensor_name;
+      if (next->outlinks.size() != 1 ||
+          !GetEpilogueOp(next,
+                         out->arg()->name,
+                         &op,
+                         &alpha,
+                         &beta,
+                         &tensor_name)) {
+        break;
+      }
+      if (!tensor_name.empty()) {
+        Node* input_node = nullptr;
+        for (auto* in : next->inlinks) {
+          if (in->arg()->name == tensor_name) input_node = in;
+        }
+        if (!input_node) break;
+        input_nodes.push_back(input_node);
+        input_names.push_back(tensor_name);
+      }
+      ops.push_back(op);
+      alphas.push_back(alpha);
+      betas.push_back(beta);
+      nodes2rm.insert(out);
+      nodes2rm.insert(next);
+      out = next->outlinks.front();
+    }
+    if (ops.size() == num_fused_ops) continue;
+
+    VLOG(4) << "Fuse " << ops.size() - num_fused_ops << " ops into "
+            << op_desc.Type();
+    op_desc.SetOutput("Out", {out->arg()->name});
+    op_desc.SetAttr("epilogue_ops", ops);
+    op_desc.SetAttr("epilogue_alphas", alphas);
+    op_desc.SetAttr("epilogue_betas", betas);
+    if (!input_names.empty()) {
+      op_desc.SetInput("EpilogueInputs", input_names);
+    }
+    gemm->stmt()->ResetOp(op_desc, graph->valid_places());
+    GraphSafeRemoveNodes(graph.get(), nodes2rm);
+    for (auto* input_node : input_nodes) {
+      DirectedLink(input_node, gemm);
+    }
+    DirectedLink(gemm, out);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_gemm_epilogue_fuse_pass,
+                  paddle::lite::mir::GemmEpilogueFusePass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("fc")
+    .BindKernel("matmul_v2");
@@ -0,0 +1,47 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * GemmEpilogueFusePass fuses the chain of elementwise ops after the x86 fc
+ * and matmul_v2 into the op as its epilogue (see GemmEpilogueParam), e.g.
+ *
+ *   fc -> scale -> elementwise_add(residual) -> relu
+ *
+ * becomes an fc which applies the scale, the add and the relu to the blocks
+ * of its output while they are in the cache, instead of a pass over the
+ * whole output in memory for each op. The chain takes every op of
+ * relu, relu6, leaky_relu, sigmoid, tanh, swish, scale and elementwise_add
+ * (axis -1) whose input is only read by it, the other input of an add must
+ * broadcast to the output of the gemm by its static shape. It runs after the
+ * attention and the add + layer_norm fusers, which match the elementwise ops
+ * behind a matmul or an fc themselves.
+ */
+class GemmEpilogueFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+// fc(x, w) of [2, 5, 8] -> scale -> elementwise_add(y) -> relu
+static void AddFcChain(PassTestHelper* helper,
+                       const std::vector<int64_t>& y_dims) {
+  helper->AddVar("x", {2, 5, 16});
+  helper->AddWeight("w", {16, 8});
+  helper->AddVar("fc_out", {2, 5, 8});
+  helper->AddVar("scale_out", {2, 5, 8});
+  helper->AddVar("y", y_dims);
+  helper->AddVar("add_out", {2, 5, 8});
+  helper->AddVar("out", {2, 5, 8});
+  auto* fc = helper->AddOp(
+      "fc", {{"Input", {"x"}}, {"W", {"w"}}}, {{"Out", {"fc_out"}}});
+  fc->SetAttr<int>("in_num_col_dims", 2);
+  auto* scale =
+      helper->AddOp("scale", {{"X", {"fc_out"}}}, {{"Out", {"scale_out"}}});
+  scale->SetAttr<float>("scale", 0.5f);
+  scale->SetAttr<float>("bias", 0.1f);
+  scale->SetAttr<bool>("bias_after_scale", true);
+  auto* add = helper->AddOp("elementwise_add",
+                            {{"X", {"scale_out"}}, {"Y", {"y"}}},
+                            {{"Out", {"add_out"}}});
+  add->SetAttr<int>("axis", -1);
+  helper->AddOp("relu", {{"X", {"add_out"}}}, {{"Out", {"out"}}});
+}
+
+TEST(GemmEpilogueFusePass, fuse_chain) {
+  PassTestHelper helper;
+  AddFcChain(&helper, {2, 5, 8});
+  auto graph = helper.BuildGraph(kPlaces);
+  helper.ApplyPass("lite_gemm_epilogue_fuse_pass", graph);
+
+  ASSERT_EQ(PassTestHelper::Stmts(graph, "scale").size(), 0u);
+  ASSERT_EQ(PassTestHelper::Stmts(graph, "elementwise_add").size(), 0u);
+  ASSERT_EQ(PassTestHelper::Stmts(graph, "relu").size(), 0u);
+  auto fcs = PassTestHelper::Stmts(graph, "fc");
+  ASSERT_EQ(fcs.size(), 1u);
+  auto* op_info = fcs.front()->stmt()->op_info();
+  EXPECT_EQ(op_info->GetAttr<std::vector<std::string>>("epilogue_ops"),
+            std::vector<std::string>({"scale", "add", "relu"}));
+  EXPECT_EQ(op_info->Input("EpilogueInputs"), std::vector<std::string>({"y"}));
+  EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"out"}));
+}
+
+TEST(GemmEpilogueFusePass, broadcast_add) {
+  // a tensor broadcast on the leading dims is added in the epilogue
+  {
+    PassTestHelper helper;
+    AddFcChain(&helper, {2, 1, 8});
+    auto graph = helper.BuildGraph(kPlaces);
+    helper.ApplyPass("lite_gemm_epilogue_fuse_pass", graph);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "elementwise_add").size(), 0u);
+  }
+  // the add of a tensor expanding the output stops the chain
+  {
+    PassTestHelper helper;
+    AddFcChain(&helper, {3, 2, 5, 8});
+    auto graph = helper.BuildGraph(kPlaces);
+    helper.ApplyPass("lite_gemm_epilogue_fuse_pass", graph);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "scale").size(), 0u);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "elementwise_add").size(), 1u);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "relu").size(), 1u);
+  }
+  // the dims only known at runtime must match
+  {
+    PassTestHelper helper;
+    AddFcChain(&helper, {-1, 5, 8});
+    auto graph = helper.BuildGraph(kPlaces);
+    helper.ApplyPass("lite_gemm_epilogue_fuse_pass", graph);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "elementwise_add").size(), 1u);
+  }
+}
+
+TEST(GemmEpilogueFusePass, residual_of_layer_norm) {
+  // fc -> elementwise_add(residual) -> layer_norm is left to
+  // lite_elementwise_add_layer_norm_fuse_pass, which runs first
+  PassTestHelper helper;
+  helper.AddVar("x", {4, 16});
+  helper.AddWeight("w", {16, 8});
+  helper.AddVar("fc_out", {4, 8});
+  helper.AddVar("residual", {4, 8});
+  helper.AddVar("add_out", {4, 8});
+  helper.AddWeight("ln_scale", {8});
+  helper.AddWeight("ln_bias", {8}, 0.f);
+  helper.AddVar("out", {4, 8});
+  helper.AddVar("mean", {4});
+  helper.AddVar("variance", {4});
+  helper.AddOp("fc", {{"Input", {"x"}}, {"W", {"w"}}}, {{"Out", {"fc_out"}}})
+      ->SetAttr<int>("in_num_col_dims", 1);
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"fc_out"}}, {"Y", {"residual"}}},
+             {{"Out", {"add_out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto* layer_norm = helper.AddOp(
+      "layer_norm",
+      {{"X", {"add_out"}}, {"Scale", {"ln_scale"}}, {"Bias", {"ln_bias"}}},
+      {{"Y", {"out"}}, {"Mean", {"mean"}}, {"Variance", {"variance"}}});
+  layer_norm->SetAttr<int>("begin_norm_axis", 1);
+  layer_norm->SetAttr<float>("epsilon", 1e-5f);
+  auto graph = helper.BuildGraph(kPlaces);
+  helper.ApplyPass("lite_elementwise_add_layer_norm_fuse_pass", graph);
+  helper.ApplyPass("lite_gemm_epilogue_fuse_pass", graph);
+
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "add_layer_norm").size(), 1u);
+  auto fcs = PassTestHelper::Stmts(graph, "fc");
+  ASSERT_EQ(fcs.size(), 1u);
+  EXPECT_FALSE(fcs.front()->stmt()->op_info()->HasAttr("epilogue_ops"));
+}
+
+TEST(GemmEpilogueFusePass, attention_keeps_epilogue) {
+  // the attention fuser leaves a qk matmul_v2 carrying an epilogue alone
+  PassTestHelper helper;
+  for (auto name : {"q", "k", "v", "qk_out", "softmax_out", "out"}) {
+    helper.AddVar(name, {2, 4, 6, 6});
+  }
+  auto* qk = helper.AddOp(
+      "matmul_v2", {{"X", {"q"}}, {"Y", {"k"}}}, {{"Out", {"qk_out"}}});
+  qk->SetAttr<bool>("trans_x", false);
+  qk->SetAttr<bool>("trans_y", true);
+  qk->SetAttr("epilogue_ops", std::vector<std::string>({"scale"}));
+  qk->SetAttr("epilogue_alphas", std::vector<float>({0.125f}));
+  qk->SetAttr("epilogue_betas", std::vector<float>({0.f}));
+  helper.AddOp("softmax", {{"X", {"qk_out"}}}, {{"Out", {"softmax_out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto* pv = helper.AddOp("matmul_v2",
+                          {{"X", {"softmax_out"}}, {"Y", {"v"}}},
+                          {{"Out", {"out"}}});
+  pv->SetAttr<bool>("trans_x", false);
+  pv->SetAttr<bool>("trans_y", false);
+  auto graph = helper.BuildGraph(kPlaces);
+  helper.ApplyPass("lite_scaled_dot_product_attention_fuse_pass", graph);
+
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "scaled_dot_product_attention").size(),
+            0u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "matmul_v2").size(), 2u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,96 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/lookup_table_sequence_pool_fuser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+void LookupTableSequencePoolFuser::BuildPattern() {
+  auto pool_type_teller = [](const std::string& pool_type) {
+    return pool_type == "SUM" || pool_type == "AVERAGE" ||
+           pool_type == "SQRT";
+  };
+
+  // create nodes.
+  auto* w = VarNode("w")->assert_is_op_input(lookup_type_, "W");
+  auto* ids = VarNode("ids")->assert_is_op_input(lookup_type_, "Ids");
+  auto* lookup = OpNode("lookup", lookup_type_)->AsIntermediate();
+  auto* emb = VarNode("emb")
+                  ->assert_is_op_output(lookup_type_, "Out")
+                  ->assert_is_op_input("sequence_pool", "X")
+                  ->AsIntermediate();
+  auto* pool = OpNode("pool", "sequence_pool")
+                   ->assert_op_attr_satisfied<std::string>(
+                       "pooltype", pool_type_teller)
+                   ->AsIntermediate();
+  auto* out = VarNode("out")->assert_is_op_output("sequence_pool", "Out");
+  auto* max_index = VarNode("max_index")
+                        ->assert_is_op_output("sequence_pool", "MaxIndex")
+                        ->AsIntermediate();
+
+  // create topology.
+  std::vector<PMNode*> lookup_inputs{w, ids};
+  lookup_inputs >> *lookup >> *emb >> *pool >> *out;
+  *pool >> *max_index;
+}
+
+void LookupTableSequencePoolFuser::InsertNewNode(SSAGraph* graph,
+                                                 const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fused_op =
+      LiteOpRegistry::Global().Create("fused_embedding_seq_pool");
+  auto lookup = matched.at("lookup")->stmt()->op();
+  auto* scope = lookup->scope();
+  auto& valid_places = lookup->valid_places();
+  fused_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fused_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("w"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc LookupTableSequencePoolFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* lookup_info = matched.at("lookup")->stmt()->op_info();
+  auto* pool_info = matched.at("pool")->stmt()->op_info();
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_embedding_seq_pool");
+  op_desc.SetInput("W", {matched.at("w")->arg()->name});
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  if (lookup_info->HasAttr("padding_idx")) {
+    op_desc.SetAttr("padding_idx",
+                    lookup_info->GetAttr<int64_t>("padding_idx"));
+  }
+  op_desc.SetAttr("pooltype", pool_info->GetAttr<std::string>("pooltype"));
+  if (pool_info->HasAttr("pad_value")) {
+    op_desc.SetAttr("pad_value", pool_info->GetAttr<float>("pad_value"));
+  }
+  op_desc.SetAttr("lookup_table_v2", lookup_type_ == "lookup_table_v2");
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
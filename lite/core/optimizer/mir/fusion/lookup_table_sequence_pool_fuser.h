@@ -0,0 +1,57 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/* Pool the embeddings while they are gathered, so the [num_ids, emb_size]
+ * output of lookup_table is never written out.
+ *
+ *    w     ids
+ *     \   /
+ *  lookup_table                    w     ids
+ *       |                           \   /
+ *      emb             ==>   fused_embedding_seq_pool
+ *       |                             |
+ *  sequence_pool                     out
+ *    /      \
+ *  out   max_index
+ *
+ * Only the SUM, AVERAGE and SQRT pool types are fused.
+ */
+class LookupTableSequencePoolFuser : public FuseBase {
+ public:
+  explicit LookupTableSequencePoolFuser(const std::string& lookup_type)
+      : lookup_type_(lookup_type) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  std::string lookup_type_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,110 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+// softmax(matmul_v2(q, k^T) * scale + mask) * v with q, v of [2, 4, 8, 16]
+static void AddAttention(PassTestHelper* helper,
+                         const std::vector<int64_t>& k_dims,
+                         float bias) {
+  helper->AddVar("q", {2, 4, 8, 16});
+  helper->AddVar("k", k_dims);
+  helper->AddVar("v", {2, 4, 8, 16});
+  helper->AddVar("mask", {2, 1, 1, 8});
+  helper->AddVar("qk_out", {2, 4, 8, 8});
+  helper->AddVar("scale_out", {2, 4, 8, 8});
+  helper->AddVar("add_out", {2, 4, 8, 8});
+  helper->AddVar("softmax_out", {2, 4, 8, 8});
+  helper->AddVar("out", {2, 4, 8, 16});
+  auto* qk = helper->AddOp(
+      "matmul_v2", {{"X", {"q"}}, {"Y", {"k"}}}, {{"Out", {"qk_out"}}});
+  qk->SetAttr<bool>("trans_x", false);
+  qk->SetAttr<bool>("trans_y", true);
+  auto* scale =
+      helper->AddOp("scale", {{"X", {"qk_out"}}}, {{"Out", {"scale_out"}}});
+  scale->SetAttr<float>("scale", 0.25f);
+  scale->SetAttr<float>("bias", bias);
+  scale->SetAttr<bool>("bias_after_scale", true);
+  auto* add = helper->AddOp("elementwise_add",
+                            {{"X", {"scale_out"}}, {"Y", {"mask"}}},
+                            {{"Out", {"add_out"}}});
+  add->SetAttr<int>("axis", -1);
+  auto* softmax = helper->AddOp(
+      "softmax", {{"X", {"add_out"}}}, {{"Out", {"softmax_out"}}});
+  softmax->SetAttr<int>("axis", -1);
+  auto* pv = helper->AddOp(
+      "matmul_v2", {{"X", {"softmax_out"}}, {"Y", {"v"}}}, {{"Out", {"out"}}});
+  pv->SetAttr<bool>("trans_x", false);
+  pv->SetAttr<bool>("trans_y", false);
+}
+
+TEST(ScaledDotProductAttentionFusePass, fold_scale) {
+  PassTestHelper helper;
+  AddAttention(&helper, {2, 4, 8, 16}, 0.f);
+  auto graph = helper.BuildGraph(kPlaces);
+  helper.ApplyPass("lite_scaled_dot_product_attention_fuse_pass", graph);
+
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "matmul_v2").size(), 0u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "scale").size(), 0u);
+  auto attentions =
+      PassTestHelper::Stmts(graph, "scaled_dot_product_attention");
+  ASSERT_EQ(attentions.size(), 1u);
+  auto* op_info = attentions.front()->stmt()->op_info();
+  EXPECT_FLOAT_EQ(op_info->GetAttr<float>("alpha"), 0.25f);
+  EXPECT_EQ(op_info->Input("Mask"), std::vector<std::string>({"mask"}));
+  EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"out"}));
+}
+
+TEST(ScaledDotProductAttentionFusePass, keep_scale_with_bias) {
+  PassTestHelper helper;
+  AddAttention(&helper, {2, 4, 8, 16}, 0.1f);
+  auto graph = helper.BuildGraph(kPlaces);
+  helper.ApplyPass("lite_scaled_dot_product_attention_fuse_pass", graph);
+
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "scaled_dot_product_attention").size(),
+            0u);
+  EXPECT_EQ(PassTestHelper::Stmts(graph, "scale").size(), 1u);
+}
+
+TEST(ScaledDotProductAttentionFusePass, keep_broadcast_k) {
+  // k is broadcast over the batch dims of q by matmul_v2
+  for (auto k_dims : std::vector<std::vector<int64_t>>{{8, 16}, {1, 8, 16}}) {
+    PassTestHelper helper;
+    AddAttention(&helper, k_dims, 0.f);
+    auto graph = helper.BuildGraph(kPlaces);
+    helper.ApplyPass("lite_scaled_dot_product_attention_fuse_pass", graph);
+
+    EXPECT_EQ(
+        PassTestHelper::Stmts(graph, "scaled_dot_product_attention").size(),
+        0u);
+    EXPECT_EQ(PassTestHelper::Stmts(graph, "matmul_v2").size(), 2u);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,185 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/scaled_dot_product_attention_fuser.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// The attention op has no epilogue, the matmuls which carry the ops fused
+// by lite_gemm_epilogue_fuse_pass are kept.
+static bool WithoutEpilogue(const Node* node) {
+  return !node->stmt()->op_info()->HasAttr("epilogue_ops");
+}
+
+// The shape of an input of the matmul, -1 for the dims only known at
+// runtime.
+static std::vector<int64_t> InputDims(const Node* node,
+                                      const std::string& arg) {
+  auto* op_info = node->stmt()->op_info();
+  auto* scope = node->stmt()->op()->scope();
+  if (!op_info->HasInput(arg) || op_info->Input(arg).size() != 1 || !scope) {
+    return {};
+  }
+  auto* var = scope->FindVar(op_info->Input(arg).front());
+  if (!var || !var->IsType<lite::Tensor>()) return {};
+  return var->Get<lite::Tensor>().dims().Vectorize();
+}
+
+// The attention op takes q, k and v of the same rank and batch dims, the
+// matmuls which broadcast one side over the batch of the other (e.g. k of a
+// lower rank than q) are kept.
+static bool WithSameBatchDims(const Node* node) {
+  auto x_dims = InputDims(node, "X");
+  auto y_dims = InputDims(node, "Y");
+  if (x_dims.size() < 2 || x_dims.size() != y_dims.size()) return false;
+  return std::equal(x_dims.begin(), x_dims.end() - 2, y_dims.begin());
+}
+
+void ScaledDotProductAttentionFuser::BuildPattern() {
+  const bool is_v2 = matmul_type_ == "matmul_v2";
+  const std::string trans_x = is_v2 ? "trans_x" : "transpose_X";
+  const std::string trans_y = is_v2 ? "trans_y" : "transpose_Y";
+
+  // create nodes.
+  auto* q = VarNode("q")->assert_is_op_input(matmul_type_, "X");
+  auto* k = VarNode("k")->assert_is_op_input(matmul_type_, "Y");
+  auto* v = VarNode("v")->assert_is_op_input(matmul_type_, "Y");
+  auto* qk_matmul = OpNode("qk_matmul", matmul_type_)
+                        ->assert_op_attr<bool>(trans_x, false)
+                        ->assert_op_attr<bool>(trans_y, true)
+                        ->assert_node_satisfied(WithoutEpilogue)
+                        ->assert_node_satisfied(WithSameBatchDims);
+  auto* qk_out = VarNode("qk_out")
+                     ->assert_is_op_output(matmul_type_, "Out")
+                     ->AsIntermediate();
+  auto* softmax = OpNode("softmax", "softmax")
+                      ->assert_op_attr_satisfied<int>(
+                          "axis", [](int attr) { return attr == -1; })
+                      ->AsIntermediate();
+  auto* softmax_out = VarNode("softmax_out")
+                          ->assert_is_op_output("softmax", "Out")
+                          ->assert_is_op_input(matmul_type_, "X")
+                          ->AsIntermediate();
+  auto* pv_matmul = OpNode("pv_matmul", matmul_type_)
+                        ->assert_op_attr<bool>(trans_x, false)
+                        ->assert_op_attr<bool>(trans_y, false)
+                        ->assert_node_satisfied(WithoutEpilogue)
+                        ->assert_node_satisfied(WithSameBatchDims)
+                        ->AsIntermediate();
+  auto* out = VarNode("out")->assert_is_op_output(matmul_type_, "Out");
+  if (!is_v2) {
+    pv_matmul->assert_op_attr_satisfied<float>(
+        "alpha", [](float attr) { return std::fabs(attr - 1.f) < 1e-5f; });
+  }
+  qk_matmul->AsIntermediate();
+
+  // create topology.
+  std::vector<PMNode*> qk_inputs{q, k};
+  qk_inputs >> *qk_matmul >> *qk_out;
+  // the output of qk, scaled when with_scale_
+  PMNode* logits = qk_out;
+  if (with_scale_) {
+    // folded into alpha, so without bias and activation
+    auto* scale =
+        OpNode("scale", "scale")
+            ->assert_op_attr_satisfied<float>(
+                "bias", [](float attr) { return std::fabs(attr) < 1e-6f; })
+            ->assert_node_satisfied([](const Node* node) {
+              return !node->stmt()->op_info()->HasAttr("activation_type");
+            })
+            ->AsIntermediate();
+    auto* scale_out = VarNode("scale_out")
+                          ->assert_is_op_output("scale", "Out")
+                          ->AsIntermediate();
+    qk_out->assert_is_op_input("scale", "X");
+    *qk_out >> *scale >> *scale_out;
+    logits = scale_out;
+  }
+  if (with_mask_) {
+    auto* mask = VarNode("mask")->assert_is_op_input("elementwise_add", "Y");
+    auto* add = OpNode("add", "elementwise_add")
+                    ->assert_op_attr<int>("axis", -1)
+                    ->AsIntermediate();
+    auto* add_out = VarNode("add_out")
+                        ->assert_is_op_output("elementwise_add", "Out")
+                        ->assert_is_op_input("softmax", "X")
+                        ->AsIntermediate();
+    logits->assert_is_op_input("elementwise_add", "X");
+    std::vector<PMNode*> add_inputs{logits, mask};
+    add_inputs >> *add >> *add_out >> *softmax >> *softmax_out;
+  } else {
+    logits->assert_is_op_input("softmax", "X");
+    *logits >> *softmax >> *softmax_out;
+  }
+  std::vector<PMNode*> pv_inputs{softmax_out, v};
+  pv_inputs >> *pv_matmul >> *out;
+}
+
+void ScaledDotProductAttentionFuser::InsertNewNode(SSAGraph* graph,
+                                                   const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto attention_op =
+      LiteOpRegistry::Global().Create("scaled_dot_product_attention");
+  auto qk_matmul = matched.at("qk_matmul")->stmt()->op();
+  auto* scope = qk_matmul->scope();
+  auto& valid_places = qk_matmul->valid_places();
+  attention_op->Attach(op_desc, scope);
+
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(attention_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("q"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("k"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("v"), new_op_node);
+  if (with_mask_) {
+    IR_NODE_LINK_TO(matched.at("mask"), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc ScaledDotProductAttentionFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* qk_op_info = matched.at("qk_matmul")->stmt()->op_info();
+  float alpha = 1.f;
+  if (qk_op_info->HasAttr("alpha")) {
+    alpha = qk_op_info->GetAttr<float>("alpha");
+  }
+  if (with_scale_) {
+    alpha *= matched.at("scale")->stmt()->op_info()->GetAttr<float>("scale");
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("scaled_dot_product_attention");
+  op_desc.SetInput("Q", {matched.at("q")->arg()->name});
+  op_desc.SetInput("K", {matched.at("k")->arg()->name});
+  op_desc.SetInput("V", {matched.at("v")->arg()->name});
+  if (with_mask_) {
+    op_desc.SetInput("Mask", {matched.at("mask")->arg()->name});
+  }
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr("alpha", alpha);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,68 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/* Fuse the attention core of transformer models
+ *
+ *   q   k                             q   k   v   mask
+ *    \ /                               \  |   |  /
+ *   matmul(transpose_Y)                 \ |   | /
+ *     |                                   ...
+ *   scale(bias=0) (optional)    ==>  scaled_dot_product_attention
+ *     |     mask                          |
+ *  elementwise_add (optional)            out
+ *     |
+ *   softmax(axis=-1)   v
+ *         \           /
+ *           matmul
+ *             |
+ *            out
+ *
+ * The scale is folded into alpha of the attention op. It is only matched
+ * right after the qk matmul, where it scales the logits but not the mask.
+ * q, k and v must have the same rank and batch dims.
+ */
+class ScaledDotProductAttentionFuser : public FuseBase {
+ public:
+  explicit ScaledDotProductAttentionFuser(const std::string& matmul_type,
+                                          bool with_mask,
+                                          bool with_scale)
+      : matmul_type_(matmul_type),
+        with_mask_(with_mask),
+        with_scale_(with_scale) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  std::string matmul_type_;
+  bool with_mask_;
+  bool with_scale_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
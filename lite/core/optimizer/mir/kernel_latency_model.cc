@@ -0,0 +1,249 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/kernel_latency_model.h"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "lite/core/type_system.h"
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The names of the ops in lite/tests/benchmark/src, for the tables made by
+// get_latency_lookup_table.py.
+static const std::map<std::string, std::string> kBenchmarkOpNames = {
+    {"conv2d", "conv"},
+    {"depthwise_conv2d", "conv"},
+    {"batch_norm", "batchnorm"},
+    {"pool2d", "pooling"},
+    {"relu", "activation"},
+    {"relu6", "activation"},
+    {"leaky_relu", "activation"},
+    {"sigmoid", "activation"},
+    {"tanh", "activation"},
+    {"hard_swish", "activation"},
+    {"swish", "activation"},
+    {"prelu", "activation"},
+};
+
+// Transforming an element costs about a ns without a line in the table, the
+// shapes unknown at the opt time count as kDefaultNumel elements.
+static const float kDefaultTransformLatencyPerElement = 1e-6f;
+static const int64_t kDefaultNumel = 1 << 16;
+
+static std::string Trim(const std::string& x) {
+  auto begin = x.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) return "";
+  auto end = x.find_last_not_of(" \t\r\n");
+  return x.substr(begin, end - begin + 1);
+}
+
+// "[1 96 112 112]" to {1, 96, 112, 112}
+static std::vector<int64_t> ParseDims(const std::string& x) {
+  std::vector<int64_t> dims;
+  std::istringstream is(x.empty() || x[0] != '[' ? x : x.substr(1));
+  int64_t d;
+  while (is >> d) dims.push_back(d);
+  return dims;
+}
+
+static int64_t Numel(const std::vector<int64_t>& dims) {
+  if (dims.empty()) return 0;
+  int64_t numel = 1;
+  for (auto d : dims) {
+    if (d <= 0) return 0;
+    numel *= d;
+  }
+  return numel;
+}
+
+static PrecisionType ParseDtype(const std::string& dtype) {
+  if (dtype == "float" || dtype == "fp32") return PRECISION(kFloat);
+  if (dtype.find("int8") == 0) return PRECISION(kInt8);
+  if (dtype == "fp16") return PRECISION(kFP16);
+  if (dtype == "int32") return PRECISION(kInt32);
+  if (dtype == "int64") return PRECISION(kInt64);
+  return PRECISION(kAny);
+}
+
+// The dims of the first input of the argument, or empty when the shape is
+// only known at runtime.
+static std::vector<int64_t> InputDims(const Node& node,
+                                      const std::string& var_name) {
+  auto* scope = node.stmt()->op()->scope();
+  auto* var = scope ? scope->FindVar(var_name) : nullptr;
+  if (!var || !var->IsType<lite::Tensor>()) return {};
+  return var->Get<lite::Tensor>().dims().Vectorize();
+}
+
+bool KernelLatencyModel::Load(const std::string& path) {
+  if (path == path_) return !entries_.empty();
+  path_ = path;
+  entries_.clear();
+  std::ifstream file(path.c_str());
+  if (!file.is_open()) {
+    LOG(WARNING) << "Missing the latency lookup table " << path;
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    auto fields = Split(line, "\t");
+    // skip the device lines and the headers
+    if (fields.size() != 7 || Trim(fields[0]) == "op_name") continue;
+    Entry entry;
+    entry.dims = ParseDims(Trim(fields[1]));
+    entry.numel = Numel(entry.dims);
+    char* end = nullptr;
+    auto avg = Trim(fields[6]);
+    entry.latency = std::strtof(avg.c_str(), &end);
+    if (end == avg.c_str()) continue;
+    auto params = Trim(fields[3]);
+    if (params.size() >= 2 && params.front() == '(') {
+      params = params.substr(1, params.size() - 2);
+    }
+    for (auto& param : Split(params, ",")) {
+      auto pos = param.find('=');
+      if (pos == std::string::npos) continue;
+      auto key = Trim(param.substr(0, pos));
+      auto value = Trim(param.substr(pos + 1));
+      if (key == "dtype") entry.precision = ParseDtype(value);
+      if (key == "target") entry.target = value;
+    }
+    entries_[Trim(fields[0])].push_back(entry);
+  }
+  VLOG(3) << "Loaded the latencies of " << entries_.size() << " ops from "
+          << path;
+  return !entries_.empty();
+}
+
+bool KernelLatencyModel::Estimate(const std::string& op_name,
+                                  TargetType target,
+                                  PrecisionType precision,
+                                  const std::vector<int64_t>& dims,
+                                  float* latency) const {
+  auto it = entries_.find(op_name);
+  if (it == entries_.end()) return false;
+  const int64_t numel = Numel(dims);
+  const Entry* closest = nullptr;
+  double closest_distance = 0;
+  for (auto& entry : it->second) {
+    if (precision != PRECISION(kAny) && entry.precision != PRECISION(kAny) &&
+        entry.precision != precision) {
+      continue;
+    }
+    if (target != TARGET(kAny) && !entry.target.empty() &&
+        entry.target != TargetToStr(target)) {
+      continue;
+    }
+    if (numel > 0 && entry.dims == dims) {
+      *latency = entry.latency;
+      return true;
+    }
+    // the distance of the sizes on the log scale
+    double distance = 0;
+    if (numel > 0 && entry.numel > 0) {
+      distance = std::fabs(std::log(static_cast<double>(numel) / entry.numel));
+    }
+    if (!closest || distance < closest_distance) {
+      closest = &entry;
+      closest_distance = distance;
+    }
+  }
+  if (!closest) return false;
+  *latency = closest->latency;
+  if (numel > 0 && closest->numel > 0) {
+    *latency *= static_cast<float>(numel) / closest->numel;
+  }
+  return true;
+}
+
+float KernelLatencyModel::TransformLatency(
+    const std::string& op_name, const std::vector<int64_t>& dims) const {
+  float latency;
+  if (Estimate(op_name, TARGET(kAny), PRECISION(kAny), dims, &latency)) {
+    return latency;
+  }
+  int64_t numel = Numel(dims);
+  if (numel <= 0) numel = kDefaultNumel;
+  return kDefaultTransformLatencyPerElement * numel;
+}
+
+bool KernelLatencyModel::EstimateCost(
+    const Node& node,
+    const KernelBase& kernel,
+    const std::map<std::string, const Type*>& in_types,
+    float* cost) {
+  auto* op_info = node.stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  auto input_args = op_info->input_argnames();
+  if (input_args.empty()) return false;
+  // the shape of the main input
+  std::string main_arg = input_args.front();
+  for (auto& arg : input_args) {
+    if (arg == "X" || arg == "Input") main_arg = arg;
+  }
+  auto main_inputs = op_info->Input(main_arg);
+  auto dims = main_inputs.empty() ? std::vector<int64_t>()
+                                  : InputDims(node, main_inputs.front());
+
+  float latency = 0.f;
+  auto name_it = kBenchmarkOpNames.find(op_type);
+  if (!Estimate(op_type, kernel.target(), kernel.precision(), dims, &latency) &&
+      (name_it == kBenchmarkOpNames.end() ||
+       !Estimate(name_it->second,
+                 kernel.target(),
+                 kernel.precision(),
+                 dims,
+                 &latency))) {
+    return false;
+  }
+
+  // the transforms inserted by the type cast passes to feed the kernel
+  for (auto* in : node.inlinks) {
+    auto* arg = in->arg();
+    if (!arg->type || arg->is_weight || arg->is_persist) continue;
+    std::string arg_name;
+    if (!op_info->GetInputArgname(arg->name, &arg_name)) continue;
+    const auto* decl = ParamTypeRegistry::Global().RetrieveInArgument(
+        kernel.place(), kernel.GenParamTypeKey(), arg_name);
+    if (!decl) continue;
+    // a tensor list for a tensor is not a transform, the kernel can not run
+    if (arg->type->id() != decl->type->id()) return false;
+    // the types of the vars are placeholders until their producers are
+    // picked
+    auto type_it = in_types.find(arg->name);
+    if (type_it == in_types.end() || !type_it->second) continue;
+    const Type& in_type = *type_it->second;
+    auto in_dims = InputDims(node, arg->name);
+    if (!TargetCompatibleTo(in_type, *decl->type)) {
+      latency += TransformLatency("io_copy", in_dims);
+    }
+    if (!PrecisionCompatibleTo(in_type, *decl->type)) {
+      latency += TransformLatency("calib", in_dims);
+    }
+    if (!DataLayoutCompatibleTo(in_type, *decl->type)) {
+      latency += TransformLatency("layout", in_dims);
+    }
+  }
+  *cost = latency;
+  return true;
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
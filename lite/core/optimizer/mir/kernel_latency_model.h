@@ -0,0 +1,90 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/optimizer/mir/node.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * KernelLatencyModel estimates the latency of running an op with a kernel,
+ * from the latency lookup table made by
+ * lite/tests/benchmark/get_latency_lookup_table.py on the device:
+ *
+ * op_name  input_dims  output_dims  param_info  min  max  avg(ms)
+ * conv  [1 96 112 112]  [1 48 114 114]  (ch_out=48,...,dtype=float)  ...
+ *
+ * The "dtype" of param_info gives the precision of the kernel and an
+ * optional "target" limits a line to the kernels of a target, e.g.
+ * (dtype=float,target=x86). The op_name is the benchmark name (conv, fc,
+ * pooling, ...) or the op type. The lines of "calib", "layout" and
+ * "io_copy" time the transforms the type cast passes insert in front of a
+ * kernel whose inputs do not have its declared types, a default rate per
+ * element is used without them.
+ *
+ * A shape missing from the table is estimated from the line of the op with
+ * the closest number of elements, scaled linearly.
+ */
+class KernelLatencyModel {
+ public:
+  static KernelLatencyModel& Global() {
+    static KernelLatencyModel x;
+    return x;
+  }
+
+  // Loads the table once, returns false if the file can not be read.
+  bool Load(const std::string& path);
+  bool empty() const { return entries_.empty(); }
+
+  // The latency of the op of the node with the kernel plus the transforms of
+  // its inputs, in ms, false if the table has no line of the op or the
+  // kernel takes another kind of data than the inputs. in_types holds the
+  // output types of the kernels already picked for the producers of the
+  // inputs, an input without one is not charged a transform.
+  bool EstimateCost(const Node& node,
+                    const KernelBase& kernel,
+                    const std::map<std::string, const Type*>& in_types,
+                    float* cost);
+
+ private:
+  struct Entry {
+    std::string target;
+    PrecisionType precision{PRECISION(kAny)};
+    std::vector<int64_t> dims;
+    int64_t numel{0};
+    float latency{0.f};
+  };
+
+  bool Estimate(const std::string& op_name,
+                TargetType target,
+                PrecisionType precision,
+                const std::vector<int64_t>& dims,
+                float* latency) const;
+  float TransformLatency(const std::string& op_name,
+                         const std::vector<int64_t>& dims) const;
+
+  std::string path_;
+  std::map<std::string, std::vector<Entry>> entries_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,145 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/kernel_latency_model.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+#include "lite/utils/env.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+// A table in the format of get_latency_lookup_table.py, the device lines
+// first and the fields padded with spaces.
+static std::string WriteTable(const std::string& path,
+                              const std::vector<std::string>& lines) {
+  std::ofstream file(path.c_str());
+  file << "dev_info      \tarmv7/v8  \tcore_num  \tthread_num\tpower_mode\n";
+  file << "x86           \t0         \t1         \t1         \t0\n";
+  file << "op_name   \tinput_dims\toutput_dims\tparam_info\t"
+       << "min_latency(ms)\tmax_latency(ms)\tavg_latency(ms)\n";
+  for (auto& line : lines) file << line << "\n";
+  return path;
+}
+
+static const KernelBase* FindKernel(Node* node, const std::string& alias) {
+  for (auto& kernel : node->stmt()->kernels()) {
+    if (kernel->target() == TARGET(kX86) && kernel->alias() == alias) {
+      return kernel.get();
+    }
+  }
+  return nullptr;
+}
+
+TEST(KernelLatencyModel, load) {
+  auto& model = KernelLatencyModel::Global();
+  EXPECT_FALSE(model.Load("kernel_latency_model_test_missing.txt"));
+  EXPECT_TRUE(model.empty());
+  EXPECT_TRUE(model.Load(WriteTable(
+      "kernel_latency_model_test_load.txt",
+      {"activation\t[1 8]     \t[1 8]     \t(act_type=relu,dtype=float)  "
+       "\t0.4       \t0.6       \t0.5       "})));
+  EXPECT_FALSE(model.empty());
+}
+
+// The line of the same shape, or the one of the closest number of elements
+// scaled, among the lines of the precision and the target of the kernel.
+TEST(KernelLatencyModel, estimate) {
+  auto& model = KernelLatencyModel::Global();
+  ASSERT_TRUE(model.Load(WriteTable(
+      "kernel_latency_model_test_estimate.txt",
+      {"activation\t[1 8]\t[1 8]\t(act_type=relu,dtype=float)\t0\t0\t0.5",
+       "activation\t[1 64]\t[1 64]\t(act_type=relu,dtype=float)\t0\t0\t2",
+       "activation\t[1 16]\t[1 16]\t(act_type=relu,dtype=fp16)\t0\t0\t0.01",
+       "activation\t[1 16]\t[1 16]\t(dtype=float,target=arm)\t0\t0\t0.01"})));
+  PassTestHelper helper;
+  helper.AddVar("x", {1, 8});
+  helper.AddVar("out", {1, 8});
+  helper.AddOp("relu", {{"X", {"x"}}}, {{"Out", {"out"}}});
+  auto graph = helper.BuildGraph(kPlaces);
+  auto* node = PassTestHelper::Stmts(graph, "relu").front();
+  auto* kernel = FindKernel(node, "def");
+  ASSERT_TRUE(kernel);
+  auto* x = helper.exec_scope()->FindVar("x")->GetMutable<Tensor>();
+  const std::map<std::string, const Type*> in_types;
+  float cost = 0.f;
+  x->Resize({1, 8});
+  ASSERT_TRUE(model.EstimateCost(*node, *kernel, in_types, &cost));
+  EXPECT_FLOAT_EQ(cost, 0.5f);
+  // 16 elements are closer to 8 than to 64 on the log scale
+  x->Resize({1, 16});
+  ASSERT_TRUE(model.EstimateCost(*node, *kernel, in_types, &cost));
+  EXPECT_FLOAT_EQ(cost, 1.f);
+  x->Resize({1, 128});
+  ASSERT_TRUE(model.EstimateCost(*node, *kernel, in_types, &cost));
+  EXPECT_FLOAT_EQ(cost, 4.f);
+}
+
+// producer -> elementwise_add, the def and int32 kernels of the add cost
+// the same and the calib in front of the one whose input type differs from
+// the output of the kernel picked for the producer decides.
+static std::string PickAddKernel(const std::string& producer) {
+  PassTestHelper helper;
+  helper.AddWeight("w", {2, 3});
+  helper.AddVar("x", {2});
+  helper.AddVar("s", {2});
+  helper.AddVar("out", {2});
+  if (producer == "shape") {
+    helper.AddOp("shape", {{"Input", {"w"}}}, {{"Out", {"s"}}});
+  } else {
+    auto* scale = helper.AddOp(producer, {{"X", {"x"}}}, {{"Out", {"s"}}});
+    scale->SetAttr<float>("scale", 2.f);
+    scale->SetAttr<float>("bias", 0.f);
+    scale->SetAttr<bool>("bias_after_scale", true);
+  }
+  helper
+      .AddOp("elementwise_add",
+             {{"X", {"s"}}, {"Y", {"s"}}},
+             {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto graph = helper.BuildGraph(kPlaces);
+  PassTestHelper::ApplyPass("static_kernel_pick_pass", graph);
+  auto* node = PassTestHelper::Stmts(graph, "elementwise_add").front();
+  return node->stmt()->kernels().front()->alias();
+}
+
+TEST(KernelLatencyModel, pick_by_calib) {
+  auto path = WriteTable(
+      "kernel_latency_model_test_pick.txt",
+      {"elementwise_add\t[2]\t[2]\t(dtype=float)\t0\t0\t0.1",
+       "calib\t[2]\t[2]\t(dtype=float)\t0\t0\t1"});
+  setenv(KERNEL_LATENCY_TABLE_FILE, path.c_str(), 1);
+  EXPECT_EQ(PickAddKernel("shape"), "int32");
+  EXPECT_EQ(PickAddKernel("scale"), "def");
+  unsetenv(KERNEL_LATENCY_TABLE_FILE);
+  // scored by the var descs without the table, which say fp32
+  EXPECT_EQ(PickAddKernel("shape"), "def");
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -13,11 +13,16 @@
 // limitations under the License.
 
 #include "lite/core/optimizer/mir/node.h"
+#include <atomic>
 #include "lite/core/op_registry.h"
 
 namespace paddle {
 namespace lite {
 
+static std::atomic<uint64_t> stmt_type_revision{0};
+
+uint64_t mir::Node::Stmt::type_revision() { return stmt_type_revision; }
+
 const OpInfo *mir::Node::Stmt::op_info() const {
   CHECK(op_);
   return op_->op_info();
@@ -42,6 +47,11 @@ void mir::Node::Stmt::ResetOp(const cpp::OpDesc &op_desc,
                               const std::vector<Place> &valid_places,
                               lite::Scope *scope) {
   CHECK((op_ && op_->scope()) || scope) << "Either scope should be set";
+  // the op info may have been changed in place, compare with the type the
+  // stmt is indexed by
+  if (!indexed_type.empty() && indexed_type != op_desc.Type()) {
+    stmt_type_revision++;
+  }
   lite::Scope *the_scope = scope ? scope : op_->scope();
   op_->Attach(op_desc, the_scope);
   // Recreate the kernels with the latest OpInfo.
@@ -53,6 +63,12 @@ void mir::Node::Stmt::ResetOp(const cpp::OpDesc &op_desc,
   }
   valid_kernels_ = op_->CreateKernels(valid_places);
 }
+void mir::Node::Stmt::SetOp(const std::shared_ptr<OpLite> &op) {
+  if (!indexed_type.empty() && op && indexed_type != op->op_info()->Type()) {
+    stmt_type_revision++;
+  }
+  op_ = op;
+}
 void mir::Node::Stmt::ResetKernels(const std::vector<Place> &valid_places) {
   CHECK(op_) << "change valid place failed, not created op";
   valid_kernels_.clear();
@@ -65,7 +65,7 @@ class Node {
       return valid_kernels_;
     }
 
-    void SetOp(const std::shared_ptr<OpLite>& op) { op_ = op; }
+    void SetOp(const std::shared_ptr<OpLite>& op);
     const std::shared_ptr<OpLite> op() const { return op_; }
 
     Place place() const;
@@ -78,6 +78,13 @@ class Node {
       return os;
     }
 
+    // The number of times the op of an indexed stmt of any graph was set to
+    // another type, the graphs rebuild their index of the stmts by op type
+    // when it changes.
+    static uint64_t type_revision();
+    // The op type the graph indexes the stmt by.
+    std::string indexed_type;
+
     // Description.
     std::string desc;
 
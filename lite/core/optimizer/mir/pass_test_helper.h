@@ -0,0 +1,128 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Builds a program of one block op by op for the tests of the passes, e.g.
+//   PassTestHelper helper;
+//   helper.AddVar("x", {2, 4});
+//   helper.AddWeight("w", {4, 8}, 0.5f);
+//   helper.AddVar("out", {2, 8});
+//   helper.AddOp("fc", {{"Input", {"x"}}, {"W", {"w"}}}, {{"Out", {"out"}}})
+//       ->SetAttr<int>("in_num_col_dims", 1);
+//   auto graph = helper.BuildGraph({Place{TARGET(kX86), PRECISION(kFloat)}});
+//   helper.ApplyPass("lite_fc_fuse_pass", graph);
+class PassTestHelper {
+ public:
+  using Args = std::map<std::string, std::vector<std::string>>;
+
+  PassTestHelper()
+      : program_desc_(std::make_shared<cpp::ProgramDesc>()),
+        scope_(std::make_shared<Scope>()) {
+    block_ = program_desc_->AddBlock<cpp::BlockDesc>();
+  }
+
+  // A fp32 var, the dims may hold -1 as in the var descs of the models.
+  void AddVar(const std::string& name, const std::vector<int64_t>& dims) {
+    auto* var_desc = block_->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var_desc->SetDataType(VarDescAPI::Type::FP32);
+    var_desc->SetShape(dims);
+    var_desc->SetPersistable(false);
+  }
+
+  // A fp32 weight in the root scope, filled with value.
+  Tensor* AddWeight(const std::string& name,
+                    const std::vector<int64_t>& dims,
+                    float value = 1.f) {
+    auto* var_desc = block_->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var_desc->SetDataType(VarDescAPI::Type::FP32);
+    var_desc->SetShape(dims);
+    var_desc->SetPersistable(true);
+    auto* tensor = scope_->Var(name)->GetMutable<Tensor>();
+    tensor->Resize(dims);
+    auto* data = tensor->mutable_data<float>();
+    for (int64_t i = 0; i < tensor->numel(); i++) data[i] = value;
+    tensor->set_persistable(true);
+    return tensor;
+  }
+
+  cpp::OpDesc* AddOp(const std::string& type,
+                     const Args& inputs,
+                     const Args& outputs) {
+    auto* op_desc = block_->AddOp<cpp::OpDesc>();
+    op_desc->SetType(type);
+    for (auto& input : inputs) op_desc->SetInput(input.first, input.second);
+    for (auto& output : outputs) {
+      op_desc->SetOutput(output.first, output.second);
+    }
+    return op_desc;
+  }
+
+  // The ops are attached to the scope when the graph is built, so the attrs
+  // must be set before.
+  std::unique_ptr<SSAGraph> BuildGraph(const std::vector<Place>& places) {
+    program_.reset(new Program(program_desc_, scope_, places));
+    std::unique_ptr<SSAGraph> graph(new SSAGraph);
+    graph->Build(*program_, places);
+    return graph;
+  }
+
+  static void ApplyPass(const std::string& name,
+                        const std::unique_ptr<SSAGraph>& graph) {
+    auto* pass = PassManager::Global().LookUp(name);
+    CHECK(pass) << "Can not find the pass " << name;
+    pass->Apply(graph);
+  }
+
+  static std::vector<Node*> Stmts(const std::unique_ptr<SSAGraph>& graph,
+                                  const std::string& type) {
+    std::vector<Node*> stmts;
+    for (auto* node : graph->StmtTopologicalOrder()) {
+      if (node->stmt()->op_type() == type) {
+        stmts.push_back(node);
+      }
+    }
+    return stmts;
+  }
+
+  Scope* scope() { return scope_.get(); }
+  Scope* exec_scope() { return program_ ? program_->exec_scope() : nullptr; }
+
+ private:
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_{nullptr};
+  std::unique_ptr<Program> program_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -15,11 +15,15 @@
 #include <algorithm>
 #include <array>
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/mir/dot.h"
 #include "lite/core/optimizer/mir/pattern_matcher.h"
+#include "lite/utils/env.h"
 #include "lite/utils/string.h"
 
 namespace paddle {
@@ -113,16 +117,79 @@ void PatternMatcher::operator()(SSAGraph *graph,
   }
 }
 
+std::vector<Node *> PatternMatcher::CandidateNodes(SSAGraph *graph,
+                                                   const PMNode *pmnode) {
+  std::vector<Node *> candidates;
+  if (!pmnode->asserted_op_type().empty()) {
+    candidates = graph->StmtsOfType(pmnode->asserted_op_type());
+    return candidates;
+  }
+  // a var of an edge is linked to a stmt of the op at the other end, take the
+  // links of the op type with the fewest stmts
+  const std::vector<Node *> *stmts = nullptr;
+  bool is_input = false;
+  for (const auto &edge : pattern_.edges()) {
+    const PMNode *op = nullptr;
+    if (edge.first == pmnode) op = edge.second;
+    if (edge.second == pmnode) op = edge.first;
+    if (!op || op->asserted_op_type().empty()) continue;
+    auto &op_stmts = graph->StmtsOfType(op->asserted_op_type());
+    if (!stmts || op_stmts.size() < stmts->size()) {
+      stmts = &op_stmts;
+      is_input = op == edge.second;
+    }
+  }
+  if (!stmts) {
+    for (auto &node : graph->mutable_nodes()) candidates.push_back(&node);
+    return candidates;
+  }
+  std::set<Node *> linked;
+  for (auto *stmt : *stmts) {
+    auto &links = is_input ? stmt->inlinks : stmt->outlinks;
+    for (auto *link : links) {
+      if (linked.insert(link).second) candidates.push_back(link);
+    }
+  }
+  return candidates;
+}
+
 bool PatternMatcher::MarkPMNodesInGraph(SSAGraph *graph) {
   VLOG(3) << "mark pmnodes in graph";
   if (graph->nodes().empty()) return false;
-  for (auto &node : graph->mutable_nodes()) {
-    for (const auto &pmnode : pattern_.nodes()) {
-      if (pmnode->Tell(&node)) {
-        pmnodes2nodes_[pmnode.get()].insert(&node);
-      }
+  std::vector<std::pair<const PMNode *, Node *>> tasks;
+  for (const auto &pmnode : pattern_.nodes()) {
+    for (auto *node : CandidateNodes(graph, pmnode.get())) {
+      tasks.emplace_back(pmnode.get(), node);
     }
   }
+  // the tellers only read the graph, they may run on several threads for the
+  // large graphs
+  std::vector<char> hits(tasks.size(), 0);
+  const int num_threads =
+      std::max(GetIntFromEnv(LITE_PATTERN_MATCHER_THREADS, 1), 1);
+  const size_t kMinTasksPerThread = 4096;
+  size_t num_workers = std::min(static_cast<size_t>(num_threads),
+                                tasks.size() / kMinTasksPerThread);
+  auto tell = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      hits[i] = tasks[i].first->Tell(tasks[i].second);
+    }
+  };
+  if (num_workers > 1) {
+    size_t chunk = (tasks.size() + num_workers - 1) / num_workers;
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_workers; i++) {
+      workers.emplace_back(
+          tell, i * chunk, std::min(tasks.size(), (i + 1) * chunk));
+    }
+    tell(0, chunk);
+    for (auto &worker : workers) worker.join();
+  } else {
+    tell(0, tasks.size());
+  }
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (hits[i]) pmnodes2nodes_[tasks[i].first].insert(tasks[i].second);
+  }
   // Check to early stop if some PMNode can't find matched Node.
   for (auto &pmnode : pattern_.nodes()) {
     if (!pmnodes2nodes_.count(pmnode.get())) {
@@ -229,25 +296,56 @@ std::vector<PatternMatcher::subgraph_t> PatternMatcher::DetectPatterns() {
     auto &cur_groups = bi_records[1 - (step++ % 2)];
     cur_groups.clear();
     if (pre_groups.empty()) break;
-    // source -> target
-    for (Node *source : pmnodes2nodes_[edge.first]) {
-      for (Node *target : pmnodes2nodes_[edge.second]) {
-        // TODO(Superjomn) add some prune strategies.
-        for (const auto &group : pre_groups) {
-          if (IsNodesLink(source, target)) {
-            HitGroup new_group = group;
-            bool flag = new_group.Match(source, edge.first) &&
-                        new_group.Match(target, edge.second);
-            if (flag) {
-              new_group.Register(source, edge.first);
-              new_group.Register(target, edge.second);
-              cur_groups.push_back(new_group);
-              // TODO(Superjomn) need to unique
+    // Grow each group from the node it has at an end of the edge by the
+    // links of the graph, rather than trying all the pairs of the nodes.
+    // The hits are sorted by source, target and group, the order of trying
+    // all the pairs, which the overlapped matches are removed by.
+    auto &sources = pmnodes2nodes_[edge.first];
+    auto &targets = pmnodes2nodes_[edge.second];
+    std::vector<std::tuple<Node *, Node *, size_t>> hits;
+    for (size_t i = 0; i < pre_groups.size(); i++) {
+      const auto &roles = pre_groups[i].roles;
+      auto source_it = roles.find(edge.first);
+      auto target_it = roles.find(edge.second);
+      if (source_it != roles.end()) {
+        Node *source = source_it->second;
+        std::set<Node *> linked(source->outlinks.begin(),
+                                source->outlinks.end());
+        for (auto *target : linked) {
+          if (targets.count(target)) hits.emplace_back(source, target, i);
+        }
+      } else if (target_it != roles.end()) {
+        Node *target = target_it->second;
+        std::set<Node *> linked(target->inlinks.begin(), target->inlinks.end());
+        for (auto *source : linked) {
+          if (sources.count(source) && IsNodesLink(source, target)) {
+            hits.emplace_back(source, target, i);
+          }
+        }
+      } else {
+        for (Node *source : sources) {
+          for (Node *target : targets) {
+            if (IsNodesLink(source, target)) {
+              hits.emplace_back(source, target, i);
             }
           }
         }
       }
     }
+    std::sort(hits.begin(), hits.end());
+    for (const auto &hit : hits) {
+      HitGroup new_group = pre_groups[std::get<2>(hit)];
+      Node *source = std::get<0>(hit);
+      Node *target = std::get<1>(hit);
+      bool flag = new_group.Match(source, edge.first) &&
+                  new_group.Match(target, edge.second);
+      if (flag) {
+        new_group.Register(source, edge.first);
+        new_group.Register(target, edge.second);
+        cur_groups.push_back(new_group);
+        // TODO(Superjomn) need to unique
+      }
+    }
     VLOG(3) << "step " << step << " get records: " << cur_groups.size();
   }
 
@@ -371,6 +469,8 @@ PMNode *PMNode::assert_only_one_output() {
 }
 
 PMNode *PMNode::assert_is_op(const std::string &op_type) {
+  // the nodes must have all the types asserted, any of them can be looked up
+  if (asserted_op_type_.empty()) asserted_op_type_ = op_type;
   asserts_.emplace_back([op_type](const Node *x) {
     if (x && x->IsStmt()) {
       auto *op_info = x->stmt()->op_info();
@@ -80,6 +80,13 @@ struct PMNode {
   bool IsOp() const { return type_ == Type::kOp; }
   bool IsVar() const { return type_ == Type::kVar; }
 
+  // The op type asserted by assert_is_op, which every node told to be this
+  // PMNode has, or empty.
+  const std::string& asserted_op_type() const {
+    static const std::string kNoType;
+    return teller_ ? kNoType : asserted_op_type_;
+  }
+
   const std::string& name() const { return name_; }
 
   PMNode& operator=(const PMNode&) = delete;
@@ -195,6 +202,7 @@ struct PMNode {
   PMPattern* pattern_;
   std::string name_;
   std::string op_type_;
+  std::string asserted_op_type_;
   Type type_{};
   Role role_{Role::kUnknown};
 };
@@ -301,6 +309,11 @@ class PatternMatcher {
   // Mark the nodes that fits the pattern.
   bool MarkPMNodesInGraph(SSAGraph* graph);
 
+  // The nodes which may be told to be the PMNode, the stmts of its asserted
+  // op type, or the vars linked to the ones of another PMNode it has an edge
+  // with, or else all the nodes.
+  std::vector<Node*> CandidateNodes(SSAGraph* graph, const PMNode* pmnode);
+
   // Detect all the pattern and output the hit records.
   std::vector<subgraph_t> DetectPatterns();
 
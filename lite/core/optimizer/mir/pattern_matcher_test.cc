@@ -15,6 +15,11 @@
 #include "lite/core/optimizer/mir/pattern_matcher.h"
 
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/utils/env.h"
 
 namespace paddle {
 namespace lite {
@@ -228,6 +233,84 @@ TEST(PatternMatcher, IntermediateCheck) {
   ASSERT_EQ(count, 1);
 }
 
+// A chain op0 -> var0 -> op1 -> var1 -> ... where every third var also feeds
+// a side op, large enough for the nodes to be told on several threads.
+void BuildChainGraph(SSAGraph* g, int num_ops) {
+  Node* prev = nullptr;
+  for (int i = 0; i < num_ops; i++) {
+    g->mutable_nodes().emplace_back();
+    Node& op = g->mutable_nodes().back();
+    op.AsStmt().desc = "op" + std::to_string(i);
+    if (prev) {
+      prev->outlinks.push_back(&op);
+      op.inlinks.push_back(prev);
+    }
+    g->mutable_nodes().emplace_back();
+    Node& var = g->mutable_nodes().back();
+    var.AsArg("var" + std::to_string(i));
+    op.outlinks.push_back(&var);
+    var.inlinks.push_back(&op);
+    if (i % 3 == 0) {
+      g->mutable_nodes().emplace_back();
+      Node& side = g->mutable_nodes().back();
+      side.AsStmt().desc = "side";
+      var.outlinks.push_back(&side);
+      side.inlinks.push_back(&var);
+    }
+    prev = &var;
+  }
+}
+
+// The pattern op -> var -> op, the var is intermediate.
+void BuildChainPattern(PatternMatcher* matcher) {
+  auto is_op = [](const Node* x) {
+    return x && x->IsStmt() && x->stmt()->desc.compare(0, 2, "op") == 0;
+  };
+  auto* op0 = matcher->mutable_pattern()->NewNode(is_op, "op0");
+  auto* var = matcher->mutable_pattern()
+                  ->NewNode([](const Node* x) { return x && x->IsArg(); },
+                            "var")
+                  ->AsIntermediate();
+  auto* op1 = matcher->mutable_pattern()->NewNode(is_op, "op1");
+  var->LinksFrom({op0}).LinksTo({op1});
+}
+
+// The nodes are told on one thread and on four, the subgraphs detected must
+// be the same.
+TEST(PatternMatcher, DetectPatterns) {
+  SSAGraph graph;
+  const int kNumOps = 3000;
+  BuildChainGraph(&graph, kNumOps);
+
+  // the subgraphs by the names of the pmnodes, which the matchers own
+  const char* threads[2] = {"1", "4"};
+  std::vector<std::map<std::string, Node*>> subgraphs[2];
+  int handled[2] = {0, 0};
+  for (int t = 0; t < 2; t++) {
+    setenv(LITE_PATTERN_MATCHER_THREADS, threads[t], 1);
+    PatternMatcher matcher;
+    BuildChainPattern(&matcher);
+    matcher.MarkPMNodesInGraph(&graph);
+    for (auto& subgraph : matcher.DetectPatterns()) {
+      std::map<std::string, Node*> nodes;
+      for (auto& item : subgraph) nodes[item.first->name()] = item.second;
+      subgraphs[t].push_back(nodes);
+    }
+    matcher(&graph, [&](const PatternMatcher::subgraph_t& g, SSAGraph* graph) {
+      ++handled[t];
+    });
+    unsetenv(LITE_PATTERN_MATCHER_THREADS);
+  }
+
+  // each var but the last links two ops, the ones also feeding a side op are
+  // dropped as they are intermediate
+  ASSERT_EQ(subgraphs[0].size(), static_cast<size_t>(kNumOps - 1));
+  EXPECT_EQ(handled[0], (kNumOps - 1) - (kNumOps + 1) / 3);
+  EXPECT_EQ(handled[1], handled[0]);
+  // the same nodes in the same order
+  EXPECT_EQ(subgraphs[1], subgraphs[0]);
+}
+
 }  // namespace mir
 }  // namespace lite
 }  // namespace paddle
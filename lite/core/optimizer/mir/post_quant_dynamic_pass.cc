@@ -163,6 +163,32 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   op_info->SetAttr(weight_name + "_quant_scale", scales);
 }
 
+int PostQuantDynamicPass::QuantAxis(const std::string& op_type,
+                                    const DDim& weight_dims) {
+  if (weight_dims.size() == 1) return 0;
+  auto iter =
+      std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
+  return iter != quant_axis1_ops.end() ? 1 : 0;
+}
+
+void FakeQuantizeWeight(const std::string& op_type,
+                        int quant_bits,
+                        Tensor* weight) {
+  CHECK(quant_bits == 8 || quant_bits == 16);
+  const DDim dims = weight->dims();
+  int quant_axis = PostQuantDynamicPass::QuantAxis(op_type, dims);
+  std::vector<float> scales;
+  FindAbsMaxPerChannel(*weight, quant_axis, &scales);
+  float range = (1 << (quant_bits - 1)) - 1;
+  int64_t channel = dims[quant_axis];
+  int64_t inner_size = dims.production() / dims.count(0, quant_axis + 1);
+  float* data = weight->mutable_data<float>();
+  for (int64_t i = 0; i < dims.production(); i++) {
+    float scale = scales[(i / inner_size) % channel] / range;
+    if (scale > 0.f) data[i] = std::round(data[i] / scale) * scale;
+  }
+}
+
 void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   int quant_bits = 16;
   if (quant_type_ == lite_api::QuantType::QUANT_INT8) {
@@ -199,14 +225,16 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
                     << "so skip quantizing the weight of " << weight_name;
           continue;
         }
-        auto iter =
-            std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
-        int quant_axis = iter != quant_axis1_ops.end() ? 1 : 0;
-        if (weight->dims().size() == 1) {
-          quant_axis = 0;
+        int weight_quant_bits = quant_bits;
+        if (!weight_quant_types_.empty()) {
+          auto type_it = weight_quant_types_.find(weight_name);
+          if (type_it == weight_quant_types_.end()) continue;
+          weight_quant_bits =
+              type_it->second == lite_api::QuantType::QUANT_INT8 ? 8 : 16;
         }
+        int quant_axis = QuantAxis(op_type, weight->dims());
         PostQuantDynamicPerChannel(
-            op_info, weight, weight_name, quant_axis, quant_bits);
+            op_info, weight, weight_name, quant_axis, weight_quant_bits);
       }
     }
   }
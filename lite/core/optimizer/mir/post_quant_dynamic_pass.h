@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,11 +47,29 @@ class PostQuantDynamicPass : public ProgramPass {
   void SetQuantType(lite_api::QuantType quant_type) {
     quant_type_ = quant_type;
   }
+  // Quantize only the weights in the map, each with its quant type, instead
+  // of all the weights of quant_ops with quant_type. It is the mixed
+  // precision picked by lite/api/tools/mixed_precision_search.cc.
+  void SetWeightQuantTypes(
+      const std::map<std::string, lite_api::QuantType>& weight_quant_types) {
+    weight_quant_types_ = weight_quant_types;
+  }
+
+  // The axis of the channels the weight of the op is quantized by.
+  static int QuantAxis(const std::string& op_type, const DDim& weight_dims);
 
  private:
   lite_api::QuantType quant_type_{lite_api::QuantType::QUANT_INT16};
+  std::map<std::string, lite_api::QuantType> weight_quant_types_;
 };
 
+// Quantizes the fp32 weight of the op per channel as the pass does, and back
+// to fp32 in place, which are the values the model computes with after the
+// weight is dequantized at the loading.
+void FakeQuantizeWeight(const std::string& op_type,
+                        int quant_bits,
+                        Tensor* weight);
+
 }  // namespace mir
 }  // namespace lite
 }  // namespace paddle
@@ -143,6 +143,7 @@ Node *SSAGraph::GraphCreateInstructNode(
   new_node.set_id(num_node_created_++);
   auto kernels = op->CreateKernels(valid_places);
   node_storage_.back().AsStmt(op->op_type_, std::move(kernels), op);
+  if (stmt_index_valid_) IndexStmt(&new_node);
 
   CHECK(new_node.inlinks.empty()) << "duplicate Build found";
   CHECK(new_node.outlinks.empty()) << "duplicate Build found";
@@ -221,12 +222,47 @@ void SSAGraph::RemoveNode(const mir::Node *node) {
                           node_storage_.end(),
                           [&node](mir::Node &n) { return &n == node; });
   CHECK(pos != node_storage_.end());
+  UnindexStmt(node);
   node_storage_.erase(pos);
 }
 
+void SSAGraph::IndexStmt(mir::Node *node) {
+  auto *stmt = node->stmt();
+  stmt->indexed_type = stmt->op_type();
+  stmt_index_[stmt->indexed_type].push_back(node);
+  stmt_index_types_[node] = stmt->indexed_type;
+}
+
+void SSAGraph::UnindexStmt(const mir::Node *node) {
+  auto it = stmt_index_types_.find(node);
+  if (it == stmt_index_types_.end()) return;
+  auto &stmts = stmt_index_[it->second];
+  stmts.erase(std::find(stmts.begin(), stmts.end(), node));
+  stmt_index_types_.erase(it);
+}
+
+const std::vector<mir::Node *> &SSAGraph::StmtsOfType(
+    const std::string &op_type) {
+  if (!stmt_index_valid_ ||
+      stmt_index_revision_ != mir::Node::Stmt::type_revision()) {
+    stmt_index_.clear();
+    stmt_index_types_.clear();
+    stmt_index_revision_ = mir::Node::Stmt::type_revision();
+    for (auto &node : node_storage_) {
+      // the stmts made by NewInstructNode may not have an op yet
+      if (node.IsStmt() && node.stmt()->op()) IndexStmt(&node);
+    }
+    stmt_index_valid_ = true;
+  }
+  return stmt_index_[op_type];
+}
+
 void SSAGraph::CloneFrom(const SSAGraph &from) {
   node_storage_.clear();
   arguments_.clear();
+  stmt_index_.clear();
+  stmt_index_types_.clear();
+  stmt_index_valid_ = false;
   valid_places_ = from.valid_places_;
 
   std::map<const mir::Node *, mir::Node *> clone_node_map;
@@ -327,6 +363,8 @@ Node *SSAGraph::NewArgumentNode(const std::string &name) {
 }
 
 Node *SSAGraph::NewInstructNode() {
+  // the op of the stmt is set after, index it on the next lookup
+  stmt_index_valid_ = false;
   node_storage_.emplace_back();
   node_storage_.back().set_id(num_node_created_++);
   return &node_storage_.back();
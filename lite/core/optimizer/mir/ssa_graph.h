@@ -73,6 +73,13 @@ class SSAGraph : GraphBase {
 
   mir::Node *RetrieveArgument(const std::string &arg);
 
+  // The stmts of the op type in the order they were created, so that the
+  // pattern matcher only looks at the ops of the types in a pattern. The
+  // index is kept up to date by the methods which create and remove the
+  // nodes, and rebuilt after a stmt was created empty or had its op reset to
+  // another type.
+  const std::vector<mir::Node *> &StmtsOfType(const std::string &op_type);
+
   Node *NewArgumentNode(const std::string &name);
   Node *NewInstructNode();
 
@@ -115,6 +122,9 @@ class SSAGraph : GraphBase {
   std::map<mir::Node *, std::set<mir::Node *, NodeComp>, NodeComp>
   BuildNodeAdjList();
 
+  void IndexStmt(mir::Node *node);
+  void UnindexStmt(const mir::Node *node);
+
   void SortHelper(
       const std::map<mir::Node *, std::set<mir::Node *, NodeComp>, NodeComp>
           &adj_list,
@@ -128,6 +138,11 @@ class SSAGraph : GraphBase {
   std::vector<Place> valid_places_;
   int block_idx_ = kRootBlockIdx;
   int num_node_created_ = 0;
+  // The index of StmtsOfType and the op type each stmt is indexed by.
+  std::map<std::string, std::vector<mir::Node *>> stmt_index_;
+  std::map<const mir::Node *, std::string> stmt_index_types_;
+  bool stmt_index_valid_{false};
+  uint64_t stmt_index_revision_{0};
 };
 
 // Remove the link between a -> b.
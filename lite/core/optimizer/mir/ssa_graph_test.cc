@@ -0,0 +1,119 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/optimizer/mir/pass_test_helper.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const std::vector<Place> kPlaces{Place{TARGET(kX86), PRECISION(kFloat)},
+                                        Place{TARGET(kHost), PRECISION(kAny)}};
+
+// Every stmt of the graph is indexed once, by the type of its op.
+static void CheckStmtIndex(SSAGraph* graph,
+                           const std::vector<std::string>& types) {
+  size_t num_stmts = 0;
+  for (auto& node : graph->nodes()) {
+    if (node.IsStmt()) num_stmts++;
+  }
+  std::set<Node*> indexed;
+  for (auto& type : types) {
+    for (auto* node : graph->StmtsOfType(type)) {
+      EXPECT_EQ(node->stmt()->op_type(), type);
+      EXPECT_TRUE(indexed.insert(node).second);
+    }
+  }
+  EXPECT_EQ(indexed.size(), num_stmts);
+}
+
+static void AddScale(PassTestHelper* helper,
+                     const std::string& x,
+                     const std::string& out) {
+  auto* scale = helper->AddOp("scale", {{"X", {x}}}, {{"Out", {out}}});
+  scale->SetAttr<float>("scale", 2.f);
+  scale->SetAttr<float>("bias", 0.f);
+  scale->SetAttr<bool>("bias_after_scale", true);
+}
+
+// scale -> relu -> scale
+TEST(SSAGraph, stmt_index) {
+  const std::vector<std::string> types{"scale", "relu", "sigmoid"};
+  PassTestHelper helper;
+  helper.AddVar("x", {2, 4});
+  helper.AddVar("a", {2, 4});
+  helper.AddVar("b", {2, 4});
+  helper.AddVar("out", {2, 4});
+  AddScale(&helper, "x", "a");
+  helper.AddOp("relu", {{"X", {"a"}}}, {{"Out", {"b"}}});
+  AddScale(&helper, "b", "out");
+  auto graph = helper.BuildGraph(kPlaces);
+
+  // in the order the stmts were created
+  auto scales = graph->StmtsOfType("scale");
+  ASSERT_EQ(scales.size(), 2UL);
+  EXPECT_EQ(scales[0]->stmt()->op_info()->Output("Out").front(), "a");
+  EXPECT_EQ(scales[1]->stmt()->op_info()->Output("Out").front(), "out");
+  ASSERT_EQ(graph->StmtsOfType("relu").size(), 1UL);
+  EXPECT_TRUE(graph->StmtsOfType("sigmoid").empty());
+  CheckStmtIndex(graph.get(), types);
+
+  // the op of the same type reset keeps the index
+  auto revision = Node::Stmt::type_revision();
+  cpp::OpDesc scale_desc = *scales[1]->stmt()->op_info();
+  scale_desc.SetAttr<float>("scale", 3.f);
+  scales[1]->stmt()->ResetOp(scale_desc, kPlaces);
+  EXPECT_EQ(Node::Stmt::type_revision(), revision);
+  EXPECT_EQ(graph->StmtsOfType("scale"), scales);
+
+  // the op reset to another type moves the stmt in the index
+  auto* relu = graph->StmtsOfType("relu").front();
+  cpp::OpDesc sigmoid_desc = *relu->stmt()->op_info();
+  sigmoid_desc.SetType("sigmoid");
+  relu->stmt()->ResetOp(sigmoid_desc, kPlaces);
+  EXPECT_GT(Node::Stmt::type_revision(), revision);
+  EXPECT_TRUE(graph->StmtsOfType("relu").empty());
+  ASSERT_EQ(graph->StmtsOfType("sigmoid").size(), 1UL);
+  EXPECT_EQ(graph->StmtsOfType("sigmoid").front(), relu);
+  CheckStmtIndex(graph.get(), types);
+
+  // the removed stmt leaves the index
+  auto* out = scales[1]->outlinks.front();
+  GraphSafeRemoveNodes(graph.get(), {scales[1], out});
+  ASSERT_EQ(graph->StmtsOfType("scale").size(), 1UL);
+  EXPECT_EQ(graph->StmtsOfType("scale").front(), scales[0]);
+  CheckStmtIndex(graph.get(), types);
+
+  // the created stmt is appended to the index
+  auto op = LiteOpRegistry::Global().Create("scale");
+  op->Attach(scale_desc, helper.exec_scope());
+  auto* node = graph->GraphCreateInstructNode(op, kPlaces);
+  ASSERT_EQ(graph->StmtsOfType("scale").size(), 2UL);
+  EXPECT_EQ(graph->StmtsOfType("scale").front(), scales[0]);
+  EXPECT_EQ(graph->StmtsOfType("scale").back(), node);
+  CheckStmtIndex(graph.get(), types);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -21,7 +21,9 @@
 #include <utility>
 #include <vector>
 #include "lite/core/optimizer/mir/graph_visualize_pass.h"
+#include "lite/core/optimizer/mir/kernel_latency_model.h"
 #include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/utils/env.h"
 
 namespace paddle {
 namespace lite {
@@ -32,6 +34,52 @@ bool KernelScoreCmp(const std::pair<float, std::unique_ptr<KernelBase>>& a,
   return a.first > b.first;
 }
 
+void StaticKernelPickPass::PickByLatency(
+    const lite::mir::Node& node,
+    const std::vector<Place>& places,
+    const std::map<std::string, const Type*>& in_types,
+    std::vector<std::pair<float, std::unique_ptr<KernelBase>>>* scored) {
+  auto& model = KernelLatencyModel::Global();
+  float best_cost;
+  if (scored->empty() ||
+      !model.EstimateCost(
+          node, *scored->front().second, in_types, &best_cost)) {
+    return;
+  }
+  const bool enable_int8 = node.stmt()->op_info()->HasAttr("enable_int8");
+  auto is_valid_place = [&](const KernelBase& kernel) {
+    // the int8 kernels need the scales of the quantized models
+    if (kernel.precision() == PRECISION(kInt8) && !enable_int8) return false;
+    for (auto& place : places) {
+      if ((place.target == kernel.target() || kernel.target() == TARGET(kAny) ||
+           place.target == TARGET(kAny)) &&
+          (place.precision == kernel.precision() ||
+           kernel.precision() == PRECISION(kAny) ||
+           place.precision == PRECISION(kAny))) {
+        return true;
+      }
+    }
+    return false;
+  };
+  size_t best = 0;
+  for (size_t i = 1; i < scored->size(); ++i) {
+    const auto& kernel = *(*scored)[i].second;
+    float cost;
+    if ((*scored)[i].first > 0 && is_valid_place(kernel) &&
+        model.EstimateCost(node, kernel, in_types, &cost) &&
+        cost < best_cost) {
+      best = i;
+      best_cost = cost;
+    }
+  }
+  if (best > 0) {
+    VLOG(2) << "pick " << (*scored)[best].second->summary()
+            << " by latency, estimated " << best_cost << " ms";
+    std::rotate(
+        scored->begin(), scored->begin() + best, scored->begin() + best + 1);
+  }
+}
+
 void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   kernel_pick_factors_.ConsiderTarget();
   kernel_pick_factors_.ConsiderPrecision();
@@ -39,13 +87,21 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   CHECK(kernel_pick_factors_.any_factor_considered())
       << "kernel_pick_factors should be specified first";
   CHECK(graph) << "graph not valid";
+  auto latency_table = GetStringFromEnv(KERNEL_LATENCY_TABLE_FILE);
+  bool pick_by_latency = !latency_table.empty() &&
+                         KernelLatencyModel::Global().Load(latency_table);
+  // the output types of the kernels picked so far, which the latency model
+  // prices the transforms of the inputs against
+  std::map<std::string, const Type*> picked_types;
 
   // sort kernels by the factors.
   VLOG(2) << "graph block_idx: " << graph->blockIdx();
   VLOG(2) << "graph->mutable_nodes().size(): " << graph->mutable_nodes().size();
   size_t idx = 0;
-  for (auto& node : graph->mutable_nodes()) {
-    if (!node.IsStmt()) continue;
+  // in the topological order, so that the producers of the inputs of a node
+  // are picked before it
+  for (auto* stmt_node : graph->StmtTopologicalOrder()) {
+    auto& node = *stmt_node;
     auto& instruct = node.AsStmt();
     VLOG(2) << "pick kernel for op : " << instruct.op_type() << ", in block "
             << graph->blockIdx() << ", idx : " << idx++;
@@ -86,6 +142,9 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       scored.emplace_back(score, std::move(kernel));
     }
     std::stable_sort(scored.begin(), scored.end(), KernelScoreCmp);
+    if (pick_by_latency) {
+      PickByLatency(node, graph->valid_places(), picked_types, &scored);
+    }
     instruct.kernels().clear();
 
     if (!instruct.op_info()->HasAttr("enable_int8")) {
@@ -150,6 +209,9 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
           scored.emplace_back(score, std::move(kernel));
         }
         std::stable_sort(scored.begin(), scored.end(), KernelScoreCmp);
+        if (pick_by_latency) {
+          PickByLatency(node, graph->valid_places(), picked_types, &scored);
+        }
         instruct.kernels().clear();
       }
       // If the out_type_int8 is true, we should pick the kernel with the
@@ -180,6 +242,17 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       CHECK(!instruct.kernels().empty()) << "No kernels found for "
                                          << instruct.op_type();
     }
+
+    if (pick_by_latency) {
+      const auto& picked = *instruct.kernels().front();
+      for (auto* out : node.outlinks) {
+        std::string arg_name;
+        if (instruct.op_info()->GetOutputArgname(out->arg()->name,
+                                                 &arg_name)) {
+          picked_types[out->arg()->name] = picked.GetOutputDeclType(arg_name);
+        }
+      }
+    }
   }
 }
 
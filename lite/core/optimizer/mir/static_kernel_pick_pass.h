@@ -18,6 +18,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "lite/core/optimizer/mir/pass.h"
 #include "lite/core/types.h"
@@ -36,6 +37,11 @@ namespace mir {
  * - place, the target place.
  * - kernel_pick_factors, the factors to consider in picking kernels.
  * Set them first before execute the pass.
+ *
+ * If KERNEL_LATENCY_TABLE_FILE gives a latency lookup table, the kernel of
+ * the valid places with the least estimated latency, including the calib,
+ * layout and io_copy its inputs need, is picked instead of the best scored
+ * one, see KernelLatencyModel.
  */
 class StaticKernelPickPass : public mir::StmtPass {
  public:
@@ -254,6 +260,15 @@ class StaticKernelPickPass : public mir::StmtPass {
     return final_score;
   }
 
+  // Moves the candidate of the least estimated cost to the front, if the
+  // best scored one has an estimate. in_types holds the output types of the
+  // kernels picked for the producers of the inputs.
+  void PickByLatency(
+      const lite::mir::Node& node,
+      const std::vector<Place>& places,
+      const std::map<std::string, const Type*>& in_types,
+      std::vector<std::pair<float, std::unique_ptr<KernelBase>>>* scored);
+
   // Compatible for PrecisionType.
   // For cuda, in the process of choosing kernel, fp16 and fp32 are compatiable.
   // If kernel's declared type is kAny, it is matched.
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_bf16_attribute_pass.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_place.h"
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+void X86BF16AttributePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    const std::string op_type = node->stmt()->op_type();
+    auto iter = bf16_ops_.find(op_type);
+    if (iter == bf16_ops_.end()) continue;
+    OpInfo* op_info = node->stmt()->mutable_op_info();
+    // the int8 path has its own weights
+    if (op_info->HasAttr("enable_int8")) continue;
+    if (!op_info->HasInput(iter->second) ||
+        op_info->Input(iter->second).empty()) {
+      continue;
+    }
+    const std::string weight_name = op_info->Input(iter->second).front();
+    auto* scope = node->stmt()->op()->scope();
+    bool enable_bf16 = false;
+    for (auto* in_node : node->inlinks) {
+      CHECK(in_node->IsArg()) << "The input node should be variable.";
+      if (in_node->arg()->name != weight_name || !in_node->arg()->is_weight) {
+        continue;
+      }
+      Tensor* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
+      CHECK(weight) << "Can not find the weight in scope.";
+      if (weight->precision() != PrecisionType::kFloat ||
+          weight->dims().size() != 2) {
+        LOG(INFO) << "The weight is not 2-D fp32, "
+                  << "so skip converting " << weight_name << " to bf16";
+        continue;
+      }
+      op_info->SetAttr<std::string>(weight_name + "_bf16", "bf16");
+      enable_bf16 = true;
+    }
+    // Attach again so that the op param and kernels see the attribute.
+    if (enable_bf16) {
+      node->stmt()->ResetOp(*op_info, graph->valid_places());
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(x86_bf16_attribute_pass,
+                  paddle::lite::mir::X86BF16AttributePass)
+    .BindTargets({TARGET(kX86)});
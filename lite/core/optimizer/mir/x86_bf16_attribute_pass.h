@@ -0,0 +1,49 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include "lite/api/paddle_place.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/target_wrapper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+/*
+ * Use x86_bf16_attribute_pass method to set bf16 attirbute in model.
+ * if the gemm weight of an op is persistable fp32, then add
+ * weight_name_bf16 attirbute;
+ * Then running model, the x86 kernel packs this weight into bf16 once in
+ * PrepareForRun and computes with fp32 accumulation. For matmul and
+ * matmul_v2 this is done when x is not transposed, transpose_Y and alpha
+ * are folded into the packed weight.
+ * It runs before static_kernel_pick_pass, see RunDefaultOptimizer.
+ */
+class X86BF16AttributePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // op type -> argument name of the weight
+  std::map<std::string, std::string> bf16_ops_{
+      {"fc", "W"}, {"mul", "Y"}, {"matmul", "Y"}, {"matmul_v2", "Y"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,51 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include "lite/api/paddle_place.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass.h"
+#include "lite/core/target_wrapper.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+/*
+ * Use x86_dynamic_quant_attribute_pass to run the gemm of fc, mul and matmul
+ * in int8 without calibration.
+ * If the gemm weight of an op is a persistable 2-D fp32, then add the
+ * weight_name_dynamic_int8 attribute;
+ * Then running model, the x86 kernel quantizes this weight per column once
+ * in PrepareForRun, quantizes the rows of the input by their abs max at
+ * every run and computes with gemm_s8u8_dynamic.
+ * The weights of the models quantized by post_quant_dynamic_pass are
+ * dequantized at the loading, and quantized back to the same int8 values.
+ * It runs before static_kernel_pick_pass, see RunDefaultOptimizer.
+ */
+class X86DynamicQuantAttributePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // op type -> argument name of the weight
+  std::map<std::string, std::string> dynamic_int8_ops_{
+      {"fc", "W"}, {"mul", "Y"}, {"matmul", "Y"}, {"matmul_v2", "Y"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "lite/core/optimizer/optimizer.h"
+#include <algorithm>
 #include <fstream>
+#include <utility>
 #ifdef LITE_WITH_XPU
 #include "lite/core/optimizer/mir/__xpu__static_kernel_pick_pass.h"
 #endif
@@ -21,6 +23,7 @@
 #include "lite/core/optimizer/mir/type_target_cast_pass.h"
 #include "lite/model_parser/model_parser.h"
 #include "lite/utils/all.h"
+#include "lite/utils/timer.h"
 
 namespace paddle {
 namespace lite {
@@ -55,6 +58,7 @@ std::unique_ptr<RuntimeProgram> Optimizer::Run(Program&& program) {
   SpecifyKernelPickTactic(kernel_pick_factor_);
   InitTargetTypeTransformPass();
   InitControlFlowOpSharedInputsAndOutputsPlaceSyncPass();
+  InitTransposeEliminatePass();
 
   ApplyPasses(&graphs_);
 
@@ -93,8 +97,19 @@ void Optimizer::InitControlFlowOpSharedInputsAndOutputsPlaceSyncPass() {
   pass->SetAllGraphs(&graphs_);
 }
 
+void Optimizer::InitTransposeEliminatePass() {
+  auto* pass =
+      mir::PassManager::Global().LookUp<mir::TransposeEliminatePass>(
+          "transpose_eliminate_pass");
+  CHECK(pass);
+  CHECK(!graphs_.empty());
+  pass->SetAllGraphs(&graphs_);
+}
+
 void Optimizer::ApplyPasses(
     std::vector<std::unique_ptr<mir::SSAGraph>>* graphes) {
+  std::vector<std::pair<float, std::string>> pass_times;
+  float total_time = 0.f;
   for (auto& pass : passes_) {
     LOG(INFO) << "== Running pass: " << pass->name();
     std::set<TargetType> targets;
@@ -107,6 +122,8 @@ void Optimizer::ApplyPasses(
       LOG(INFO) << "   - Skip " << pass->name()
                 << " because the target or kernel does not match.";
     } else {
+      Timer timer;
+      timer.Start();
       // Check the pass whether it is supported for processing subblocks
       if (kSubblockUnsupportedPasses.count(pass->name()) ||
           kSubblockSkippedPasses.count(pass->name())) {
@@ -116,9 +133,27 @@ void Optimizer::ApplyPasses(
           pass->Apply(graph);
         }
       }
-      LOG(INFO) << "== Finished running: " << pass->name();
+      float time = timer.Stop();
+      pass_times.emplace_back(time, pass->name());
+      total_time += time;
+      LOG(INFO) << "== Finished running: " << pass->name() << " in " << time
+                << " ms";
     }
   }
+  // the passes which took the most of the time
+  const size_t kNumSlowestPasses = 10;
+  std::stable_sort(pass_times.begin(),
+                   pass_times.end(),
+                   [](const std::pair<float, std::string>& a,
+                      const std::pair<float, std::string>& b) {
+                     return a.first > b.first;
+                   });
+  LOG(INFO) << "== Ran " << pass_times.size() << " passes in " << total_time
+            << " ms, the slowest ones:";
+  for (size_t i = 0; i < std::min(kNumSlowestPasses, pass_times.size()); i++) {
+    LOG(INFO) << "   " << pass_times[i].second << ": " << pass_times[i].first
+              << " ms";
+  }
 }
 
 std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
@@ -141,6 +176,8 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "unsqueeze_calc_offline_pass",
        "reshape_calc_offline_pass",
        "ssd_boxes_calc_offline_pass",
+       // Fold the rest of the ops fed only by weights with the host kernels.
+       "constant_folding_pass",
        // A minimal set of op fusion pass.
        "op_fusion_minimal_set_pass",
        // For the fully quantization model, the quantization parameters of the
@@ -158,6 +195,8 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        // want to insert a pass in the above passes.
        "remove_scale1_pass",
        "adaptive_1x1_pool2d_convert_global_pass",  //
+       // Sink, merge and fold the transposes before the fusions match them.
+       "transpose_eliminate_pass",
        "lite_unsqueeze2_pad3d_squeeze2_fuse_pass",
        "lite_conv_elementwise_fuse_pass",  // conv-elemwise-bn
        "lite_conv_bn_fuse_pass",           //
@@ -190,6 +229,12 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_greater_than_cast_fuse_pass",
        "fill_range_fuse_pass",
        "identity_dropout_eliminate_pass",
+       "lite_scaled_dot_product_attention_fuse_pass",
+       "lite_elementwise_add_layer_norm_fuse_pass",
+       // after the fusers matching the elementwise ops behind a gemm
+       "lite_gemm_epilogue_fuse_pass",
+       "lite_elementwise_chain_fuse_pass",
+       "lite_lookup_table_sequence_pool_fuse_pass",
        "sparse_conv_detect_pass",
        //  "keepdims_convert_pass",
        "__xpu__max_pooling_pad_zero_detect_fuse_pass",
@@ -216,6 +261,10 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "__xpu__dynamic_lstm_fuse_pass",
        "__xpu__multi_softmax_fuse_pass",
        "__xpu__conv2d_transpose_fuse_pass",
+       // Merge the duplicated ops and remove the ops nothing fetches, after
+       // the fusions, which mostly need the ops they match to have a single
+       // consumer.
+       "redundant_op_elimination_pass",
        // pick original kernel from graph (exclude xpu)
        "static_kernel_pick_pass",
        // xpu pick original kernel from graph
@@ -300,6 +349,11 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
   const std::string pqd_pass{"post_quant_dynamic_pass"};
   const std::string pqd_depend_pass{"lite_quant_dequant_fuse_pass"};
   const std::string fp16_pass{"fp16_attribute_pass"};
+  // x86_bf16_attribute_pass and x86_dynamic_quant_attribute_pass must be in
+  // the front of static_kernel_pick_pass
+  const std::string bf16_pass{"x86_bf16_attribute_pass"};
+  const std::string dynamic_quant_pass{"x86_dynamic_quant_attribute_pass"};
+  const std::string bf16_depend_pass{"static_kernel_pick_pass"};
 
   for (const std::string& pass : passes) {
     if (pass == pqd_pass) {
@@ -307,6 +361,11 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
           std::find(passes_local.begin(), passes_local.end(), pqd_depend_pass);
       CHECK(iter != passes_local.end()) << "No find " << pqd_depend_pass;
       passes_local.push_back(pass);
+    } else if (pass == bf16_pass || pass == dynamic_quant_pass) {
+      auto iter =
+          std::find(passes_local.begin(), passes_local.end(), bf16_depend_pass);
+      CHECK(iter != passes_local.end()) << "No find " << bf16_depend_pass;
+      passes_local.insert(iter, pass);
     } else {
       passes_local.push_back(pass);
     }
@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 #include "lite/core/optimizer/mir/control_flow_op_shared_inputs_and_outputs_place_sync_pass.h"
+#include "lite/core/optimizer/mir/elimination/transpose_eliminate_pass.h"
 #include "lite/core/optimizer/mir/fp16_attribute_pass.h"
 #include "lite/core/optimizer/mir/generate_program_pass.h"
 #include "lite/core/optimizer/mir/pass_manager.h"
@@ -28,6 +29,8 @@
 #include "lite/core/optimizer/mir/ssa_graph.h"
 #include "lite/core/optimizer/mir/static_kernel_pick_pass.h"
 #include "lite/core/optimizer/mir/type_target_cast_pass.h"
+#include "lite/core/optimizer/mir/x86_bf16_attribute_pass.h"
+#include "lite/core/optimizer/mir/x86_dynamic_quant_attribute_pass.h"
 #include "lite/core/optimizer/mir/x86_int8_attribute_pass.h"
 #include "lite/core/program.h"
 #include "lite/core/types.h"
@@ -47,6 +50,8 @@ const std::set<std::string> kSubblockSkippedPasses(
      "range_calc_offline_pass",
      "assign_value_calc_offline_pass",
      "ssd_boxes_calc_offline_pass",
+     "constant_folding_pass",
+     "redundant_op_elimination_pass",
      "p_norm_fill_constant_max_div_fuse_pass"});
 
 /*
@@ -84,6 +89,7 @@ class Optimizer {
   void InitTargetTypeTransformPass();
   void InitControlFlowOpUnusedInputsAndOutputsEliminatePass();
   void InitControlFlowOpSharedInputsAndOutputsPlaceSyncPass();
+  void InitTransposeEliminatePass();
   void SpecifyKernelPickTactic(core::KernelPickFactor factor);
   Scope* exec_scope() { return exec_scope_; }
 
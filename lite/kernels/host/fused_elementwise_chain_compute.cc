@@ -0,0 +1,47 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/fused_elementwise_chain_compute.h"
+#include "lite/backends/host/math/elementwise_chain.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+void FusedElementwiseChainCompute::Run() {
+  auto& param = this->Param<param_t>();
+  // the data of the inputs may move between the runs
+  auto ops = lite::host::math::elementwise_chain_ops(param);
+  lite::host::math::elementwise_chain(param.X->data<float>(),
+                                      param.Out->mutable_data<float>(),
+                                      param.X->numel(),
+                                      ops);
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_elementwise_chain,
+                     kHost,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::host::FusedElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindInput("Inputs", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kHost))})
+    .Finalize();
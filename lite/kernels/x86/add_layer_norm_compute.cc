@@ -0,0 +1,66 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/add_layer_norm_compute.h"
+#include "lite/backends/x86/math/layer_norm.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void AddLayerNormCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto matrix_dim = param.X->dims().Flatten2D(param.begin_norm_axis);
+  const int left = static_cast<int>(matrix_dim[0]);
+  const int right = static_cast<int>(matrix_dim[1]);
+
+  const float* residual = nullptr;
+  int64_t residual_stride = 0;
+  if (param.Residual) {
+    residual = param.Residual->data<float>();
+    residual_stride = param.Residual->numel() == right ? 0 : right;
+  }
+  auto norm = param.rms_norm ? lite::x86::math::add_rms_norm
+                             : lite::x86::math::add_layer_norm;
+  norm(param.X->data<float>(),
+       residual,
+       residual_stride,
+       param.Scale ? param.Scale->data<float>() : nullptr,
+       param.Bias ? param.Bias->data<float>() : nullptr,
+       param.Y->mutable_data<float>(),
+       param.ResidualOut ? param.ResidualOut->mutable_data<float>() : nullptr,
+       left,
+       right,
+       param.epsilon);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(add_layer_norm,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::AddLayerNormCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Residual", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("ResidualOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,155 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/add_layer_norm_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// y = norm(x + residual) * scale + bias, residual has right or left * right
+// elements
+static void add_layer_norm_ref(const float* x,
+                               const float* residual,
+                               int64_t residual_size,
+                               const float* scale,
+                               const float* bias,
+                               int left,
+                               int right,
+                               float epsilon,
+                               bool rms_norm,
+                               float* y,
+                               float* sum) {
+  for (int i = 0; i < left; i++) {
+    std::vector<double> s(right);
+    double mean = 0;
+    double square = 0;
+    for (int j = 0; j < right; j++) {
+      s[j] = x[i * right + j] +
+             residual[residual_size == right ? j : i * right + j];
+      sum[i * right + j] = s[j];
+      mean += s[j];
+      square += s[j] * s[j];
+    }
+    mean /= right;
+    double var = 0;
+    for (int j = 0; j < right; j++) {
+      var += (s[j] - mean) * (s[j] - mean);
+    }
+    var /= right;
+    for (int j = 0; j < right; j++) {
+      const double norm = rms_norm ? s[j] / std::sqrt(square / right + epsilon)
+                                   : (s[j] - mean) / std::sqrt(var + epsilon);
+      y[i * right + j] = norm * scale[j] + bias[j];
+    }
+  }
+}
+
+TEST(add_layer_norm_x86, retrive_op) {
+  auto add_layer_norm = KernelRegistry::Global().Create("add_layer_norm");
+  ASSERT_FALSE(add_layer_norm.empty());
+  ASSERT_TRUE(add_layer_norm.front());
+}
+
+TEST(add_layer_norm_x86, init) {
+  AddLayerNormCompute add_layer_norm;
+  ASSERT_EQ(add_layer_norm.precision(), PRECISION(kFloat));
+  ASSERT_EQ(add_layer_norm.target(), TARGET(kX86));
+}
+
+TEST(add_layer_norm_x86, run_test) {
+  const float epsilon = 1e-5f;
+  for (int left : {1, 6}) {
+    for (int right : {3, 16, 37, 768}) {
+      for (bool broadcast : {false, true}) {
+        for (bool rms_norm : {false, true}) {
+          lite::Tensor x, residual, scale, bias, y, residual_out;
+          x.Resize({left, 1, right});
+          residual.Resize(broadcast ? DDim({right})
+                                    : DDim({left, 1, right}));
+          scale.Resize({right});
+          bias.Resize({right});
+          y.Resize({left, 1, right});
+          residual_out.Resize({left, 1, right});
+          auto* x_data = x.mutable_data<float>();
+          auto* residual_data = residual.mutable_data<float>();
+          auto* scale_data = scale.mutable_data<float>();
+          auto* bias_data = bias.mutable_data<float>();
+          for (int64_t i = 0; i < x.numel(); i++) {
+            x_data[i] = 10.f + static_cast<float>((i * 7 % 23) - 11) / 4.f;
+          }
+          for (int64_t i = 0; i < residual.numel(); i++) {
+            residual_data[i] = static_cast<float>((i * 5 % 13) - 6) / 2.f;
+          }
+          for (int i = 0; i < right; i++) {
+            scale_data[i] = 0.5f + (i % 4) * 0.25f;
+            bias_data[i] = static_cast<float>(i % 3) - 1.f;
+          }
+
+          AddLayerNormCompute add_layer_norm;
+          operators::AddLayerNormParam param;
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          add_layer_norm.SetContext(std::move(ctx));
+          param.X = &x;
+          param.Residual = &residual;
+          param.Scale = &scale;
+          param.Bias = &bias;
+          param.Y = &y;
+          param.ResidualOut = &residual_out;
+          param.begin_norm_axis = 1;
+          param.epsilon = epsilon;
+          param.rms_norm = rms_norm;
+          add_layer_norm.SetParam(param);
+          add_layer_norm.Run();
+
+          std::vector<float> y_ref(y.numel()), sum_ref(y.numel());
+          add_layer_norm_ref(x_data,
+                             residual_data,
+                             residual.numel(),
+                             scale_data,
+                             bias_data,
+                             left,
+                             right,
+                             epsilon,
+                             rms_norm,
+                             y_ref.data(),
+                             sum_ref.data());
+          const float* y_data = y.data<float>();
+          const float* residual_out_data = residual_out.data<float>();
+          for (int64_t i = 0; i < y.numel(); i++) {
+            EXPECT_NEAR(y_data[i], y_ref[i], 1e-4);
+            EXPECT_NEAR(residual_out_data[i], sum_ref[i], 1e-5);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(add_layer_norm, kX86, kFloat, kNCHW, def);
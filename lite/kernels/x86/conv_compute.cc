@@ -13,8 +13,13 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/conv_compute.h"
+#include <map>
+#include <memory>
+#include <sstream>
 #include <utility>
 #include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/core/context.h"
+#include "lite/core/kernel_autotune.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/kernels/x86/conv_direct.h"
 
@@ -79,6 +84,40 @@ namespace x86 {
   bool pads_equal =                                                 \
       ((paddings[0] == paddings[1]) && (paddings[2] == paddings[3]));
 
+// A new "depthwise" or "direct" implementation of the fp32 conv, nullptr for
+// the im2col + gemm of Conv2dCompute::Run.
+static KernelLite<TARGET(kX86), PRECISION(kFloat)>* NewConvImpl(
+    const std::string& impl) {
+  if (impl == "depthwise") {
+    return new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
+  }
+#if defined(_WIN64) || defined(__MINGW64__) || \
+    (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
+  if (impl == "direct") {
+    return new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
+  }
+#endif
+  return nullptr;
+}
+
+std::string ConvAutoTuneKey(const operators::ConvParam& param) {
+  std::ostringstream os;
+  auto join = [&](const std::vector<int>& values) {
+    for (size_t i = 0; i < values.size(); i++) {
+      os << (i ? "," : "") << values[i];
+    }
+  };
+  os << "conv2d/x86/float x=" << param.x->dims()
+     << " w=" << param.filter->dims() << " s=";
+  join(param.strides);
+  os << " p=";
+  join(*param.paddings);
+  os << " d=";
+  join(*param.dilations);
+  os << " g=" << param.groups;
+  return os.str();
+}
+
 template <>
 void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   PREPARE_PARAM
@@ -100,11 +139,11 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
                        (paddings[2] == paddings[3]);
   bool flag_p = paddings[0] <= stride_h;
 
-  //! select conv impl
+  //! select conv impl, the later ones are preferred by default
+  std::vector<std::string> impls{"gemm"};
   if (dw_kernel && kps_equal && flag_dw && pads_equal &&
       ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0))) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
+    impls.push_back("depthwise");
   }
 
   // support 3x3s1p01,5x5s1p01,7x7s1p01
@@ -115,11 +154,40 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
       pad_all_equal && flag_p) {
 #if defined(_WIN64) || defined(__MINGW64__) || \
     (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
-    VLOG(3) << "invoking directConv";
+    impls.push_back("direct");
 #endif
   }
 
+  std::string impl = impls.back();
+  if (impls.size() > 1) {
+    // the candidates run on the inputs of this first run, every one with a
+    // context of its own, the gemm one is Run without impl_
+    std::map<std::string,
+             std::unique_ptr<KernelLite<TARGET(kX86), PRECISION(kFloat)>>>
+        tuned;
+    std::vector<std::pair<std::string, std::function<void()>>> candidates;
+    for (auto& name : impls) {
+      candidates.emplace_back(name, [&, name]() {
+        if (name == "gemm") {
+          this->Run();
+          return;
+        }
+        auto& tuned_impl = tuned[name];
+        if (!tuned_impl) {
+          tuned_impl.reset(NewConvImpl(name));
+          tuned_impl->SetContext(
+              ContextScheduler::Global().NewContext(TARGET(kX86)));
+          tuned_impl->SetParam(param);
+          tuned_impl->PrepareForRun();
+        }
+        tuned_impl->Run();
+      });
+    }
+    impl = KernelAutoTunePick(ConvAutoTuneKey(param), candidates, impl);
+  }
+  VLOG(3) << "invoking the " << impl << " conv";
+  impl_ = NewConvImpl(impl);
+
   if (impl_) {
     impl_->SetContext(std::move(this->ctx_));
     impl_->SetParam(param);
@@ -46,6 +46,9 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// The key of the autotune table, the shapes and the attrs of the conv.
+std::string ConvAutoTuneKey(const operators::ConvParam& param);
+
 template <PrecisionType Ptype, PrecisionType OutType>
 class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
  public:
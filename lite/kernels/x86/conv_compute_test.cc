@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -92,6 +93,29 @@ TEST(conv2d_x86, run_test) {
   }
 }
 
+// the shapes and the attrs of the conv, the strides and the paddings apart
+TEST(conv2d_x86, autotune_key) {
+  lite::Tensor x, filter;
+  x.Resize({1, 32, 56, 56});
+  filter.Resize({64, 32, 3, 3});
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.strides = {2, 1};
+  param.paddings = std::make_shared<std::vector<int>>(
+      std::vector<int>({1, 0, 1, 0}));
+  param.dilations =
+      std::make_shared<std::vector<int>>(std::vector<int>({1, 1}));
+  param.groups = 1;
+  EXPECT_EQ(ConvAutoTuneKey(param),
+            "conv2d/x86/float x={1,32,56,56} w={64,32,3,3} s=2,1 p=1,0,1,0 "
+            "d=1,1 g=1");
+  param.strides = {1, 2};
+  EXPECT_NE(ConvAutoTuneKey(param),
+            "conv2d/x86/float x={1,32,56,56} w={64,32,3,3} s=2,1 p=1,0,1,0 "
+            "d=1,1 g=1");
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
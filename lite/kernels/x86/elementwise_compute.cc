@@ -122,6 +122,83 @@ using ElementWiseFn = void(const T* dinx,
 template <class T>
 using BinaryOpFn = lite::kernels::host::BinaryOpFn<T>;
 
+// Runs f(batch_id) over the batches of the general broadcast, the batches
+// write disjoint parts of the output.
+template <typename Func>
+static void ForEachBatch(int batch_num, int range_length, const Func& f) {
+  x86_math::elementwise_parallel_for(
+      batch_num, range_length, [&](int64_t begin, int64_t end) {
+        for (int64_t batch_id = begin; batch_id < end; ++batch_id) {
+          f(batch_id);
+        }
+      });
+}
+
+// The batch arg of the general broadcast over the output dims without the
+// dims of size 1 and with the neighbouring dims that broadcast the same way
+// merged, e.g. [N, C, H, W] + [1, C, H, 1] runs as [N, C * H, W] +
+// [1, C * H, 1]. Every batch then covers the longest contiguous range and
+// the offset of a batch is computed over fewer dims.
+template <class T>
+static lite::kernels::host::BatchElementWiseArg<T, int64_t>
+GenCollapsedBatchElementWiseArg(const lite::Tensor* x,
+                                const lite::Tensor* y,
+                                lite::Tensor* out,
+                                int axis) {
+  std::vector<int64_t> full_x_dims;
+  std::vector<int64_t> full_y_dims;
+  lite::kernels::host::fix_x_y_dims<int64_t>(
+      x, y, out, axis, &full_x_dims, &full_y_dims);
+  auto& full_z_dims = out->dims().data();
+
+  std::vector<int64_t> x_dims;
+  std::vector<int64_t> y_dims;
+  std::vector<int64_t> z_dims;
+  for (size_t i = 0; i < full_z_dims.size(); ++i) {
+    if (full_z_dims[i] == 1) continue;
+    bool x_bcast = full_x_dims[i] == 1;
+    bool y_bcast = full_y_dims[i] == 1;
+    if (!z_dims.empty() && (x_dims.back() == 1) == x_bcast &&
+        (y_dims.back() == 1) == y_bcast) {
+      x_dims.back() *= full_x_dims[i];
+      y_dims.back() *= full_y_dims[i];
+      z_dims.back() *= full_z_dims[i];
+    } else {
+      x_dims.push_back(full_x_dims[i]);
+      y_dims.push_back(full_y_dims[i]);
+      z_dims.push_back(full_z_dims[i]);
+    }
+  }
+  if (z_dims.empty()) {
+    x_dims.push_back(1);
+    y_dims.push_back(1);
+    z_dims.push_back(1);
+  }
+
+  int dim_size = z_dims.size();
+  std::vector<int64_t> x_stride(dim_size, 1);
+  std::vector<int64_t> y_stride(dim_size, 1);
+  std::vector<int64_t> z_stride(dim_size, 1);
+  for (int i = dim_size - 2; i >= 0; --i) {
+    x_stride[i] = x_stride[i + 1] * x_dims[i + 1];
+    y_stride[i] = y_stride[i + 1] * y_dims[i + 1];
+    z_stride[i] = z_stride[i + 1] * z_dims[i + 1];
+  }
+
+  lite::kernels::host::BatchElementWiseArg<T, int64_t> batch_arg;
+  batch_arg.Update(x->template data<T>(),
+                   y->template data<T>(),
+                   out->template mutable_data<T>(),
+                   x_dims.data(),
+                   y_dims.data(),
+                   z_dims.data(),
+                   x_stride.data(),
+                   y_stride.data(),
+                   z_stride.data(),
+                   dim_size);
+  return batch_arg;
+}
+
 template <class Elem_t, class DimValue_t, class X86Config>
 struct X86CommonElementWise {
   static void Run(
@@ -137,33 +214,33 @@ struct X86CommonElementWise {
     int range_length = batch_arg.ElemNumPerBatch();
     switch (bcast_type) {
       case (lite::kernels::host::BroadcastType::X_AS_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           paddle::lite::x86::math::elementwise_range_to_one<X86Config>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length);
-        }
+        });
         break;
       }
       case (lite::kernels::host::BroadcastType::Y_AS_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           paddle::lite::x86::math::elementwise_one_to_range<X86Config>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length);
-        }
+        });
         break;
       }
       case (lite::kernels::host::BroadcastType::BOTH_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           paddle::lite::x86::math::elementwise_range_to_range<X86Config>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length);
-        }
+        });
         break;
       }
       default: {
@@ -191,36 +268,36 @@ struct X86CommonElementWise<Elem_t,
     int range_length = batch_arg.ElemNumPerBatch();
     switch (bcast_type) {
       case (lite::kernels::host::BroadcastType::X_AS_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           lite::kernels::host::element_wise_range_to_one<Elem_t>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length,
               op);
-        }
+        });
         break;
       }
       case (lite::kernels::host::BroadcastType::Y_AS_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           lite::kernels::host::element_wise_one_to_range<Elem_t>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length,
               op);
-        }
+        });
         break;
       }
       case (lite::kernels::host::BroadcastType::BOTH_CONTINUOUS): {
-        for (int batch_id = 0; batch_id < batch_num; ++batch_id) {
+        ForEachBatch(batch_num, range_length, [&](int64_t batch_id) {
           lite::kernels::host::element_wise_range_to_range<Elem_t>(
               batch_arg.XAtBatch(batch_id),
               batch_arg.YAtBatch(batch_id),
               batch_arg.ZAtBatch(batch_id),
               range_length,
               op);
-        }
+        });
         break;
       }
       default: {
@@ -263,7 +340,7 @@ void elementwise_compute_template(paddle::lite::KernelBase* kernel,
         x_data, y_data, out_data, pre, n, post, has_active, act_type, true);
   } else {
     auto batch_arg =
-        lite::kernels::host::GenBatchElementWiseArg<T>(x, y, param.Out, axis);
+        GenCollapsedBatchElementWiseArg<T>(x, y, param.Out, axis);
     X86CommonElementWise<T, int64_t, X86Config>::Run(batch_arg, op);
   }
   if (!elementwise_fn && !fast_bcast_fn) {
@@ -332,6 +409,20 @@ void elementwise_compute_template(paddle::lite::KernelBase* kernel,
                      lite::x86::math::Naive##op<float>,                       \
                      true,                                                    \
                      param.act_type);                                         \
+    } else if (param.act_type == "abs") {                                     \
+      using X86Config = paddle::lite::x86::math::MergeConfig<                 \
+          lite::x86::math::op##Config<float>,                                 \
+          lite::x86::math::ActiveConfig<lite::x86::math::ActiveType::ABS,     \
+                                        float>>;                              \
+      elementwise_compute_template<                                           \
+          operators::FusionElementwiseActivationParam,                        \
+          float,                                                              \
+          X86Config>(this,                                                    \
+                     lite::x86::math::Elementwise_Broadcast_##op<float>,      \
+                     lite::x86::math::Elementwise_##op<float>,                \
+                     lite::x86::math::Naive##op<float>,                       \
+                     true,                                                    \
+                     param.act_type);                                         \
     } else {                                                                  \
       LOG(FATAL) << "unsupported active type:" << param.act_type;             \
       using X86Config = paddle::lite::x86::math::MergeConfig<                 \
@@ -13,7 +13,11 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/fc_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_epilogue.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
 #include "lite/backends/x86/math/saturate.h"
 
 namespace paddle {
@@ -139,6 +143,77 @@ class FCFunctor {
   }
 };
 
+// The fc with an epilogue runs the gemm by blocks of rows, large enough for
+// the gemm to run at full speed and small enough to stay in the L2 cache
+// until the epilogue has gone through them.
+static const int64_t kEpilogueBlockBytes = 256 * 1024;
+static const int64_t kEpilogueMinBlockRows = 64;
+
+static void FcWithEpilogue(const lite::X86Context& context,
+                           const operators::GemmEpilogueParam& epilogue,
+                           int64_t M,
+                           int64_t N,
+                           int64_t K,
+                           const float* X,
+                           const float* W,
+                           int64_t ldw,
+                           float* Y,
+                           const DDim& out_dims) {
+  auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, float>(context);
+  const int64_t block_rows =
+      std::max(kEpilogueMinBlockRows,
+               kEpilogueBlockBytes / static_cast<int64_t>(N * sizeof(float)));
+  for (int64_t row = 0; row < M; row += block_rows) {
+    const int64_t rows = std::min(block_rows, M - row);
+    blas.GEMM(false,
+              false,
+              rows,
+              N,
+              K,
+              1.f,
+              X + row * K,
+              K,
+              W,
+              ldw,
+              0.f,
+              Y + row * N,
+              N);
+    lite::x86::math::gemm_epilogue(epilogue, Y, out_dims, row, row + rows);
+  }
+}
+
+template <PrecisionType PType, PrecisionType OutType>
+void FcCompute<PType, OutType>::PrepareForRun() {}
+
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  use_dynamic_int8_ = param.enable_dynamic_int8 && !param.padding_weights;
+  use_bf16_ =
+      param.enable_bf16 && !param.padding_weights && !use_dynamic_int8_;
+  const auto& w_dims = param.w->dims();
+  int K = w_dims[0];
+  int N = w_dims[1];
+  if (use_dynamic_int8_) {
+    w_int8_.Resize(
+        {lite::x86::math::gemm_s8u8_dynamic_packed_b_size(N, K)});
+    w_scales_.Resize({N});
+    lite::x86::math::gemm_s8u8_dynamic_quant_b(N,
+                                               K,
+                                               param.w->data<float>(),
+                                               N,
+                                               false,
+                                               1.f,
+                                               w_int8_.mutable_data<uint8_t>(),
+                                               w_scales_.mutable_data<float>());
+    return;
+  }
+  if (!use_bf16_) return;
+  w_bf16_.Resize({lite::x86::math::gemm_bf16_packed_b_size(N, K)});
+  lite::x86::math::gemm_bf16_pack_b(
+      N, K, param.w->data<float>(), N, w_bf16_.mutable_data<uint16_t>());
+}
+
 template <>
 void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = *param_.get_mutable<param_t>();
@@ -159,7 +234,81 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   const float* w_data = w->template data<float>();
   float* output_data = output->template mutable_data<float>();
 
+  if (use_dynamic_int8_) {
+    lite::x86::math::gemm_s8u8_dynamic(
+        M,
+        w_dims1,
+        w_dims0,
+        input_data,
+        w_dims0,
+        w_int8_.data<uint8_t>(),
+        w_scales_.data<float>(),
+        output_data,
+        w_dims1,
+        bias ? bias->template data<float>() : nullptr,
+        with_relu);
+    if (!param.epilogue.empty()) {
+      lite::x86::math::gemm_epilogue(
+          param.epilogue, output_data, output->dims(), 0, M);
+    }
+    return;
+  }
+
+  if (use_bf16_) {
+    lite::x86::math::gemm_bf16(M,
+                               w_dims1,
+                               w_dims0,
+                               input_data,
+                               w_dims0,
+                               w_bf16_.data<uint16_t>(),
+                               output_data,
+                               w_dims1,
+                               bias ? bias->template data<float>() : nullptr,
+                               with_relu);
+    if (!param.epilogue.empty()) {
+      lite::x86::math::gemm_epilogue(
+          param.epilogue, output_data, output->dims(), 0, M);
+    }
+    return;
+  }
+
   auto& context = ctx_->As<X86Context>();
+  if (!param.epilogue.empty()) {
+    // the bias and the activation of the fc go first
+    operators::GemmEpilogueParam epilogue;
+    if (bias) {
+      epilogue.ops.push_back("add");
+      epilogue.alphas.push_back(0.f);
+      epilogue.betas.push_back(0.f);
+      epilogue.tensors.push_back(bias);
+    }
+    if (with_relu) {
+      epilogue.ops.push_back("relu");
+      epilogue.alphas.push_back(0.f);
+      epilogue.betas.push_back(0.f);
+      epilogue.tensors.push_back(nullptr);
+    }
+    const auto& fused = param.epilogue;
+    epilogue.ops.insert(epilogue.ops.end(), fused.ops.begin(), fused.ops.end());
+    epilogue.alphas.insert(
+        epilogue.alphas.end(), fused.alphas.begin(), fused.alphas.end());
+    epilogue.betas.insert(
+        epilogue.betas.end(), fused.betas.begin(), fused.betas.end());
+    epilogue.tensors.insert(
+        epilogue.tensors.end(), fused.tensors.begin(), fused.tensors.end());
+    FcWithEpilogue(context,
+                   epilogue,
+                   M,
+                   w_dims1,
+                   w_dims0,
+                   input_data,
+                   w_data,
+                   w_dims[1],
+                   output_data,
+                   output->dims());
+    return;
+  }
+
   FCFunctor<lite::TargetType::kX86, float> fc;
   fc(context,
      M,
@@ -290,6 +439,7 @@ REGISTER_LITE_KERNEL(fc, kX86, kFloat, kNCHW, FcCompute_FP32, def)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("EpilogueInputs", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
 
@@ -35,9 +35,21 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
  public:
   using param_t = operators::FcParam;
 
+  virtual void PrepareForRun();
+
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // weights packed by gemm_bf16_pack_b when param.enable_bf16 is set
+  Tensor w_bf16_;
+  bool use_bf16_{false};
+  // weights quantized by gemm_s8u8_dynamic_quant_b when
+  // param.enable_dynamic_int8 is set
+  Tensor w_int8_;
+  Tensor w_scales_;
+  bool use_dynamic_int8_{false};
 };
 
 }  // namespace x86
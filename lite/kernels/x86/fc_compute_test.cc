@@ -0,0 +1,97 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fc_compute.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static std::unique_ptr<KernelBase> CreateFc() {
+  auto kernels = KernelRegistry::Global().Create(
+      "fc", TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW));
+  for (auto& kernel : kernels) {
+    if (kernel->alias() == "def") return std::move(kernel);
+  }
+  return nullptr;
+}
+
+static void RunFc(lite::Tensor* x,
+                  lite::Tensor* w,
+                  lite::Tensor* bias,
+                  bool enable_dynamic_int8,
+                  lite::Tensor* out) {
+  auto fc = CreateFc();
+  ASSERT_TRUE(fc);
+  operators::FcParam param;
+  param.input = x;
+  param.w = w;
+  param.bias = bias;
+  param.output = out;
+  param.in_num_col_dims = 2;
+  param.activation_type = "relu";
+  param.enable_dynamic_int8 = enable_dynamic_int8;
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  fc->SetContext(std::move(ctx));
+  fc->SetParam(param);
+  fc->Launch();
+}
+
+TEST(fc_x86, retrive_op) { ASSERT_TRUE(CreateFc()); }
+
+TEST(fc_x86, dynamic_int8) {
+  // x: [2, 5, k], w: [k, n], out: [2, 5, n] with bias and relu
+  for (int n : {1, 17, 64}) {
+    for (int k : {3, 64, 255}) {
+      lite::Tensor x, w, bias, out, out_ref;
+      x.Resize({2, 5, k});
+      w.Resize({k, n});
+      bias.Resize({n});
+      out.Resize({2, 5, n});
+      out_ref.Resize({2, 5, n});
+      fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+      fill_data_rand(w.mutable_data<float>(), -1.f, 1.f, w.numel());
+      fill_data_rand(bias.mutable_data<float>(), -1.f, 1.f, bias.numel());
+
+      RunFc(&x, &w, &bias, false, &out_ref);
+      RunFc(&x, &w, &bias, true, &out);
+      // x and w in [-1, 1], the rounding errors of the k products add up
+      // like a random walk
+      const float tolerance = 3e-2f * std::sqrt(static_cast<float>(k));
+      for (int i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], tolerance)
+            << "n: " << n << ", k: " << k << " at " << i;
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fc, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,88 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/backends/x86/math/embedding.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T_IDS>
+class FusedEmbeddingSeqPoolCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedEmbeddingSeqPoolParam;
+
+  void Run() override {
+    auto& param = this->Param<param_t>();
+    auto* ids = param.Ids;
+    auto* out = param.Out;
+    auto table_dims = param.W->dims();
+    auto ids_dims = ids->dims();
+    const int64_t ids_height = ids_dims[0];
+    const int64_t ids_width = ids_height > 0 ? ids->numel() / ids_height : 0;
+
+    // one id row per sequence when there is no lod
+    std::vector<uint64_t> offset;
+    const auto& lod = ids->lod();
+    if (lod.empty()) {
+      offset.resize(ids_height + 1);
+      for (int64_t i = 0; i <= ids_height; i++) {
+        offset[i] = i;
+      }
+    } else {
+      CHECK_LE(lod.size(), 2UL);
+      offset = lod.back();
+      CHECK_EQ(offset.back(), static_cast<uint64_t>(ids_height));
+    }
+    const int64_t num_seqs = static_cast<int64_t>(offset.size()) - 1;
+
+    lite::x86::math::embedding_seq_pool<T_IDS>(param.W->data<float>(),
+                                               table_dims[0],
+                                               table_dims[1],
+                                               ids->template data<T_IDS>(),
+                                               ids_width,
+                                               offset.data(),
+                                               num_seqs,
+                                               param.pool_type,
+                                               param.padding_idx,
+                                               param.pad_value,
+                                               out->mutable_data<float>());
+
+    // the same lod as the output of sequence_pool
+    out->mutable_lod()->clear();
+    if (lod.size() == 2) {
+      out->mutable_lod()->push_back(lod[0]);
+    } else {
+      std::vector<uint64_t> out_offset(num_seqs + 1);
+      for (int64_t i = 0; i <= num_seqs; i++) {
+        out_offset[i] = i;
+      }
+      out->mutable_lod()->push_back(out_offset);
+    }
+  }
+
+  virtual ~FusedEmbeddingSeqPoolCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
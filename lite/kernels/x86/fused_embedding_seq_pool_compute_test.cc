@@ -0,0 +1,140 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// lookup_table and then sequence_pool over the rows [lod[s], lod[s + 1])
+static void embedding_seq_pool_ref(const float* table,
+                                   int width,
+                                   const int64_t* ids,
+                                   int ids_width,
+                                   const std::vector<uint64_t>& lod,
+                                   const std::string& pool_type,
+                                   int64_t padding_idx,
+                                   float pad_value,
+                                   float* out) {
+  const int out_width = ids_width * width;
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    float* out_row = out + s * out_width;
+    const int height = static_cast<int>(lod[s + 1] - lod[s]);
+    for (int c = 0; c < out_width; c++) {
+      out_row[c] = height == 0 ? pad_value : 0.f;
+    }
+    for (uint64_t h = lod[s]; h < lod[s + 1]; h++) {
+      for (int w = 0; w < ids_width; w++) {
+        const int64_t id = ids[h * ids_width + w];
+        if (id == padding_idx) continue;
+        for (int c = 0; c < width; c++) {
+          out_row[w * width + c] += table[id * width + c];
+        }
+      }
+    }
+    if (height > 0 && pool_type != "SUM") {
+      const float scale =
+          pool_type == "AVERAGE"
+              ? 1.f / height
+              : 1.f / std::sqrt(static_cast<float>(height));
+      for (int c = 0; c < out_width; c++) {
+        out_row[c] *= scale;
+      }
+    }
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("fused_embedding_seq_pool");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, init) {
+  FusedEmbeddingSeqPoolCompute<int64_t> kernel;
+  ASSERT_EQ(kernel.precision(), PRECISION(kFloat));
+  ASSERT_EQ(kernel.target(), TARGET(kX86));
+}
+
+TEST(fused_embedding_seq_pool_x86, run_test) {
+  const int vocab_size = 37;
+  const std::vector<uint64_t> lod{0, 3, 3, 4, 12, 20};
+  const int ids_height = lod.back();
+  for (int width : {5, 16, 64}) {
+    for (int ids_width : {1, 2}) {
+      for (std::string pool_type : {"SUM", "AVERAGE", "SQRT"}) {
+        for (int64_t padding_idx : {-1, 3}) {
+          lite::Tensor w, ids, out;
+          w.Resize({vocab_size, width});
+          ids.Resize({ids_height, ids_width});
+          ids.set_lod({lod});
+          out.Resize({static_cast<int64_t>(lod.size()) - 1,
+                      ids_width * width});
+          auto* w_data = w.mutable_data<float>();
+          auto* ids_data = ids.mutable_data<int64_t>();
+          for (int64_t i = 0; i < w.numel(); i++) {
+            w_data[i] = static_cast<float>((i * 7 % 23) - 11) / 8.f;
+          }
+          for (int64_t i = 0; i < ids.numel(); i++) {
+            ids_data[i] = (i * 13 + 5) % vocab_size;
+          }
+
+          FusedEmbeddingSeqPoolCompute<int64_t> kernel;
+          operators::FusedEmbeddingSeqPoolParam param;
+          param.W = &w;
+          param.Ids = &ids;
+          param.Out = &out;
+          param.pool_type = pool_type;
+          param.padding_idx = padding_idx;
+          param.pad_value = 0.5f;
+          kernel.SetParam(param);
+          kernel.Run();
+
+          std::vector<float> out_ref(out.numel());
+          embedding_seq_pool_ref(w_data,
+                                 width,
+                                 ids_data,
+                                 ids_width,
+                                 lod,
+                                 pool_type,
+                                 padding_idx,
+                                 param.pad_value,
+                                 out_ref.data());
+          const float* out_data = out.data<float>();
+          for (int64_t i = 0; i < out.numel(); i++) {
+            EXPECT_NEAR(out_data[i], out_ref[i], 1e-5);
+          }
+          ASSERT_EQ(out.lod().size(), 1UL);
+          EXPECT_EQ(out.lod()[0].size(), lod.size());
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
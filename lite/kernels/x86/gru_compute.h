@@ -55,6 +55,47 @@ static inline int64_t CalculateSeqWidth(const DDim& dims) {
 template <typename T>
 class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
+  // The weights are persistable, pack them for MKL once instead of on
+  // every Run.
+  void PrepareForRun() override {
+#ifdef PADDLE_WITH_MKLML
+    if (paddle_num_threads < 4 || packed_gate_) return;
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::GRUParam>();
+    const T* weight_data = param.weight->template data<T>();
+    const int frame_size = param.weight->dims()[0];
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+    packed_gate_ = blas.GEMM_ALLOC(CblasBMatrix,
+                                   1 /*height of C*/,
+                                   frame_size * 2 /*width of weight*/,
+                                   frame_size /*height of height*/);
+    CHECK(packed_gate_);
+    blas.GEMM_PACK(CblasBMatrix,
+                   CblasNoTrans,
+                   1 /*cur bs?*/,
+                   frame_size * 2,
+                   frame_size,
+                   T(1.0),
+                   weight_data,
+                   frame_size * 2,
+                   packed_gate_);
+    packed_state_ = blas.GEMM_ALLOC(CblasBMatrix,
+                                    1 /*height of C*/,
+                                    frame_size /*width of weight*/,
+                                    frame_size /*height of height*/);
+    CHECK(packed_state_);
+    blas.GEMM_PACK(CblasBMatrix,
+                   CblasNoTrans,
+                   1 /*cur bs?*/,
+                   frame_size,
+                   frame_size,
+                   T(1.0),
+                   weight_data + 2 * frame_size * frame_size,
+                   frame_size,
+                   packed_state_);
+#endif
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::GRUParam>();
@@ -120,36 +161,8 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
 #ifdef PADDLE_WITH_MKLML
     // use MKL packed to speedup GEMM
-    if (paddle_num_threads >= 4) {
+    if (packed_gate_) {
       auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
-      T* packed_gate = blas.GEMM_ALLOC(CblasBMatrix,
-                                       1 /*height of C*/,
-                                       frame_size * 2 /*width of weight*/,
-                                       frame_size /*height of height*/);
-      CHECK(packed_gate);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size * 2,
-                     frame_size,
-                     T(1.0),
-                     gru_value.gate_weight,
-                     frame_size * 2,
-                     packed_gate);
-      T* packed_state = blas.GEMM_ALLOC(CblasBMatrix,
-                                        1 /*height of C*/,
-                                        frame_size /*width of weight*/,
-                                        frame_size /*height of height*/);
-      CHECK(packed_state);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size,
-                     frame_size,
-                     T(1.0),
-                     gru_value.state_weight,
-                     frame_size,
-                     packed_state);
       for (size_t n = 0; n < seq_len; n++) {
         int64_t bstart = static_cast<int64_t>(batch_starts[n]);
         int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
@@ -168,13 +181,35 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
                             frame_size,
                             gru_value.prev_out_value,
                             frame_size,
-                            packed_gate,
+                            packed_gate_,
                             frame_size * 2,
                             T(1),
                             gru_value.gate_value,
                             frame_size * 3);
         }
 
+        lite::x86::math::detail::forward_reset_output(
+            lite::x86::math::detail::forward::gru_resetOutput<T>(),
+            gru_value,
+            frame_size,
+            cur_batch_size,
+            active_gate);
+
+        if (gru_value.prev_out_value) {
+          blas.GEMM_COMPUTE(CblasNoTrans,
+                            CblasPacked,
+                            cur_batch_size,
+                            frame_size,
+                            frame_size,
+                            gru_value.reset_output_value,
+                            frame_size,
+                            packed_state_,
+                            frame_size,
+                            T(1),
+                            gru_value.gate_value + frame_size * 2,
+                            frame_size * 3);
+        }
+
         lite::x86::math::detail::forward_final_output(
             lite::x86::math::detail::forward::gru_finalOutput<T>(),
             gru_value,
@@ -185,9 +220,6 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
         gru_value.prev_out_value = gru_value.output_value;
       }
-
-      blas.GEMM_FREE(packed_gate);
-      blas.GEMM_FREE(packed_state);
     } else {
 #endif
       for (size_t n = 0; n < seq_len; n++) {
@@ -218,6 +250,19 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     batch_hidden->set_lod(batch_gate->lod());
     to_seq(context, *batch_hidden, hidden);
   }
+
+  virtual ~GRUCompute() {
+#ifdef PADDLE_WITH_MKLML
+    if (packed_gate_) {
+      lite::x86::math::CBlas<T>::GEMM_FREE(packed_gate_);
+      lite::x86::math::CBlas<T>::GEMM_FREE(packed_state_);
+    }
+#endif
+  }
+
+ private:
+  T* packed_gate_{nullptr};
+  T* packed_state_{nullptr};
 };
 
 }  // namespace x86
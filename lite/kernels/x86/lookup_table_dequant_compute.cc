@@ -0,0 +1,54 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lookup_table_dequant_compute.h"
+#include "lite/backends/x86/math/embedding.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void LookupTableDequantCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto* w = param.W;
+  auto* ids = param.Ids;
+  auto* out = param.Out;
+
+  auto table_dims = w->dims();
+  lite::x86::math::lookup_table_dequant<int64_t>(w->data<float>(),
+                                                 table_dims[0],
+                                                 table_dims[1],
+                                                 ids->data<int64_t>(),
+                                                 ids->numel(),
+                                                 param.padding_idx,
+                                                 out->mutable_data<float>());
+  *(out->mutable_lod()) = ids->lod();
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(lookup_table_dequant,
+                     kX86,
+                     kAny,
+                     kNCHW,
+                     paddle::lite::kernels::x86::LookupTableDequantCompute,
+                     def)
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
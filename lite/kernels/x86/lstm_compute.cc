@@ -0,0 +1,199 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lstm_compute.h"
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/sequence2batch.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static jit::KernelType GetJitActType(lite_api::ActivationType type) {
+  switch (type) {
+    case lite_api::ActivationType::kSigmoid:
+    case lite_api::ActivationType::kSigmoid_v2:
+      return jit::kVSigmoid;
+    case lite_api::ActivationType::kTanh:
+    case lite_api::ActivationType::kTanh_v2:
+      return jit::kVTanh;
+    case lite_api::ActivationType::kRelu:
+      return jit::kVRelu;
+    case lite_api::ActivationType::kIndentity:
+      return jit::kVIdentity;
+    default:
+      LOG(FATAL) << "Unsupported lstm activation type: "
+                 << static_cast<int>(type);
+  }
+  return jit::kVIdentity;
+}
+
+void LstmCompute::Run() {
+  auto& context = ctx_->As<X86Context>();
+  auto& param = *param_.get_mutable<operators::LstmParam>();
+  auto* input = param.Input;
+  auto* weight = param.Weight;
+  auto* batch_gate = param.BatchGate;
+
+  // gates of every row: W_ch, W_ih, W_fh, W_oh
+  const int frame_size = static_cast<int>(weight->dims()[0]);
+  const int gate_width = 4 * frame_size;
+  const int64_t rows = input->dims()[0];
+
+  lite::x86::math::LoDTensor2BatchFunctor<TARGET(kX86), float> to_batch;
+  to_batch(context, *input, batch_gate, true, param.is_reverse);
+  float* gate_data = batch_gate->mutable_data<float>();
+
+  const float* bias_data = param.Bias->data<float>();
+  lite::x86::RunParallelFor(0, rows, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      float* gate_row = gate_data + i * gate_width;
+      for (int j = 0; j < gate_width; ++j) {
+        gate_row[j] += bias_data[j];
+      }
+    }
+  });
+
+  // Since the batch computing for LSTM reorders the input sequences
+  // according to their length. The initialized states also need to reorder.
+  const std::vector<uint64_t>& order = batch_gate->lod()[2];
+  lite::x86::math::CopyMatrixRowsFunctor<TARGET(kX86), float> row_shuffle;
+  Tensor ordered_h0, ordered_c0;
+  if (param.H0) {
+    ordered_h0.Resize(param.H0->dims());
+    row_shuffle(context, *param.H0, order, &ordered_h0, true);
+  }
+  if (param.C0) {
+    ordered_c0.Resize(param.C0->dims());
+    row_shuffle(context, *param.C0, order, &ordered_c0, true);
+  }
+
+  Tensor batch_hidden, batch_cell;
+  batch_hidden.Resize({rows, frame_size});
+  batch_cell.Resize({rows, frame_size});
+  float* batch_hidden_data = batch_hidden.mutable_data<float>();
+  float* batch_cell_data = batch_cell.mutable_data<float>();
+  // only read by the backward pass, which lite does not run
+  param.BatchCellPreAct->mutable_data<float>();
+
+  const bool use_peepholes = param.use_peepholes;
+  jit::lstm_attr_t attr(frame_size,
+                        GetJitActType(param.gate_activation),
+                        GetJitActType(param.candidate_activation),
+                        GetJitActType(param.cell_activation),
+                        use_peepholes);
+  auto ct_ht =
+      jit::KernelFuncs<jit::LSTMCtHtTuple<float>, fluid::CPUPlace>::Cache().At(
+          attr);
+  auto c1_h1 =
+      jit::KernelFuncs<jit::LSTMC1H1Tuple<float>, fluid::CPUPlace>::Cache().At(
+          attr);
+  // W_ic, W_fc, W_oc follow the gate bias
+  const float* peephole = use_peepholes ? bias_data + gate_width : nullptr;
+
+  const auto& batch_starts = batch_gate->lod()[0];
+  const size_t num_batch = batch_starts.size() - 1;
+  // the first step holds every sequence
+  std::vector<float> checked;
+  if (use_peepholes && num_batch > 0) {
+    checked.resize((batch_starts[1] - batch_starts[0]) * 2 * frame_size);
+  }
+
+  auto blas = lite::x86::math::GetBlas<TARGET(kX86), float>(context);
+  const float* weight_data = weight->data<float>();
+  for (size_t n = 0; n < num_batch; n++) {
+    const int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+    const int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
+    const int cur_batch_size = static_cast<int>(bend - bstart);
+    float* gate_t = gate_data + bstart * gate_width;
+
+    // The sequences are sorted by length, so the rows of this step continue
+    // the first cur_batch_size rows of the previous one.
+    const float* prev_h = param.H0 ? ordered_h0.data<float>() : nullptr;
+    const float* prev_c = param.C0 ? ordered_c0.data<float>() : nullptr;
+    if (n > 0) {
+      const int64_t pre_start = static_cast<int64_t>(batch_starts[n - 1]);
+      prev_h = batch_hidden_data + pre_start * frame_size;
+      prev_c = batch_cell_data + pre_start * frame_size;
+    }
+    if (prev_h) {
+      blas.GEMM(false,
+                false,
+                cur_batch_size,
+                gate_width,
+                frame_size,
+                1.f,
+                prev_h,
+                frame_size,
+                weight_data,
+                gate_width,
+                1.f,
+                gate_t,
+                gate_width);
+    }
+
+    lite::x86::RunParallelFor(
+        0, cur_batch_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            jit::lstm_t step;
+            step.gates = gate_t + i * gate_width;
+            step.ct_1 = prev_c ? prev_c + i * frame_size : nullptr;
+            step.ct = batch_cell_data + (bstart + i) * frame_size;
+            step.ht = batch_hidden_data + (bstart + i) * frame_size;
+            step.wp = peephole;
+            step.checked =
+                use_peepholes ? checked.data() + i * 2 * frame_size : nullptr;
+            if (prev_c) {
+              ct_ht(&step, &attr);
+            } else {
+              c1_h1(&step, &attr);
+            }
+          }
+        });
+  }
+
+  lite::x86::math::Batch2LoDTensorFunctor<TARGET(kX86), float> to_seq;
+  batch_hidden.set_lod(batch_gate->lod());
+  to_seq(context, batch_hidden, param.Hidden);
+  batch_cell.set_lod(batch_gate->lod());
+  to_seq(context, batch_cell, param.Cell);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(lstm,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::LstmCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Weight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("C0", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("H0", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Hidden", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Cell", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("BatchGate", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("BatchCellPreAct", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
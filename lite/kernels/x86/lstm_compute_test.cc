@@ -0,0 +1,172 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/lstm_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static float sigmoid_ref(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// Runs every sequence on its own, gates of a row: c, i, f, o.
+static void lstm_ref(const float* x,
+                     const std::vector<uint64_t>& lod,
+                     const float* weight,
+                     const float* bias,
+                     const float* h0,
+                     const float* c0,
+                     int d,
+                     bool use_peepholes,
+                     bool is_reverse,
+                     float* hidden,
+                     float* cell) {
+  const float* wp = bias + 4 * d;
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    std::vector<float> h(d, 0.f), c(d, 0.f), g(4 * d);
+    if (h0) h.assign(h0 + s * d, h0 + (s + 1) * d);
+    if (c0) c.assign(c0 + s * d, c0 + (s + 1) * d);
+    const int len = static_cast<int>(lod[s + 1] - lod[s]);
+    for (int step = 0; step < len; step++) {
+      const int row = lod[s] + (is_reverse ? len - 1 - step : step);
+      for (int j = 0; j < 4 * d; j++) {
+        g[j] = x[row * 4 * d + j] + bias[j];
+        for (int k = 0; k < d; k++) {
+          g[j] += h[k] * weight[k * 4 * d + j];
+        }
+      }
+      for (int j = 0; j < d; j++) {
+        float gi = g[d + j], gf = g[2 * d + j], go = g[3 * d + j];
+        if (use_peepholes) {
+          gi += wp[j] * c[j];
+          gf += wp[d + j] * c[j];
+        }
+        c[j] = sigmoid_ref(gf) * c[j] + sigmoid_ref(gi) * std::tanh(g[j]);
+        if (use_peepholes) {
+          go += wp[2 * d + j] * c[j];
+        }
+        h[j] = sigmoid_ref(go) * std::tanh(c[j]);
+        hidden[row * d + j] = h[j];
+        cell[row * d + j] = c[j];
+      }
+    }
+  }
+}
+
+static void fill_data(lite::Tensor* tensor, int seed) {
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>((i * 17 + seed * 7) % 29 - 14) / 20.f;
+  }
+}
+
+TEST(lstm_x86, retrive_op) {
+  auto lstm = KernelRegistry::Global().Create("lstm");
+  ASSERT_FALSE(lstm.empty());
+  ASSERT_TRUE(lstm.front());
+}
+
+TEST(lstm_x86, init) {
+  LstmCompute lstm;
+  ASSERT_EQ(lstm.precision(), PRECISION(kFloat));
+  ASSERT_EQ(lstm.target(), TARGET(kX86));
+}
+
+TEST(lstm_x86, run_test) {
+  const std::vector<uint64_t> lod{0, 2, 6, 9};
+  const int rows = lod.back();
+  const int num_seq = lod.size() - 1;
+  // 16 is handled by the generated code, 5 by the fallback kernels
+  for (int d : {16, 5}) {
+    for (bool use_peepholes : {false, true}) {
+      for (bool is_reverse : {false, true}) {
+        for (bool has_init : {false, true}) {
+          lite::Tensor input, weight, bias, h0, c0;
+          lite::Tensor hidden, cell, batch_gate, batch_cell_pre_act;
+          input.Resize({rows, 4 * d});
+          input.set_lod({lod});
+          weight.Resize({d, 4 * d});
+          bias.Resize({1, (use_peepholes ? 7 : 4) * d});
+          h0.Resize({num_seq, d});
+          c0.Resize({num_seq, d});
+          hidden.Resize({rows, d});
+          cell.Resize({rows, d});
+          batch_gate.Resize({rows, 4 * d});
+          batch_cell_pre_act.Resize({rows, d});
+          fill_data(&input, 1);
+          fill_data(&weight, 2);
+          fill_data(&bias, 3);
+          fill_data(&h0, 4);
+          fill_data(&c0, 5);
+
+          LstmCompute lstm;
+          operators::LstmParam param;
+          param.Input = &input;
+          param.Weight = &weight;
+          param.Bias = &bias;
+          param.H0 = has_init ? &h0 : nullptr;
+          param.C0 = has_init ? &c0 : nullptr;
+          param.Hidden = &hidden;
+          param.Cell = &cell;
+          param.BatchGate = &batch_gate;
+          param.BatchCellPreAct = &batch_cell_pre_act;
+          param.use_peepholes = use_peepholes;
+          param.is_reverse = is_reverse;
+          param.gate_activation = lite_api::ActivationType::kSigmoid;
+          param.cell_activation = lite_api::ActivationType::kTanh;
+          param.candidate_activation = lite_api::ActivationType::kTanh;
+
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          lstm.SetContext(std::move(ctx));
+          lstm.SetParam(param);
+          lstm.Run();
+
+          std::vector<float> hidden_ref(rows * d), cell_ref(rows * d);
+          lstm_ref(input.data<float>(),
+                   lod,
+                   weight.data<float>(),
+                   bias.data<float>(),
+                   has_init ? h0.data<float>() : nullptr,
+                   has_init ? c0.data<float>() : nullptr,
+                   d,
+                   use_peepholes,
+                   is_reverse,
+                   hidden_ref.data(),
+                   cell_ref.data());
+          for (int i = 0; i < rows * d; i++) {
+            EXPECT_NEAR(hidden.data<float>()[i], hidden_ref[i], 1e-4);
+            EXPECT_NEAR(cell.data<float>()[i], cell_ref[i], 1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lstm, kX86, kFloat, kNCHW, def);
@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -49,6 +52,44 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MatMulParam;
 
+  void PrepareForRun() override {
+    auto &param = *param_.get_mutable<operators::MatMulParam>();
+    // x of [..., M, K] times the weight y, as one gemm of all the rows of x
+    use_dynamic_int8_ = param.enable_dynamic_int8 &&
+                        std::is_same<T, float>::value &&
+                        param.Y->dims().size() == 2 && !param.transpose_X;
+    use_bf16_ = param.enable_bf16 && std::is_same<T, float>::value &&
+                param.Y->dims().size() == 2 && !param.transpose_X &&
+                !use_dynamic_int8_;
+    if (!use_bf16_ && !use_dynamic_int8_) return;
+    auto y_dims = param.Y->dims();
+    int K = param.transpose_Y ? y_dims[1] : y_dims[0];
+    int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+    if (use_dynamic_int8_) {
+      y_int8_.Resize(
+          {lite::x86::math::gemm_s8u8_dynamic_packed_b_size(N, K)});
+      y_scales_.Resize({N});
+      lite::x86::math::gemm_s8u8_dynamic_quant_b(
+          N,
+          K,
+          param.Y->template data<float>(),
+          y_dims[1],
+          param.transpose_Y,
+          param.alpha,
+          y_int8_.mutable_data<uint8_t>(),
+          y_scales_.mutable_data<float>());
+      return;
+    }
+    y_bf16_.Resize({lite::x86::math::gemm_bf16_packed_b_size(N, K)});
+    lite::x86::math::gemm_bf16_pack_b(N,
+                                      K,
+                                      param.Y->template data<float>(),
+                                      y_dims[1],
+                                      param.transpose_Y,
+                                      param.alpha,
+                                      y_bf16_.mutable_data<uint16_t>());
+  }
+
   void Run() override {
     auto &context = ctx_->As<X86Context>();
     auto &param = *param_.get_mutable<operators::MatMulParam>();
@@ -58,6 +99,41 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto *out = param.Out;
     out->template mutable_data<T>();
 
+    if (use_dynamic_int8_ && x->dims().size() >= 2) {
+      auto y_dims = y->dims();
+      int K = param.transpose_Y ? y_dims[1] : y_dims[0];
+      int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+      int M = x->numel() / K;
+      lite::x86::math::gemm_s8u8_dynamic(M,
+                                         N,
+                                         K,
+                                         x->template data<float>(),
+                                         K,
+                                         y_int8_.data<uint8_t>(),
+                                         y_scales_.data<float>(),
+                                         out->template mutable_data<float>(),
+                                         N,
+                                         nullptr,
+                                         false);
+      return;
+    }
+    if (use_bf16_ && x->dims().size() >= 2) {
+      int K = param.transpose_Y ? y->dims()[1] : y->dims()[0];
+      int N = param.transpose_Y ? y->dims()[0] : y->dims()[1];
+      int M = x->numel() / K;
+      lite::x86::math::gemm_bf16(M,
+                                 N,
+                                 K,
+                                 x->template data<float>(),
+                                 K,
+                                 y_bf16_.data<uint16_t>(),
+                                 out->template mutable_data<float>(),
+                                 N,
+                                 nullptr,
+                                 false);
+      return;
+    }
+
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     auto mat_dim_a = lite::x86::math::CreateMatrixDescriptor(
         RowMatrixFromVector(x->dims()), 0, param.transpose_X);
@@ -68,6 +144,16 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MatMulCompute() = default;
+
+ private:
+  // y packed by gemm_bf16_pack_b when param.enable_bf16 is set
+  Tensor y_bf16_;
+  bool use_bf16_{false};
+  // y quantized by gemm_s8u8_dynamic_quant_b when param.enable_dynamic_int8
+  // is set
+  Tensor y_int8_;
+  Tensor y_scales_;
+  bool use_dynamic_int8_{false};
 };
 
 }  // namespace x86
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -21,6 +22,8 @@
 
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/matmul_compute.h"
+#include "lite/kernels/x86/matmul_v2_compute.h"
+#include "lite/tests/utils/fill_data.h"
 
 namespace paddle {
 namespace lite {
@@ -80,6 +83,57 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+template <typename KernelT>
+static void RunMatMul(const lite::Tensor& x,
+                      const lite::Tensor& y,
+                      float alpha,
+                      bool enable_dynamic_int8,
+                      lite::Tensor* out) {
+  KernelT matmul;
+  operators::MatMulParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.Out = out;
+  param.transpose_Y = true;
+  param.alpha = alpha;
+  param.enable_dynamic_int8 = enable_dynamic_int8;
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  matmul.SetContext(std::move(ctx));
+  matmul.SetParam(param);
+  matmul.PrepareForRun();
+  matmul.Run();
+}
+
+template <typename KernelT>
+static void TestMatMulDynamicInt8() {
+  // x: [2, 5, k] times the weight y: [n, k] transposed
+  const int n = 17, k = 64;
+  const float alpha = 0.5f;
+  lite::Tensor x, y, out, out_ref;
+  x.Resize({2, 5, k});
+  y.Resize({n, k});
+  out.Resize({2, 5, n});
+  out_ref.Resize({2, 5, n});
+  fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+  fill_data_rand(y.mutable_data<float>(), -1.f, 1.f, y.numel());
+
+  RunMatMul<KernelT>(x, y, alpha, false, &out_ref);
+  RunMatMul<KernelT>(x, y, alpha, true, &out);
+  // x and y in [-1, 1], the rounding errors of the k products add up
+  // like a random walk
+  const float tolerance = 3e-2f * alpha * std::sqrt(static_cast<float>(k));
+  for (int i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], tolerance);
+  }
+}
+
+TEST(matmul_x86, dynamic_int8) {
+  TestMatMulDynamicInt8<MatMulCompute<float>>();
+  TestMatMulDynamicInt8<MatMulV2Compute<float>>();
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -13,7 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_epilogue.h"
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -148,6 +152,44 @@ class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MatMulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MatMulParam>();
+    // x of [..., M, K] times the weight y, as one gemm of all the rows of x
+    use_dynamic_int8_ = param.enable_dynamic_int8 &&
+                        std::is_same<T, float>::value &&
+                        param.Y->dims().size() == 2 && !param.transpose_X;
+    use_bf16_ = param.enable_bf16 && std::is_same<T, float>::value &&
+                param.Y->dims().size() == 2 && !param.transpose_X &&
+                !use_dynamic_int8_;
+    if (!use_bf16_ && !use_dynamic_int8_) return;
+    auto y_dims = param.Y->dims();
+    int K = param.transpose_Y ? y_dims[1] : y_dims[0];
+    int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+    if (use_dynamic_int8_) {
+      y_int8_.Resize(
+          {lite::x86::math::gemm_s8u8_dynamic_packed_b_size(N, K)});
+      y_scales_.Resize({N});
+      lite::x86::math::gemm_s8u8_dynamic_quant_b(
+          N,
+          K,
+          param.Y->template data<float>(),
+          y_dims[1],
+          param.transpose_Y,
+          param.alpha,
+          y_int8_.mutable_data<uint8_t>(),
+          y_scales_.mutable_data<float>());
+      return;
+    }
+    y_bf16_.Resize({lite::x86::math::gemm_bf16_packed_b_size(N, K)});
+    lite::x86::math::gemm_bf16_pack_b(N,
+                                      K,
+                                      param.Y->template data<float>(),
+                                      y_dims[1],
+                                      param.transpose_Y,
+                                      param.alpha,
+                                      y_bf16_.mutable_data<uint16_t>());
+  }
+
   void Run() override {
     INIT_PARAM;
     const auto* x_data = param.X->template data<T>();
@@ -158,8 +200,32 @@ class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(ctx);
 
-    if ((x_dims.size() >= 2 && y_dims.size() >= 2) &&
-        (x_dims.size() != 2 || y_dims.size() != 2)) {
+    if (use_dynamic_int8_ && x_dims.size() >= 2) {
+      // x: [B, ..., M, K], y: [K, N], out: [B, ..., M, N]
+      lite::x86::math::gemm_s8u8_dynamic(x_dims.production() / k,
+                                         n,
+                                         k,
+                                         x_data,
+                                         k,
+                                         y_int8_.data<uint8_t>(),
+                                         y_scales_.data<float>(),
+                                         o_data,
+                                         n,
+                                         nullptr,
+                                         false);
+    } else if (use_bf16_ && x_dims.size() >= 2) {
+      lite::x86::math::gemm_bf16(x_dims.production() / k,
+                                 n,
+                                 k,
+                                 x_data,
+                                 k,
+                                 y_bf16_.data<uint16_t>(),
+                                 o_data,
+                                 n,
+                                 nullptr,
+                                 false);
+    } else if ((x_dims.size() >= 2 && y_dims.size() >= 2) &&
+               (x_dims.size() != 2 || y_dims.size() != 2)) {
       // x: [B, ..., M, K], y: [B, ..., K, N], out: [B, ..., M, N]
       // x: [B, M, K], y: [K, N], out: [B, M, N]
       // or
@@ -294,9 +360,26 @@ class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       LOG(FATAL) << "not supported x_dims(" << x_dims << ") and y_dims("
                  << y_dims << ")";
     }
+
+    if (!param.epilogue.empty()) {
+      // one pass over the output for the whole chain of the fused ops
+      int64_t cols = o_dims.size() ? o_dims[o_dims.size() - 1] : 1;
+      int64_t rows = o_dims.production() / cols;
+      lite::x86::math::gemm_epilogue(param.epilogue, o_data, o_dims, 0, rows);
+    }
   }
 
   virtual ~MatMulV2Compute() = default;
+
+ private:
+  // y packed by gemm_bf16_pack_b when param.enable_bf16 is set
+  Tensor y_bf16_;
+  bool use_bf16_{false};
+  // y quantized by gemm_s8u8_dynamic_quant_b when param.enable_dynamic_int8
+  // is set
+  Tensor y_int8_;
+  Tensor y_scales_;
+  bool use_dynamic_int8_{false};
 };
 
 }  // namespace x86
@@ -13,7 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,6 +42,39 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    use_dynamic_int8_ = param.enable_dynamic_int8 &&
+                        std::is_same<T, float>::value &&
+                        param.y->dims().size() == 2;
+    use_bf16_ = param.enable_bf16 && std::is_same<T, float>::value &&
+                param.y->dims().size() == 2 && !use_dynamic_int8_;
+    if (!use_bf16_ && !use_dynamic_int8_) return;
+    int K = param.y->dims()[0];
+    int N = param.y->dims()[1];
+    if (use_dynamic_int8_) {
+      y_int8_.Resize(
+          {lite::x86::math::gemm_s8u8_dynamic_packed_b_size(N, K)});
+      y_scales_.Resize({N});
+      lite::x86::math::gemm_s8u8_dynamic_quant_b(
+          N,
+          K,
+          param.y->template data<float>(),
+          N,
+          false,
+          1.f,
+          y_int8_.mutable_data<uint8_t>(),
+          y_scales_.mutable_data<float>());
+      return;
+    }
+    y_bf16_.Resize({lite::x86::math::gemm_bf16_packed_b_size(N, K)});
+    lite::x86::math::gemm_bf16_pack_b(N,
+                                      K,
+                                      param.y->template data<float>(),
+                                      N,
+                                      y_bf16_.mutable_data<uint16_t>());
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -70,15 +106,56 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       z->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
     }
 
-    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-
-    blas.MatMul(x_matrix, y_matrix, z);
+    if (use_dynamic_int8_) {
+      int M = x_matrix.dims()[0];
+      int K = x_matrix.dims()[1];
+      int N = y_matrix.dims()[1];
+      lite::x86::math::gemm_s8u8_dynamic(M,
+                                         N,
+                                         K,
+                                         x_matrix.template data<float>(),
+                                         K,
+                                         y_int8_.data<uint8_t>(),
+                                         y_scales_.data<float>(),
+                                         z->template mutable_data<float>(),
+                                         N,
+                                         nullptr,
+                                         false);
+    } else if (use_bf16_) {
+      int M = x_matrix.dims()[0];
+      int K = x_matrix.dims()[1];
+      int N = y_matrix.dims()[1];
+      lite::x86::math::gemm_bf16(M,
+                                 N,
+                                 K,
+                                 x_matrix.template data<float>(),
+                                 K,
+                                 y_bf16_.data<uint16_t>(),
+                                 z->template mutable_data<float>(),
+                                 N,
+                                 nullptr,
+                                 false);
+    } else {
+      auto blas =
+          lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+      blas.MatMul(x_matrix, y_matrix, z);
+    }
     if (z_dim.size() != 2) {
       z->Resize(z_dim);
     }
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // y packed by gemm_bf16_pack_b when param.enable_bf16 is set
+  Tensor y_bf16_;
+  bool use_bf16_{false};
+  // y quantized by gemm_s8u8_dynamic_quant_b when param.enable_dynamic_int8
+  // is set
+  Tensor y_int8_;
+  Tensor y_scales_;
+  bool use_dynamic_int8_{false};
 };
 
 }  // namespace x86
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -21,6 +22,7 @@
 
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/mul_compute.h"
+#include "lite/tests/utils/fill_data.h"
 
 namespace paddle {
 namespace lite {
@@ -80,6 +82,45 @@ TEST(mul_x86, run_test) {
   }
 }
 
+static void RunMul(const lite::Tensor& x,
+                   const lite::Tensor& y,
+                   bool enable_dynamic_int8,
+                   lite::Tensor* out) {
+  MulCompute<float> mul;
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = out;
+  param.enable_dynamic_int8 = enable_dynamic_int8;
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.PrepareForRun();
+  mul.Run();
+}
+
+TEST(mul_x86, dynamic_int8) {
+  const int m = 33, n = 17, k = 64;
+  lite::Tensor x, y, out, out_ref;
+  x.Resize({m, k});
+  y.Resize({k, n});
+  out.Resize({m, n});
+  out_ref.Resize({m, n});
+  fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+  fill_data_rand(y.mutable_data<float>(), -1.f, 1.f, y.numel());
+
+  RunMul(x, y, false, &out_ref);
+  RunMul(x, y, true, &out);
+  // x and y in [-1, 1], the rounding errors of the k products add up
+  // like a random walk
+  const float tolerance = 3e-2f * std::sqrt(static_cast<float>(k));
+  for (int i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], tolerance);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
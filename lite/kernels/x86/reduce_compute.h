@@ -14,58 +14,41 @@
 #pragma once
 
 #include <vector>
-#include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/math/reduce.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
-#include "lite/kernels/x86/reduce_op_function.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace x86 {
 
+// The functors name the reduction of every kernel.
 struct SumFunctor {
-  template <typename X, typename Y, typename Dim>
-  void operator()(X* x, Y* y, const Dim& dim) {
-    y->device(lite::fluid::EigenDeviceType<TARGET(kX86)>()) = x->sum(dim);
-  }
+  static const lite::x86::math::ReduceType type =
+      lite::x86::math::ReduceType::kSum;
 };
 
 struct ProdFunctor {
-  template <typename X, typename Y, typename Dim>
-  void operator()(X* x, Y* y, const Dim& dim) {
-    y->device(lite::fluid::EigenDeviceType<TARGET(kX86)>()) = x->prod(dim);
-  }
+  static const lite::x86::math::ReduceType type =
+      lite::x86::math::ReduceType::kProd;
 };
 
 struct MeanFunctor {
-  template <typename X, typename Y, typename Dim>
-  void operator()(X* x, Y* y, const Dim& dim) {
-    y->device(lite::fluid::EigenDeviceType<TARGET(kX86)>()) = x->mean(dim);
-  }
+  static const lite::x86::math::ReduceType type =
+      lite::x86::math::ReduceType::kMean;
 };
 
 struct MaxFunctor {
-  template <typename X, typename Y, typename Dim>
-  void operator()(X* x, Y* y, const Dim& dim) {
-    y->device(lite::fluid::EigenDeviceType<TARGET(kX86)>()) = x->maximum(dim);
-  }
+  static const lite::x86::math::ReduceType type =
+      lite::x86::math::ReduceType::kMax;
 };
 
 struct MinFunctor {
-  template <typename X, typename Y, typename Dim>
-  void operator()(X* x, Y* y, const Dim& dim) {
-    y->device(lite::fluid::EigenDeviceType<TARGET(kX86)>()) = x->minimum(dim);
-  }
+  static const lite::x86::math::ReduceType type =
+      lite::x86::math::ReduceType::kMin;
 };
 
-#define HANDLE_DIM(NDIM, RDIM, FUNCTOR)                                \
-  if (ndim == NDIM && rdim == RDIM) {                                  \
-    paddle::lite::kernels::x86::                                       \
-        ReduceFunctor<lite::TargetType::kX86, T, NDIM, RDIM, FUNCTOR>( \
-            *x, out, dims, keep_dim);                                  \
-  }
-
 template <typename T, typename Functor>
 class ReduceCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -75,30 +58,24 @@ class ReduceCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto& param = *param_.get_mutable<operators::ReduceParam>();
     auto* x = param.X;
     auto* out = param.Out;
-    out->template mutable_data<T>();
     auto x_dims = x->dims();
+    const int rank = x_dims.size();
 
-    const auto& dims = param.dim;
-    bool keep_dim = param.keep_dim;
-    bool reduce_all = param.reduce_all;
-    if (reduce_all || dims.empty() || x_dims.size() == 1 ||
-        x_dims.size() == dims.size()) {
-      // Flatten and reduce 1-D tensor
-      auto x_e = lite::fluid::EigenVector<T>::Flatten(*x);
-      auto out_e = lite::fluid::EigenScalar<T>::From(out);
-      auto reduce_dim = Eigen::array<int, 1>({{0}});
-      Functor functor;
-      functor(&x_e, &out_e, reduce_dim);
+    std::vector<int> dims;
+    if (param.reduce_all || param.dim.empty()) {
+      for (int i = 0; i < rank; ++i) {
+        dims.push_back(i);
+      }
     } else {
-      int ndim = x_dims.size();
-      int rdim = dims.size();
-      HANDLE_DIM(4, 3, Functor);
-      HANDLE_DIM(4, 2, Functor);
-      HANDLE_DIM(4, 1, Functor);
-      HANDLE_DIM(3, 2, Functor);
-      HANDLE_DIM(3, 1, Functor);
-      HANDLE_DIM(2, 1, Functor);
+      for (auto d : param.dim) {
+        dims.push_back(d < 0 ? d + rank : d);
+      }
     }
+    lite::x86::math::reduce<T>(x->template data<T>(),
+                               out->template mutable_data<T>(),
+                               x_dims.Vectorize(),
+                               dims,
+                               Functor::type);
   }
 
   virtual ~ReduceCompute() = default;
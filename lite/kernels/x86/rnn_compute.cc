@@ -14,6 +14,7 @@
 
 #include "lite/backends/x86/math/rnn.h"
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,21 +28,24 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
-#define RUN_RNN_LAYER(x, y, z, w) \
-  RunRnnLayer(&ctx,               \
-              input_temp_holder,  \
-              parameter_lists[x], \
-              init_h_unbind,      \
-              init_c_unbind,      \
-              sequence_length,    \
-              &last_h_unbind,     \
-              &last_c_unbind,     \
-              y,                  \
-              x,                  \
-              &gate_value,        \
-              z,                  \
-              w,                  \
-              mode)
+#define RUN_RNN_LAYER(x, y, z, w)                                       \
+  RunRnnLayer(&ctx,                                                     \
+              input_temp_holder,                                        \
+              parameter_lists[x],                                       \
+              init_h_unbind,                                            \
+              init_c_unbind,                                            \
+              sequence_length,                                          \
+              &last_h_unbind,                                           \
+              &last_c_unbind,                                           \
+              y,                                                        \
+              x,                                                        \
+              &gate_value,                                              \
+              z,                                                        \
+              w,                                                        \
+              mode,                                                     \
+              packed_weights_.empty()                                   \
+                  ? nullptr                                             \
+                  : &packed_weights_[(x) * (is_bidirec ? 2 : 1) + (w)])
 
 static void reset_parameter_vector(
     const std::vector<Tensor*>& raw_params_vec,
@@ -399,6 +403,81 @@ static void gru_cell(X86Context* ctx,
       ctx, gru_value, frame_size, batch_size, cand_act, gate_act);
 }
 
+/******************************************************
+input:
+    gate_value:(3D)time_step, batch, gate_num * hidden_size, the input
+        projection of all the steps and the biases from preprocess,
+    weight:W_hh packed for the fused cell,
+    bias_hh,
+    init_h:(2D), init_c:(2D) for LSTM only,
+    mode:LSTM, GRU
+output:
+    output:(3D)time_step, batch, hidden_size,
+    last_h:(2D),
+    last_c:(2D)
+*******************************************************/
+static void RunPackedRnnLayer(const Tensor& gate_value,
+                              const lite::x86::math::RnnPackedWeight& weight,
+                              const Tensor& bias_hh,
+                              const Tensor& init_h,
+                              const Tensor* init_c,
+                              bool is_reverse,
+                              const std::string& mode,
+                              Tensor* output,
+                              Tensor* last_h,
+                              Tensor* last_c) {
+  const int time_step = gate_value.dims()[0];
+  const int batch = gate_value.dims()[1];
+  const int hidden = weight.hidden_size();
+  const size_t gate_stride =
+      static_cast<size_t>(batch) * weight.gate_num() * hidden;
+  const size_t hidden_stride = static_cast<size_t>(batch) * hidden;
+  const float* x_data = gate_value.data<float>();
+  float* out_data = output->mutable_data<float>();
+  const float* h_prev = init_h.data<float>();
+
+  // the cell state of the steps alternates between two buffers
+  Tensor cell_buffer;
+  float* cell_data[2] = {nullptr, nullptr};
+  const float* c_prev = nullptr;
+  if ("LSTM" == mode) {
+    cell_buffer.Resize({2, batch, hidden});
+    cell_data[0] = cell_buffer.mutable_data<float>();
+    cell_data[1] = cell_data[0] + hidden_stride;
+    c_prev = init_c->data<float>();
+  }
+
+  for (int i = 0; i < time_step; i++) {
+    const int t = is_reverse ? time_step - 1 - i : i;
+    float* h = out_data + t * hidden_stride;
+    if ("LSTM" == mode) {
+      lite::x86::math::rnn_lstm_cell_packed(weight,
+                                            x_data + t * gate_stride,
+                                            h_prev,
+                                            c_prev,
+                                            h,
+                                            cell_data[i % 2],
+                                            batch);
+      c_prev = cell_data[i % 2];
+    } else {
+      lite::x86::math::rnn_gru_cell_packed(weight,
+                                           x_data + t * gate_stride,
+                                           bias_hh.data<float>() + 2 * hidden,
+                                           h_prev,
+                                           h,
+                                           batch);
+    }
+    h_prev = h;
+  }
+
+  std::memcpy(
+      last_h->mutable_data<float>(), h_prev, hidden_stride * sizeof(float));
+  if ("LSTM" == mode) {
+    std::memcpy(
+        last_c->mutable_data<float>(), c_prev, hidden_stride * sizeof(float));
+  }
+}
+
 static void RunRnnLayer(X86Context* ctx,
                         const Tensor* input,
                         std::vector<Tensor> vec,
@@ -412,7 +491,8 @@ static void RunRnnLayer(X86Context* ctx,
                         Tensor* gate_value,
                         bool is_bidirect,
                         int offset,
-                        std::string mode) {
+                        std::string mode,
+                        const lite::x86::math::RnnPackedWeight* packed) {
   bool is_reverse = false;
   if (is_bidirect) {
     layer_idx = 2 * layer_idx + offset;
@@ -430,6 +510,21 @@ static void RunRnnLayer(X86Context* ctx,
              mode,
              gate_value);
 
+  // the masked steps of sequence_length still go through the cells below
+  if (sequence_length == nullptr && packed != nullptr) {
+    RunPackedRnnLayer(*gate_value,
+                      *packed,
+                      vec[3 + offset * 4],
+                      init_h[layer_idx],
+                      "LSTM" == mode ? &init_c[layer_idx] : nullptr,
+                      is_reverse,
+                      mode,
+                      output,
+                      &(*last_h_ptr)[layer_idx],
+                      "LSTM" == mode ? &(*last_c_ptr)[layer_idx] : nullptr);
+    return;
+  }
+
   std::vector<Tensor> input_tensors, output_tensors;
   std::vector<Tensor *> input_tensors_t, output_tensors_t;
   std::vector<int> stride1, stride2, stride3;
@@ -631,6 +726,39 @@ static void RunRnnLayer(X86Context* ctx,
   }
 }
 
+void RnnCompute::PrepareForRun() {
+  auto& param = this->Param<operators::RnnParam>();
+  int gate_num = 0;
+  if ("LSTM" == param.mode) {
+    gate_num = 4;
+  } else if ("GRU" == param.mode) {
+    gate_num = 3;
+  } else {
+    // Run reports the unsupported mode
+    return;
+  }
+  // the weights are persistable, so W_hh is packed once rather than copied
+  // at every time step
+  std::vector<std::vector<Tensor>> parameter_lists;
+  parameter_lists.reserve(param.num_layers);
+  reset_parameter_vector(param.WeightList,
+                         param.num_layers,
+                         gate_num,
+                         param.is_bidirec,
+                         &parameter_lists);
+  const int direction_num = param.is_bidirec ? 2 : 1;
+  packed_weights_.resize(param.num_layers * direction_num);
+  for (int i = 0; i < param.num_layers; i++) {
+    for (int d = 0; d < direction_num; d++) {
+      const Tensor& weight_hh = parameter_lists[i][1 + d * 4];
+      const int hidden_size = weight_hh.dims()[1];
+      CHECK_EQ(weight_hh.dims()[0], gate_num * hidden_size);
+      packed_weights_[i * direction_num + d].Pack(
+          weight_hh.data<float>(), gate_num, hidden_size);
+    }
+  }
+}
+
 void RnnCompute::Run() {
   auto& param = this->Param<operators::RnnParam>();
   auto& ctx = this->ctx_->As<X86Context>();
@@ -756,6 +884,21 @@ void RnnCompute::Run() {
   if (num_layers % 2 == 0) {
     output->CopyDataFrom(*output_holder);
   }
+  // the unbind states are copies of the slices of State, write them back
+  float* last_h_data = state[0]->mutable_data<float>();
+  for (auto& last_h : last_h_unbind) {
+    std::memcpy(
+        last_h_data, last_h.data<float>(), last_h.numel() * sizeof(float));
+    last_h_data += last_h.numel();
+  }
+  if ("LSTM" == mode) {
+    float* last_c_data = state[1]->mutable_data<float>();
+    for (auto& last_c : last_c_unbind) {
+      std::memcpy(
+          last_c_data, last_c.data<float>(), last_c.numel() * sizeof(float));
+      last_c_data += last_c.numel();
+    }
+  }
 }
 
 }  // namespace x86
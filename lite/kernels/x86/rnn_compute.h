@@ -14,6 +14,8 @@
 
 #pragma once
 #include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/rnn_cell.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -24,9 +26,15 @@ namespace x86 {
 
 class RnnCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
+  void PrepareForRun() override;
+
   void Run() override;
 
   virtual ~RnnCompute() = default;
+
+ private:
+  // W_hh of every layer and direction, packed once for the fused cell
+  std::vector<lite::x86::math::RnnPackedWeight> packed_weights_;
 };
 
 }  // namespace x86
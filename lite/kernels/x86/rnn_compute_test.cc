@@ -0,0 +1,209 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/rnn_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static float sigmoid_ref(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// One direction of one layer, x: [time_step, batch, input_size],
+// out: [time_step, batch, out_width] at out_offset of every row.
+static void rnn_ref(const std::string& mode,
+                    const float* x,
+                    int time_step,
+                    int batch,
+                    int input_size,
+                    int hidden,
+                    const float* w_ih,
+                    const float* w_hh,
+                    const float* b_ih,
+                    const float* b_hh,
+                    bool is_reverse,
+                    const float* init_h,
+                    const float* init_c,
+                    float* out,
+                    int out_width,
+                    int out_offset,
+                    float* last_h,
+                    float* last_c) {
+  const int gate_num = mode == "LSTM" ? 4 : 3;
+  std::vector<float> h(init_h, init_h + batch * hidden);
+  std::vector<float> c(batch * hidden, 0.f);
+  if (init_c) c.assign(init_c, init_c + batch * hidden);
+  std::vector<float> xg(gate_num * hidden), hg(gate_num * hidden);
+  for (int i = 0; i < time_step; i++) {
+    const int t = is_reverse ? time_step - 1 - i : i;
+    std::vector<float> h_new(batch * hidden);
+    for (int b = 0; b < batch; b++) {
+      const float* xt = x + (t * batch + b) * input_size;
+      for (int u = 0; u < gate_num * hidden; u++) {
+        xg[u] = b_ih[u];
+        hg[u] = b_hh[u];
+        for (int k = 0; k < input_size; k++) {
+          xg[u] += xt[k] * w_ih[u * input_size + k];
+        }
+        for (int k = 0; k < hidden; k++) {
+          hg[u] += h[b * hidden + k] * w_hh[u * hidden + k];
+        }
+      }
+      for (int u = 0; u < hidden; u++) {
+        if (mode == "LSTM") {
+          float ig = sigmoid_ref(xg[u] + hg[u]);
+          float fg = sigmoid_ref(xg[hidden + u] + hg[hidden + u]);
+          float cg = std::tanh(xg[2 * hidden + u] + hg[2 * hidden + u]);
+          float og = sigmoid_ref(xg[3 * hidden + u] + hg[3 * hidden + u]);
+          c[b * hidden + u] = fg * c[b * hidden + u] + ig * cg;
+          h_new[b * hidden + u] = og * std::tanh(c[b * hidden + u]);
+        } else {
+          float rg = sigmoid_ref(xg[u] + hg[u]);
+          float zg = sigmoid_ref(xg[hidden + u] + hg[hidden + u]);
+          float ng = std::tanh(xg[2 * hidden + u] + rg * hg[2 * hidden + u]);
+          h_new[b * hidden + u] = (1.f - zg) * ng + zg * h[b * hidden + u];
+        }
+        out[(t * batch + b) * out_width + out_offset + u] =
+            h_new[b * hidden + u];
+      }
+    }
+    h = h_new;
+  }
+  std::copy(h.begin(), h.end(), last_h);
+  if (last_c) std::copy(c.begin(), c.end(), last_c);
+}
+
+static void fill_data(lite::Tensor* tensor, int seed) {
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>((i * 37 + seed * 11) % 41 - 20) / 40.f;
+  }
+}
+
+TEST(rnn_x86, retrive_op) {
+  auto rnn = KernelRegistry::Global().Create("rnn");
+  ASSERT_FALSE(rnn.empty());
+  ASSERT_TRUE(rnn.front());
+}
+
+TEST(rnn_x86, run_test) {
+  const int time_step = 5;
+  const int batch = 3;
+  const int input_size = 6;
+  // not a multiple of the tile of the fused cell
+  const int hidden = 11;
+  for (std::string mode : {"LSTM", "GRU"}) {
+    for (bool is_bidirec : {false, true}) {
+      const int gate_num = mode == "LSTM" ? 4 : 3;
+      const int direction_num = is_bidirec ? 2 : 1;
+      lite::Tensor input, pre_h, pre_c, out, last_h, last_c;
+      input.Resize({time_step, batch, input_size});
+      pre_h.Resize({direction_num, batch, hidden});
+      pre_c.Resize({direction_num, batch, hidden});
+      out.Resize({time_step, batch, direction_num * hidden});
+      last_h.Resize({direction_num, batch, hidden});
+      last_c.Resize({direction_num, batch, hidden});
+      fill_data(&input, 1);
+      fill_data(&pre_h, 2);
+      fill_data(&pre_c, 3);
+
+      // [w_ih, w_hh] of every direction and then [b_ih, b_hh]
+      std::vector<lite::Tensor> weights(4 * direction_num);
+      for (int d = 0; d < direction_num; d++) {
+        weights[2 * d].Resize({gate_num * hidden, input_size});
+        weights[2 * d + 1].Resize({gate_num * hidden, hidden});
+        weights[2 * direction_num + 2 * d].Resize({gate_num * hidden});
+        weights[2 * direction_num + 2 * d + 1].Resize({gate_num * hidden});
+      }
+      std::vector<lite::Tensor*> weight_list;
+      for (size_t i = 0; i < weights.size(); i++) {
+        fill_data(&weights[i], 4 + i);
+        weight_list.push_back(&weights[i]);
+      }
+
+      RnnCompute rnn;
+      operators::RnnParam param;
+      param.Input = &input;
+      param.PreState = {&pre_h, &pre_c};
+      param.WeightList = weight_list;
+      param.Out = &out;
+      param.State = {&last_h, &last_c};
+      param.is_bidirec = is_bidirec;
+      param.input_size = input_size;
+      param.hidden_size = hidden;
+      param.num_layers = 1;
+      param.mode = mode;
+      param.is_test = true;
+
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      rnn.SetContext(std::move(ctx));
+      rnn.SetParam(param);
+      rnn.PrepareForRun();
+      rnn.Run();
+
+      std::vector<float> out_ref(out.numel());
+      std::vector<float> last_h_ref(last_h.numel());
+      std::vector<float> last_c_ref(last_c.numel());
+      for (int d = 0; d < direction_num; d++) {
+        const int state_offset = d * batch * hidden;
+        rnn_ref(mode,
+                input.data<float>(),
+                time_step,
+                batch,
+                input_size,
+                hidden,
+                weights[2 * d].data<float>(),
+                weights[2 * d + 1].data<float>(),
+                weights[2 * direction_num + 2 * d].data<float>(),
+                weights[2 * direction_num + 2 * d + 1].data<float>(),
+                d == 1,
+                pre_h.data<float>() + state_offset,
+                mode == "LSTM" ? pre_c.data<float>() + state_offset : nullptr,
+                out_ref.data(),
+                direction_num * hidden,
+                d * hidden,
+                last_h_ref.data() + state_offset,
+                mode == "LSTM" ? last_c_ref.data() + state_offset : nullptr);
+      }
+      for (int64_t i = 0; i < out.numel(); i++) {
+        EXPECT_NEAR(out.data<float>()[i], out_ref[i], 1e-4) << mode;
+      }
+      for (int64_t i = 0; i < last_h.numel(); i++) {
+        EXPECT_NEAR(last_h.data<float>()[i], last_h_ref[i], 1e-4) << mode;
+        if (mode == "LSTM") {
+          EXPECT_NEAR(last_c.data<float>()[i], last_c_ref[i], 1e-4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(rnn, kX86, kFloat, kNCHW, def);
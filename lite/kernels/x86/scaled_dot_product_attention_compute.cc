@@ -0,0 +1,103 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/scaled_dot_product_attention_compute.h"
+#include <vector>
+#include "lite/backends/x86/math/attention.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void ScaledDotProductAttentionCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto q_dims = param.q->dims();
+  const auto v_dims = param.v->dims();
+  const int rank = q_dims.size();
+  const int sq = q_dims[rank - 2];
+  const int d = q_dims[rank - 1];
+  const int sk = param.k->dims()[rank - 2];
+  const int dv = v_dims[rank - 1];
+  const int batch = q_dims.count(0, rank - 2);
+
+  const float* mask_data = nullptr;
+  int64_t mask_row_stride = 0;
+  std::vector<int64_t> mask_offset;
+  if (param.mask) {
+    // The mask is broadcast to the scores [..., sq, sk] from the right,
+    // typically [batch, 1, 1, sk] for padding or [sq, sk] for causal.
+    const auto mask_dims = param.mask->dims();
+    const int mask_rank = mask_dims.size();
+    CHECK_LE(mask_rank, rank);
+    CHECK_EQ(mask_dims[mask_rank - 1], sk)
+        << "The last dim of mask should be equal to the key length.";
+    if (mask_rank >= 2) {
+      CHECK(mask_dims[mask_rank - 2] == 1 || mask_dims[mask_rank - 2] == sq)
+          << "The mask can not be broadcast to the query length.";
+      mask_row_stride = mask_dims[mask_rank - 2] == 1 ? 0 : sk;
+    }
+    // offset of each batch in the mask, computed from the broadcast strides
+    mask_offset.assign(batch, 0);
+    int64_t mask_stride = mask_rank >= 2 ? mask_dims[mask_rank - 2] * sk : sk;
+    int64_t inner = 1;
+    for (int i = rank - 3; i >= 0; i--) {
+      const int mask_i = i - (rank - mask_rank);
+      const int64_t dim = q_dims[i];
+      if (mask_i >= 0 && mask_dims[mask_i] != 1) {
+        CHECK_EQ(mask_dims[mask_i], dim)
+            << "The mask can not be broadcast to the scores.";
+        for (int b = 0; b < batch; b++) {
+          mask_offset[b] += (b / inner) % dim * mask_stride;
+        }
+        mask_stride *= dim;
+      }
+      inner *= dim;
+    }
+    mask_data = param.mask->data<float>();
+  }
+
+  lite::x86::math::scaled_dot_product_attention(
+      param.q->data<float>(),
+      param.k->data<float>(),
+      param.v->data<float>(),
+      mask_data,
+      mask_offset.data(),
+      mask_row_stride,
+      batch,
+      sq,
+      sk,
+      d,
+      dv,
+      param.alpha,
+      param.output->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(scaled_dot_product_attention,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::ScaledDotProductAttentionCompute,
+                     def)
+    .BindInput("Q", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("K", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("V", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Mask", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
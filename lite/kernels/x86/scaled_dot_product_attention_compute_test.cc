@@ -0,0 +1,178 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/scaled_dot_product_attention_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// q: [batch, heads, sq, d], k: [batch, heads, sk, d], v: [batch, heads, sk,
+// dv], mask: [batch, 1, mask_rows, sk] with mask_rows 1 or sq
+static void attention_ref(const float* q,
+                          const float* k,
+                          const float* v,
+                          const float* mask,
+                          int mask_rows,
+                          int batch,
+                          int heads,
+                          int sq,
+                          int sk,
+                          int d,
+                          int dv,
+                          float alpha,
+                          float* out) {
+  std::vector<double> s(sk);
+  for (int b = 0; b < batch * heads; b++) {
+    const float* qb = q + b * sq * d;
+    const float* kb = k + b * sk * d;
+    const float* vb = v + b * sk * dv;
+    for (int i = 0; i < sq; i++) {
+      double max_s = -INFINITY;
+      for (int j = 0; j < sk; j++) {
+        double sum = 0;
+        for (int dd = 0; dd < d; dd++) {
+          sum += qb[i * d + dd] * kb[j * d + dd];
+        }
+        s[j] = sum * alpha;
+        if (mask) {
+          const int row = mask_rows == 1 ? 0 : i;
+          s[j] += mask[((b / heads) * mask_rows + row) * sk + j];
+        }
+        max_s = std::max(max_s, s[j]);
+      }
+      double sum_s = 0;
+      for (int j = 0; j < sk; j++) {
+        s[j] = std::exp(s[j] - max_s);
+        sum_s += s[j];
+      }
+      for (int c = 0; c < dv; c++) {
+        double sum = 0;
+        for (int j = 0; j < sk; j++) {
+          sum += s[j] * vb[j * dv + c];
+        }
+        out[(b * sq + i) * dv + c] = sum / sum_s;
+      }
+    }
+  }
+}
+
+TEST(scaled_dot_product_attention_x86, retrive_op) {
+  auto kernel =
+      KernelRegistry::Global().Create("scaled_dot_product_attention");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(scaled_dot_product_attention_x86, init) {
+  ScaledDotProductAttentionCompute attention;
+  ASSERT_EQ(attention.precision(), PRECISION(kFloat));
+  ASSERT_EQ(attention.target(), TARGET(kX86));
+}
+
+TEST(scaled_dot_product_attention_x86, run_test) {
+  const int batch = 2;
+  const int heads = 3;
+  const int d = 20;
+  const int dv = 24;
+  const float alpha = 1.f / std::sqrt(static_cast<float>(d));
+  for (int sq : {1, 7, 45}) {
+    for (int sk : {5, 64, 131}) {
+      // 0: no mask, 1: padding mask, 2: causal mask
+      for (int mask_type : {0, 1, 2}) {
+        const int mask_rows = mask_type == 2 ? sq : 1;
+        lite::Tensor q, k, v, mask, out;
+        q.Resize({batch, heads, sq, d});
+        k.Resize({batch, heads, sk, d});
+        v.Resize({batch, heads, sk, dv});
+        mask.Resize({batch, 1, mask_rows, sk});
+        out.Resize({batch, heads, sq, dv});
+        auto* q_data = q.mutable_data<float>();
+        auto* k_data = k.mutable_data<float>();
+        auto* v_data = v.mutable_data<float>();
+        auto* mask_data = mask.mutable_data<float>();
+        for (int64_t i = 0; i < q.numel(); i++) {
+          q_data[i] = static_cast<float>((i * 7 % 13) - 6) / 4.f;
+        }
+        for (int64_t i = 0; i < k.numel(); i++) {
+          k_data[i] = static_cast<float>((i * 5 % 11) - 5) / 4.f;
+        }
+        for (int64_t i = 0; i < v.numel(); i++) {
+          v_data[i] = static_cast<float>((i * 3 % 17) - 8) / 8.f;
+        }
+        for (int b = 0; b < batch; b++) {
+          // the last b + 1 keys are padding
+          const int valid = std::max(sk - b - 1, 1);
+          for (int i = 0; i < mask_rows; i++) {
+            for (int j = 0; j < sk; j++) {
+              bool masked = mask_type == 2 ? j > i : j >= valid;
+              mask_data[(b * mask_rows + i) * sk + j] =
+                  masked ? -10000.f : 0.f;
+            }
+          }
+        }
+
+        ScaledDotProductAttentionCompute attention;
+        operators::ScaledDotProductAttentionParam param;
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        attention.SetContext(std::move(ctx));
+        param.q = &q;
+        param.k = &k;
+        param.v = &v;
+        param.mask = mask_type == 0 ? nullptr : &mask;
+        param.output = &out;
+        param.alpha = alpha;
+        attention.SetParam(param);
+        attention.Run();
+
+        std::vector<float> ref(out.numel());
+        attention_ref(q_data,
+                      k_data,
+                      v_data,
+                      mask_type == 0 ? nullptr : mask_data,
+                      mask_rows,
+                      batch,
+                      heads,
+                      sq,
+                      sk,
+                      d,
+                      dv,
+                      alpha,
+                      ref.data());
+        const float* out_data = out.data<float>();
+        for (int64_t i = 0; i < out.numel(); i++) {
+          EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(scaled_dot_product_attention, kX86, kFloat, kNCHW, def);
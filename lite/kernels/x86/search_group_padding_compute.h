@@ -14,6 +14,7 @@
 #pragma once
 
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -79,21 +80,25 @@ class SearchGroupPaddingCompute
     const auto* bottom_data = bottom0->template data<T>();
     auto* top_data = top0->template mutable_data<T>();
     auto* top_padding_input_data = top2->template mutable_data<T>();
-    for (int i = 0; i < batch; i++) {
-      const int copy_step = offset[i + 1] - offset[i];
-      const int start = i * max_seq;
-      memcpy(top_data + start * dim1,
-             bottom_data + offset[i] * dim1,
-             copy_step * dim1 * sizeof(T));
-      memset(top_data + (start + copy_step) * dim1,
-             0,
-             (max_seq - copy_step) * dim1 * sizeof(T));
-      // for padding input id
-      memset(top_padding_input_data + start, 0, copy_step * sizeof(T));
-      for (int j = start + copy_step; j < start + max_seq; j++) {
-        top_padding_input_data[j] = static_cast<T>(_pad_id);
+    // every sequence is padded to max_seq rows, so the batches take about
+    // the same time and are split evenly
+    lite::x86::RunParallelFor(0, batch, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const int copy_step = offset[i + 1] - offset[i];
+        const int start = i * max_seq;
+        memcpy(top_data + start * dim1,
+               bottom_data + offset[i] * dim1,
+               copy_step * dim1 * sizeof(T));
+        memset(top_data + (start + copy_step) * dim1,
+               0,
+               (max_seq - copy_step) * dim1 * sizeof(T));
+        // for padding input id
+        memset(top_padding_input_data + start, 0, copy_step * sizeof(T));
+        for (int j = start + copy_step; j < start + max_seq; j++) {
+          top_padding_input_data[j] = static_cast<T>(_pad_id);
+        }
       }
-    }
+    });
   }
 
   virtual ~SearchGroupPaddingCompute() = default;
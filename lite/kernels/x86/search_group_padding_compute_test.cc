@@ -85,6 +85,55 @@ TEST(search_group_padding_x86, run_test) {
   }
 }
 
+// Empty sequences and one long sequence, all padded to the long one.
+TEST(search_group_padding_x86, empty_and_long_sequences) {
+  const int64_t dim1 = 2;
+  const int pad_id = 7;
+  std::vector<uint64_t> offset{0, 0, 3, 3, 1003, 1005};
+  const int64_t batch = offset.size() - 1;
+  const int64_t max_seq = 1000;
+  lite::Tensor x, out_emb_padding, out_new, out_padding;
+  x.Resize({static_cast<int64_t>(offset.back()), dim1});
+  x.set_lod({offset});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i + 1);
+  }
+
+  SearchGroupPaddingCompute<float> sgp_kernel;
+  operators::SearchGroupPaddingParam param;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  sgp_kernel.SetContext(std::move(ctx));
+  param.x = &x;
+  param.out_emb_padding = &out_emb_padding;
+  param.out_new = &out_new;
+  param.out_padding = &out_padding;
+  param.pad_id = pad_id;
+  sgp_kernel.SetParam(param);
+  sgp_kernel.Run();
+
+  ASSERT_EQ(out_emb_padding.dims()[0], batch * max_seq);
+  ASSERT_EQ(out_padding.dims()[0], batch * max_seq);
+  const auto* emb_data = out_emb_padding.data<float>();
+  const auto* padding_data = out_padding.data<float>();
+  for (int64_t i = 0; i < batch; i++) {
+    const int64_t len = offset[i + 1] - offset[i];
+    for (int64_t k = 0; k < max_seq; k++) {
+      const int64_t row = i * max_seq + k;
+      for (int64_t j = 0; j < dim1; j++) {
+        float ref = k < len ? x_data[(offset[i] + k) * dim1 + j] : 0.f;
+        ASSERT_EQ(emb_data[row * dim1 + j], ref) << "row " << row;
+      }
+      ASSERT_EQ(padding_data[row], k < len ? 0.f : pad_id) << "row " << row;
+    }
+  }
+  const auto* new_data = out_new.data<float>();
+  for (int64_t i = 0; i < out_new.numel(); i++) {
+    EXPECT_EQ(new_data[i], 0.f);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/search_seq_depadding_compute.h"
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 
 namespace paddle {
 namespace lite {
@@ -52,10 +53,15 @@ void SearchSeqDepaddingCompute<T>::Run() {
       LOG(FATAL)
           << "the length of padding seq input is less than source seq input.";
     }
-    memcpy(out_data + src_offset[i] * pad_cap_e,
-           pad_data + pad_offset[i] * pad_cap_e,
-           src_i_l * pad_cap_e * sizeof(T));
   }
+  lite::x86::RunParallelForLoD(src_offset, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int src_i_l = src_offset[i + 1] - src_offset[i];
+      memcpy(out_data + src_offset[i] * pad_cap_e,
+             pad_data + pad_offset[i] * pad_cap_e,
+             src_i_l * pad_cap_e * sizeof(T));
+    }
+  });
 }
 
 }  // namespace x86
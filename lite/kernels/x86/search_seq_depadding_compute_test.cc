@@ -75,6 +75,54 @@ TEST(search_seq_depadding_x86, run_test) {
   }
 }
 
+// Empty sources, one long source among the short ones, and padded
+// sequences longer than their sources, split over several chunks.
+TEST(search_seq_depadding_x86, empty_and_long_sequences) {
+  const int64_t width = 4;
+  std::vector<uint64_t> src_offset{0};
+  std::vector<uint64_t> pad_offset{0};
+  for (int i = 0; i < 300; i++) {
+    uint64_t len = i % 6 == 0 ? 0 : 1 + i * 3 % 7;
+    if (i == 250) len = 1000;
+    src_offset.push_back(src_offset.back() + len);
+    pad_offset.push_back(pad_offset.back() + len + i % 3);
+  }
+  lite::Tensor pad, src, out;
+  pad.Resize({static_cast<int64_t>(pad_offset.back()), width});
+  pad.set_lod({pad_offset});
+  src.Resize({static_cast<int64_t>(src_offset.back()), 1});
+  src.set_lod({src_offset});
+  auto* pad_data = pad.mutable_data<float>();
+  for (int64_t i = 0; i < pad.numel(); i++) {
+    pad_data[i] = static_cast<float>(i);
+  }
+
+  SearchSeqDepaddingCompute<float> ssdc;
+  operators::SearchSeqDepaddingParam param;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  ssdc.SetContext(std::move(ctx));
+  param.pad = &pad;
+  param.src = &src;
+  param.out = &out;
+  ssdc.SetParam(param);
+  ssdc.Run();
+
+  ASSERT_EQ(out.lod()[0], src_offset);
+  ASSERT_EQ(out.dims()[0], static_cast<int64_t>(src_offset.back()));
+  // the first rows of each padded sequence
+  const auto* out_data = out.data<float>();
+  for (size_t i = 0; i + 1 < src_offset.size(); i++) {
+    for (uint64_t k = 0; k < src_offset[i + 1] - src_offset[i]; k++) {
+      for (int64_t j = 0; j < width; j++) {
+        ASSERT_EQ(out_data[(src_offset[i] + k) * width + j],
+                  pad_data[(pad_offset[i] + k) * width + j])
+            << "sequence " << i << " row " << k;
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
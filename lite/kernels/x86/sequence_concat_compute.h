@@ -14,6 +14,7 @@
 #pragma once
 
 #include <vector>
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -89,13 +90,17 @@ class SequenceConcatCompute
       input_cols[i] = x_in_order[i].numel() / out_rows;
     }
 
-    int col_idx = 0;
+    // the slices are copied in parallel, each to its offset in Out
+    std::vector<uint64_t> col_offsets(num + 1, 0);
     for (int j = 0; j < num; ++j) {
-      int col_len = input_cols[j];
-      auto input_data = x_in_order[j].data<T>();
-      memcpy(dout + col_idx, input_data, sizeof(T) * col_len);
-      col_idx += col_len;
+      col_offsets[j + 1] = col_offsets[j] + input_cols[j];
     }
+    lite::x86::RunParallelForLoD(col_offsets, [&](int64_t begin, int64_t end) {
+      for (int64_t j = begin; j < end; ++j) {
+        auto input_data = x_in_order[j].data<T>();
+        memcpy(dout + col_offsets[j], input_data, sizeof(T) * input_cols[j]);
+      }
+    });
   }
 
   virtual ~SequenceConcatCompute() = default;
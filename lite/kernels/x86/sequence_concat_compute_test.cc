@@ -156,6 +156,57 @@ TEST(sequence_concat_x86, run_test) {
   }
 }
 
+// Short sequences empty in some of the inputs, one empty in all of them and
+// one long sequence in x1, the slices are split over several chunks by
+// RunParallelForLoD.
+TEST(sequence_concat_x86, empty_and_long_sequences) {
+  const int64_t feature_len = 4;
+  const int num_seqs = 300;
+  std::vector<LoD> lods(3, LoD{{0}});
+  for (int i = 0; i < num_seqs; ++i) {
+    uint64_t lens[3] = {static_cast<uint64_t>(i * 7 % 11),
+                        static_cast<uint64_t>(i % 3),
+                        static_cast<uint64_t>(i % 5 == 0 ? 0 : 2)};
+    if (i == 200) lens[0] = 1000;
+    if (i == 50) lens[0] = lens[1] = lens[2] = 0;
+    for (int j = 0; j < 3; ++j) {
+      lods[j][0].push_back(lods[j][0].back() + lens[j]);
+    }
+  }
+  std::vector<lite::Tensor> x_tensors(lods.size());
+  std::vector<lite::Tensor*> xs;
+  for (size_t i = 0; i < lods.size(); ++i) {
+    auto& x = x_tensors[i];
+    x.Resize({static_cast<int64_t>(lods[i][0].back()), feature_len});
+    x.set_lod(lods[i]);
+    float* x_data = x.mutable_data<float>();
+    for (int64_t j = 0; j < x.numel(); ++j) {
+      x_data[j] = i * 10000.f + j;
+    }
+    xs.push_back(&x);
+  }
+
+  SequenceConcatCompute<float> seq_kernel;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  operators::SequenceConcatParam param;
+  lite::Tensor y, y_ref;
+  param.X = xs;
+  param.Out = &y;
+  seq_kernel.SetParam(param);
+  seq_kernel.SetContext(std::move(ctx));
+  seq_kernel.Run();
+
+  sequence_concat_ref(xs, &y_ref);
+  ASSERT_EQ(y.lod(), y_ref.lod());
+  ASSERT_EQ(y.numel(), y_ref.numel());
+  const float* y_data = y.data<float>();
+  const float* y_ref_data = y_ref.data<float>();
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_EQ(y_data[i], y_ref_data[i]) << "at " << i;
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,131 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/sequence_conv_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Row i of out is the context_length rows of x from i + context_start, the
+// rows out of the sequence of i taken as zeros, times the filter.
+static void sequence_conv_ref(const lite::Tensor& x,
+                              const lite::Tensor& filter,
+                              int context_start,
+                              int context_length,
+                              std::vector<float>* out) {
+  const auto& lod = x.lod()[0];
+  const int64_t width = x.dims()[1];
+  const int64_t out_width = filter.dims()[1];
+  const float* x_data = x.data<float>();
+  const float* filter_data = filter.data<float>();
+  out->assign(x.dims()[0] * out_width, 0.f);
+  for (size_t s = 0; s + 1 < lod.size(); ++s) {
+    for (int64_t i = lod[s]; i < static_cast<int64_t>(lod[s + 1]); ++i) {
+      for (int c = 0; c < context_length; ++c) {
+        int64_t row = i + context_start + c;
+        if (row < static_cast<int64_t>(lod[s]) ||
+            row >= static_cast<int64_t>(lod[s + 1])) {
+          continue;
+        }
+        for (int64_t k = 0; k < width; ++k) {
+          float v = x_data[row * width + k];
+          for (int64_t o = 0; o < out_width; ++o) {
+            (*out)[i * out_width + o] +=
+                v * filter_data[(c * width + k) * out_width + o];
+          }
+        }
+      }
+    }
+  }
+}
+
+static void TestSequenceConv(const std::vector<uint64_t>& lod,
+                             int context_start,
+                             int context_length) {
+  const int64_t width = 3;
+  const int64_t out_width = 2;
+  lite::Tensor x, filter, out;
+  x.Resize({static_cast<int64_t>(lod.back()), width});
+  x.set_lod({lod});
+  filter.Resize({context_length * width, out_width});
+  out.Resize({static_cast<int64_t>(lod.back()), out_width});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<float>(i % 17) * 0.1f - 0.8f;
+  }
+  auto* filter_data = filter.mutable_data<float>();
+  for (int64_t i = 0; i < filter.numel(); ++i) {
+    filter_data[i] = static_cast<float>(i % 5) * 0.2f - 0.4f;
+  }
+
+  SequenceConvCompute<float> kernel;
+  operators::SequenceConvParam param;
+  param.X = &x;
+  param.Filter = &filter;
+  param.Out = &out;
+  param.contextStart = context_start;
+  param.contextLength = context_length;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel.SetContext(std::move(ctx));
+  kernel.SetParam(param);
+  kernel.Run();
+
+  std::vector<float> out_ref;
+  sequence_conv_ref(x, filter, context_start, context_length, &out_ref);
+  const auto* out_data = out.data<float>();
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    ASSERT_NEAR(out_data[i], out_ref[i], 1e-4)
+        << "row " << i / out_width << " start " << context_start;
+  }
+}
+
+TEST(sequence_conv_x86, retrive_op) {
+  auto sequence_conv = KernelRegistry::Global().Create("sequence_conv");
+  ASSERT_FALSE(sequence_conv.empty());
+  ASSERT_TRUE(sequence_conv.front());
+}
+
+TEST(sequence_conv_x86, run_test) {
+  TestSequenceConv({0, 3, 4}, -1, 3);
+  TestSequenceConv({0, 3, 4}, 0, 2);
+}
+
+// Short sequences, empty ones and one long sequence, which RunParallelForLoD
+// splits over several chunks of the im2col.
+TEST(sequence_conv_x86, empty_and_long_sequences) {
+  std::vector<uint64_t> lod{0};
+  for (int i = 0; i < 300; ++i) {
+    uint64_t len = i % 4 == 0 ? 0 : i * 5 % 9;
+    if (i == 250) len = 1000;
+    lod.push_back(lod.back() + len);
+  }
+  TestSequenceConv(lod, -1, 3);
+  TestSequenceConv(lod, -2, 3);
+  TestSequenceConv(lod, 1, 2);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(sequence_conv, kX86, kFloat, kNCHW, def);
@@ -13,9 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,18 +41,17 @@ struct SequenceExpandFunctor {
     const T *in_data = x.data<T>();
     T *out_data = out->mutable_data<T, T>();
 
-    for (int h_id = 0; h_id < hight; ++h_id) {
-      uint64_t span = ref_lod[h_id + 1] - ref_lod[h_id];
-      if (span == 0) continue;
-      const T *src = in_data + h_id * width;
-      for (uint64_t w_id = 0; w_id < width; ++w_id) {
-        T ele = src[w_id];
-        size_t offset = ref_lod[h_id] * width;
-        for (uint64_t k = 0; k < span; ++k) {
-          out_data[offset + k * width + w_id] = ele;
+    // row h_id of x is repeated over the rows [ref_lod[h_id],
+    // ref_lod[h_id + 1]) of out, the rows of x are split by the sizes of
+    // what they expand to.
+    lite::x86::RunParallelForLoD(ref_lod, [&](int64_t begin, int64_t end) {
+      for (int64_t h_id = begin; h_id < end; ++h_id) {
+        const T *src = in_data + h_id * width;
+        for (uint64_t k = ref_lod[h_id]; k < ref_lod[h_id + 1]; ++k) {
+          std::memcpy(out_data + k * width, src, width * sizeof(T));
         }
       }
-    }
+    });
   }
 };
 
@@ -89,6 +89,48 @@ TEST(sequence_expand_as_x86, run_test) {
   }
 }
 
+// Rows expanded to a few rows, to nothing, and one to a long sequence, so
+// that RunParallelForLoD splits them into chunks of different sizes.
+TEST(sequence_expand_as_x86, empty_and_long_sequences) {
+  const int64_t width = 3;
+  std::vector<std::vector<uint64_t>> lod{{0}};
+  for (int i = 0; i < 400; i++) {
+    uint64_t len = i % 5 == 0 ? 0 : i * 7 % 11;
+    if (i == 300) len = 1000;
+    lod[0].push_back(lod[0].back() + len);
+  }
+  lite::Tensor x, y, out;
+  x.Resize({static_cast<int64_t>(lod[0].size()) - 1, width});
+  y.Resize({static_cast<int64_t>(lod[0].back()), 1});
+  y.set_lod(lod);
+  out.Resize({static_cast<int64_t>(lod[0].back()), width});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i);
+  }
+
+  SequenceExpandAsCompute<float, PRECISION(kFloat)> sequence_expand_as;
+  operators::SequenceExpandAsParam param;
+  param.x = &x;
+  param.y = &y;
+  param.out = &out;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  sequence_expand_as.SetContext(std::move(ctx));
+  sequence_expand_as.SetParam(param);
+  sequence_expand_as.Run();
+
+  const auto* out_data = out.data<float>();
+  for (size_t i = 0; i + 1 < lod[0].size(); i++) {
+    for (uint64_t k = lod[0][i]; k < lod[0][i + 1]; k++) {
+      for (int64_t j = 0; j < width; j++) {
+        ASSERT_EQ(out_data[k * width + j], x_data[i * width + j])
+            << "row " << k;
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
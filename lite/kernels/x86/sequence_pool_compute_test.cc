@@ -14,7 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -81,6 +84,73 @@ TEST(sequence_pool_x86, run_test) {
   }
 }
 
+// Several sequences of different lengths, an empty one included, so that
+// they are split across threads, and a width with a tail after the blocks.
+TEST(sequence_pool_x86, run_lod_test) {
+  const std::vector<uint64_t> offset{0, 3, 3, 40, 41, 60};
+  const int64_t num_seqs = static_cast<int64_t>(offset.size()) - 1;
+  const int64_t width = 19;
+  const float pad_value = -2.f;
+  for (std::string pool_type :
+       {"SUM", "AVERAGE", "SQRT", "MAX", "FIRST", "LAST"}) {
+    lite::Tensor x, out, index;
+    x.set_lod({offset});
+    x.Resize({static_cast<int64_t>(offset.back()), width});
+    index.Resize({num_seqs, width});
+    auto x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>((i * 37) % 101) / 10.f - 5.f;
+    }
+
+    SequencePoolCompute<float> sequence_pool;
+    operators::SequencePoolParam param;
+    param.X = &x;
+    param.Out = &out;
+    param.MaxIndex = &index;
+    param.pool_type = pool_type;
+    param.pad_value = pad_value;
+
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    sequence_pool.SetContext(std::move(ctx));
+    sequence_pool.SetParam(param);
+    sequence_pool.Run();
+
+    ASSERT_EQ(out.dims()[0], num_seqs);
+    const float* out_data = out.data<float>();
+    for (int64_t s = 0; s < num_seqs; s++) {
+      const int64_t h = static_cast<int64_t>(offset[s + 1] - offset[s]);
+      for (int64_t k = 0; k < width; k++) {
+        float ref = pad_value;
+        if (h > 0) {
+          const float* col = x_data + offset[s] * width + k;
+          if (pool_type == "FIRST") {
+            ref = col[0];
+          } else if (pool_type == "LAST") {
+            ref = col[(h - 1) * width];
+          } else if (pool_type == "MAX") {
+            ref = col[0];
+            for (int64_t j = 1; j < h; j++) {
+              ref = std::max(ref, col[j * width]);
+            }
+          } else {
+            ref = 0.f;
+            for (int64_t j = 0; j < h; j++) {
+              ref += col[j * width];
+            }
+            if (pool_type == "AVERAGE") {
+              ref /= h;
+            } else if (pool_type == "SQRT") {
+              ref /= std::sqrt(static_cast<float>(h));
+            }
+          }
+        }
+        EXPECT_NEAR(out_data[s * width + k], ref, 1e-4) << pool_type;
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -52,36 +52,22 @@ class SoftmaxCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<operators::SoftmaxParam>();
-    auto& context = ctx_->As<X86Context>();
     CHECK(param.output);
     CHECK(param.x);
 
     auto* x = param.x;
     auto* output = param.output;
-    output->template mutable_data<T>();
-
-    const int rank = x->dims().size();
+    const auto& x_dims = x->dims();
+    const int rank = x_dims.size();
     const int axis = CanonicalAxis(param.axis, rank);
-    int axis_dim = x->dims()[axis];
-    if (rank == 2 && axis == 1) {
-      lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-          context, axis_dim, x, output);
-    } else {
-      const int n = SizeToAxis(axis, x->dims());
-      const int d = SizeFromAxis(axis, x->dims());
-
-      DDim x_dims = x->dims();
-      DDim out_dims = output->dims();
-
-      DDim shape_2d(std::vector<DDim::value_type>{n, d});
-      x->Resize(shape_2d);
-      output->Resize(shape_2d);
-
-      lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-          context, axis_dim, x, output);
-      x->Resize(x_dims);
-      output->Resize(out_dims);
-    }
+    const int axis_dim = x_dims[axis];
+    const int outer_num = SizeToAxis(axis, x_dims);
+    const int inner_num = SizeFromAxis(axis + 1, x_dims);
+    lite::x86::math::softmax(x->template data<T>(),
+                             output->template mutable_data<T>(),
+                             outer_num,
+                             axis_dim,
+                             inner_num);
   }
 
   virtual ~SoftmaxCompute() = default;
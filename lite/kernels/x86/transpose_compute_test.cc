@@ -74,6 +74,79 @@ TEST(transpose_x86, run_test) {
   }
 }
 
+// out[o] of the permuted dims from the input index of every output index
+static void transpose_ref(const std::vector<float>& in,
+                          const std::vector<int64_t>& dims,
+                          const std::vector<int>& axis,
+                          std::vector<float>* out) {
+  const int rank = dims.size();
+  std::vector<int64_t> in_stride(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_stride[i] = in_stride[i + 1] * dims[i + 1];
+  }
+  for (size_t o = 0; o < out->size(); ++o) {
+    int64_t rem = o;
+    int64_t offset = 0;
+    for (int k = rank - 1; k >= 0; --k) {
+      offset += (rem % dims[axis[k]]) * in_stride[axis[k]];
+      rem /= dims[axis[k]];
+    }
+    (*out)[o] = in[offset];
+  }
+}
+
+TEST(transpose_x86, permute_test) {
+  // 2D, NCHW -> NHWC, NHWC -> NCHW, the head split of attention, dims of
+  // size 1 and a rank above 6
+  std::vector<std::vector<int64_t>> dims_list{{37, 53},
+                                              {2, 3, 17, 19},
+                                              {2, 19, 17, 3},
+                                              {3, 20, 4, 16},
+                                              {1, 5, 1, 7},
+                                              {2, 3, 2, 3, 2, 3, 2}};
+  std::vector<std::vector<int>> axis_list{{1, 0},
+                                          {0, 2, 3, 1},
+                                          {0, 3, 1, 2},
+                                          {0, 2, 1, 3},
+                                          {3, 1, 2, 0},
+                                          {6, 3, 1, 0, 2, 4, 5}};
+  for (size_t c = 0; c < dims_list.size(); ++c) {
+    auto& dims = dims_list[c];
+    auto& axis = axis_list[c];
+    std::vector<int64_t> out_dims;
+    for (auto i : axis) out_dims.push_back(dims[i]);
+    lite::Tensor x;
+    lite::Tensor out;
+    x.Resize(lite::DDim(dims));
+    out.Resize(lite::DDim(out_dims));
+    auto* x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      x_data[i] = static_cast<float>(i);
+    }
+
+    TransposeCompute<float> transpose;
+    operators::TransposeParam param;
+    param.x = &x;
+    param.output = &out;
+    param.axis = axis;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    transpose.SetContext(std::move(ctx));
+    transpose.SetParam(param);
+    transpose.Run();
+
+    std::vector<float> out_ref(out.numel());
+    transpose_ref(std::vector<float>(x_data, x_data + x.numel()),
+                  dims,
+                  axis,
+                  &out_ref);
+    auto* out_data = out.data<float>();
+    for (int64_t i = 0; i < out.numel(); ++i) {
+      EXPECT_EQ(out_data[i], out_ref[i]) << "case " << c;
+    }
+  }
+}
+
 // transpose2
 TEST(transpose2_x86, retrive_op) {
   auto transpose2 = KernelRegistry::Global().Create("transpose2");
@@ -0,0 +1,82 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/add_layer_norm_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool AddLayerNormOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X);
+  CHECK_OR_FALSE(param_.Y);
+  const auto x_dims = param_.X->dims();
+  CHECK_OR_FALSE(param_.begin_norm_axis >= 0 &&
+                 param_.begin_norm_axis < static_cast<int>(x_dims.size()));
+  const int64_t right = x_dims.Flatten2D(param_.begin_norm_axis)[1];
+  if (param_.Residual) {
+    // either the shape of X, or one row broadcast to all rows
+    const int64_t numel = param_.Residual->numel();
+    CHECK_OR_FALSE(numel == x_dims.production() || numel == right);
+  }
+  if (param_.Scale) {
+    CHECK_EQ_OR_FALSE(param_.Scale->numel(), right);
+  }
+  if (param_.Bias) {
+    CHECK_EQ_OR_FALSE(param_.Bias->numel(), right);
+  }
+  return true;
+}
+
+bool AddLayerNormOp::InferShapeImpl() const {
+  param_.Y->Resize(param_.X->dims());
+  param_.Y->set_lod(param_.X->lod());
+  if (param_.ResidualOut) {
+    param_.ResidualOut->Resize(param_.X->dims());
+    param_.ResidualOut->set_lod(param_.X->lod());
+  }
+  return true;
+}
+
+bool AddLayerNormOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
+  param_.X = scope->FindTensor(opdesc.Input("X").front());
+  param_.Y = scope->FindMutableTensor(opdesc.Output("Y").front());
+  if (opdesc.HasInput("Residual") && !opdesc.Input("Residual").empty()) {
+    param_.Residual = scope->FindTensor(opdesc.Input("Residual").front());
+  }
+  if (opdesc.HasInput("Scale") && !opdesc.Input("Scale").empty()) {
+    param_.Scale = scope->FindTensor(opdesc.Input("Scale").front());
+  }
+  if (opdesc.HasInput("Bias") && !opdesc.Input("Bias").empty()) {
+    param_.Bias = scope->FindTensor(opdesc.Input("Bias").front());
+  }
+  if (opdesc.HasOutput("ResidualOut") &&
+      !opdesc.Output("ResidualOut").empty()) {
+    param_.ResidualOut =
+        scope->FindMutableTensor(opdesc.Output("ResidualOut").front());
+  }
+  param_.begin_norm_axis = opdesc.GetAttr<int>("begin_norm_axis");
+  param_.epsilon = opdesc.GetAttr<float>("epsilon");
+  if (opdesc.HasAttr("rms_norm")) {
+    param_.rms_norm = opdesc.GetAttr<bool>("rms_norm");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(add_layer_norm, paddle::lite::operators::AddLayerNormOp);
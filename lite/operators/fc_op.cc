@@ -118,6 +118,8 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   } else {
     param_.padding_weights = false;
   }
+  param_.enable_bf16 = op_desc.HasAttr(W + "_bf16");
+  param_.enable_dynamic_int8 = op_desc.HasAttr(W + "_dynamic_int8");
 
   if (param_.activation_type == "prelu") {
     param_.Prelu_mode = op_desc.GetAttr<std::string>("prelu_mode");
@@ -147,6 +149,8 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   if (op_desc.HasAttr("op_type")) {
     param_.op_type = op_desc.GetAttr<std::string>("op_type");
   }
+  CHECK(AttachGemmEpilogue(op_desc, scope, &param_.epilogue))
+      << "Invalid epilogue of fc";
 
   return true;
 }
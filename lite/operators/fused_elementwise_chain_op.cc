@@ -0,0 +1,87 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_elementwise_chain_op.h"
+#include "lite/core/op_lite.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+static bool IsBinaryChainOp(const std::string &op) {
+  return op == "add" || op == "sub" || op == "rsub" || op == "mul" ||
+         op == "div" || op == "rdiv" || op == "max" || op == "min";
+}
+
+bool FusedElementwiseChainOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_EQ_OR_FALSE(param_.alphas.size(), param_.ops.size());
+  CHECK_EQ_OR_FALSE(param_.betas.size(), param_.ops.size());
+  size_t num_inputs = 0;
+  for (auto &op : param_.ops) {
+    if (IsBinaryChainOp(op)) num_inputs++;
+  }
+  CHECK_EQ_OR_FALSE(num_inputs, param_.inputs.size());
+  // the inputs are broadcast to X on its last dims
+  const auto &x_dims = param_.X->dims();
+  for (auto *input : param_.inputs) {
+    CHECK_OR_FALSE(input);
+    const auto &y_dims = input->dims();
+    if (y_dims.production() == 1) continue;
+    size_t y_rank = y_dims.size();
+    size_t start = 0;
+    while (start < y_rank && y_dims[start] == 1) start++;
+    CHECK_GE_OR_FALSE(x_dims.size(), y_rank - start);
+    for (size_t i = start; i < y_rank; i++) {
+      CHECK_EQ_OR_FALSE(y_dims[i], x_dims[x_dims.size() - (y_rank - i)]);
+    }
+  }
+  return true;
+}
+
+bool FusedElementwiseChainOp::InferShapeImpl() const {
+  param_.Out->Resize(param_.X->dims());
+  param_.Out->set_lod(param_.X->lod());
+  return true;
+}
+
+bool FusedElementwiseChainOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                         lite::Scope *scope) {
+  auto X = op_desc.Input("X").front();
+  auto Out = op_desc.Output("Out").front();
+  param_.X = GetVar<lite::Tensor>(scope, X);
+  param_.Out = GetMutableVar<lite::Tensor>(scope, Out);
+  param_.inputs.clear();
+  if (op_desc.HasInput("Inputs")) {
+    for (auto &name : op_desc.Input("Inputs")) {
+      param_.inputs.push_back(GetVar<lite::Tensor>(scope, name));
+    }
+  }
+  param_.ops = op_desc.GetAttr<std::vector<std::string>>("chain_ops");
+  param_.alphas = op_desc.GetAttr<std::vector<float>>("chain_alphas");
+  param_.betas = op_desc.GetAttr<std::vector<float>>("chain_betas");
+  input_tensor_ptrs_cache_.push_back(param_.X);
+  output_tensor_ptrs_cache_.push_back(param_.Out);
+  return true;
+}
+
+} /* namespace operators */
+} /* namespace lite */
+} /* namespace paddle */
+
+REGISTER_LITE_OP(fused_elementwise_chain,
+                 paddle::lite::operators::FusedElementwiseChainOp);
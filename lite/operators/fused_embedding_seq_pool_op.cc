@@ -0,0 +1,80 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_embedding_seq_pool_op.h"
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedEmbeddingSeqPoolOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W);
+  CHECK_OR_FALSE(param_.Ids);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_EQ_OR_FALSE(param_.W->dims().size(), 2UL);
+  CHECK_GE_OR_FALSE(param_.Ids->dims().size(), 1UL);
+  CHECK_OR_FALSE(param_.pool_type == "SUM" || param_.pool_type == "AVERAGE" ||
+                 param_.pool_type == "SQRT");
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::InferShapeImpl() const {
+  const auto ids_dims = param_.Ids->dims();
+  const auto &lod = param_.Ids->lod();
+  std::vector<int64_t> out_dims = ids_dims.Vectorize();
+  // the sequences are the last level of lod, as in sequence_pool
+  if (!lod.empty()) {
+    out_dims[0] = static_cast<int64_t>(lod.back().size()) - 1;
+  }
+  if (param_.lookup_table_v2) {
+    out_dims.push_back(param_.W->dims()[1]);
+  } else {
+    out_dims.back() *= param_.W->dims()[1];
+  }
+  param_.Out->Resize(out_dims);
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::AttachImpl(const cpp::OpDesc &opdesc,
+                                         lite::Scope *scope) {
+  param_.W = scope->FindTensor(opdesc.Input("W").front());
+  param_.Ids = scope->FindTensor(opdesc.Input("Ids").front());
+  param_.Out = scope->FindMutableTensor(opdesc.Output("Out").front());
+  if (opdesc.HasAttr("padding_idx")) {
+    param_.padding_idx = opdesc.GetAttr<int64_t>("padding_idx");
+  }
+  // the op from paddle only has combiner, which is always "sum"
+  if (opdesc.HasAttr("pooltype")) {
+    param_.pool_type = opdesc.GetAttr<std::string>("pooltype");
+  } else if (opdesc.HasAttr("combiner")) {
+    CHECK_EQ(opdesc.GetAttr<std::string>("combiner"), "sum");
+    param_.pool_type = "SUM";
+  }
+  if (opdesc.HasAttr("pad_value")) {
+    param_.pad_value = opdesc.GetAttr<float>("pad_value");
+  }
+  if (opdesc.HasAttr("lookup_table_v2")) {
+    param_.lookup_table_v2 = opdesc.GetAttr<bool>("lookup_table_v2");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_embedding_seq_pool,
+                 paddle::lite::operators::FusedEmbeddingSeqPoolOp);
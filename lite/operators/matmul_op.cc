@@ -150,6 +150,8 @@ bool MatMulOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   param_.transpose_X = op_desc.GetAttr<bool>("transpose_X");
   param_.transpose_Y = op_desc.GetAttr<bool>("transpose_Y");
   param_.alpha = op_desc.GetAttr<float>("alpha");
+  param_.enable_bf16 = op_desc.HasAttr(Y + "_bf16");
+  param_.enable_dynamic_int8 = op_desc.HasAttr(Y + "_dynamic_int8");
   input_tensor_ptrs_cache_.push_back(param_.X);
   input_tensor_ptrs_cache_.push_back(param_.Y);
   output_tensor_ptrs_cache_.push_back(param_.Out);
@@ -136,6 +136,10 @@ bool MatMulV2OpLite::AttachImpl(const cpp::OpDesc &op_desc,
   if (op_desc.HasAttr("alpha")) {
     param_.alpha = op_desc.GetAttr<float>("alpha");
   }
+  CHECK(AttachGemmEpilogue(op_desc, scope, &param_.epilogue))
+      << "Invalid epilogue of matmul_v2";
+  param_.enable_bf16 = op_desc.HasAttr(Y + "_bf16");
+  param_.enable_dynamic_int8 = op_desc.HasAttr(Y + "_dynamic_int8");
   input_tensor_ptrs_cache_.push_back(param_.X);
   input_tensor_ptrs_cache_.push_back(param_.Y);
   output_tensor_ptrs_cache_.push_back(param_.Out);
@@ -58,6 +58,8 @@ class MulOpLite : public OpLite {
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
+    param_.enable_bf16 = op_desc.HasAttr(W + "_bf16");
+    param_.enable_dynamic_int8 = op_desc.HasAttr(W + "_dynamic_int8");
 
     const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
@@ -13,3 +13,42 @@
 // limitations under the License.
 
 #include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool AttachGemmEpilogue(const cpp::OpDesc& op_desc,
+                        lite::Scope* scope,
+                        GemmEpilogueParam* epilogue) {
+  *epilogue = GemmEpilogueParam();
+  if (!op_desc.HasAttr("epilogue_ops")) return true;
+  epilogue->ops = op_desc.GetAttr<std::vector<std::string>>("epilogue_ops");
+  epilogue->alphas = op_desc.GetAttr<std::vector<float>>("epilogue_alphas");
+  epilogue->betas = op_desc.GetAttr<std::vector<float>>("epilogue_betas");
+  const size_t num_ops = epilogue->ops.size();
+  if (epilogue->alphas.size() != num_ops || epilogue->betas.size() != num_ops) {
+    return false;
+  }
+  std::vector<std::string> input_names;
+  if (op_desc.HasInput("EpilogueInputs")) {
+    input_names = op_desc.Input("EpilogueInputs");
+  }
+  // the inputs are in the order of the adds
+  size_t input_idx = 0;
+  for (auto& op : epilogue->ops) {
+    const lite::Tensor* tensor = nullptr;
+    if (op == "add") {
+      if (input_idx >= input_names.size()) return false;
+      auto* var = scope->FindVar(input_names[input_idx++]);
+      if (!var) return false;
+      tensor = &var->Get<lite::Tensor>();
+    }
+    epilogue->tensors.push_back(tensor);
+  }
+  return input_idx == input_names.size();
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
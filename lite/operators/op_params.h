@@ -97,6 +97,30 @@ struct SubgraphParam : ParamBase {
 
 /// -------------------------- NN operators ------------------------------------
 
+// The chain of elementwise ops which lite_gemm_epilogue_fuse_pass fuses into
+// the output of a gemm based op, applied to every element in order:
+//   "scale": x * alpha + beta
+//   "relu", "relu6" (alpha is the threshold), "leaky_relu" (alpha),
+//   "sigmoid", "tanh", "swish" (alpha is the beta)
+//   "add": x + the tensor of the op, which is broadcast to the output from
+//          the right as elementwise_add with axis -1 does
+// The ops are kept in the attrs "epilogue_ops", "epilogue_alphas" and
+// "epilogue_betas", the tensors of the adds in the input "EpilogueInputs".
+struct GemmEpilogueParam {
+  std::vector<std::string> ops;
+  std::vector<float> alphas;
+  std::vector<float> betas;
+  // the tensor of each op, nullptr if the op has none
+  std::vector<const lite::Tensor*> tensors;
+
+  bool empty() const { return ops.empty(); }
+};
+
+// Reads the epilogue of the op, returns false if the attrs are broken.
+bool AttachGemmEpilogue(const cpp::OpDesc& op_desc,
+                        lite::Scope* scope,
+                        GemmEpilogueParam* epilogue);
+
 struct FcParam : ParamBase {
   lite::Tensor* input{nullptr};
   lite::Tensor* w{nullptr};
@@ -113,6 +137,13 @@ struct FcParam : ParamBase {
       "channel"};  // prelu param, can be "all", "channel" or "element"
   std::string op_type{"mul"};
   float alpha{6.f};
+  // for bf16, set by x86_bf16_attribute_pass
+  bool enable_bf16{false};
+  // for the int8 gemm without calibration, set by
+  // x86_dynamic_quant_attribute_pass
+  bool enable_dynamic_int8{false};
+  // applied after the bias and the activation
+  GemmEpilogueParam epilogue;
   // for int8
   WITH_INT8_CONFIG
 };
@@ -152,6 +183,11 @@ struct MulParam : ParamBase {
 
   int x_num_col_dims{1};
   int y_num_col_dims{1};
+  // for bf16, set by x86_bf16_attribute_pass
+  bool enable_bf16{false};
+  // for the int8 gemm without calibration, set by
+  // x86_dynamic_quant_attribute_pass
+  bool enable_dynamic_int8{false};
   // for int8
   WITH_INT8_CONFIG
 };
@@ -566,6 +602,24 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+// The chain of elementwise ops fused by lite_elementwise_chain_fuse_pass, run
+// in order on the value from X:
+//   unary: "scale" (x * alpha + beta), "relu", "relu6" (alpha), "leaky_relu"
+//          (alpha), "sigmoid", "tanh", "swish" (alpha), "gelu" (alpha is 1
+//          for the tanh approximation), "clip" (alpha, beta), "hard_sigmoid"
+//          (alpha is the slope, beta the offset)
+//   binary with the next tensor of Inputs as y: "add", "sub", "mul", "div",
+//          "max", "min", and "rsub", "rdiv" for y - x and y / x
+// The tensors of Inputs are of the shape of X, of its last dims or scalars.
+struct FusedElementwiseChainParam : ParamBase {
+  const lite::Tensor* X{};
+  std::vector<const lite::Tensor*> inputs;
+  lite::Tensor* Out{};
+  std::vector<std::string> ops;
+  std::vector<float> alphas;
+  std::vector<float> betas;
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam : ParamBase {
   const lite::Tensor* X{};
@@ -976,6 +1030,20 @@ struct LookupTableDequantParam : ParamBase {
   int64_t padding_idx{-1};
 };
 
+// lookup_table or lookup_table_v2 followed by sequence_pool
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  // SUM, AVERAGE or SQRT, as the pooltype of sequence_pool
+  std::string pool_type{"SUM"};
+  float pad_value{0.0f};
+  // Out is [num_seqs, ids_dims[1:], emb_size] as with lookup_table_v2,
+  // otherwise the last dim of ids is multiplied by emb_size
+  bool lookup_table_v2{false};
+};
+
 struct Im2SequenceParam : ParamBase {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};
@@ -1009,6 +1077,20 @@ struct LayerNormParam : ParamBase {
   float epsilon{1e-5f};
 };
 
+// Y = layer_norm(X + Residual), or rms_norm when rms_norm is set.
+// ResidualOut is optional and holds X + Residual.
+struct AddLayerNormParam : ParamBase {
+  const lite::Tensor* X{};
+  const lite::Tensor* Residual{};
+  const lite::Tensor* Scale{};
+  const lite::Tensor* Bias{};
+  lite::Tensor* Y{};
+  lite::Tensor* ResidualOut{};
+  int begin_norm_axis{1};
+  float epsilon{1e-5f};
+  bool rms_norm{false};
+};
+
 struct LogicalParam : ParamBase {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};
@@ -1182,6 +1264,16 @@ struct AttentionPaddingMaskParam : ParamBase {
   lite::Tensor* pad_begin{};
 };
 
+// Out = softmax(alpha * Q * K^T + Mask) * V over the last two dims
+struct ScaledDotProductAttentionParam : ParamBase {
+  const lite::Tensor* q{};
+  const lite::Tensor* k{};
+  const lite::Tensor* v{};
+  const lite::Tensor* mask{};
+  lite::Tensor* output{};
+  float alpha{1.f};
+};
+
 struct SequenceArithmeticParam : ParamBase {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};
@@ -1387,6 +1479,12 @@ struct MatMulParam : ParamBase {
   bool transpose_X{false};
   bool transpose_Y{false};
   float alpha{1.0f};
+  // for bf16, set by x86_bf16_attribute_pass
+  bool enable_bf16{false};
+  // for the int8 gemm without calibration, set by
+  // x86_dynamic_quant_attribute_pass
+  bool enable_dynamic_int8{false};
+  GemmEpilogueParam epilogue;
   WITH_INT8_CONFIG
 };
 
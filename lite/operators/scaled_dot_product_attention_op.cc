@@ -0,0 +1,74 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/scaled_dot_product_attention_op.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/scope.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool ScaledDotProductAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.q);
+  CHECK_OR_FALSE(param_.k);
+  CHECK_OR_FALSE(param_.v);
+  CHECK_OR_FALSE(param_.output);
+  const auto q_dims = param_.q->dims();
+  const auto k_dims = param_.k->dims();
+  const auto v_dims = param_.v->dims();
+  const size_t rank = q_dims.size();
+  CHECK_GE_OR_FALSE(rank, 2UL);
+  CHECK_EQ_OR_FALSE(k_dims.size(), rank);
+  CHECK_EQ_OR_FALSE(v_dims.size(), rank);
+  for (size_t i = 0; i + 2 < rank; i++) {
+    CHECK_EQ_OR_FALSE(q_dims[i], k_dims[i]);
+    CHECK_EQ_OR_FALSE(q_dims[i], v_dims[i]);
+  }
+  CHECK_EQ_OR_FALSE(q_dims[rank - 1], k_dims[rank - 1]);
+  CHECK_EQ_OR_FALSE(k_dims[rank - 2], v_dims[rank - 2]);
+  return true;
+}
+
+bool ScaledDotProductAttentionOp::InferShapeImpl() const {
+  auto out_dims = param_.q->dims();
+  out_dims[out_dims.size() - 1] = param_.v->dims()[out_dims.size() - 1];
+  param_.output->Resize(out_dims);
+  param_.output->set_lod(param_.q->lod());
+  return true;
+}
+
+bool ScaledDotProductAttentionOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                             lite::Scope *scope) {
+  param_.q = scope->FindTensor(op_desc.Input("Q").front());
+  param_.k = scope->FindTensor(op_desc.Input("K").front());
+  param_.v = scope->FindTensor(op_desc.Input("V").front());
+  if (op_desc.HasInput("Mask") && !op_desc.Input("Mask").empty()) {
+    param_.mask = scope->FindTensor(op_desc.Input("Mask").front());
+  } else {
+    param_.mask = nullptr;
+  }
+  param_.output = scope->FindMutableTensor(op_desc.Output("Out").front());
+  if (op_desc.HasAttr("alpha")) {
+    param_.alpha = op_desc.GetAttr<float>("alpha");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(scaled_dot_product_attention,
+                 paddle::lite::operators::ScaledDotProductAttentionOp);
@@ -0,0 +1,134 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lite/core/context.h"
+#include "lite/kernels/x86/rnn_compute.h"
+
+// args: time_step, batch, input_size, hidden_size
+static void LiteRnnBench(const benchmark::State &state_in,
+                         const std::string &mode) {
+  // const in parameter is used to pass CI system
+  // because google bench mark must work with a `benchmark::State &`
+  // we do a const cast here
+  benchmark::State &state = const_cast<benchmark::State &>(state_in);
+
+  const int time_step = state.range(0);
+  const int batch = state.range(1);
+  const int input_size = state.range(2);
+  const int hidden = state.range(3);
+  const int gate_num = mode == "LSTM" ? 4 : 3;
+
+  using paddle::lite::Tensor;
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto f32rng = std::bind(std::uniform_real_distribution<float>(-0.1f, 0.1f),
+                          std::ref(rng));
+  auto fill = [&](Tensor *tensor) {
+    std::generate(tensor->mutable_data<float>(),
+                  tensor->mutable_data<float>() + tensor->numel(),
+                  std::ref(f32rng));
+  };
+
+  Tensor input, pre_h, pre_c, out, last_h, last_c;
+  input.Resize({time_step, batch, input_size});
+  pre_h.Resize({1, batch, hidden});
+  pre_c.Resize({1, batch, hidden});
+  out.Resize({time_step, batch, hidden});
+  last_h.Resize({1, batch, hidden});
+  last_c.Resize({1, batch, hidden});
+  fill(&input);
+  fill(&pre_h);
+  fill(&pre_c);
+  // w_ih, w_hh, b_ih, b_hh
+  std::vector<Tensor> weights(4);
+  weights[0].Resize({gate_num * hidden, input_size});
+  weights[1].Resize({gate_num * hidden, hidden});
+  weights[2].Resize({gate_num * hidden});
+  weights[3].Resize({gate_num * hidden});
+  std::vector<Tensor *> weight_list;
+  for (auto &weight : weights) {
+    fill(&weight);
+    weight_list.push_back(&weight);
+  }
+
+  paddle::lite::operators::RnnParam param;
+  param.Input = &input;
+  param.PreState = {&pre_h, &pre_c};
+  param.WeightList = weight_list;
+  param.Out = &out;
+  param.State = {&last_h, &last_c};
+  param.input_size = input_size;
+  param.hidden_size = hidden;
+  param.num_layers = 1;
+  param.mode = mode;
+  param.is_test = true;
+
+  paddle::lite::kernels::x86::RnnCompute rnn_compute;
+  rnn_compute.SetParam(param);
+  auto ctx = paddle::lite::ContextScheduler::Global().NewContext(
+      paddle::lite_api::TargetType::kX86);
+  rnn_compute.SetContext(std::move(ctx));
+
+  for (int i = 0; i < 2; ++i) {
+    rnn_compute.Launch();
+  }
+
+  for (auto _ : state) {
+    rnn_compute.Launch();
+  }
+
+  // the input projection and the recurrent gemv of every step
+  state.counters["FLOPS"] = benchmark::Counter(
+      uint64_t(state.iterations()) * 2 * time_step * batch * gate_num *
+          hidden * (input_size + hidden),
+      benchmark::Counter::kIsRate);
+}
+
+// The speech models run one utterance at a time, the taggers a few
+// sentences, over sequences from a few steps to a few hundred.
+static void RnnArguments(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"T", "N", "I", "H"});
+  for (int time_step : {1, 8, 32, 128, 512}) {
+    for (int batch : {1, 4}) {
+      b->Args({time_step, batch, 128, 128});
+      b->Args({time_step, batch, 256, 512});
+    }
+  }
+}
+
+static void paddle_lstm(const benchmark::State &state, const char *net) {
+  LiteRnnBench(state, "LSTM");
+}
+
+static void paddle_gru(const benchmark::State &state, const char *net) {
+  LiteRnnBench(state, "GRU");
+}
+
+BENCHMARK_CAPTURE(paddle_lstm, rnn, "rnn LSTM")
+    ->Apply(RnnArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(paddle_gru, rnn, "rnn GRU")
+    ->Apply(RnnArguments)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
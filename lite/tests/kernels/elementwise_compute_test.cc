@@ -224,6 +224,9 @@ class ElementwiseComputeTester : public arena::TestCase {
       } else if (act_type_ == "sigmoid") {
         for (int i = 0; i < x_dims_.production(); i++)
           out_data[i] = NaiveSigmoid(out_data[i]);
+      } else if (act_type_ == "abs") {
+        for (int i = 0; i < x_dims_.production(); i++)
+          out_data[i] = std::fabs(out_data[i]);
       } else {
         LOG(FATAL) << "unsupported act_type:" << act_type_;
       }
@@ -389,6 +392,39 @@ void TestEltFuseActFloat(Place place, float abs_error) {
     TestElt<float>(place, abs_error, elt_type, {2, 3, 14, 5}, {3}, 1, "tanh");
     TestElt<float>(
         place, abs_error, elt_type, {2, 3, 14, 5}, {3}, 1, "sigmoid");
+    TestElt<float>(
+        place, abs_error, elt_type, {2, 13, 4, 5}, {2, 13, 4, 5}, 0, "abs");
+    TestElt<float>(place, abs_error, elt_type, {2, 3, 14, 5}, {3}, 1, "abs");
+  }
+}
+
+// The same-shape, scalar, row and column loops of the x86 elementwise, and
+// the threaded ones from 32768 outputs on.
+void TestEltBroadcastFloat(Place place, float abs_error) {
+  for (auto elt_type : std::vector<std::string>{"add", "mul", "div"}) {
+    for (auto act_type : std::vector<std::string>{"", "relu", "tanh", "abs"}) {
+      // scalar
+      TestElt<float>(
+          place, abs_error, elt_type, {2, 3, 4, 15}, {1}, -1, act_type);
+      // row
+      TestElt<float>(
+          place, abs_error, elt_type, {2, 3, 4, 15}, {4, 15}, -1, act_type);
+      // column
+      TestElt<float>(
+          place, abs_error, elt_type, {2, 3, 4, 15}, {3, 4}, 1, act_type);
+      // threaded
+      TestElt<float>(place,
+                     abs_error,
+                     elt_type,
+                     {4, 16, 33, 17},
+                     {4, 16, 33, 17},
+                     0,
+                     act_type);
+      TestElt<float>(
+          place, abs_error, elt_type, {4, 16, 33, 17}, {16}, 1, act_type);
+      TestElt<float>(
+          place, abs_error, elt_type, {4, 16, 33, 17}, {33, 17}, 2, act_type);
+    }
   }
 }
 #endif
@@ -490,6 +526,7 @@ TEST(Elementwise, precision) {
 #elif defined(LITE_WITH_X86)
   place = TARGET(kX86);
   TestEltFuseActFloat(place, abs_error);
+  TestEltBroadcastFloat(place, abs_error);
 #else
   return;
 #endif
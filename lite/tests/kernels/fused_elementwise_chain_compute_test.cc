@@ -0,0 +1,118 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/test/arena/framework.h"
+
+namespace paddle {
+namespace lite {
+
+class FusedElementwiseChainComputeTester : public arena::TestCase {
+ protected:
+  std::string x_ = "x";
+  std::string bias_ = "bias";
+  std::string gate_ = "gate";
+  std::string out_ = "out";
+  DDim x_dims_;
+
+ public:
+  FusedElementwiseChainComputeTester(const Place& place,
+                                     const std::string& alias,
+                                     const DDim& x_dims)
+      : TestCase(place, alias), x_dims_(x_dims) {}
+
+  // scale -> add(bias) -> sigmoid -> mul(gate) -> rsub(gate) -> clip
+  void RunBaseline(Scope* scope) override {
+    auto* x = scope->FindTensor(x_);
+    auto* bias = scope->FindTensor(bias_);
+    auto* gate = scope->FindTensor(gate_);
+    auto* out = scope->NewTensor(out_);
+    CHECK(out);
+    out->Resize(x->dims());
+    const auto* x_data = x->data<float>();
+    const auto* bias_data = bias->data<float>();
+    const auto* gate_data = gate->data<float>();
+    auto* out_data = out->mutable_data<float>();
+    const int64_t w = x_dims_[x_dims_.size() - 1];
+    for (int64_t i = 0; i < x->numel(); i++) {
+      float v = x_data[i] * 2.f + 0.5f;
+      v += bias_data[i % w];
+      v = 1.f / (1.f + std::exp(-v));
+      v *= gate_data[i];
+      v = gate_data[i] - v;
+      out_data[i] = std::min(std::max(v, -0.5f), 0.5f);
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) override {
+    op_desc->SetType("fused_elementwise_chain");
+    op_desc->SetInput("X", {x_});
+    op_desc->SetInput("Inputs", {bias_, gate_, gate_});
+    op_desc->SetOutput("Out", {out_});
+    op_desc->SetAttr("chain_ops",
+                     std::vector<std::string>(
+                         {"scale", "add", "sigmoid", "mul", "rsub", "clip"}));
+    op_desc->SetAttr("chain_alphas",
+                     std::vector<float>({2.f, 0.f, 0.f, 0.f, 0.f, -0.5f}));
+    op_desc->SetAttr("chain_betas",
+                     std::vector<float>({0.5f, 0.f, 0.f, 0.f, 0.f, 0.5f}));
+  }
+
+  void PrepareData() override {
+    std::vector<float> x_data(x_dims_.production());
+    std::vector<float> gate_data(x_dims_.production());
+    for (int64_t i = 0; i < x_dims_.production(); i++) {
+      x_data[i] = static_cast<float>(i % 17) * 0.25f - 2.f;
+      gate_data[i] = static_cast<float>(i % 5) * 0.3f - 0.6f;
+    }
+    const int64_t w = x_dims_[x_dims_.size() - 1];
+    std::vector<float> bias_data(w);
+    for (int64_t i = 0; i < w; i++) {
+      bias_data[i] = static_cast<float>(i) * 0.1f - 0.2f;
+    }
+    SetCommonTensor(x_, x_dims_, x_data.data());
+    SetCommonTensor(gate_, x_dims_, gate_data.data());
+    SetCommonTensor(
+        bias_, DDim(std::vector<int64_t>({w})), bias_data.data(), {}, true);
+  }
+};
+
+TEST(FusedElementwiseChain, precision) {
+  LOG(INFO) << "test fused_elementwise_chain op";
+#if defined(LITE_WITH_X86)
+  Place place(TARGET(kX86));
+#else
+  Place place(TARGET(kHost));
+#endif
+  float abs_err = 1e-5;
+  for (auto dims : std::vector<std::vector<int64_t>>{
+           // the last one is split over the threads on x86
+           {1, 3, 5, 7},
+           {2, 64},
+           {129},
+           {4, 3, 32, 33},
+           {8, 64, 65}}) {
+    std::unique_ptr<arena::TestCase> tester(
+        new FusedElementwiseChainComputeTester(place, "def", DDim(dims)));
+    arena::Arena arena(std::move(tester), place, abs_err);
+    arena.TestPrecision();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
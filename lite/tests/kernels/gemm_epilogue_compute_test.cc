@@ -0,0 +1,240 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/test/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+// Runs fc or matmul_v2 with the epilogue scale -> add(y) -> act, against
+// the gemm followed by the unfused ops.
+class GemmEpilogueComputeTester : public arena::TestCase {
+ protected:
+  std::string op_type_;
+  std::string x_ = "x";
+  std::string w_ = "w";
+  std::string y_ = "y";
+  std::string out_ = "out";
+  DDim x_dims_;
+  DDim w_dims_;
+  DDim y_dims_;
+  float scale_{0.5f};
+  float bias_{0.1f};
+  std::string act_;
+  float act_alpha_{0.f};
+
+ public:
+  GemmEpilogueComputeTester(const Place& place,
+                            const std::string& alias,
+                            const std::string& op_type,
+                            const DDim& x_dims,
+                            const DDim& w_dims,
+                            const DDim& y_dims,
+                            const std::string& act,
+                            float act_alpha)
+      : TestCase(place, alias),
+        op_type_(op_type),
+        x_dims_(x_dims),
+        w_dims_(w_dims),
+        y_dims_(y_dims),
+        act_(act),
+        act_alpha_(act_alpha) {}
+
+  void RunBaseline(Scope* scope) override {
+    auto* x = scope->FindTensor(x_);
+    auto* w = scope->FindTensor(w_);
+    auto* y = scope->FindTensor(y_);
+    auto* out = scope->NewTensor(out_);
+    CHECK(out);
+    // x: [..., M, K], w: [K, N] or [..., K, N] of the batches of x
+    const int64_t rank = x_dims_.size();
+    const int64_t m = x_dims_[rank - 2];
+    const int64_t k = x_dims_[rank - 1];
+    const int64_t n = w_dims_[w_dims_.size() - 1];
+    const int64_t batch = x_dims_.production() / (m * k);
+    const bool w_batched = w_dims_.size() > 2;
+    std::vector<int64_t> out_shape = x_dims_.Vectorize();
+    out_shape.back() = n;
+    DDim out_dims(out_shape);
+    out->Resize(out_dims);
+    const auto* x_data = x->data<float>();
+    const auto* w_data = w->data<float>();
+    const auto* y_data = y->data<float>();
+    auto* out_data = out->mutable_data<float>();
+    for (int64_t b = 0; b < batch; b++) {
+      const float* xb = x_data + b * m * k;
+      const float* wb = w_data + (w_batched ? b * k * n : 0);
+      float* ob = out_data + b * m * n;
+      for (int64_t i = 0; i < m; i++) {
+        for (int64_t j = 0; j < n; j++) {
+          float sum = 0.f;
+          for (int64_t l = 0; l < k; l++) {
+            sum += xb[i * k + l] * wb[l * n + j];
+          }
+          ob[i * n + j] = sum;
+        }
+      }
+    }
+    // y is broadcast to the output from the right
+    const size_t offset = out_dims.size() - y_dims_.size();
+    for (int64_t i = 0; i < out_dims.production(); i++) {
+      int64_t index = i;
+      int64_t y_index = 0;
+      int64_t y_stride = 1;
+      for (size_t d = out_dims.size(); d-- > 0;) {
+        const int64_t out_idx = index % out_dims[d];
+        index /= out_dims[d];
+        if (d < offset) continue;
+        const int64_t y_dim = y_dims_[d - offset];
+        if (y_dim != 1) y_index += out_idx * y_stride;
+        y_stride *= y_dim;
+      }
+      float v = out_data[i] * scale_ + bias_;
+      v += y_data[y_index];
+      if (act_ == "relu") {
+        v = std::max(v, 0.f);
+      } else if (act_ == "relu6") {
+        v = std::min(std::max(v, 0.f), act_alpha_);
+      } else if (act_ == "leaky_relu") {
+        v = v > 0.f ? v : v * act_alpha_;
+      } else if (act_ == "sigmoid") {
+        v = 1.f / (1.f + std::exp(-v));
+      } else if (act_ == "tanh") {
+        v = std::tanh(v);
+      } else if (act_ == "swish") {
+        v = v / (1.f + std::exp(-act_alpha_ * v));
+      }
+      out_data[i] = v;
+    }
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) override {
+    op_desc->SetType(op_type_);
+    if (op_type_ == "fc") {
+      op_desc->SetInput("Input", {x_});
+      op_desc->SetInput("W", {w_});
+      op_desc->SetAttr<int>("in_num_col_dims",
+                            static_cast<int>(x_dims_.size()) - 1);
+    } else {
+      op_desc->SetInput("X", {x_});
+      op_desc->SetInput("Y", {w_});
+      op_desc->SetAttr<bool>("trans_x", false);
+      op_desc->SetAttr<bool>("trans_y", false);
+    }
+    op_desc->SetInput("EpilogueInputs", {y_});
+    op_desc->SetOutput("Out", {out_});
+    op_desc->SetAttr("epilogue_ops",
+                     std::vector<std::string>({"scale", "add", act_}));
+    op_desc->SetAttr("epilogue_alphas",
+                     std::vector<float>({scale_, 0.f, act_alpha_}));
+    op_desc->SetAttr("epilogue_betas", std::vector<float>({bias_, 0.f, 0.f}));
+  }
+
+  void PrepareData() override {
+    std::vector<float> x_data(x_dims_.production());
+    fill_data_rand(x_data.data(), -1.f, 1.f, x_dims_.production());
+    std::vector<float> w_data(w_dims_.production());
+    fill_data_rand(w_data.data(), -1.f, 1.f, w_dims_.production());
+    std::vector<float> y_data(y_dims_.production());
+    fill_data_rand(y_data.data(), -1.f, 1.f, y_dims_.production());
+    SetCommonTensor(x_, x_dims_, x_data.data());
+    SetCommonTensor(w_, w_dims_, w_data.data(), {}, op_type_ == "fc");
+    SetCommonTensor(y_, y_dims_, y_data.data());
+  }
+};
+
+static void TestGemmEpilogue(const Place& place,
+                             float abs_error,
+                             const std::string& op_type,
+                             const std::vector<int64_t>& x_dims,
+                             const std::vector<int64_t>& w_dims,
+                             const std::vector<int64_t>& y_dims,
+                             const std::string& act = "relu",
+                             float act_alpha = 0.f) {
+  std::unique_ptr<arena::TestCase> tester(
+      new GemmEpilogueComputeTester(place,
+                                    "def",
+                                    op_type,
+                                    DDim(x_dims),
+                                    DDim(w_dims),
+                                    DDim(y_dims),
+                                    act,
+                                    act_alpha));
+  arena::Arena arena(std::move(tester), place, abs_error);
+  arena.TestPrecision();
+}
+
+TEST(GemmEpilogue, precision) {
+#if defined(LITE_WITH_X86)
+  Place place(TARGET(kX86));
+  float abs_error = 1e-4;
+  for (auto op_type : {"fc", "matmul_v2"}) {
+    // a residual of the shape of the output
+    TestGemmEpilogue(place, abs_error, op_type, {2, 5, 16}, {16, 8}, {2, 5, 8});
+    // a bias of the last dim
+    TestGemmEpilogue(place, abs_error, op_type, {2, 5, 16}, {16, 8}, {8});
+    // a tensor of the rows
+    TestGemmEpilogue(place, abs_error, op_type, {10, 16}, {16, 8}, {10, 1});
+    // broadcast on the leading dims only
+    TestGemmEpilogue(place, abs_error, op_type, {3, 5, 16}, {16, 8}, {5, 8});
+    TestGemmEpilogue(
+        place, abs_error, op_type, {3, 5, 16}, {16, 8}, {3, 1, 8});
+  }
+  // the mask of the attention scores, [batch, 1, 1, seq] on
+  // [batch, head, seq, seq]
+  TestGemmEpilogue(place,
+                   abs_error,
+                   "matmul_v2",
+                   {2, 3, 7, 4},
+                   {2, 3, 4, 7},
+                   {2, 1, 1, 7});
+  TestGemmEpilogue(place,
+                   abs_error,
+                   "matmul_v2",
+                   {2, 3, 7, 4},
+                   {2, 3, 4, 7},
+                   {2, 3, 7, 1});
+  // the activations, on rows with a tail past the avx width and enough of
+  // them to be split over the threads
+  const std::vector<std::pair<std::string, float>> acts{{"relu6", 1.f},
+                                                        {"leaky_relu", 0.1f},
+                                                        {"sigmoid", 0.f},
+                                                        {"tanh", 0.f},
+                                                        {"swish", 1.5f}};
+  for (auto& act : acts) {
+    TestGemmEpilogue(
+        place, abs_error, "fc", {5, 16}, {16, 13}, {13}, act.first, act.second);
+    TestGemmEpilogue(place,
+                     abs_error,
+                     "matmul_v2",
+                     {64, 32},
+                     {32, 300},
+                     {300},
+                     act.first,
+                     act.second);
+  }
+#endif
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -113,8 +113,10 @@ TEST(Softmax, precision) {
 #else
   return;
 #endif
-#elif defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
+#elif defined(LITE_WITH_ARM)
   place = TARGET(kHost);
+#elif defined(LITE_WITH_X86)
+  place = TARGET(kX86);
 #else
   return;
 #endif
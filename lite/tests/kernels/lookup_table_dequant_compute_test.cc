@@ -127,9 +127,13 @@ class LookupTableDequantComputeTest : public arena::TestCase {
 };
 
 TEST(LookupTableDequant, precision) {
-#ifdef LITE_WITH_ARM
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
   float abs_error = 2e-5;
+#ifdef LITE_WITH_ARM
   Place place = TARGET(kARM);
+#else
+  Place place = TARGET(kX86);
+#endif
   for (auto ids_dims :
        std::vector<std::vector<int64_t>>{{5, 2, 3, 1}, {2, 3, 1}, {3, 1}}) {
     for (auto w_dims :
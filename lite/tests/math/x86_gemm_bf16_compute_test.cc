@@ -0,0 +1,133 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace math = paddle::lite::x86::math;
+
+// c = a * b + bias on the bf16-rounded inputs, accumulated in double
+void basic_gemm_bf16(int m,
+                     int n,
+                     int k,
+                     const float *a,
+                     const float *b,
+                     const float *bias,
+                     bool relu,
+                     float *c) {
+  std::vector<uint16_t> a_bf16(m * k), b_bf16(k * n);
+  std::vector<float> a_round(m * k), b_round(k * n);
+  math::fp32_to_bf16(a, a_bf16.data(), m * k);
+  math::fp32_to_bf16(b, b_bf16.data(), k * n);
+  math::bf16_to_fp32(a_bf16.data(), a_round.data(), m * k);
+  math::bf16_to_fp32(b_bf16.data(), b_round.data(), k * n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double sum = bias ? bias[j] : 0.;
+      for (int l = 0; l < k; l++) {
+        sum += static_cast<double>(a_round[i * k + l]) * b_round[l * n + j];
+      }
+      c[i * n + j] = relu ? std::max(sum, 0.) : sum;
+    }
+  }
+}
+
+bool test_gemm_bf16(int m, int n, int k, bool has_bias, bool relu) {
+  std::vector<float> a(m * k), b(k * n), bias(n), c_ref(m * n), c_test(m * n);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+  const float *bias_ptr = has_bias ? bias.data() : nullptr;
+  basic_gemm_bf16(m, n, k, a.data(), b.data(), bias_ptr, relu, c_ref.data());
+
+  std::vector<uint16_t> pack_b(math::gemm_bf16_packed_b_size(n, k));
+  math::gemm_bf16_pack_b(n, k, b.data(), n, pack_b.data());
+  math::gemm_bf16(m,
+                  n,
+                  k,
+                  a.data(),
+                  k,
+                  pack_b.data(),
+                  c_test.data(),
+                  n,
+                  bias_ptr,
+                  relu);
+  for (int i = 0; i < m * n; i++) {
+    if (std::fabs(c_test[i] - c_ref[i]) > 1e-3 * (1.f + std::fabs(c_ref[i]))) {
+      LOG(INFO) << "m: " << m << ", n: " << n << ", k: " << k << " at " << i
+                << " real is " << c_ref[i] << ", test is " << c_test[i];
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(TestX86LiteGemmBF16, fp32_to_bf16) {
+  // round to nearest even on the 16 dropped bits
+  std::vector<float> din{1.f, 1.00390625f, 1.01171875f, -0.f, INFINITY, NAN};
+  std::vector<uint16_t> expect{0x3f80, 0x3f80, 0x3f82, 0x8000, 0x7f80};
+  std::vector<uint16_t> dout(din.size());
+  math::fp32_to_bf16(din.data(), dout.data(), din.size());
+  for (size_t i = 0; i < expect.size(); i++) {
+    EXPECT_EQ(dout[i], expect[i]);
+  }
+  EXPECT_EQ(dout.back() & 0x7f80, 0x7f80);
+  EXPECT_NE(dout.back() & 0x7f, 0);
+}
+
+TEST(TestX86LiteGemmBF16, pack_b_trans_alpha) {
+  // the N x K weight of matmul(transpose_Y) packs the same as its scaled
+  // K x N transpose
+  const float alpha = 0.125f;
+  for (int nn : {1, 15, 16, 33}) {
+    for (int kk : {1, 2, 63}) {
+      std::vector<float> b_t(nn * kk), b(kk * nn);
+      fill_data_rand(b_t.data(), -1.f, 1.f, b_t.size());
+      for (int j = 0; j < nn; j++) {
+        for (int l = 0; l < kk; l++) {
+          b[l * nn + j] = alpha * b_t[j * kk + l];
+        }
+      }
+      std::vector<uint16_t> ref(math::gemm_bf16_packed_b_size(nn, kk));
+      std::vector<uint16_t> test(ref.size());
+      math::gemm_bf16_pack_b(nn, kk, b.data(), nn, ref.data());
+      math::gemm_bf16_pack_b(nn, kk, b_t.data(), kk, true, alpha, test.data());
+      EXPECT_TRUE(ref == test) << "n: " << nn << ", k: " << kk;
+    }
+  }
+}
+
+TEST(TestX86LiteGemmBF16, gemm_bf16_compute) {
+  for (int mm : {1, 3, 8, 13, 64, 130}) {
+    for (int nn : {1, 15, 16, 33, 100}) {
+      for (int kk : {1, 2, 63, 64, 255}) {
+        for (auto &bias : {true, false}) {
+          for (auto &relu : {true, false}) {
+            if (!test_gemm_bf16(mm, nn, kk, bias, relu))
+              LOG(FATAL) << "bf16 precision check failed (diff > 0.001)!";
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -24,8 +24,11 @@
 #include <gtest/gtest.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include "lite/backends/x86/math/gemm_s8u8_pack.h"
 #include "lite/core/context.h"
 #include "lite/core/profile/timer.h"
 #include "lite/core/tensor.h"
@@ -413,4 +416,87 @@ TEST(TestX86LiteGemmInt8f32, gemm_s8u8f32_compute) {
   }
 }
 
+// Every isa-specific micro-kernel the cpu supports must match the scalar
+// reference kernel on the same packed data.
+template <typename TYPE_C>
+bool test_gemm_s8u8_isa_kernels(int m, int n, int k, int relu_type) {
+  using paddle::lite::x86::cpu_isa_t;
+  namespace math = paddle::lite::x86::math;
+  int k_align4 = (k + 3) / 4 * 4;
+  std::vector<int8_t> a(m * k), b(k * n), pack_a(m * k_align4);
+  std::vector<uint8_t> pack_b(n * k_align4);
+  std::vector<float> scale(m), bias(m);
+  // |a| < 64 keeps the avx2 vpmaddubsw pair sums away from int16 saturation
+  for (auto &v : a) v = static_cast<int8_t>(rand() % 127 - 63);  // NOLINT
+  for (auto &v : b) v = static_cast<int8_t>(rand() % 255 - 127);  // NOLINT
+  for (int i = 0; i < m; i++) {
+    scale[i] = 1.f / (1000.f + i);
+    bias[i] = (rand() % 200 - 100) / 100.f;  // NOLINT
+  }
+  memset(pack_a.data(), 0, pack_a.size());
+  math::gemm_s8u8s8_prepackA(m, k, a.data(), pack_a.data(), false);
+  math::gemm_s8u8s8_runpackB(n, k, n, b.data(), pack_b.data(), false);
+
+  std::vector<TYPE_C> c_ref(m * n), c_test(m * n);
+  math::GetGemmS8U8Kernel<TYPE_C>(paddle::lite::x86::isa_any)(m,
+                                                              n,
+                                                              k,
+                                                              pack_a.data(),
+                                                              pack_b.data(),
+                                                              c_ref.data(),
+                                                              n,
+                                                              scale.data(),
+                                                              bias.data(),
+                                                              relu_type,
+                                                              6.f);
+  const double tol = sizeof(TYPE_C) == 1 ? 1. : 1e-3;
+  for (cpu_isa_t isa : {paddle::lite::x86::avx2,
+                        paddle::lite::x86::avx512_core,
+                        paddle::lite::x86::avx512_core_vnni,
+                        paddle::lite::x86::avx512_core_amx}) {
+    auto kern = math::GetGemmS8U8Kernel<TYPE_C>(isa);
+    if (kern == nullptr) continue;
+    kern(m,
+         n,
+         k,
+         pack_a.data(),
+         pack_b.data(),
+         c_test.data(),
+         n,
+         scale.data(),
+         bias.data(),
+         relu_type,
+         6.f);
+    for (int i = 0; i < m * n; i++) {
+      double diff = std::fabs(static_cast<double>(c_test[i]) -
+                              static_cast<double>(c_ref[i]));
+      if (diff > tol) {
+        LOG(INFO) << "isa " << isa << " m: " << m << ", n: " << n
+                  << ", k: " << k << ", relu: " << relu_type << " at " << i
+                  << " real is " << static_cast<double>(c_ref[i])
+                  << ", test is " << static_cast<double>(c_test[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(TestX86LiteGemmInt8Isa, gemm_s8u8_isa_kernels) {
+  LOG(INFO) << "best gemm_s8u8 isa: "
+            << paddle::lite::x86::math::GemmS8U8BestIsa();
+  for (int mm : {1, 2, 15, 16, 33, 64}) {
+    for (int nn : {1, 7, 31, 32, 61, 100}) {
+      for (int kk : {3, 4, 63, 64, 65, 130}) {
+        for (int relu : {0, 1, 2, 3}) {
+          if (!test_gemm_s8u8_isa_kernels<int8_t>(mm, nn, kk, relu))
+            LOG(FATAL) << "int8 isa kernel check failed (diff > 1)!";
+          if (!test_gemm_s8u8_isa_kernels<float>(mm, nn, kk, relu))
+            LOG(FATAL) << "float isa kernel check failed (diff > 0.001)!";
+        }
+      }
+    }
+  }
+}
+
 #endif  // LITE_WITH_X86
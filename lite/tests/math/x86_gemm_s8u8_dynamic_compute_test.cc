@@ -0,0 +1,143 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace math = paddle::lite::x86::math;
+
+// c = a * b + bias on the rows of a and the cols of b quantized the way
+// gemm_s8u8_dynamic does, the int products summed exactly
+void basic_gemm_s8u8_dynamic(int m,
+                             int n,
+                             int k,
+                             const float *a,
+                             const float *b,
+                             const float *bias,
+                             bool relu,
+                             float *c) {
+  const float a_range = math::gemm_s8u8_dynamic_a_range();
+  std::vector<float> b_scales(n);
+  for (int j = 0; j < n; j++) {
+    float abs_max = 0.f;
+    for (int l = 0; l < k; l++) {
+      abs_max = std::max(abs_max, std::fabs(b[l * n + j]));
+    }
+    b_scales[j] = abs_max / 127.f;
+  }
+  // the inverse scales multiply, as in the kernel, for the same rounding, a
+  // is rounded to nearest even as by cvtps
+  for (int i = 0; i < m; i++) {
+    float abs_max = 0.f;
+    for (int l = 0; l < k; l++) {
+      abs_max = std::max(abs_max, std::fabs(a[i * k + l]));
+    }
+    float a_scale = abs_max / a_range;
+    float a_inv = a_scale > 0.f ? 1.f / a_scale : 0.f;
+    for (int j = 0; j < n; j++) {
+      float b_inv = b_scales[j] > 0.f ? 1.f / b_scales[j] : 0.f;
+      int64_t sum = 0;
+      for (int l = 0; l < k; l++) {
+        int64_t qa = std::nearbyint(a[i * k + l] * a_inv);
+        int64_t qb = std::round(b[l * n + j] * b_inv);
+        sum += qa * qb;
+      }
+      double x = static_cast<double>(sum) * a_scale * b_scales[j];
+      if (bias) x += bias[j];
+      c[i * n + j] = relu ? std::max(x, 0.) : x;
+    }
+  }
+}
+
+bool test_gemm_s8u8_dynamic(int m, int n, int k, bool has_bias, bool relu) {
+  std::vector<float> a(m * k), b(k * n), bias(n), c_ref(m * n), c_test(m * n);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+  const float *bias_ptr = has_bias ? bias.data() : nullptr;
+  basic_gemm_s8u8_dynamic(
+      m, n, k, a.data(), b.data(), bias_ptr, relu, c_ref.data());
+
+  std::vector<uint8_t> qb(math::gemm_s8u8_dynamic_packed_b_size(n, k));
+  std::vector<float> b_scales(n);
+  math::gemm_s8u8_dynamic_quant_b(
+      n, k, b.data(), n, false, 1.f, qb.data(), b_scales.data());
+  math::gemm_s8u8_dynamic(m,
+                          n,
+                          k,
+                          a.data(),
+                          k,
+                          qb.data(),
+                          b_scales.data(),
+                          c_test.data(),
+                          n,
+                          bias_ptr,
+                          relu);
+  for (int i = 0; i < m * n; i++) {
+    if (std::fabs(c_test[i] - c_ref[i]) > 1e-4 * (1.f + std::fabs(c_ref[i]))) {
+      LOG(INFO) << "m: " << m << ", n: " << n << ", k: " << k << " at " << i
+                << " real is " << c_ref[i] << ", test is " << c_test[i];
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(TestX86LiteGemmS8U8Dynamic, quant_b_trans) {
+  // the transposed b gives the same int8 and scales as b
+  const int n = 7;
+  const int k = 5;
+  std::vector<float> b(k * n), b_trans(n * k);
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  for (int l = 0; l < k; l++) {
+    for (int j = 0; j < n; j++) b_trans[j * k + l] = b[l * n + j];
+  }
+  const int64_t size = math::gemm_s8u8_dynamic_packed_b_size(n, k);
+  std::vector<uint8_t> qb(size), qb_trans(size);
+  std::vector<float> scales(n), scales_trans(n);
+  math::gemm_s8u8_dynamic_quant_b(
+      n, k, b.data(), n, false, 2.f, qb.data(), scales.data());
+  math::gemm_s8u8_dynamic_quant_b(
+      n, k, b_trans.data(), k, true, 2.f, qb_trans.data(), scales_trans.data());
+  for (int64_t i = 0; i < size; i++) {
+    EXPECT_EQ(qb[i], qb_trans[i]);
+  }
+  for (int j = 0; j < n; j++) {
+    EXPECT_FLOAT_EQ(scales[j], scales_trans[j]);
+  }
+}
+
+TEST(TestX86LiteGemmS8U8Dynamic, gemm_s8u8_dynamic_compute) {
+  for (int mm : {1, 3, 8, 13, 64, 130}) {
+    for (int nn : {1, 15, 16, 33, 100}) {
+      for (int kk : {1, 2, 63, 64, 255}) {
+        for (auto &bias : {true, false}) {
+          for (auto &relu : {true, false}) {
+            if (!test_gemm_s8u8_dynamic(mm, nn, kk, bias, relu))
+              LOG(FATAL) << "dynamic int8 precision check failed!";
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "lite/backends/x86/math/softmax.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace math = paddle::lite::x86::math;
+
+// softmax of x: [outer_num, axis_size, inner_num] along axis_size in double
+void basic_softmax(const float *x,
+                   float *y,
+                   int outer_num,
+                   int axis_size,
+                   int inner_num,
+                   bool log) {
+  for (int o = 0; o < outer_num; o++) {
+    for (int c = 0; c < inner_num; c++) {
+      const float *x_col = x + o * axis_size * inner_num + c;
+      float *y_col = y + o * axis_size * inner_num + c;
+      double max_val = -std::numeric_limits<double>::infinity();
+      for (int a = 0; a < axis_size; a++) {
+        max_val = std::max(max_val, static_cast<double>(x_col[a * inner_num]));
+      }
+      double sum = 0;
+      for (int a = 0; a < axis_size; a++) {
+        sum += std::exp(x_col[a * inner_num] - max_val);
+      }
+      for (int a = 0; a < axis_size; a++) {
+        const double v = x_col[a * inner_num] - max_val;
+        y_col[a * inner_num] = log ? v - std::log(sum) : std::exp(v) / sum;
+      }
+    }
+  }
+}
+
+TEST(TestX86LiteSoftmax, softmax_compute) {
+  for (int outer_num : {1, 3, 17}) {
+    for (int axis_size : {1, 5, 16, 37, 1000}) {
+      for (int inner_num : {1, 3, 8, 13}) {
+        for (bool log : {false, true}) {
+          const int size = outer_num * axis_size * inner_num;
+          std::vector<float> x(size), y(size), y_ref(size);
+          fill_data_rand(x.data(), -8.f, 8.f, size);
+          if (log) {
+            math::log_softmax(
+                x.data(), y.data(), outer_num, axis_size, inner_num);
+          } else {
+            math::softmax(x.data(), y.data(), outer_num, axis_size, inner_num);
+          }
+          basic_softmax(
+              x.data(), y_ref.data(), outer_num, axis_size, inner_num, log);
+          for (int i = 0; i < size; i++) {
+            EXPECT_NEAR(
+                y[i], y_ref[i], 1e-5 * std::max(1.f, std::fabs(y_ref[i])));
+          }
+        }
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -88,6 +88,38 @@
 #define MIXED_PRECISION_QUANTIZATION_CONFIG_BUFFER \
   "MIXED_PRECISION_QUANTIZATION_CONFIG_BUFFER"
 
+// The environment variables for the x86 jit kernels.
+// Time every candidate implementation of a jit kernel the first time an attr
+// is seen and use the fastest one, instead of the default picked offline.
+#define LITE_JIT_AUTOTUNE "LITE_JIT_AUTOTUNE"
+// Specify the file of the jit autotune table, it is loaded on the first use
+// and saved at the exit if LITE_JIT_AUTOTUNE is set, an example of the lines
+// is shown as below:
+// kernel_type jit_code_key impl_type
+// kSeqPool 5147735862214399342 JitCode
+#define LITE_JIT_AUTOTUNE_FILE "LITE_JIT_AUTOTUNE_FILE"
+
+// The environment variables for the kernels with several implementations.
+// Time every implementation which can run an instruction on its actual
+// shapes at the first run and keep the fastest, instead of the heuristics.
+#define LITE_KERNEL_AUTOTUNE "LITE_KERNEL_AUTOTUNE"
+// Specify the file of the kernel autotune table, it is loaded on the first
+// use and saved at the exit if new choices were made, an example of the lines
+// is shown as below:
+// impl key
+// direct conv2d/x86/float x=[1 32 56 56] w=[64 32 3 3] s=1,1 p=1,1,1,1 ...
+#define LITE_KERNEL_AUTOTUNE_FILE "LITE_KERNEL_AUTOTUNE_FILE"
+
+// Specify the latency lookup table of the device to pick the kernels by their
+// estimated latency, in the format of the table made by
+// lite/tests/benchmark/get_latency_lookup_table.py.
+#define KERNEL_LATENCY_TABLE_FILE "KERNEL_LATENCY_TABLE_FILE"
+
+// The number of threads the pattern matcher of the optimizer tells the nodes
+// of the large graphs with, 1 by default. The tellers of the patterns must
+// only read the graph.
+#define LITE_PATTERN_MATCHER_THREADS "LITE_PATTERN_MATCHER_THREADS"
+
 namespace paddle {
 namespace lite {
 